@@ -0,0 +1,152 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the FIFO reserve and commit functions. Random writes,
+ * reservations and reads are compared with a reference queue of the bytes
+ * written so that reservations that wrap around the end of the buffer are
+ * covered at every position.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Fifo.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define DATA_SIZE (61)
+#define NUMBER_OF_OPERATIONS (1000000)
+#define REFERENCE_SIZE (DATA_SIZE * 2)
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint8_t data[DATA_SIZE];
+static Fifo fifo = {.data = data, .dataSize = sizeof (data)};
+
+static uint8_t reference[REFERENCE_SIZE];
+static size_t referenceWriteIndex;
+static size_t referenceReadIndex;
+static uint8_t nextByte;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Returns the number of bytes in the reference queue.
+ */
+static size_t ReferenceAvailable(void) {
+    return referenceWriteIndex - referenceReadIndex;
+}
+
+/**
+ * @brief Generates bytes and adds them to the reference queue.
+ */
+static void Generate(uint8_t * const destination, const size_t numberOfBytes) {
+    for (size_t index = 0; index < numberOfBytes; index++) {
+        destination[index] = nextByte++;
+        reference[referenceWriteIndex++ % REFERENCE_SIZE] = destination[index];
+    }
+}
+
+/**
+ * @brief Writes a message with FifoWrite.
+ */
+static void Write(const size_t numberOfBytes) {
+    uint8_t message[DATA_SIZE];
+    if (numberOfBytes > FifoAvailableWrite(&fifo)) {
+        assert(FifoWrite(&fifo, message, numberOfBytes) == FifoResultError);
+        return;
+    }
+    Generate(message, numberOfBytes);
+    assert(FifoWrite(&fifo, message, numberOfBytes) == FifoResultOk);
+}
+
+/**
+ * @brief Reserves space, skips a header, writes the message in chunks in a
+ * random order, and commits the header and the message or fewer bytes.
+ */
+static void Reserve(const size_t numberOfBytes) {
+    FifoReservation reservation;
+    if (numberOfBytes > FifoAvailableWrite(&fifo)) {
+        assert(FifoReserve(&fifo, numberOfBytes, &reservation) == FifoResultError);
+        return;
+    }
+    const size_t availableRead = FifoAvailableRead(&fifo);
+    assert(FifoReserve(&fifo, numberOfBytes, &reservation) == FifoResultOk);
+    assert((reservation.firstSize + reservation.secondSize) == numberOfBytes);
+    assert((reservation.first >= data) && ((reservation.first + reservation.firstSize) <= (data + DATA_SIZE)));
+    assert((reservation.secondSize == 0) || ((reservation.first + reservation.firstSize) == (data + DATA_SIZE)));
+    assert(reservation.second == data);
+
+    // Write header
+    const size_t headerSize = numberOfBytes == 0 ? 0 : (size_t) rand() % (numberOfBytes + 1);
+    uint8_t message[DATA_SIZE];
+    Generate(message, headerSize);
+    FifoReservationWrite(&reservation, 0, message, headerSize);
+    FifoReservationSkip(&reservation, headerSize);
+    assert((reservation.firstSize + reservation.secondSize) == (numberOfBytes - headerSize));
+
+    // Write message in two chunks, second chunk first
+    const size_t messageSize = (size_t) rand() % (numberOfBytes - headerSize + 1);
+    const size_t chunkSize = messageSize == 0 ? 0 : (size_t) rand() % (messageSize + 1);
+    Generate(message, messageSize);
+    FifoReservationWrite(&reservation, chunkSize, &message[chunkSize], messageSize - chunkSize);
+    assert(FifoAvailableRead(&fifo) == availableRead);
+    FifoReservationWrite(&reservation, 0, message, chunkSize);
+    FifoCommit(&fifo, headerSize + messageSize);
+    assert(FifoAvailableRead(&fifo) == (availableRead + headerSize + messageSize));
+}
+
+/**
+ * @brief Reads and compares with the reference queue.
+ */
+static void Read(const size_t numberOfBytes) {
+    uint8_t destination[DATA_SIZE];
+    const size_t expected = numberOfBytes < ReferenceAvailable() ? numberOfBytes : ReferenceAvailable();
+    assert(FifoRead(&fifo, destination, numberOfBytes) == expected);
+    for (size_t index = 0; index < expected; index++) {
+        assert(destination[index] == reference[referenceReadIndex++ % REFERENCE_SIZE]);
+    }
+}
+
+/**
+ * @brief Random writes, reservations and reads.
+ */
+static void TestReserve(void) {
+    int numberOfWraparounds = 0;
+    for (int operation = 0; operation < NUMBER_OF_OPERATIONS; operation++) {
+        const size_t numberOfBytes = (size_t) rand() % DATA_SIZE;
+        switch (rand() % 3) {
+            case 0:
+                Write(numberOfBytes);
+                break;
+            case 1:
+                numberOfWraparounds += ((numberOfBytes <= FifoAvailableWrite(&fifo)) && ((fifo.writeIndex + numberOfBytes) > DATA_SIZE)) ? 1 : 0;
+                Reserve(numberOfBytes);
+                break;
+            default:
+                Read(numberOfBytes);
+                break;
+        }
+        assert(FifoAvailableRead(&fifo) == ReferenceAvailable());
+        assert((FifoAvailableRead(&fifo) + FifoAvailableWrite(&fifo)) == FifoCapacity(&fifo));
+    }
+    printf("reserve: %d operations, %d reservations wrapped around: ok\n", NUMBER_OF_OPERATIONS, numberOfWraparounds);
+    assert(numberOfWraparounds > 0);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestReserve();
+    printf("Fifo: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,317 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the frame. Sensors set samples in batches of random
+ * size, as they do in ImuBatchTasks, and so are at different frames when each
+ * update is called. The gyroscope x axis of each sample is the sample number
+ * so that the sample selected for each frame can be checked.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Frame/Frame.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define SAMPLE_RATE (1024.0f)
+#define PERIOD ((double) TIMER_TICKS_PER_SECOND / (double) SAMPLE_RATE)
+#define DIVISOR (4)
+#define SAMPLES_PER_ROUND (4)
+#define NUMBER_OF_ROUNDS (1000)
+#define MAX_NUMBER_OF_FRAMES (2000)
+#define NUMBER_OF_SAMPLES (NUMBER_OF_ROUNDS * SAMPLES_PER_ROUND)
+#define ALL_SENSORS ((1UL << FRAME_NUMBER_OF_SENSORS) - 1)
+
+/**
+ * @brief Sent frame.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint32_t presence;
+    float sampleNumbers[FRAME_NUMBER_OF_SENSORS];
+    float sampleOffsets[FRAME_NUMBER_OF_SENSORS];
+    int round;
+} SentFrame;
+
+/**
+ * @brief Simulation. Sample n of sensor i is at phases[i] + n * PERIOD plus
+ * jitter ticks. A sample is lost if lost returns true. The frame rate divisor
+ * multiplier is set to multiplier at multiplierRound if multiplier is not 0.
+ */
+typedef struct {
+    double phases[FRAME_NUMBER_OF_SENSORS];
+    double jitter;
+    bool (*lost)(const int index, const uint64_t sampleNumber);
+    uint32_t multiplier;
+    int multiplierRound;
+} Simulation;
+
+//------------------------------------------------------------------------------
+// Variables
+
+Send sendMain;
+
+static SendRateDivisorMultipliers rateDivisorMultipliers;
+
+static SentFrame frames[MAX_NUMBER_OF_FRAMES];
+static int numberOfFrames;
+static int currentRound;
+static int processedRounds[FRAME_NUMBER_OF_SENSORS][NUMBER_OF_SAMPLES];
+
+//------------------------------------------------------------------------------
+// Functions
+
+void SendFrame(Send * const send, const SendFrameData * const frameData) {
+    assert(numberOfFrames < MAX_NUMBER_OF_FRAMES);
+    assert(frameData->numberOfSensors == FRAME_NUMBER_OF_SENSORS);
+    SentFrame * const sentFrame = &frames[numberOfFrames++];
+    sentFrame->ticks = frameData->ticks;
+    sentFrame->presence = frameData->presence;
+    for (int index = 0; index < FRAME_NUMBER_OF_SENSORS; index++) {
+        sentFrame->sampleNumbers[index] = frameData->sensors[index].gyroscope.axis.x;
+        sentFrame->sampleOffsets[index] = frameData->sensors[index].accelerometer.axis.x;
+    }
+    sentFrame->round = currentRound;
+}
+
+const SendRateDivisorMultipliers * SendGetRateDivisorMultipliers(void) {
+    return &rateDivisorMultipliers;
+}
+
+static uint64_t SampleTicks(const Simulation * const simulation, const int index, const uint64_t sampleNumber) {
+    const double jitter = simulation->jitter * (((double) rand() / (double) RAND_MAX) - 0.5);
+    return (uint64_t) (simulation->phases[index] + ((double) sampleNumber * PERIOD) + jitter);
+}
+
+/**
+ * @brief Runs the simulation. SAMPLES_PER_ROUND samples of each sensor arrive
+ * each round and each sensor sets between 2 and 8 of its pending samples.
+ */
+static void Run(const Simulation * const simulation) {
+    Frame frame = {.send = &sendMain};
+    const FrameSettings settings = {.frameMessageRateDivisor = DIVISOR};
+    FrameSetSettings(&frame, &settings);
+    numberOfFrames = 0;
+    rateDivisorMultipliers.frame = 1;
+    uint64_t sampleNumbers[FRAME_NUMBER_OF_SENSORS] = {0};
+    for (currentRound = 0; currentRound < NUMBER_OF_ROUNDS; currentRound++) {
+        if ((simulation->multiplier != 0) && (currentRound == simulation->multiplierRound)) {
+            rateDivisorMultipliers.frame = simulation->multiplier;
+        }
+        const uint64_t arrived = (uint64_t) (currentRound + 1) * SAMPLES_PER_ROUND;
+        for (int index = 0; index < FRAME_NUMBER_OF_SENSORS; index++) {
+            const uint64_t batchSize = 2 + (rand() % 7);
+            const uint64_t end = (sampleNumbers[index] + batchSize) < arrived ? (sampleNumbers[index] + batchSize) : arrived;
+            for (; sampleNumbers[index] < end; sampleNumbers[index]++) {
+                processedRounds[index][sampleNumbers[index]] = currentRound;
+                if ((simulation->lost != NULL) && simulation->lost(index, sampleNumbers[index])) {
+                    continue;
+                }
+                const uint64_t ticks = SampleTicks(simulation, index, sampleNumbers[index]);
+                const SendFrameSensor sensor = {
+                    .gyroscope = {.axis = {.x = (float) sampleNumbers[index]}},
+                    .accelerometer = {.axis = {.x = (float) ((double) ticks - simulation->phases[index] - ((double) sampleNumbers[index] * PERIOD))}},
+                };
+                FrameSetSensor(&frame, index, ticks, SAMPLE_RATE, &sensor);
+            }
+        }
+        FrameUpdate(&frame);
+    }
+}
+
+/**
+ * @brief Returns the frame number of a sent frame.
+ */
+static uint64_t FrameNumber(const SentFrame * const sentFrame) {
+    return (uint64_t) llround((double) sentFrame->ticks / (DIVISOR * PERIOD));
+}
+
+/**
+ * @brief Checks that frames are consecutive and at the frame ticks, and that
+ * the sample of each present sensor is the sample nearest the frame tick.
+ */
+static void CheckFrames(const Simulation * const simulation) {
+    assert(numberOfFrames > ((NUMBER_OF_ROUNDS * SAMPLES_PER_ROUND) / DIVISOR) - FRAME_NUMBER_OF_PENDING_FRAMES);
+    for (int index = 0; index < numberOfFrames; index++) {
+        const SentFrame * const sentFrame = &frames[index];
+        const uint64_t number = FrameNumber(sentFrame);
+        assert(fabs((double) sentFrame->ticks - ((double) number * DIVISOR * PERIOD)) <= 1.0);
+        if (index > 0) {
+            assert(number == (FrameNumber(&frames[index - 1]) + 1));
+        }
+        for (int sensor = 0; sensor < FRAME_NUMBER_OF_SENSORS; sensor++) {
+            if ((sentFrame->presence & (1UL << sensor)) == 0) {
+                continue;
+            }
+            const double sampleTicks = simulation->phases[sensor] + ((double) sentFrame->sampleNumbers[sensor] * PERIOD) + sentFrame->sampleOffsets[sensor];
+            assert(fabs(sampleTicks - (double) sentFrame->ticks) <= (0.5 * (PERIOD + simulation->jitter)));
+        }
+    }
+}
+
+/**
+ * @brief Returns the maximum number of rounds between each frame being sent
+ * and each sensor that is not lost setting the sample after the frame tick.
+ */
+static int MaxLatency(const Simulation * const simulation, const int first) {
+    int maxLatency = 0;
+    for (int index = first; index < numberOfFrames; index++) {
+        const uint64_t sampleNumber = (FrameNumber(&frames[index]) * DIVISOR) + 1;
+        int readyRound = 0;
+        for (int sensor = 0; sensor < FRAME_NUMBER_OF_SENSORS; sensor++) {
+            if ((simulation->lost != NULL) && simulation->lost(sensor, sampleNumber)) {
+                continue;
+            }
+            readyRound = processedRounds[sensor][sampleNumber] > readyRound ? processedRounds[sensor][sampleNumber] : readyRound;
+        }
+        const int latency = frames[index].round - readyRound;
+        maxLatency = latency > maxLatency ? latency : maxLatency;
+    }
+    return maxLatency;
+}
+
+/**
+ * @brief Resampled samples are on the frame ticks. All sensors are present in
+ * each frame.
+ */
+static void TestResampled(void) {
+    const Simulation simulation = {0};
+    Run(&simulation);
+    CheckFrames(&simulation);
+    for (int index = 0; index < numberOfFrames; index++) {
+        assert(frames[index].presence == ALL_SENSORS);
+        for (int sensor = 0; sensor < FRAME_NUMBER_OF_SENSORS; sensor++) {
+            assert(frames[index].sampleNumbers[sensor] == (float) (FrameNumber(&frames[index]) * DIVISOR));
+        }
+    }
+    printf("resampled: %d frames, all sensors present, max latency %d rounds\n", numberOfFrames, MaxLatency(&simulation, 0));
+}
+
+/**
+ * @brief Samples with a different phase and jitter for each sensor. The
+ * sample nearest each frame tick is selected.
+ */
+static void TestNotResampled(void) {
+    Simulation simulation = {.jitter = 0.1 * PERIOD};
+    for (int index = 0; index < FRAME_NUMBER_OF_SENSORS; index++) {
+        simulation.phases[index] = (0.2 + (0.6 * ((double) rand() / (double) RAND_MAX))) * PERIOD;
+    }
+    Run(&simulation);
+    CheckFrames(&simulation);
+    int numberOfComplete = 0;
+    for (int index = 0; index < numberOfFrames; index++) {
+        numberOfComplete += frames[index].presence == ALL_SENSORS ? 1 : 0;
+    }
+    printf("not resampled: %d frames, %d with all sensors present\n", numberOfFrames, numberOfComplete);
+    assert(numberOfComplete == numberOfFrames);
+}
+
+static bool LoseSensor3Frame10(const int index, const uint64_t sampleNumber) {
+    return (index == 3) && (sampleNumber == (10 * DIVISOR));
+}
+
+/**
+ * @brief A lost sample clears the presence bit of the sensor for that frame
+ * only, and does not delay the frame.
+ */
+static void TestLostSample(void) {
+    const Simulation simulation = {.lost = LoseSensor3Frame10};
+    Run(&simulation);
+    CheckFrames(&simulation);
+    for (int index = 0; index < numberOfFrames; index++) {
+        const uint32_t expected = FrameNumber(&frames[index]) == 10 ? (ALL_SENSORS & ~(1UL << 3)) : ALL_SENSORS;
+        assert(frames[index].presence == expected);
+    }
+    const int maxLatency = MaxLatency(&simulation, 0);
+    printf("lost sample: presence bit cleared for one frame, max latency %d rounds\n", maxLatency);
+    assert(maxLatency == 0);
+}
+
+static bool StopSensor0(const int index, const uint64_t sampleNumber) {
+    return (index == 0) && (sampleNumber >= (100 * DIVISOR));
+}
+
+/**
+ * @brief Frames continue without the first sensor if it stops.
+ */
+static void TestSensorStops(void) {
+    const Simulation simulation = {.lost = StopSensor0};
+    Run(&simulation);
+    CheckFrames(&simulation);
+    int first = 0;
+    for (int index = 0; index < numberOfFrames; index++) {
+        const uint64_t number = FrameNumber(&frames[index]);
+        const uint32_t expected = number < 100 ? ALL_SENSORS : (ALL_SENSORS & ~1UL);
+        assert(frames[index].presence == expected);
+        if (number < (100 + FRAME_NUMBER_OF_PENDING_FRAMES)) {
+            first = index + 1;
+        }
+    }
+    const int maxLatency = MaxLatency(&simulation, first);
+    printf("sensor stops: %d frames, max latency %d rounds after %d pending frames\n", numberOfFrames, maxLatency, FRAME_NUMBER_OF_PENDING_FRAMES);
+    assert(maxLatency == 0);
+}
+
+/**
+ * @brief Frames continue at the reduced rate if the rate divisor multiplier
+ * changes.
+ */
+static void TestRateDivisorMultiplier(void) {
+    const Simulation simulation = {.multiplier = 4, .multiplierRound = NUMBER_OF_ROUNDS / 2};
+    Run(&simulation);
+    int numberOfReduced = 0;
+    for (int index = 1; index < numberOfFrames; index++) {
+        const double interval = (double) (frames[index].ticks - frames[index - 1].ticks) / (DIVISOR * PERIOD);
+        if (frames[index].round < simulation.multiplierRound) {
+            assert(fabs(interval - 1.0) < 0.01);
+            assert(frames[index].presence == ALL_SENSORS);
+        } else if (frames[index].round > (simulation.multiplierRound + 2)) {
+            assert(fabs(interval - simulation.multiplier) < 0.01);
+            assert(frames[index].presence == ALL_SENSORS);
+            numberOfReduced++;
+        }
+    }
+    printf("rate divisor multiplier: %d frames, %d at the reduced rate\n", numberOfFrames, numberOfReduced);
+    assert(numberOfReduced > ((int) ((NUMBER_OF_SAMPLES / 2) / (DIVISOR * simulation.multiplier)) - 2));
+}
+
+/**
+ * @brief No frames are sent if the message is disabled.
+ */
+static void TestDisabled(void) {
+    rateDivisorMultipliers.frame = 1;
+    Frame frame = {.send = &sendMain};
+    const FrameSettings settings = {.frameMessageRateDivisor = 0};
+    FrameSetSettings(&frame, &settings);
+    numberOfFrames = 0;
+    const SendFrameSensor sensor = {0};
+    for (uint64_t sampleNumber = 0; sampleNumber < 100; sampleNumber++) {
+        FrameSetSensor(&frame, 0, (uint64_t) ((double) sampleNumber * PERIOD), SAMPLE_RATE, &sensor);
+        FrameUpdate(&frame);
+    }
+    assert(numberOfFrames == 0);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestResampled();
+    TestNotResampled();
+    TestLostSample();
+    TestSensorStops();
+    TestRateDivisorMultiplier();
+    TestDisabled();
+    printf("Frame: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
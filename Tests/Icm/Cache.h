@@ -0,0 +1,31 @@
+/**
+ * @file Cache.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for data cache maintenance. The functions are defined
+ * by the test so that invalidating samples written by the CPU, which may not
+ * have been written back, is detected.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define CACHE_LINE_BYTES (16)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void CacheWritebackInvalidate(const volatile void* const address, const size_t numberOfBytes);
+void CacheInvalidate(const volatile void* const address, const size_t numberOfBytes);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,758 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the ICM FIFO and data ready reads. A simulated ICM
+ * samples into a FIFO and asserts its interrupt for every sample while the FIFO
+ * count is greater than or equal to the watermark. A simulated SPI bus begins
+ * each transfer once the bus is free and calls the transfer complete callback
+ * after the transfer duration. The bus may be stalled to model other clients.
+ * The tests are repeated for each ICM, each on the simulated bus of its SPI
+ * bus. The FIFO discards the oldest packet when full. Register writes set the
+ * sample rate and watermark of the simulated ICM and may flush the FIFO.
+ * Samples written by the CPU are tagged with a non-zero temperature so that
+ * invalidating them is detected. The samples per microsecond converted by
+ * IcmGetData and IcmGetDataBatch are compared. Durations depend on the host
+ * and are not asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Cache.h"
+#include "definitions.h"
+#include "Imu/Icm/Icm.h"
+#include <math.h>
+#include "Profile/Profile.h"
+#include "Spi/SpiBus2.h"
+#include "Spi/SpiBus3.h"
+#include "Spi/SpiBus4.h"
+#include "Spi/SpiBus5.h"
+#include "Spi/SpiBus6.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define SAMPLE_RATE (IcmSampleRate8kHz)
+#define NOMINAL_PERIOD ((double) TIMER_TICKS_PER_SECOND / (double) SAMPLE_RATE)
+#define SENSOR_TIMESTAMP_PERIOD (1000000 / SAMPLE_RATE)
+#define MAX_NUMBER_OF_SAMPLES (1 << 20)
+#define MAX_INTERRUPT_LATENCY (2 * TIMER_TICKS_PER_MICROSECOND)
+#define NUMBER_OF_REPETITIONS (2000)
+
+/**
+ * @brief Simulated SPI bus.
+ */
+typedef struct {
+    const SpiBus * const spiBus;
+    SpiBusClient* client;
+    bool started;
+    uint64_t queuedTicks;
+    uint64_t completeTicks;
+    uint64_t stallTicks;
+} MockBus;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint64_t ticks;
+static bool hung;
+
+static struct {
+    bool running;
+    uint8_t bank;
+    uint32_t fifoWatermark;
+    double period;
+    double nextSampleTicks;
+    uint32_t numberOfSamples;
+    uint32_t timestampPeriod;
+    uint32_t timestamp;
+    uint32_t fifo[ICM_FIFO_CAPACITY];
+    uint16_t fifoTimestamps[ICM_FIFO_CAPACITY];
+    uint32_t fifoIndex;
+    uint32_t fifoCount;
+    uint32_t numberOfLostPackets;
+    uint32_t numberOfFlushedPackets;
+} sensor;
+
+static uint64_t sampleTicks[MAX_NUMBER_OF_SAMPLES];
+
+static struct {
+    GPIO_PIN_CALLBACK callback;
+    uintptr_t context;
+    bool enabled;
+} pins[MOCK_NUMBER_OF_PINS];
+
+static MockBus buses[] = {
+    {.spiBus = &spiBus2},
+    {.spiBus = &spiBus3},
+    {.spiBus = &spiBus4},
+    {.spiBus = &spiBus5},
+    {.spiBus = &spiBus6},
+};
+static SpiBusClient clients[MOCK_NUMBER_OF_PINS];
+static MockBus* clientBuses[MOCK_NUMBER_OF_PINS];
+
+static Icm* icm;
+static MockBus* bus;
+
+static struct {
+    uint32_t nextIndex;
+    uint32_t firstIndex;
+    uint32_t numberOfSamples;
+    uint32_t numberOfMissingSamples;
+    uint32_t bufferOverflow;
+    double maxError;
+    bool checkTicks;
+    bool paused;
+} consumer;
+
+//------------------------------------------------------------------------------
+// Functions - timer, profile, and GPIO stand-ins
+
+uint32_t TimerGetTicks32(void) {
+    return (uint32_t) ticks;
+}
+
+uint64_t TimerGetTicks64(void) {
+    if (hung) {
+        ticks += TIMER_TICKS_PER_MICROSECOND; // time passes while the driver waits
+    }
+    return ticks;
+}
+
+void ProfileAdd(const ProfileProbe probe, const uint32_t duration) {
+}
+
+bool GPIO_PinRead(GPIO_PIN pin) {
+    return false; // only falling edges are simulated
+}
+
+void GPIO_PinIntEnable(GPIO_PIN pin, GPIO_INTERRUPT_STYLE style) {
+    pins[pin].enabled = true;
+}
+
+void GPIO_PinIntDisable(GPIO_PIN pin) {
+    pins[pin].enabled = false;
+}
+
+bool GPIO_PinInterruptCallbackRegister(GPIO_PIN pin, const GPIO_PIN_CALLBACK callback, uintptr_t context) {
+    pins[pin].callback = callback;
+    pins[pin].context = context;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Functions - cache stand-in
+
+void CacheWritebackInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+}
+
+void CacheInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+    const volatile IcmSample * const samples = address;
+    for (size_t index = 0; index < (numberOfBytes / sizeof (IcmSample)); index++) {
+        assert(samples[index].registers.tempData == 0); // sample written by the CPU would be discarded
+    }
+}
+
+//------------------------------------------------------------------------------
+// Functions - SPI bus stand-in
+
+static void WriteRegister(const uint8_t address, const uint8_t value) {
+    if (address == ICM_REG_BANK_SEL_ADDRESS) {
+        sensor.bank = value;
+        return;
+    }
+    if (sensor.bank != 0) {
+        return;
+    }
+    switch (address) {
+        case ICM_GYRO_CONFIG0_ADDRESS: {
+            const IcmGyroConfig0Register gyroConfig0Register = {.value = value};
+            const IcmSampleRate sampleRates[] = {IcmSampleRate32kHz, IcmSampleRate16kHz, IcmSampleRate8kHz, IcmSampleRate4kHz, IcmSampleRate2kHz, IcmSampleRate1kHz, IcmSampleRate500Hz, IcmSampleRate200Hz, IcmSampleRate100Hz, IcmSampleRate50Hz, IcmSampleRate25Hz, IcmSampleRate12Hz};
+            for (size_t index = 0; index < (sizeof (sampleRates) / sizeof (sampleRates[0])); index++) {
+                if (IcmSampleRateToOdr(sampleRates[index]) == gyroConfig0Register.gyroOdr) {
+                    sensor.period = (double) TIMER_TICKS_PER_SECOND / (double) sampleRates[index];
+                    sensor.timestampPeriod = 1000000 / sampleRates[index];
+                }
+            }
+            break;
+        }
+        case ICM_FIFO_CONFIG2_ADDRESS:
+            sensor.fifoWatermark = (sensor.fifoWatermark & 0xFF00) | value;
+            break;
+        case ICM_FIFO_CONFIG3_ADDRESS:
+            sensor.fifoWatermark = (sensor.fifoWatermark & 0x00FF) | ((uint32_t) value << 8);
+            break;
+        case ICM_SIGNAL_PATH_RESET_ADDRESS: {
+            const IcmSignalPathResetRegister signalPathResetRegister = {.value = value};
+            if (signalPathResetRegister.fifoFlush == 1) {
+                sensor.numberOfFlushedPackets += sensor.fifoCount;
+                sensor.fifoCount = 0;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static SpiBusClient * const AddClient(MockBus * const bus_, const GPIO_PIN csPin) {
+    assert(clientBuses[csPin] == NULL);
+    clientBuses[csPin] = bus_;
+    clients[csPin].csPin = csPin;
+    return &clients[csPin];
+}
+
+static SpiBusClient * const AddClient2(const GPIO_PIN csPin) {
+    return AddClient(&buses[0], csPin);
+}
+
+static SpiBusClient * const AddClient3(const GPIO_PIN csPin) {
+    return AddClient(&buses[1], csPin);
+}
+
+static SpiBusClient * const AddClient4(const GPIO_PIN csPin) {
+    return AddClient(&buses[2], csPin);
+}
+
+static SpiBusClient * const AddClient5(const GPIO_PIN csPin) {
+    return AddClient(&buses[3], csPin);
+}
+
+static SpiBusClient * const AddClient6(const GPIO_PIN csPin) {
+    return AddClient(&buses[4], csPin);
+}
+
+static void Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context) {
+    assert(client->inProgress == false);
+    assert(client->csPin == icm->csPin);
+    assert(clientBuses[client->csPin] == bus);
+    volatile uint8_t * const bytes = data;
+    if (hung) {
+        client->inProgress = true; // transfer never completes
+        return;
+    }
+    if (transferComplete == NULL) { // register transfers complete immediately
+        if (bytes[0] == (0x80 | ICM_WHO_AM_I_ADDRESS)) {
+            bytes[1] = ICM_WHO_AM_I_RESET_VALUE;
+        } else if ((bytes[0] & 0x80) == 0) {
+            WriteRegister(bytes[0], bytes[1]);
+        }
+        return;
+    }
+    assert(bus->client == NULL);
+    client->data = data;
+    client->numberOfBytes = numberOfBytes;
+    client->transferComplete = transferComplete;
+    client->context = context;
+    client->inProgress = true;
+    bus->client = client;
+    bus->started = false;
+    bus->queuedTicks = ticks;
+}
+
+static bool TransferInProgress(const SpiBusClient * const client) {
+    if (client == NULL) {
+        return false;
+    }
+    return client->inProgress;
+}
+
+const SpiBus spiBus2 = {.addClient = AddClient2, .transfer = Transfer, .transferInProgress = TransferInProgress};
+const SpiBus spiBus3 = {.addClient = AddClient3, .transfer = Transfer, .transferInProgress = TransferInProgress};
+const SpiBus spiBus4 = {.addClient = AddClient4, .transfer = Transfer, .transferInProgress = TransferInProgress};
+const SpiBus spiBus5 = {.addClient = AddClient5, .transfer = Transfer, .transferInProgress = TransferInProgress};
+const SpiBus spiBus6 = {.addClient = AddClient6, .transfer = Transfer, .transferInProgress = TransferInProgress};
+
+//------------------------------------------------------------------------------
+// Functions - simulation
+
+static void WriteSample(const uint32_t index, int16_t * const x, int16_t * const y) {
+    *x = (int16_t) (index & 0x7FFF);
+    *y = (int16_t) ((index >> 15) & 0x7FFF);
+}
+
+static void BeginTransfer(void) {
+    volatile uint8_t * const bytes = bus->client->data;
+    if (bytes[0] == (0x80 | ICM_FIFO_COUNTH_ADDRESS)) {
+        volatile IcmSpiFifoPacket * const packet = bus->client->data;
+        packet->fifoCount = (uint16_t) sensor.fifoCount;
+        const size_t numberOfPackets = (bus->client->numberOfBytes - offsetof(IcmSpiFifoPacket, fifoData)) / sizeof (IcmFifoDataPacket);
+        for (size_t index = 0; index < numberOfPackets; index++) {
+            volatile IcmFifoDataPacket * const fifoData = &packet->fifoData[index];
+            fifoData->header.value = 0;
+            if (sensor.fifoCount == 0) {
+                fifoData->header.headerMsg = 1;
+                continue;
+            }
+            const uint32_t sampleIndex = sensor.fifo[sensor.fifoIndex];
+            const uint16_t timestamp = sensor.fifoTimestamps[sensor.fifoIndex];
+            sensor.fifoIndex = (sensor.fifoIndex + 1) % ICM_FIFO_CAPACITY;
+            sensor.fifoCount--;
+            int16_t x, y;
+            WriteSample(sampleIndex, &x, &y);
+            fifoData->accelDataX = x;
+            fifoData->accelDataY = y;
+            fifoData->tempData = 1;
+            fifoData->timestamp = timestamp;
+        }
+    } else {
+        assert(bytes[0] == (0x80 | ICM_TEMP_DATA1_ADDRESS));
+        volatile IcmSensorRegisters * const registers = (volatile IcmSensorRegisters *) &bytes[1];
+        int16_t x, y;
+        WriteSample(sensor.numberOfSamples - 1, &x, &y);
+        registers->accelDataX = x;
+        registers->accelDataY = y;
+        registers->tempData = 0;
+    }
+    bus->started = true;
+    bus->completeTicks = ticks + (uint64_t) llround(((double) bus->client->numberOfBytes * 8.0 * TIMER_TICKS_PER_SECOND) / (double) icmSpiSettings.clockFrequency);
+}
+
+static void CompleteTransfer(void) {
+    SpiBusClient * const client = bus->client;
+    bus->client = NULL;
+    client->inProgress = false;
+    client->transferComplete(client->context);
+}
+
+static void Sample(void) {
+    const uint32_t index = sensor.numberOfSamples++;
+    assert(index < MAX_NUMBER_OF_SAMPLES);
+    sampleTicks[index] = ticks;
+    sensor.timestamp += sensor.timestampPeriod;
+    if (sensor.fifoWatermark > 0) {
+        if (sensor.fifoCount == ICM_FIFO_CAPACITY) {
+            sensor.fifoIndex = (sensor.fifoIndex + 1) % ICM_FIFO_CAPACITY;
+            sensor.fifoCount--;
+            sensor.numberOfLostPackets++;
+        }
+        sensor.fifo[(sensor.fifoIndex + sensor.fifoCount) % ICM_FIFO_CAPACITY] = index;
+        sensor.fifoTimestamps[(sensor.fifoIndex + sensor.fifoCount) % ICM_FIFO_CAPACITY] = (uint16_t) sensor.timestamp;
+        sensor.fifoCount++;
+        if (sensor.fifoCount < sensor.fifoWatermark) {
+            return;
+        }
+    }
+    const GPIO_PIN pin = icm->intPin;
+    if (pins[pin].enabled) {
+        ticks += rand() % MAX_INTERRUPT_LATENCY;
+        pins[pin].callback(pin, pins[pin].context);
+        ticks = sampleTicks[index];
+    }
+}
+
+static void Consume(void) {
+    if (consumer.paused) {
+        return;
+    }
+    while (true) {
+        IcmDataBatch batch;
+        const size_t numberOfSamples = IcmGetDataBatch(icm, &batch, ICM_MAX_BATCH_SIZE);
+        if (numberOfSamples == 0) {
+            break;
+        }
+        for (size_t sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++) {
+            const uint32_t index = (uint32_t) lrintf(batch.accelerometerX[sampleIndex] * -2048.0f) | ((uint32_t) lrintf(batch.accelerometerY[sampleIndex] * -2048.0f) << 15);
+            assert(index >= consumer.nextIndex);
+            assert(index >= consumer.firstIndex);
+            consumer.numberOfMissingSamples += index - consumer.nextIndex;
+            consumer.nextIndex = index + 1;
+            consumer.numberOfSamples++;
+            if (consumer.checkTicks) {
+                const double error = fabs((double) batch.ticks[sampleIndex] - (double) sampleTicks[index]);
+                consumer.maxError = fmax(consumer.maxError, error);
+            }
+        }
+    }
+    consumer.bufferOverflow += IcmBufferOverflow(icm);
+}
+
+static void Run(const double duration) {
+    const uint64_t endTicks = ticks + (uint64_t) llround(duration * TIMER_TICKS_PER_SECOND);
+    while (true) {
+        uint64_t nextTicks = sensor.running ? (uint64_t) ceil(sensor.nextSampleTicks) : UINT64_MAX;
+        if (bus->client != NULL) {
+            const uint64_t busTicks = bus->started ? bus->completeTicks : (bus->queuedTicks > bus->stallTicks ? bus->queuedTicks : bus->stallTicks);
+            if (busTicks <= nextTicks) {
+                nextTicks = busTicks;
+            }
+        }
+        if (nextTicks > endTicks) {
+            ticks = endTicks;
+            break;
+        }
+        ticks = nextTicks;
+        if ((bus->client != NULL) && bus->started && (ticks >= bus->completeTicks)) {
+            CompleteTransfer();
+        } else if ((bus->client != NULL) && (bus->started == false) && (ticks >= bus->queuedTicks) && (ticks >= bus->stallTicks)) {
+            BeginTransfer();
+        } else {
+            Sample();
+            sensor.nextSampleTicks += sensor.period;
+        }
+        if ((ticks % (TIMER_TICKS_PER_SECOND / 1000)) < (uint64_t) NOMINAL_PERIOD) {
+            Consume();
+        }
+    }
+    Consume();
+}
+
+static void Stall(const double duration, const double settle) {
+    bus->stallTicks = ticks + (uint64_t) llround(duration * TIMER_TICKS_PER_SECOND);
+    Run(duration + settle);
+}
+
+static void Initialise(const uint32_t fifoWatermark, const bool sensorTimestampEnabled, const double drift) {
+    IcmDeinitialise(icm);
+    const IcmSettings settings = {
+        .gyroscopeAntiAliasing = IcmAntiAliasingDisabled,
+        .accelerometerAntiAliasing = IcmAntiAliasingDisabled,
+        .sampleRate = SAMPLE_RATE,
+        .fifoWatermark = fifoWatermark,
+        .sensorTimestampEnabled = sensorTimestampEnabled,
+    };
+    IcmInitialise(icm, &settings);
+    while (IcmInitialisationComplete(icm) == false) {
+        IcmTasks(icm);
+        ticks += TIMER_TICKS_PER_MILLISECOND;
+    }
+    sensor = (typeof (sensor)){
+        .running = true,
+        .fifoWatermark = fifoWatermark,
+        .period = NOMINAL_PERIOD * (1.0 + drift),
+        .timestampPeriod = SENSOR_TIMESTAMP_PERIOD,
+        .timestamp = 12345,
+        .nextSampleTicks = (double) ticks + 1000.0,
+    };
+    bus->stallTicks = 0;
+    consumer = (typeof (consumer)){.checkTicks = true};
+}
+
+static void Select(Icm * const icm_) {
+    if (icm != NULL) {
+        sensor.running = false;
+        Run(0.01);
+        IcmDeinitialise(icm);
+    }
+    icm = icm_;
+    bus = NULL;
+    for (size_t index = 0; index < (sizeof (buses) / sizeof (buses[0])); index++) {
+        if (buses[index].spiBus == icm->spiBus) {
+            bus = &buses[index];
+        }
+    }
+    assert(bus != NULL);
+}
+
+static void Reconfigure(const IcmSampleRate sampleRate, const uint32_t fifoWatermark, const bool sensorTimestampEnabled) {
+    consumer.paused = true;
+    Run(0.001);
+    while (bus->client != NULL) {
+        Run(1.0 / TIMER_TICKS_PER_SECOND);
+    }
+    const IcmSettings settings = {
+        .gyroscopeAntiAliasing = IcmAntiAliasingDisabled,
+        .accelerometerAntiAliasing = IcmAntiAliasingDisabled,
+        .sampleRate = sampleRate,
+        .fifoWatermark = fifoWatermark,
+        .sensorTimestampEnabled = sensorTimestampEnabled,
+    };
+    consumer.firstIndex = sensor.numberOfSamples;
+    IcmInitialise(icm, &settings);
+    while (IcmInitialisationComplete(icm) == false) {
+        IcmTasks(icm);
+        Run(1.0 / TIMER_TICKS_PER_SECOND);
+    }
+    consumer.paused = false;
+}
+
+static void Print(const char* const name) {
+    printf("ICM %d, %s: %u samples, %u missing, %u counted as overflow, %u lost by FIFO, max error %.2f periods\n", (int) (icm - icms) + 1, name, sensor.numberOfSamples, consumer.numberOfMissingSamples, consumer.bufferOverflow, sensor.numberOfLostPackets, consumer.maxError / NOMINAL_PERIOD);
+}
+
+static void CheckDrained(void) {
+    sensor.running = false;
+    bus->stallTicks = 0;
+    Run(0.01);
+    assert(bus->client == NULL);
+    assert((sensor.fifoCount == 0) || (sensor.fifoCount < sensor.fifoWatermark));
+    assert(consumer.numberOfSamples + consumer.numberOfMissingSamples + sensor.fifoCount == sensor.numberOfSamples);
+}
+
+//------------------------------------------------------------------------------
+// Functions - tests
+
+/**
+ * @brief No stalls. Every sample is received with the interrupt ticks.
+ */
+static void TestNominal(void) {
+    Initialise(4, false, 0.0);
+    Run(1.0);
+    CheckDrained();
+    Print("nominal");
+    assert(consumer.numberOfMissingSamples == 0);
+    assert(consumer.bufferOverflow == 0);
+    assert(consumer.maxError <= MAX_INTERRUPT_LATENCY);
+}
+
+/**
+ * @brief Bus stalls shorter than the FIFO capacity, each followed by a settling
+ * period. Interrupts during each
+ * stall are not lost, the backlog is drained, and the newest packet remains
+ * anchored to the interrupt ticks.
+ */
+static void TestBacklog(const uint32_t fifoWatermark, const double drift) {
+    Initialise(fifoWatermark, false, drift);
+    for (int stall = 0; stall < 200; stall++) {
+        Stall((double) (rand() % (ICM_FIFO_CAPACITY - fifoWatermark - 1)) / SAMPLE_RATE, 0.005 + (0.001 * (rand() % 10)));
+    }
+    CheckDrained();
+    char name[64];
+    snprintf(name, sizeof (name), "backlog, watermark %u, drift %+.0f%%", fifoWatermark, drift * 100.0);
+    Print(name);
+    assert(sensor.numberOfLostPackets == 0);
+    assert(consumer.numberOfMissingSamples == 0);
+    assert(consumer.bufferOverflow == 0);
+    assert(consumer.maxError <= (NOMINAL_PERIOD * (1.0 + (fabs(drift) * ICM_FIFO_CAPACITY))));
+}
+
+/**
+ * @brief Bus stalls longer than the FIFO capacity. Packets discarded by the
+ * FIFO are counted as buffer overflow.
+ */
+static void TestFifoOverflow(void) {
+    Initialise(8, false, 0.0);
+    Run(0.02);
+    for (int stall = 0; stall < 50; stall++) {
+        Stall((double) (ICM_FIFO_CAPACITY + 1 + (rand() % 200)) / SAMPLE_RATE, 0.02);
+    }
+    CheckDrained();
+    Print("FIFO overflow");
+    assert(sensor.numberOfLostPackets > 0);
+    assert(consumer.numberOfMissingSamples == sensor.numberOfLostPackets);
+    assert(consumer.bufferOverflow == sensor.numberOfLostPackets);
+}
+
+/**
+ * @brief Sensor timestamps with a drifting sensor clock and bus stalls. The
+ * estimate is anchored to the newest packet in the FIFO.
+ */
+static void TestSensorTimestamp(const double drift) {
+    Initialise(4, true, drift);
+    Run(2.0); // allow estimate to converge
+    consumer.maxError = 0.0;
+    for (int stall = 0; stall < 200; stall++) {
+        Stall((double) (rand() % (ICM_FIFO_CAPACITY - 8)) / SAMPLE_RATE, 0.005 + (0.001 * (rand() % 10)));
+    }
+    CheckDrained();
+    char name[64];
+    snprintf(name, sizeof (name), "sensor timestamp, drift %+.1f%%", drift * 100.0);
+    Print(name);
+    assert(consumer.numberOfMissingSamples == 0);
+    assert(consumer.bufferOverflow == 0);
+    assert(consumer.maxError <= (0.5 * NOMINAL_PERIOD));
+}
+
+/**
+ * @brief Sample rate, watermark, and sensor timestamp changes while running.
+ * The ICM is not reset. Samples buffered before each change, including
+ * samples written by the CPU in FIFO mode before changing to data-ready mode,
+ * are discarded and the FIFO is flushed so that each sample read after the
+ * change was acquired after the change and has the ticks of the new sample
+ * rate.
+ */
+static void TestModeSwitch(void) {
+    Initialise(4, false, 0.0);
+    Run(0.1);
+    Reconfigure(IcmSampleRate1kHz, 8, false);
+    Run(0.1);
+    Reconfigure(IcmSampleRate1kHz, 0, false);
+    Run(0.1);
+    Reconfigure(IcmSampleRate8kHz, 4, false);
+    Run(0.1);
+    Reconfigure(IcmSampleRate2kHz, 16, true);
+    Run(0.1);
+    Reconfigure(IcmSampleRate8kHz, 4, false);
+    Run(0.1);
+    CheckDrained();
+    Print("mode switch");
+    printf("ICM %d, mode switch: %u packets flushed\n", (int) (icm - icms) + 1, sensor.numberOfFlushedPackets);
+    assert(sensor.numberOfFlushedPackets > 0);
+    assert(consumer.bufferOverflow == 0);
+    assert(consumer.maxError <= MAX_INTERRUPT_LATENCY);
+}
+
+/**
+ * @brief Data ready interrupts while a transfer is in progress are counted as
+ * buffer overflow.
+ */
+static void TestDataReady(void) {
+    Initialise(0, false, 0.0);
+    consumer.checkTicks = false; // registers are read when the transfer begins
+    for (int stall = 0; stall < 200; stall++) {
+        Stall((double) (rand() % 20) / SAMPLE_RATE, 0.005);
+    }
+    Run(0.01);
+    Print("data ready");
+    assert(consumer.bufferOverflow > 0);
+    assert(consumer.numberOfMissingSamples == consumer.bufferOverflow);
+}
+
+/**
+ * @brief A transfer that never completes. The initialisation fails within the
+ * timeout and the self-test fails. Deinitialisation does not wait
+ * indefinitely.
+ */
+static void TestTimeout(void) {
+    sensor.running = false;
+    Run(0.01);
+    IcmDeinitialise(icm);
+    hung = true;
+    const uint64_t startTicks = ticks;
+    const IcmSettings settings = {
+        .gyroscopeAntiAliasing = IcmAntiAliasingDisabled,
+        .accelerometerAntiAliasing = IcmAntiAliasingDisabled,
+        .sampleRate = SAMPLE_RATE,
+    };
+    IcmInitialise(icm, &settings);
+    while (IcmInitialisationComplete(icm) == false) {
+        IcmTasks(icm);
+        ticks += TIMER_TICKS_PER_MICROSECOND;
+        assert((ticks - startTicks) < TIMER_TICKS_PER_SECOND);
+    }
+    const double duration = (double) (ticks - startTicks) / TIMER_TICKS_PER_SECOND;
+    const IcmTestResult result = IcmTest(icm);
+    IcmDeinitialise(icm);
+    hung = false;
+    clients[icm->csPin].inProgress = false;
+    printf("ICM %d, timeout: failed after %.3f s, self-test %s\n", (int) (icm - icms) + 1, duration, IcmTestResultToString(result));
+    assert(duration < 1.0);
+    assert(result != IcmTestResultPassed);
+}
+
+/**
+ * @brief Each ICM has its own pins, SPI packets, and ring.
+ */
+static void TestInstances(void) {
+    for (int a = 0; a < ICM_NUMBER_OF_ICMS; a++) {
+        for (int b = a + 1; b < ICM_NUMBER_OF_ICMS; b++) {
+            assert(icms[a].csPin != icms[b].csPin);
+            assert(icms[a].intPin != icms[b].intPin);
+            assert(icms[a].spiPacket != icms[b].spiPacket);
+            assert(icms[a].spiFifoPacket != icms[b].spiFifoPacket);
+            assert(icms[a].ring.slots != icms[b].ring.slots);
+        }
+    }
+    printf("instances: %d ICMs with separate pins, SPI packets, and rings: ok\n", ICM_NUMBER_OF_ICMS);
+}
+
+static double Seconds(void) {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (double) timespec.tv_sec + ((double) timespec.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief Fills the ring with random samples.
+ */
+static void Fill(void) {
+    IcmSample* sample;
+    while ((sample = RingWriteSlot(&icm->ring)) != NULL) {
+        sample->ticks = ticks++;
+        sample->registers.tempData = (int16_t) rand();
+        sample->registers.accelDataX = (int16_t) rand();
+        sample->registers.accelDataY = (int16_t) rand();
+        sample->registers.accelDataZ = (int16_t) rand();
+        sample->registers.gyroDataX = (int16_t) rand();
+        sample->registers.gyroDataY = (int16_t) rand();
+        sample->registers.gyroDataZ = (int16_t) rand();
+        RingWriteComplete(&icm->ring);
+    }
+}
+
+/**
+ * @brief Full rings of samples are read one at a time with IcmGetData, and in
+ * batches with IcmGetDataBatch. The batches are equal to the data. The read
+ * index of the ring advances by a sample each repetition so that batches wrap
+ * around the end of the ring at every position.
+ */
+static void BenchmarkBatch(void) {
+    static IcmData data[ICM_NUMBER_OF_SAMPLES];
+    static IcmDataBatch batches[ICM_NUMBER_OF_SAMPLES / ICM_MAX_BATCH_SIZE];
+    Initialise(4, false, 0.0);
+    sensor.running = false;
+    Run(0.01);
+    double durations[2] = {0};
+    for (int repetition = 0; repetition < NUMBER_OF_REPETITIONS; repetition++) {
+        const uint64_t firstTicks = ticks;
+        srand((unsigned int) repetition);
+        Fill();
+        double start = Seconds();
+        size_t numberOfSamples = 0;
+        while (IcmGetData(icm, &data[numberOfSamples]) == IcmResultOk) {
+            numberOfSamples++;
+        }
+        durations[0] += Seconds() - start;
+        assert(numberOfSamples == ICM_NUMBER_OF_SAMPLES);
+        ticks = firstTicks;
+        srand((unsigned int) repetition);
+        Fill();
+        start = Seconds();
+        size_t numberOfBatches = 0;
+        while (IcmGetDataBatch(icm, &batches[numberOfBatches], ICM_MAX_BATCH_SIZE) == ICM_MAX_BATCH_SIZE) {
+            numberOfBatches++;
+        }
+        durations[1] += Seconds() - start;
+        assert(numberOfBatches == (ICM_NUMBER_OF_SAMPLES / ICM_MAX_BATCH_SIZE));
+        for (size_t index = 0; index < ICM_NUMBER_OF_SAMPLES; index++) {
+            const IcmDataBatch * const batch = &batches[index / ICM_MAX_BATCH_SIZE];
+            const size_t sampleIndex = index % ICM_MAX_BATCH_SIZE;
+            assert(batch->ticks[sampleIndex] == data[index].ticks);
+            assert(batch->gyroscopeX[sampleIndex] == data[index].gyroscopeX);
+            assert(batch->gyroscopeY[sampleIndex] == data[index].gyroscopeY);
+            assert(batch->gyroscopeZ[sampleIndex] == data[index].gyroscopeZ);
+            assert(batch->accelerometerX[sampleIndex] == data[index].accelerometerX);
+            assert(batch->accelerometerY[sampleIndex] == data[index].accelerometerY);
+            assert(batch->accelerometerZ[sampleIndex] == data[index].accelerometerZ);
+            assert(batch->temperature[sampleIndex] == data[index].temperature);
+        }
+        RingWriteSlot(&icm->ring); // advance read index by one sample
+        RingWriteComplete(&icm->ring);
+        IcmGetData(icm, &data[0]);
+    }
+    const double numberOfSamples = (double) NUMBER_OF_REPETITIONS * ICM_NUMBER_OF_SAMPLES;
+    printf("batch: %.0f samples, IcmGetData %.1f samples/us, IcmGetDataBatch %.1f samples/us, ratio %.2f\n", numberOfSamples, numberOfSamples * 1e-6 / durations[0], numberOfSamples * 1e-6 / durations[1], durations[0] / durations[1]);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestInstances();
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        Select(&icms[index]);
+        TestNominal();
+        TestBacklog(1, 0.0);
+        TestBacklog(4, 0.0);
+        TestBacklog(16, 0.0);
+        TestBacklog(4, 0.01);
+        TestBacklog(4, -0.01);
+        TestFifoOverflow();
+        TestSensorTimestamp(0.02);
+        TestSensorTimestamp(-0.02);
+        TestModeSwitch();
+        TestDataReady();
+        TestTimeout();
+    }
+    BenchmarkBatch();
+    printf("Icm: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
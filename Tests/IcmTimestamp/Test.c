@@ -0,0 +1,167 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the ICM timestamp estimator. A synthetic sensor clock
+ * drifts relative to the timer and each update is given the timer ticks of an
+ * interrupt with random latency.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Imu/Icm/IcmTimestamp.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define SAMPLE_PERIOD (125) // microseconds
+#define TICKS_PER_MICROSECOND ((double) TIMER_TICKS_PER_MICROSECOND)
+
+/**
+ * @brief Synthetic sensor.
+ */
+typedef struct {
+    double drift;
+    double offset;
+    uint32_t sensorTime;
+} Sensor;
+
+//------------------------------------------------------------------------------
+// Functions
+
+uint32_t TimerGetTicks32(void) {
+    return 0;
+}
+
+uint64_t TimerGetTicks64(void) {
+    return 0;
+}
+
+static double TrueTicks(const Sensor * const sensor, const uint64_t sensorTime) {
+    return sensor->offset + ((double) sensorTime * TICKS_PER_MICROSECOND * (1.0 + sensor->drift));
+}
+
+static double Latency(const double maxLatency) {
+    return maxLatency * ((double) rand() / (double) RAND_MAX);
+}
+
+/**
+ * @brief Runs the estimator for a number of samples and returns the maximum
+ * absolute error in timer ticks of the mapped timestamps of the last half of
+ * the samples. The estimate converges to the mean interrupt latency and so the
+ * error is relative to the true ticks plus the mean latency.
+ */
+static double Run(IcmTimestamp * const timestamp, Sensor * const sensor, const int numberOfSamples, const double maxLatency) {
+    double maxError = 0.0;
+    for (int index = 0; index < numberOfSamples; index++) {
+        sensor->sensorTime += SAMPLE_PERIOD;
+        const uint64_t sensorTime = IcmTimestampUnwrap(timestamp, (uint16_t) sensor->sensorTime);
+        const double trueTicks = TrueTicks(sensor, sensorTime);
+        IcmTimestampUpdate(timestamp, sensorTime, (uint64_t) (trueTicks + Latency(maxLatency)));
+        if (index >= (numberOfSamples / 2)) {
+            maxError = fmax(maxError, fabs((double) IcmTimestampToTicks(timestamp, sensorTime) - (trueTicks + (maxLatency / 2.0))));
+        }
+    }
+    return maxError;
+}
+
+static void Initialise(IcmTimestamp * const timestamp, Sensor * const sensor, const double drift) {
+    IcmTimestampInitialise(timestamp, 1);
+    *sensor = (Sensor){.drift = drift, .offset = 1e9, .sensorTime = 60000}; // 16-bit timestamp wraps soon after start
+}
+
+/**
+ * @brief Sensor time unwraps across 16-bit overflow.
+ */
+static void TestUnwrap(void) {
+    IcmTimestamp timestamp;
+    IcmTimestampInitialise(&timestamp, 1);
+    assert(IcmTimestampUnwrap(&timestamp, 65000) == 65000);
+    assert(IcmTimestampUnwrap(&timestamp, 65500) == 65500);
+    assert(IcmTimestampUnwrap(&timestamp, 464) == 66000);
+    assert(IcmTimestampUnwrap(&timestamp, 964) == 66500);
+    printf("unwrap: ok\n");
+}
+
+/**
+ * @brief Drifting sensor clock with interrupt latency. The jitter of the mapped
+ * timestamps is a fraction of the interrupt latency jitter.
+ */
+static void TestDrift(const double drift) {
+    IcmTimestamp timestamp;
+    Sensor sensor;
+    Initialise(&timestamp, &sensor, drift);
+    const double maxLatency = 10.0 * TICKS_PER_MICROSECOND;
+    const double maxError = Run(&timestamp, &sensor, 200000, maxLatency);
+    const double periodError = (timestamp.period / (TICKS_PER_MICROSECOND * (1.0 + drift))) - 1.0;
+    printf("drift %+.1f%%: max error %.2f us, period error %.1f ppm\n", drift * 100.0, maxError / TICKS_PER_MICROSECOND, periodError * 1e6);
+    assert(maxError < (maxLatency * 0.35)); // error of interrupt ticks is up to half of max latency
+    assert(fabs(periodError) < 1000e-6);
+}
+
+/**
+ * @brief Sensor clock drift beyond the maximum period error. The period is
+ * clamped and the offset gain follows the resulting error.
+ */
+static void TestClamp(void) {
+    IcmTimestamp timestamp;
+    Sensor sensor;
+    Initialise(&timestamp, &sensor, 0.08);
+    const double maxError = Run(&timestamp, &sensor, 20000, 0.0);
+    printf("drift +8.0%%: period clamped to %+.1f%%, max error %.2f us\n", ((timestamp.period / TICKS_PER_MICROSECOND) - 1.0) * 100.0, maxError / TICKS_PER_MICROSECOND);
+    assert(fabs((timestamp.period / TICKS_PER_MICROSECOND) - 1.05) < 1e-9);
+    const double expectedError = (0.08 - 0.05) * SAMPLE_PERIOD * TICKS_PER_MICROSECOND / 0.05; // steady-state lag of offset loop
+    assert(maxError < (expectedError * 1.1));
+}
+
+/**
+ * @brief A step in the timer ticks greater than 10 ms resets the estimate.
+ * A smaller step is tracked by the offset gain.
+ */
+static void TestReset(void) {
+    IcmTimestamp timestamp;
+    Sensor sensor;
+    Initialise(&timestamp, &sensor, 0.01);
+    Run(&timestamp, &sensor, 20000, 0.0);
+
+    // Step greater than threshold
+    sensor.offset += 0.011 * TIMER_TICKS_PER_SECOND;
+    sensor.sensorTime += SAMPLE_PERIOD;
+    uint64_t sensorTime = IcmTimestampUnwrap(&timestamp, (uint16_t) sensor.sensorTime);
+    IcmTimestampUpdate(&timestamp, sensorTime, (uint64_t) TrueTicks(&sensor, sensorTime));
+    assert(fabs((double) IcmTimestampToTicks(&timestamp, sensorTime) - TrueTicks(&sensor, sensorTime)) < 1.0);
+    assert(timestamp.period == timestamp.nominalPeriod);
+
+    // Step less than threshold
+    sensor.offset += 0.009 * TIMER_TICKS_PER_SECOND;
+    sensor.sensorTime += SAMPLE_PERIOD;
+    sensorTime = IcmTimestampUnwrap(&timestamp, (uint16_t) sensor.sensorTime);
+    IcmTimestampUpdate(&timestamp, sensorTime, (uint64_t) TrueTicks(&sensor, sensorTime));
+    assert(fabs((double) IcmTimestampToTicks(&timestamp, sensorTime) - TrueTicks(&sensor, sensorTime)) > (0.008 * TIMER_TICKS_PER_SECOND));
+    const double maxError = Run(&timestamp, &sensor, 20000, 0.0);
+    printf("reset: 11 ms step reset, 9 ms step tracked to within %.2f us: ok\n", maxError / TICKS_PER_MICROSECOND);
+    assert(maxError < TICKS_PER_MICROSECOND);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestUnwrap();
+    TestDrift(0.0);
+    TestDrift(0.01);
+    TestDrift(-0.01);
+    TestDrift(0.04);
+    TestDrift(-0.04);
+    TestClamp();
+    TestReset();
+    printf("IcmTimestamp: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
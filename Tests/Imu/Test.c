@@ -0,0 +1,516 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the IMU processing. Samples are replayed through
+ * ImuBatchTasks by a stand-in for IcmGetDataBatch, and the AHRS, inertial and
+ * frame outputs are captured by stand-ins for Send and Frame. Durations depend
+ * on the host and are not asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Frame/Frame.h"
+#include "Imu/Imu.h"
+#include "Kinematics/Kinematics.h"
+#include <math.h>
+#include "Profile/Profile.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define CONING_SAMPLE_RATE (2000)
+#define CONING_DURATION (60)
+#define CONING_HALF_ANGLE (30.0)
+#define CONING_FREQUENCY (4.0)
+#define CONING_DIVISOR (20)
+#define NUMBER_OF_SAMPLES (CONING_SAMPLE_RATE * CONING_DURATION)
+#define TICKS_PER_SAMPLE (TIMER_TICKS_PER_SECOND / CONING_SAMPLE_RATE)
+#define NUMBER_OF_CALIBRATION_SAMPLES (1000)
+#define CALIBRATION_TOLERANCE (1e-5f) // relative to the vector magnitude
+#define NUMBER_OF_CALIBRATION_REPETITIONS (10000)
+#define NUMBER_OF_THROUGHPUT_SAMPLES (20000)
+
+/**
+ * @brief Sample and true orientation.
+ */
+typedef struct {
+    uint64_t ticks;
+    FusionVector gyroscope;
+    FusionVector accelerometer;
+    FusionQuaternion truth;
+} Sample;
+
+/**
+ * @brief Samples replayed to an ICM.
+ */
+typedef struct {
+    const Sample* samples;
+    size_t numberOfSamples;
+    size_t index;
+} Replay;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static float Error(const FusionQuaternion quaternion, const uint64_t ticks);
+
+//------------------------------------------------------------------------------
+// Variables
+
+Icm icms[ICM_NUMBER_OF_ICMS];
+Send sendA, sendB, sendC, sendD, sendE, sendF, sendG, sendH, sendI, sendJ, sendK, sendL, sendM, sendN, sendO, sendP, sendQ, sendR, sendS, sendT;
+Kinematics kinematics;
+Frame frame;
+
+static Sample samples[NUMBER_OF_SAMPLES];
+static Replay replays[ICM_NUMBER_OF_ICMS];
+static SendInertialData inertialData[NUMBER_OF_CALIBRATION_SAMPLES];
+static bool compareWithTruth;
+static float maxAhrsError;
+static float maxFrameError;
+static int numberOfAhrsMessages;
+
+//------------------------------------------------------------------------------
+// Functions - Stand-ins
+
+size_t IcmGetDataBatch(Icm * const icm, IcmDataBatch * const batch, size_t numberOfSamples) {
+    Replay * const replay = &replays[icm - icms];
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        if (replay->index >= replay->numberOfSamples) {
+            return index;
+        }
+        const Sample * const sample = &replay->samples[replay->index++];
+        batch->ticks[index] = sample->ticks;
+        batch->gyroscopeX[index] = sample->gyroscope.axis.x;
+        batch->gyroscopeY[index] = sample->gyroscope.axis.y;
+        batch->gyroscopeZ[index] = sample->gyroscope.axis.z;
+        batch->accelerometerX[index] = sample->accelerometer.axis.x;
+        batch->accelerometerY[index] = sample->accelerometer.axis.y;
+        batch->accelerometerZ[index] = sample->accelerometer.axis.z;
+        batch->temperature[index] = 25.0f;
+    }
+    return numberOfSamples;
+}
+
+bool SendAvailable(Send * const send, const size_t numberOfBytes) {
+    return true;
+}
+
+void SendInertial(Send * const send, const SendInertialData * const inertialData_) {
+    const size_t index = (size_t) (inertialData_->ticks / TICKS_PER_SAMPLE) - 1;
+    if (index < NUMBER_OF_CALIBRATION_SAMPLES) {
+        inertialData[index] = *inertialData_;
+    }
+}
+
+void SendTemperature(Send * const send, const SendTemperatureData * const temperatureData) {
+}
+
+void SendAhrs(Send * const send, const SendAhrsData * const ahrsData) {
+    if (compareWithTruth == false) {
+        return;
+    }
+    const float error = Error(FusionAhrsGetQuaternion(ahrsData->ahrs), ahrsData->ticks);
+    maxAhrsError = error > maxAhrsError ? error : maxAhrsError;
+    numberOfAhrsMessages++;
+}
+
+void KinematicsUpdate(Kinematics * const kinematics_, const uint64_t ticks, const uint32_t numberOfUpdates, const FusionQuaternion * const quaternions) {
+}
+
+void FrameSetSensor(Frame * const frame_, const int index, const uint64_t ticks, const float sampleRate, const SendFrameSensor * const sensor) {
+    if (compareWithTruth == false) {
+        return;
+    }
+    const float error = Error(sensor->quaternion, ticks);
+    maxFrameError = error > maxFrameError ? error : maxFrameError;
+}
+
+void FrameUpdate(Frame * const frame_) {
+}
+
+//------------------------------------------------------------------------------
+// Functions - Test
+
+static float Random(const float min, const float max) {
+    return min + ((max - min) * ((float) rand() / (float) RAND_MAX));
+}
+
+static double Seconds(void) {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (double) timespec.tv_sec + ((double) timespec.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief Returns the quaternion product in double precision.
+ */
+static void Product(const double a[4], const double b[4], double result[4]) {
+    result[0] = (a[0] * b[0]) - (a[1] * b[1]) - (a[2] * b[2]) - (a[3] * b[3]);
+    result[1] = (a[0] * b[1]) + (a[1] * b[0]) + (a[2] * b[3]) - (a[3] * b[2]);
+    result[2] = (a[0] * b[2]) - (a[1] * b[3]) + (a[2] * b[0]) + (a[3] * b[1]);
+    result[3] = (a[0] * b[3]) + (a[1] * b[2]) - (a[2] * b[1]) + (a[3] * b[0]);
+}
+
+/**
+ * @brief Returns the orientation of coning motion. The sensor Z axis is tilted
+ * by the half angle around an axis that rotates about the earth Z axis at the
+ * coning frequency.
+ */
+static void Coning(const double time, double quaternion[4]) {
+    const double halfTilt = 0.5 * CONING_HALF_ANGLE * (M_PI / 180.0);
+    const double phase = 2.0 * M_PI * CONING_FREQUENCY * time;
+    quaternion[0] = cos(halfTilt);
+    quaternion[1] = sin(halfTilt) * cos(phase);
+    quaternion[2] = sin(halfTilt) * sin(phase);
+    quaternion[3] = 0.0;
+}
+
+/**
+ * @brief Generates coning samples. The gyroscope of each sample is the constant
+ * angular rate that rotates the previous orientation to that of the sample.
+ * The accelerometer is gravity in the sensor axes. The true orientation is
+ * relative to that of the first sample because the AHRS starts at identity on
+ * the first sample.
+ */
+static void GenerateConing(void) {
+    double first[4];
+    Coning(0.0, first);
+    const double firstConjugate[4] = {first[0], -first[1], -first[2], -first[3]};
+    double previous[4] = {first[0], first[1], first[2], first[3]};
+    for (int index = 0; index < NUMBER_OF_SAMPLES; index++) {
+        double quaternion[4];
+        Coning((double) index / CONING_SAMPLE_RATE, quaternion);
+        const double conjugate[4] = {previous[0], -previous[1], -previous[2], -previous[3]};
+        double delta[4];
+        Product(conjugate, quaternion, delta);
+        const double norm = sqrt((delta[1] * delta[1]) + (delta[2] * delta[2]) + (delta[3] * delta[3]));
+        const double scale = norm == 0.0 ? 0.0 : (2.0 * atan2(norm, delta[0]) * (180.0 / M_PI) * CONING_SAMPLE_RATE) / norm;
+        const double gravity[4] = {0.0, 0.0, 0.0, 1.0};
+        const double inverse[4] = {quaternion[0], -quaternion[1], -quaternion[2], -quaternion[3]};
+        double rotated[4];
+        double accelerometer[4];
+        Product(inverse, gravity, rotated);
+        Product(rotated, quaternion, accelerometer);
+        double truth[4];
+        Product(firstConjugate, quaternion, truth);
+        samples[index] = (Sample){
+            .ticks = (uint64_t) (index + 1) * TICKS_PER_SAMPLE,
+            .gyroscope = {.axis = {.x = (float) (delta[1] * scale), .y = (float) (delta[2] * scale), .z = (float) (delta[3] * scale)}},
+            .accelerometer = {.axis = {.x = (float) accelerometer[1], .y = (float) accelerometer[2], .z = (float) accelerometer[3]}},
+            .truth = {.element = {.w = (float) truth[0], .x = (float) truth[1], .y = (float) truth[2], .z = (float) truth[3]}},
+        };
+        for (int element = 0; element < 4; element++) {
+            previous[element] = quaternion[element];
+        }
+    }
+}
+
+/**
+ * @brief Returns the angle in degrees between a quaternion and the true
+ * orientation of the sample at the ticks.
+ */
+static float Error(const FusionQuaternion quaternion, const uint64_t ticks) {
+    const size_t index = (size_t) (ticks / TICKS_PER_SAMPLE) - 1;
+    const FusionQuaternion truth = samples[index].truth;
+    const FusionQuaternion conjugate = {.element = {.w = truth.element.w, .x = -truth.element.x, .y = -truth.element.y, .z = -truth.element.z}};
+    const FusionQuaternion error = FusionQuaternionProduct(conjugate, quaternion);
+    const float norm = sqrtf((error.element.x * error.element.x) + (error.element.y * error.element.y) + (error.element.z * error.element.z));
+    return FusionRadiansToDegrees(2.0f * atan2f(norm, fabsf(error.element.w)));
+}
+
+/**
+ * @brief Returns the settings of an uncalibrated IMU.
+ */
+static ImuSettings Settings(const float sampleRate, const uint32_t ahrsUpdateRateDivisor, const float ahrsGain) {
+    return (ImuSettings){
+        .gyroscopeMisalignment = FUSION_MATRIX_IDENTITY,
+        .gyroscopeSensitivity = FUSION_VECTOR_ONES,
+        .gyroscopeOffset = FUSION_VECTOR_ZERO,
+        .accelerometerMisalignment = FUSION_MATRIX_IDENTITY,
+        .accelerometerSensitivity = FUSION_VECTOR_ONES,
+        .accelerometerOffset = FUSION_VECTOR_ZERO,
+        .sampleRate = sampleRate,
+        .axesRemap = FusionRemapAlignmentPXPYPZ,
+        .gyroscopeBiasCorrectionEnabled = false,
+        .resamplingEnabled = false,
+        .ahrsUpdateRateDivisor = ahrsUpdateRateDivisor,
+        .ahrsAxesConvention = FusionConventionNwu,
+        .ahrsGain = ahrsGain,
+        .ahrsAccelerationRejection = 10.0f,
+    };
+}
+
+/**
+ * @brief Initialises an IMU as at power on and replays samples to it.
+ */
+static void Initialise(Imu * const imu, const ImuSettings * const settings, const Sample * const samples_, const size_t numberOfSamples) {
+    imu->initialised = false;
+    imu->downsampledCount = 0;
+    imu->previousTicks = 0;
+    ImuSetSettings(imu, settings);
+    replays[imu->icm - icms] = (Replay){.samples = samples_, .numberOfSamples = numberOfSamples};
+}
+
+/**
+ * @brief Replays the coning samples through ImuBatchTasks to IMU A with an
+ * AHRS update rate divisor and returns the duration per sample in seconds.
+ */
+static double ReplayConing(const uint32_t ahrsUpdateRateDivisor) {
+    const ImuSettings settings = Settings(CONING_SAMPLE_RATE, ahrsUpdateRateDivisor, 0.0f);
+    Initialise(&imuA, &settings, samples, NUMBER_OF_SAMPLES);
+    maxAhrsError = 0.0f;
+    maxFrameError = 0.0f;
+    numberOfAhrsMessages = 0;
+    compareWithTruth = true;
+    size_t budgets[IMU_NUMBER_OF_IMUS] = {0};
+    budgets[0] = NUMBER_OF_SAMPLES;
+    const double start = Seconds();
+    ImuBatchTasks(budgets);
+    const double duration = Seconds() - start;
+    compareWithTruth = false;
+    assert(replays[0].index == NUMBER_OF_SAMPLES);
+    assert(numberOfAhrsMessages == (int) ((NUMBER_OF_SAMPLES - 1) / ahrsUpdateRateDivisor));
+    replays[0] = (Replay){0};
+    return duration / NUMBER_OF_SAMPLES;
+}
+
+/**
+ * @brief Updates an AHRS at the downsampled rate with the average gyroscope
+ * and accelerometer, as preceded pre-integration, and returns the maximum
+ * error.
+ */
+static float ReplayConingAveraged(void) {
+    FusionAhrs ahrs;
+    FusionAhrsInitialise(&ahrs);
+    const FusionAhrsSettings ahrsSettings = {
+        .convention = FusionConventionNwu,
+        .gain = 0.0f,
+        .gyroscopeRange = 2000.0f,
+        .accelerationRejection = 10.0f,
+        .recoveryTriggerPeriod = 10 * 100,
+    };
+    FusionAhrsSetSettings(&ahrs, &ahrsSettings);
+    float maxError = 0.0f;
+    FusionVector gyroscope = FUSION_VECTOR_ZERO;
+    FusionVector accelerometer = FUSION_VECTOR_ZERO;
+    int count = 0;
+    for (int index = 1; index < NUMBER_OF_SAMPLES; index++) {
+        gyroscope = FusionVectorAdd(gyroscope, samples[index].gyroscope);
+        accelerometer = FusionVectorAdd(accelerometer, samples[index].accelerometer);
+        if (++count < CONING_DIVISOR) {
+            continue;
+        }
+        const float scale = 1.0f / (float) count;
+        FusionAhrsUpdateNoMagnetometer(&ahrs, FusionVectorScale(gyroscope, scale), FusionVectorScale(accelerometer, scale), (float) count / CONING_SAMPLE_RATE);
+        const float error = Error(FusionAhrsGetQuaternion(&ahrs), samples[index].ticks);
+        maxError = error > maxError ? error : maxError;
+        gyroscope = FUSION_VECTOR_ZERO;
+        accelerometer = FUSION_VECTOR_ZERO;
+        count = 0;
+    }
+    return maxError;
+}
+
+/**
+ * @brief Coning motion is replayed with an AHRS gain of zero so that the error
+ * is that of the gyroscope integration alone. Pre-integration between AHRS
+ * updates retains the accuracy of a full-rate AHRS, and the quaternion of each
+ * sample between updates does not lag, whereas averaging the gyroscope loses
+ * the coning rotation.
+ */
+static void TestPreintegration(void) {
+    GenerateConing();
+    const double fullRateDuration = ReplayConing(1);
+    const float fullRateError = maxAhrsError;
+    const float fullRateFrameError = maxFrameError;
+    const ProfileStatistics fullRateStatistics = ProfileGetStatistics(ProfileProbeAhrsUpdate);
+    ProfileReset();
+    const double preintegratedDuration = ReplayConing(CONING_DIVISOR);
+    const float preintegratedError = maxAhrsError;
+    const float preintegratedFrameError = maxFrameError;
+    const ProfileStatistics preintegratedStatistics = ProfileGetStatistics(ProfileProbeAhrsUpdate);
+    ProfileReset();
+    const float averagedError = ReplayConingAveraged();
+    printf("preintegration: %d s coning at %d Hz, %.0f degree half angle, %.0f Hz\n", CONING_DURATION, CONING_SAMPLE_RATE, CONING_HALF_ANGLE, CONING_FREQUENCY);
+    printf("preintegration: max error full rate %.3f degrees, averaged %d Hz %.3f degrees, pre-integrated %d Hz %.3f degrees (%.3f degrees between updates)\n",
+           fullRateError, CONING_SAMPLE_RATE / CONING_DIVISOR, averagedError, CONING_SAMPLE_RATE / CONING_DIVISOR, preintegratedError, preintegratedFrameError);
+    printf("preintegration: ImuBatchTasks full rate %.1f ns/sample, pre-integrated %.1f ns/sample, AHRS update %.1f ns\n",
+           fullRateDuration * 1e9, preintegratedDuration * 1e9, (double) fullRateStatistics.total / (double) fullRateStatistics.numberOfDurations);
+    assert(fullRateStatistics.numberOfDurations == (NUMBER_OF_SAMPLES - 1));
+    assert(preintegratedStatistics.numberOfDurations == ((NUMBER_OF_SAMPLES - 1) / CONING_DIVISOR));
+    assert(fullRateError < 1.0f);
+    assert(fullRateFrameError < 1.0f);
+    assert(preintegratedError < (fullRateError + 0.1f));
+    assert(preintegratedFrameError < (fullRateFrameError + 0.1f));
+    assert(averagedError > (10.0f * preintegratedError));
+}
+
+/**
+ * @brief Returns a random misalignment matrix close to identity.
+ */
+static FusionMatrix RandomMisalignment(void) {
+    FusionMatrix misalignment = FUSION_MATRIX_IDENTITY;
+    for (int index = 0; index < 9; index++) {
+        misalignment.array[index] += Random(-0.05f, 0.05f);
+    }
+    return misalignment;
+}
+
+/**
+ * @brief Returns a random sensitivity close to one.
+ */
+static FusionVector RandomSensitivity(void) {
+    return (FusionVector){.axis = {.x = Random(0.95f, 1.05f), .y = Random(0.95f, 1.05f), .z = Random(0.95f, 1.05f)}};
+}
+
+/**
+ * @brief Returns the error of a calibrated vector relative to the magnitude of
+ * the reference.
+ */
+static float RelativeError(const FusionVector vector, const FusionVector reference) {
+    const float magnitude = FusionVectorNorm(reference);
+    return FusionVectorNorm(FusionVectorSubtract(vector, reference)) / (magnitude > 1.0f ? magnitude : 1.0f);
+}
+
+/**
+ * @brief Random samples are replayed through ImuBatchTasks with a random
+ * calibration for every axes alignment. The inertial data sent is compared with
+ * FusionModelInertial followed by FusionRemap, as applied before the
+ * calibration and remap were combined. The duration of each transform is then
+ * measured for the same vectors.
+ */
+static void TestCalibration(void) {
+    static Sample calibrationSamples[NUMBER_OF_CALIBRATION_SAMPLES];
+    float maxError = 0.0f;
+    for (int alignment = 0; alignment <= FusionRemapAlignmentNXNYPZ; alignment++) {
+        ImuSettings settings = Settings(1000.0f, 0, 0.5f);
+        settings.gyroscopeMisalignment = RandomMisalignment();
+        settings.gyroscopeSensitivity = RandomSensitivity();
+        settings.gyroscopeOffset = (FusionVector){.axis = {.x = Random(-5, 5), .y = Random(-5, 5), .z = Random(-5, 5)}};
+        settings.accelerometerMisalignment = RandomMisalignment();
+        settings.accelerometerSensitivity = RandomSensitivity();
+        settings.accelerometerOffset = (FusionVector){.axis = {.x = Random(-0.1f, 0.1f), .y = Random(-0.1f, 0.1f), .z = Random(-0.1f, 0.1f)}};
+        settings.axesRemap = (FusionRemapAlignment) alignment;
+        for (int index = 0; index < NUMBER_OF_CALIBRATION_SAMPLES; index++) {
+            calibrationSamples[index] = (Sample){
+                .ticks = (uint64_t) (index + 1) * TICKS_PER_SAMPLE,
+                .gyroscope = {.axis = {.x = Random(-2000, 2000), .y = Random(-2000, 2000), .z = Random(-2000, 2000)}},
+                .accelerometer = {.axis = {.x = Random(-16, 16), .y = Random(-16, 16), .z = Random(-16, 16)}},
+            };
+        }
+        Initialise(&imuA, &settings, calibrationSamples, NUMBER_OF_CALIBRATION_SAMPLES);
+        size_t budgets[IMU_NUMBER_OF_IMUS] = {0};
+        budgets[0] = NUMBER_OF_CALIBRATION_SAMPLES;
+        ImuBatchTasks(budgets);
+        assert(replays[0].index == NUMBER_OF_CALIBRATION_SAMPLES);
+        replays[0] = (Replay){0};
+        for (int index = 0; index < NUMBER_OF_CALIBRATION_SAMPLES; index++) {
+            const Sample * const sample = &calibrationSamples[index];
+            const FusionVector gyroscope = FusionRemap(FusionModelInertial(sample->gyroscope, settings.gyroscopeMisalignment, settings.gyroscopeSensitivity, settings.gyroscopeOffset), settings.axesRemap);
+            const FusionVector accelerometer = FusionRemap(FusionModelInertial(sample->accelerometer, settings.accelerometerMisalignment, settings.accelerometerSensitivity, settings.accelerometerOffset), settings.axesRemap);
+            assert(inertialData[index].ticks == sample->ticks);
+            const float gyroscopeError = RelativeError(inertialData[index].gyroscope, gyroscope);
+            const float accelerometerError = RelativeError(inertialData[index].accelerometer, accelerometer);
+            maxError = gyroscopeError > maxError ? gyroscopeError : maxError;
+            maxError = accelerometerError > maxError ? accelerometerError : maxError;
+        }
+    }
+    printf("calibration: %d alignments, max error %.2g relative to magnitude: ok\n", FusionRemapAlignmentNXNYPZ + 1, maxError);
+    assert(maxError < CALIBRATION_TOLERANCE);
+
+    // Benchmark
+    const ImuSettings settings = imuA.settings;
+    const ImuCalibration calibration = imuA.gyroscopeCalibration;
+    FusionVector sum = FUSION_VECTOR_ZERO;
+    double start = Seconds();
+    for (int repetition = 0; repetition < NUMBER_OF_CALIBRATION_REPETITIONS; repetition++) {
+        for (int index = 0; index < NUMBER_OF_CALIBRATION_SAMPLES; index++) {
+            sum = FusionVectorAdd(sum, FusionRemap(FusionModelInertial(calibrationSamples[index].gyroscope, settings.gyroscopeMisalignment, settings.gyroscopeSensitivity, settings.gyroscopeOffset), settings.axesRemap));
+        }
+        __asm__ volatile("" : "+m"(sum));
+    }
+    const double reference = (Seconds() - start) / ((double) NUMBER_OF_CALIBRATION_REPETITIONS * NUMBER_OF_CALIBRATION_SAMPLES);
+    start = Seconds();
+    for (int repetition = 0; repetition < NUMBER_OF_CALIBRATION_REPETITIONS; repetition++) {
+        for (int index = 0; index < NUMBER_OF_CALIBRATION_SAMPLES; index++) {
+            sum = FusionVectorAdd(sum, FusionMatrixMultiply(calibration.matrix, FusionVectorSubtract(calibrationSamples[index].gyroscope, calibration.offset)));
+        }
+        __asm__ volatile("" : "+m"(sum));
+    }
+    const double combined = (Seconds() - start) / ((double) NUMBER_OF_CALIBRATION_REPETITIONS * NUMBER_OF_CALIBRATION_SAMPLES);
+    printf("calibration: FusionModelInertial and FusionRemap %.2f ns/vector, combined %.2f ns/vector, ratio %.2f\n", reference * 1e9, combined * 1e9, reference / combined);
+}
+
+/**
+ * @brief Replays the coning samples to all IMUs through ImuBatchTasks and
+ * returns the samples per second. All IMUs are processed together, as by the
+ * scheduler, or one IMU at a time with one batch per call.
+ */
+static double ReplayAll(const bool together, FusionQuaternion * const quaternions) {
+    ImuSettings settings = Settings(CONING_SAMPLE_RATE, CONING_DIVISOR, 0.5f);
+    settings.gyroscopeBiasCorrectionEnabled = true;
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        Initialise(imus[index], &settings, samples, NUMBER_OF_THROUGHPUT_SAMPLES);
+    }
+    size_t budgets[IMU_NUMBER_OF_IMUS];
+    const double start = Seconds();
+    if (together) {
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            budgets[index] = NUMBER_OF_THROUGHPUT_SAMPLES;
+        }
+        ImuBatchTasks(budgets);
+    } else {
+        while (replays[IMU_NUMBER_OF_IMUS - 1].index < NUMBER_OF_THROUGHPUT_SAMPLES) {
+            for (int imu = 0; imu < IMU_NUMBER_OF_IMUS; imu++) {
+                for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+                    budgets[index] = index == imu ? ICM_MAX_BATCH_SIZE : 0;
+                }
+                ImuBatchTasks(budgets);
+            }
+        }
+    }
+    const double duration = Seconds() - start;
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        assert(replays[index].index == NUMBER_OF_THROUGHPUT_SAMPLES);
+        replays[index] = (Replay){0};
+        quaternions[index] = FusionAhrsGetQuaternion(&imus[index]->ahrs);
+    }
+    return ((double) IMU_NUMBER_OF_IMUS * NUMBER_OF_THROUGHPUT_SAMPLES) / duration;
+}
+
+/**
+ * @brief Coning samples are replayed to all IMUs with bias correction and
+ * pre-integration enabled. The quaternions of processing all IMUs together and
+ * one IMU at a time are compared, and the samples per second of each are
+ * printed as the sample rate available to each of the IMUs.
+ */
+static void BenchmarkThroughput(void) {
+    FusionQuaternion quaternions[2][IMU_NUMBER_OF_IMUS];
+    const double together = ReplayAll(true, quaternions[0]);
+    const double separately = ReplayAll(false, quaternions[1]);
+    assert(memcmp(quaternions[0], quaternions[1], sizeof (quaternions[0])) == 0);
+    printf("throughput: %d IMUs, together %.2f M samples/s (%.1f kHz per IMU), one at a time %.2f M samples/s (%.1f kHz per IMU), ratio %.2f\n",
+           IMU_NUMBER_OF_IMUS, together * 1e-6, (together / IMU_NUMBER_OF_IMUS) * 1e-3, separately * 1e-6, (separately / IMU_NUMBER_OF_IMUS) * 1e-3, together / separately);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestPreintegration();
+    TestCalibration();
+    BenchmarkThroughput();
+    printf("Imu: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
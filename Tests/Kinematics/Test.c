@@ -0,0 +1,227 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the hand kinematics. Synthetic quaternions are built
+ * from known joint angles for random carpus orientations. The AHRS of each
+ * segment has a random heading offset that is removed by zeroing.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Kinematics/Kinematics.h"
+#include <math.h>
+#include "Profile/Profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_POSES (10000)
+#define TOLERANCE (0.05f) // degrees
+
+//------------------------------------------------------------------------------
+// Variables
+
+Send sendMain;
+
+static const SendRateDivisorMultipliers rateDivisorMultipliers = {.jointAngles = 1};
+
+static KinematicsJointAngles sentJointAngles;
+static int numberOfMessages;
+
+/**
+ * @brief Parent of each segment. Matches the joints of Kinematics.c.
+ */
+static const int parents[KINEMATICS_NUMBER_OF_SEGMENTS] = {-1, 0, 1, 2, 0, 4, 5, 6, 0, 8, 9, 10, 0, 12, 13, 14, 0, 16, 17, 18};
+
+//------------------------------------------------------------------------------
+// Functions
+
+void ProfileAdd(const ProfileProbe probe, const uint32_t duration) {
+}
+
+void SendJointAngles(Send * const send, const SendJointAnglesData * const jointAnglesData) {
+    assert(jointAnglesData->numberOfAngles == (2 * KINEMATICS_NUMBER_OF_JOINTS));
+    memcpy(sentJointAngles.array, jointAnglesData->angles, sizeof (sentJointAngles.array));
+    numberOfMessages++;
+}
+
+const SendRateDivisorMultipliers * SendGetRateDivisorMultipliers(void) {
+    return &rateDivisorMultipliers;
+}
+
+static float Random(const float min, const float max) {
+    return min + ((max - min) * ((float) rand() / (float) RAND_MAX));
+}
+
+static FusionQuaternion AxisAngle(const float x, const float y, const float z, const float degrees) {
+    const float halfAngle = FusionDegreesToRadians(0.5f * degrees);
+    return (FusionQuaternion){.element = {.w = cosf(halfAngle), .x = x * sinf(halfAngle), .y = y * sinf(halfAngle), .z = z * sinf(halfAngle)}};
+}
+
+static FusionQuaternion Product3(const FusionQuaternion a, const FusionQuaternion b, const FusionQuaternion c) {
+    return FusionQuaternionProduct(FusionQuaternionProduct(a, b), c);
+}
+
+/**
+ * @brief Returns a random orientation as ZYX Euler angles.
+ */
+static FusionQuaternion RandomOrientation(void) {
+    return Product3(AxisAngle(0, 0, 1, Random(-180, 180)), AxisAngle(0, 1, 0, Random(-80, 80)), AxisAngle(1, 0, 0, Random(-180, 180)));
+}
+
+/**
+ * @brief Builds the quaternion of each segment from the carpus orientation and
+ * joint angles. The relative rotation of each joint is flexion around Y, then
+ * abduction around Z, then twist around X. Each quaternion is then rotated by
+ * the heading offset of its AHRS.
+ */
+static void Build(FusionQuaternion * const quaternions, const FusionQuaternion carpus, const KinematicsJointAngles * const jointAngles, const float * const twists, const float * const headingOffsets) {
+    FusionQuaternion segments[KINEMATICS_NUMBER_OF_SEGMENTS];
+    segments[0] = carpus;
+    for (int segment = 1; segment < KINEMATICS_NUMBER_OF_SEGMENTS; segment++) {
+        const int joint = segment - 1;
+        const FusionQuaternion relative = Product3(AxisAngle(0, 1, 0, jointAngles->joint[joint].flexion), AxisAngle(0, 0, 1, jointAngles->joint[joint].abduction), AxisAngle(1, 0, 0, twists[joint]));
+        segments[segment] = FusionQuaternionProduct(segments[parents[segment]], relative);
+    }
+    for (int segment = 0; segment < KINEMATICS_NUMBER_OF_SEGMENTS; segment++) {
+        quaternions[segment] = FusionQuaternionProduct(AxisAngle(0, 0, 1, headingOffsets[segment]), segments[segment]);
+    }
+}
+
+static float AngleError(const float a, const float b) {
+    float error = fmodf(fabsf(a - b), 360.0f);
+    return error > 180.0f ? 360.0f - error : error;
+}
+
+/**
+ * @brief Returns the maximum error of the calculated joint angles.
+ */
+static float MaxError(const KinematicsJointAngles * const expected, const KinematicsJointAngles * const actual) {
+    float maxError = 0.0f;
+    for (int index = 0; index < (2 * KINEMATICS_NUMBER_OF_JOINTS); index++) {
+        maxError = fmaxf(maxError, AngleError(expected->array[index], actual->array[index]));
+    }
+    return maxError;
+}
+
+/**
+ * @brief Runs random poses and returns the maximum error.
+ */
+static float Run(const Kinematics * const kinematics, const float * const headingOffsets, const float maxFlexion) {
+    float maxError = 0.0f;
+    for (int pose = 0; pose < NUMBER_OF_POSES; pose++) {
+        KinematicsJointAngles expected;
+        float twists[KINEMATICS_NUMBER_OF_JOINTS];
+        for (int joint = 0; joint < KINEMATICS_NUMBER_OF_JOINTS; joint++) {
+            expected.joint[joint].flexion = Random(-maxFlexion, maxFlexion);
+            expected.joint[joint].abduction = Random(-45, 45);
+            twists[joint] = Random(-30, 30);
+        }
+        FusionQuaternion quaternions[KINEMATICS_NUMBER_OF_SEGMENTS];
+        Build(quaternions, RandomOrientation(), &expected, twists, headingOffsets);
+        const KinematicsJointAngles actual = KinematicsCalculateJointAngles(kinematics, quaternions);
+        maxError = fmaxf(maxError, MaxError(&expected, &actual));
+    }
+    return maxError;
+}
+
+/**
+ * @brief Builds the zero pose. The carpus is level with a random heading and all
+ * joint angles are zero.
+ */
+static void BuildZeroPose(FusionQuaternion * const quaternions, const float * const headingOffsets) {
+    const KinematicsJointAngles zero = {0};
+    const float twists[KINEMATICS_NUMBER_OF_JOINTS] = {0};
+    Build(quaternions, AxisAngle(0, 0, 1, Random(-180, 180)), &zero, twists, headingOffsets);
+}
+
+/**
+ * @brief Joint angles are exact when the headings of all segments agree,
+ * including for flexion beyond 90 degrees.
+ */
+static void TestAlignedHeadings(void) {
+    Kinematics kinematics = {0};
+    const float headingOffsets[KINEMATICS_NUMBER_OF_SEGMENTS] = {0};
+    float maxError = Run(&kinematics, headingOffsets, 85);
+    printf("aligned headings, flexion within 85 degrees: max error %.4f degrees\n", maxError);
+    assert(maxError < TOLERANCE);
+    maxError = Run(&kinematics, headingOffsets, 170);
+    printf("aligned headings, flexion within 170 degrees: max error %.4f degrees\n", maxError);
+    assert(maxError < TOLERANCE);
+}
+
+/**
+ * @brief Mismatched headings corrupt the joint angles until the headings are
+ * aligned in the zero pose.
+ */
+static void TestMismatchedHeadings(void) {
+    float headingOffsets[KINEMATICS_NUMBER_OF_SEGMENTS];
+    for (int segment = 0; segment < KINEMATICS_NUMBER_OF_SEGMENTS; segment++) {
+        headingOffsets[segment] = Random(-180, 180);
+    }
+    Kinematics kinematics = {0};
+    const float unalignedError = Run(&kinematics, headingOffsets, 120);
+    printf("mismatched headings, not zeroed: max error %.1f degrees\n", unalignedError);
+    assert(unalignedError > 10.0f);
+
+    FusionQuaternion quaternions[KINEMATICS_NUMBER_OF_SEGMENTS];
+    BuildZeroPose(quaternions, headingOffsets);
+    KinematicsAlignHeadings(&kinematics, quaternions);
+    const float maxError = Run(&kinematics, headingOffsets, 120);
+    printf("mismatched headings, zeroed, flexion within 120 degrees: max error %.4f degrees\n", maxError);
+    assert(maxError < TOLERANCE);
+}
+
+/**
+ * @brief The zero command aligns the headings on the next update and joint
+ * angles are sent at the message rate.
+ */
+static void TestZeroCommand(void) {
+    float headingOffsets[KINEMATICS_NUMBER_OF_SEGMENTS];
+    for (int segment = 0; segment < KINEMATICS_NUMBER_OF_SEGMENTS; segment++) {
+        headingOffsets[segment] = Random(-180, 180);
+    }
+    Kinematics kinematics = {.send = &sendMain};
+    const KinematicsSettings settings = {.jointAnglesMessageRateDivisor = 2};
+    KinematicsSetSettings(&kinematics, &settings);
+
+    // Zero
+    FusionQuaternion quaternions[KINEMATICS_NUMBER_OF_SEGMENTS];
+    BuildZeroPose(quaternions, headingOffsets);
+    KinematicsZero(&kinematics);
+    KinematicsUpdate(&kinematics, 0, 1, quaternions);
+    assert(numberOfMessages == 0);
+
+    // Pose
+    KinematicsJointAngles expected;
+    float twists[KINEMATICS_NUMBER_OF_JOINTS];
+    for (int joint = 0; joint < KINEMATICS_NUMBER_OF_JOINTS; joint++) {
+        expected.joint[joint].flexion = Random(-120, 120);
+        expected.joint[joint].abduction = Random(-45, 45);
+        twists[joint] = Random(-30, 30);
+    }
+    Build(quaternions, RandomOrientation(), &expected, twists, headingOffsets);
+    KinematicsUpdate(&kinematics, 0, 1, quaternions);
+    assert(numberOfMessages == 1);
+    const float maxError = MaxError(&expected, &sentJointAngles);
+    printf("zero command: max error %.4f degrees\n", maxError);
+    assert(maxError < TOLERANCE);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestAlignedHeadings();
+    TestMismatchedHeadings();
+    TestZeroCommand();
+    printf("Kinematics: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,33 @@
+/**
+ * @file Cache.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for data cache maintenance. Simulated DMA transfers
+ * are performed by the CPU and so no maintenance is required.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stddef.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define CACHE_LINE_BYTES (16)
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+static inline void CacheWritebackInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+}
+
+static inline void CacheInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
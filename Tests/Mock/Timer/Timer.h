@@ -1,31 +1,32 @@
 /**
- * @file Icm11.h
+ * @file Timer.h
  * @author Seb Madgwick
- * @brief ICM-42688-P driver.
+ * @brief Host stand-in for the timer driver. The timer is simulated by each
+ * test.
  */
 
-#ifndef ICM11_H
-#define ICM11_H
+#ifndef TIMER_H
+#define TIMER_H
 
 //------------------------------------------------------------------------------
 // Includes
 
-#include "Icm.h"
 #include <stdint.h>
 
 //------------------------------------------------------------------------------
-// Variable declarations
+// Definitions
 
-extern const Icm icm11;
+#define TIMER_TICKS_PER_SECOND (100000000U)
+
+#define TIMER_TICKS_PER_MILLISECOND (TIMER_TICKS_PER_SECOND / 1000U)
+
+#define TIMER_TICKS_PER_MICROSECOND (TIMER_TICKS_PER_SECOND / 1000000U)
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-void Icm11Initialise(const IcmSettings * const settings);
-void Icm11Deinitialise(void);
-IcmResult Icm11GetData(IcmData * const data);
-uint32_t Icm11BufferOverflow(void);
-IcmTestResult Icm11Test(void);
+uint32_t TimerGetTicks32(void);
+uint64_t TimerGetTicks64(void);
 
 #endif
 
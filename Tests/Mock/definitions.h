@@ -0,0 +1,93 @@
+/**
+ * @file definitions.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the Harmony definitions. Only the declarations used
+ * by the modules under test are provided. Each test defines the functions that
+ * it uses.
+ */
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define CPU_CLOCK_FREQUENCY (200000000U)
+
+#define MOCK_PIN(number, channel) ((GPIO_PIN) ((((channel) - 1) * 4) + ((number) - 1)))
+
+#define CS1_CH1_PIN MOCK_PIN(1, 1)
+#define CS2_CH1_PIN MOCK_PIN(2, 1)
+#define CS3_CH1_PIN MOCK_PIN(3, 1)
+#define CS4_CH1_PIN MOCK_PIN(4, 1)
+#define CS1_CH2_PIN MOCK_PIN(1, 2)
+#define CS2_CH2_PIN MOCK_PIN(2, 2)
+#define CS3_CH2_PIN MOCK_PIN(3, 2)
+#define CS4_CH2_PIN MOCK_PIN(4, 2)
+#define CS1_CH3_PIN MOCK_PIN(1, 3)
+#define CS2_CH3_PIN MOCK_PIN(2, 3)
+#define CS3_CH3_PIN MOCK_PIN(3, 3)
+#define CS4_CH3_PIN MOCK_PIN(4, 3)
+#define CS1_CH4_PIN MOCK_PIN(1, 4)
+#define CS2_CH4_PIN MOCK_PIN(2, 4)
+#define CS3_CH4_PIN MOCK_PIN(3, 4)
+#define CS4_CH4_PIN MOCK_PIN(4, 4)
+#define CS1_CH5_PIN MOCK_PIN(1, 5)
+#define CS2_CH5_PIN MOCK_PIN(2, 5)
+#define CS3_CH5_PIN MOCK_PIN(3, 5)
+#define CS4_CH5_PIN MOCK_PIN(4, 5)
+
+#define INT1_CH1_PIN (MOCK_PIN(1, 1) + 20)
+#define INT2_CH1_PIN (MOCK_PIN(2, 1) + 20)
+#define INT3_CH1_PIN (MOCK_PIN(3, 1) + 20)
+#define INT4_CH1_PIN (MOCK_PIN(4, 1) + 20)
+#define INT1_CH2_PIN (MOCK_PIN(1, 2) + 20)
+#define INT2_CH2_PIN (MOCK_PIN(2, 2) + 20)
+#define INT3_CH2_PIN (MOCK_PIN(3, 2) + 20)
+#define INT4_CH2_PIN (MOCK_PIN(4, 2) + 20)
+#define INT1_CH3_PIN (MOCK_PIN(1, 3) + 20)
+#define INT2_CH3_PIN (MOCK_PIN(2, 3) + 20)
+#define INT3_CH3_PIN (MOCK_PIN(3, 3) + 20)
+#define INT4_CH3_PIN (MOCK_PIN(4, 3) + 20)
+#define INT1_CH4_PIN (MOCK_PIN(1, 4) + 20)
+#define INT2_CH4_PIN (MOCK_PIN(2, 4) + 20)
+#define INT3_CH4_PIN (MOCK_PIN(3, 4) + 20)
+#define INT4_CH4_PIN (MOCK_PIN(4, 4) + 20)
+#define INT1_CH5_PIN (MOCK_PIN(1, 5) + 20)
+#define INT2_CH5_PIN (MOCK_PIN(2, 5) + 20)
+#define INT3_CH5_PIN (MOCK_PIN(3, 5) + 20)
+#define INT4_CH5_PIN (MOCK_PIN(4, 5) + 20)
+
+#define MOCK_NUMBER_OF_PINS (40)
+
+typedef uint32_t GPIO_PIN;
+
+typedef enum {
+    GPIO_INTERRUPT_ON_MISMATCH,
+    GPIO_INTERRUPT_ON_RISING_EDGE,
+    GPIO_INTERRUPT_ON_FALLING_EDGE,
+    GPIO_INTERRUPT_ON_BOTH_EDGES,
+} GPIO_INTERRUPT_STYLE;
+
+typedef void (*GPIO_PIN_CALLBACK) (GPIO_PIN pin, uintptr_t context);
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+bool GPIO_PinRead(GPIO_PIN pin);
+void GPIO_PinIntEnable(GPIO_PIN pin, GPIO_INTERRUPT_STYLE style);
+void GPIO_PinIntDisable(GPIO_PIN pin);
+bool GPIO_PinInterruptCallbackRegister(GPIO_PIN pin, const GPIO_PIN_CALLBACK callback, uintptr_t context);
+void SYS_Tasks(void);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
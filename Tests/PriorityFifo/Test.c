@@ -0,0 +1,251 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the priority FIFO. Random writes, reservations, reads
+ * and clears are compared with a reference model in which each message is read
+ * in full and the next message is the oldest message of the highest priority.
+ * The FIFO sizes are odd so that the message size written at the start of
+ * each message wraps around the end of the buffer. The latency of a
+ * high-priority message written while low-priority messages are being read is
+ * bounded by the remainder of the message being read.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "PriorityFifo.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_OPERATIONS (1000000)
+#define MAX_MESSAGE_SIZE (40)
+#define MAX_READ_SIZE (64)
+#define MAX_NUMBER_OF_MESSAGES (64)
+
+/**
+ * @brief Message of the reference model.
+ */
+typedef struct {
+    uint32_t sequence;
+    size_t size;
+} Message;
+
+/**
+ * @brief Queue of messages of one priority of the reference model.
+ */
+typedef struct {
+    Message messages[MAX_NUMBER_OF_MESSAGES];
+    size_t writeIndex;
+    size_t readIndex;
+} Queue;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint8_t lowData[97];
+static uint8_t mediumData[53];
+static uint8_t highData[31];
+static PriorityFifo priorityFifo = {.fifos = {
+    {.data = lowData, .dataSize = sizeof (lowData)},
+    {.data = mediumData, .dataSize = sizeof (mediumData)},
+    {.data = highData, .dataSize = sizeof (highData)},
+}};
+
+static Queue queues[PRIORITY_FIFO_NUMBER_OF_PRIORITIES];
+static uint32_t sequence;
+static bool reading;
+static int readPriority;
+static size_t readOffset;
+static int numberOfMessagesRead[PRIORITY_FIFO_NUMBER_OF_PRIORITIES];
+static int numberOfLowReadAtHighRead;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Returns the byte of a message.
+ */
+static uint8_t Byte(const uint32_t sequence_, const size_t index) {
+    return (uint8_t) ((sequence_ * 31) ^ index);
+}
+
+/**
+ * @brief Writes a message with PriorityFifoWrite or with a reservation. Fewer
+ * bytes than reserved may be committed.
+ */
+static void Write(const PriorityFifoPriority priority, const size_t numberOfBytes, const bool reserve) {
+    const size_t available = PriorityFifoAvailableWrite(&priorityFifo, priority);
+    uint8_t data[MAX_MESSAGE_SIZE];
+    FifoReservation reservation;
+    if (numberOfBytes > available) {
+        assert(PriorityFifoWrite(&priorityFifo, priority, data, numberOfBytes) == FifoResultError);
+        assert(PriorityFifoReserve(&priorityFifo, priority, numberOfBytes, &reservation) == FifoResultError);
+        return;
+    }
+    sequence++;
+    size_t messageSize = numberOfBytes;
+    if (reserve) {
+        assert(PriorityFifoReserve(&priorityFifo, priority, numberOfBytes, &reservation) == FifoResultOk);
+        assert((reservation.firstSize + reservation.secondSize) == numberOfBytes);
+        messageSize = (size_t) rand() % (numberOfBytes + 1);
+        for (size_t index = 0; index < messageSize; index++) {
+            const uint8_t byte = Byte(sequence, index);
+            FifoReservationWrite(&reservation, index, &byte, 1);
+        }
+        PriorityFifoCommit(&priorityFifo, priority, messageSize);
+    } else {
+        for (size_t index = 0; index < messageSize; index++) {
+            data[index] = Byte(sequence, index);
+        }
+        assert(PriorityFifoWrite(&priorityFifo, priority, data, messageSize) == FifoResultOk);
+    }
+    Queue * const queue = &queues[priority];
+    assert((queue->writeIndex - queue->readIndex) < MAX_NUMBER_OF_MESSAGES);
+    queue->messages[queue->writeIndex++ % MAX_NUMBER_OF_MESSAGES] = (Message){.sequence = sequence, .size = messageSize};
+}
+
+/**
+ * @brief Returns the priority of the next message of the reference model, or
+ * -1 if there are no messages.
+ */
+static int NextPriority(void) {
+    for (int priority = PRIORITY_FIFO_NUMBER_OF_PRIORITIES - 1; priority >= 0; priority--) {
+        if (queues[priority].writeIndex != queues[priority].readIndex) {
+            return priority;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reads and compares with the reference model.
+ */
+static void Read(const size_t numberOfBytes) {
+    uint8_t destination[MAX_READ_SIZE];
+    const size_t numberOfBytesRead = PriorityFifoRead(&priorityFifo, destination, numberOfBytes);
+    size_t index = 0;
+    while (index < numberOfBytes) {
+        if (reading == false) {
+            readPriority = NextPriority();
+            if (readPriority < 0) {
+                break;
+            }
+            reading = true;
+            readOffset = 0;
+        }
+        Queue * const queue = &queues[readPriority];
+        const Message message = queue->messages[queue->readIndex % MAX_NUMBER_OF_MESSAGES];
+        while ((index < numberOfBytes) && (readOffset < message.size)) {
+            assert(index < numberOfBytesRead);
+            assert(destination[index++] == Byte(message.sequence, readOffset++));
+        }
+        if (readOffset == message.size) {
+            queue->readIndex++;
+            reading = false;
+            numberOfMessagesRead[readPriority]++;
+            if (readPriority == PriorityFifoPriorityHigh) {
+                numberOfLowReadAtHighRead = numberOfMessagesRead[PriorityFifoPriorityLow];
+            }
+        }
+    }
+    assert(numberOfBytesRead == index);
+    assert(PriorityFifoEmpty(&priorityFifo) == (NextPriority() < 0));
+}
+
+/**
+ * @brief Clears the FIFO and the reference model.
+ */
+static void Clear(void) {
+    PriorityFifoClear(&priorityFifo);
+    for (int priority = 0; priority < PRIORITY_FIFO_NUMBER_OF_PRIORITIES; priority++) {
+        queues[priority].readIndex = queues[priority].writeIndex;
+    }
+    reading = false;
+    assert(PriorityFifoEmpty(&priorityFifo));
+}
+
+/**
+ * @brief Random writes, reservations, reads and clears.
+ */
+static void TestPriority(void) {
+    for (int operation = 0; operation < NUMBER_OF_OPERATIONS; operation++) {
+        const int action = rand() % 1000;
+        if (action < 400) {
+            Write((PriorityFifoPriority) (rand() % PRIORITY_FIFO_NUMBER_OF_PRIORITIES), 1 + ((size_t) rand() % MAX_MESSAGE_SIZE), (rand() % 2) == 0);
+        } else if (action < 999) {
+            Read((size_t) rand() % (MAX_READ_SIZE + 1));
+        } else {
+            Clear();
+        }
+    }
+    printf("priority: %d operations, messages read (low, medium, high): %d, %d, %d: ok\n", NUMBER_OF_OPERATIONS, numberOfMessagesRead[PriorityFifoPriorityLow], numberOfMessagesRead[PriorityFifoPriorityMedium], numberOfMessagesRead[PriorityFifoPriorityHigh]);
+}
+
+/**
+ * @brief A message of the space available may be written and a larger message
+ * may not.
+ */
+static void TestAvailableWrite(void) {
+    uint8_t data[sizeof (lowData)] = {0};
+    for (int priority = 0; priority < PRIORITY_FIFO_NUMBER_OF_PRIORITIES; priority++) {
+        Clear();
+        const size_t available = PriorityFifoAvailableWrite(&priorityFifo, (PriorityFifoPriority) priority);
+        assert(available == (PriorityFifoCapacity(&priorityFifo, (PriorityFifoPriority) priority) - sizeof (uint16_t)));
+        assert(PriorityFifoWrite(&priorityFifo, (PriorityFifoPriority) priority, data, available + 1) == FifoResultError);
+        assert(PriorityFifoWrite(&priorityFifo, (PriorityFifoPriority) priority, data, available) == FifoResultOk);
+        assert(PriorityFifoAvailableWrite(&priorityFifo, (PriorityFifoPriority) priority) == 0);
+    }
+    Clear();
+    printf("available write: ok\n");
+}
+
+/**
+ * @brief A high-priority message written while the low-priority FIFO is full
+ * and a low-priority message is partially read is read next, after at most the
+ * remainder of the message being read, for reads of different sizes.
+ */
+static void TestLatency(void) {
+    const size_t readSizes[] = {1, 7, MAX_READ_SIZE};
+    int maxNumberOfReads = 0;
+    for (size_t readSize = 0; readSize < (sizeof (readSizes) / sizeof (readSizes[0])); readSize++) {
+        for (int trial = 0; trial < 1000; trial++) {
+            Clear();
+            while (PriorityFifoAvailableWrite(&priorityFifo, PriorityFifoPriorityLow) > 0) {
+                Write(PriorityFifoPriorityLow, 1 + ((size_t) rand() % MAX_MESSAGE_SIZE), false);
+            }
+            Read((size_t) rand() % (MAX_MESSAGE_SIZE + 1));
+            const int numberOfLowRead = numberOfMessagesRead[PriorityFifoPriorityLow];
+            const int numberOfHighRead = numberOfMessagesRead[PriorityFifoPriorityHigh];
+            const size_t highSize = 1 + ((size_t) rand() % PriorityFifoAvailableWrite(&priorityFifo, PriorityFifoPriorityHigh));
+            Write(PriorityFifoPriorityHigh, highSize, (rand() % 2) == 0);
+            int numberOfReads = 0;
+            while (numberOfMessagesRead[PriorityFifoPriorityHigh] == numberOfHighRead) {
+                Read(readSizes[readSize]);
+                numberOfReads++;
+            }
+            assert((numberOfLowReadAtHighRead - numberOfLowRead) <= 1);
+            assert(numberOfReads <= (int) (((MAX_MESSAGE_SIZE + highSize) / readSizes[readSize]) + 2));
+            maxNumberOfReads = numberOfReads > maxNumberOfReads ? numberOfReads : maxNumberOfReads;
+        }
+    }
+    Clear();
+    printf("latency: high-priority message read after at most one low-priority message, max %d reads: ok\n", maxNumberOfReads);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestPriority();
+    TestAvailableWrite();
+    TestLatency();
+    printf("PriorityFifo: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
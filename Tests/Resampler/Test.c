@@ -0,0 +1,258 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the resampler. Input samples of linear signals are
+ * timestamped with drift and jitter, and processed in batches as in
+ * ImuBatchTasks. Each output sample must be on the grid and equal to the
+ * signal at the grid point.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Imu/Resampler/Resampler.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define SAMPLE_RATE (1125.0f)
+#define PERIOD ((double) TIMER_TICKS_PER_SECOND / (double) SAMPLE_RATE)
+#define NUMBER_OF_INPUTS (10000)
+#define MAX_NUMBER_OF_OUTPUTS (2 * NUMBER_OF_INPUTS)
+#define TOLERANCE (0.001f)
+
+/**
+ * @brief Output samples.
+ */
+typedef struct {
+    uint64_t ticks[MAX_NUMBER_OF_OUTPUTS];
+    float values[MAX_NUMBER_OF_OUTPUTS][7];
+    int numberOfOutputs;
+} Outputs;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint64_t inputTicks[NUMBER_OF_INPUTS];
+static Outputs outputs;
+static Outputs otherOutputs;
+
+//------------------------------------------------------------------------------
+// Functions
+
+static double Random(const double min, const double max) {
+    return min + ((max - min) * ((double) rand() / (double) RAND_MAX));
+}
+
+/**
+ * @brief Returns the value of each signal at a time in ticks. The signals are
+ * linear so that interpolation is exact.
+ */
+static float Signal(const int channel, const double ticks) {
+    const double seconds = ticks / (double) TIMER_TICKS_PER_SECOND;
+    return (float) ((channel + 1) * 10.0 * seconds) - (float) channel;
+}
+
+/**
+ * @brief Generates input ticks with a drift and jitter in sample periods. A
+ * gap of gapPeriods sample periods follows input gapIndex if gapIndex is not
+ * 0.
+ */
+static void GenerateTicks(const double phase, const double drift, const double jitter, const int gapIndex, const double gapPeriods) {
+    double ticks = 1000.0 * PERIOD + (phase * PERIOD);
+    for (int index = 0; index < NUMBER_OF_INPUTS; index++) {
+        inputTicks[index] = (uint64_t) (ticks + Random(-0.5, 0.5) * jitter * PERIOD);
+        ticks += (1.0 + drift) * PERIOD;
+        if ((gapIndex != 0) && (index == gapIndex)) {
+            ticks += gapPeriods * PERIOD;
+        }
+    }
+}
+
+/**
+ * @brief Resamples the inputs in batches of random size up to
+ * RESAMPLER_MAX_NUMBER_OF_SAMPLES.
+ */
+static void Run(Outputs * const result) {
+    Resampler resampler;
+    ResamplerInitialise(&resampler, SAMPLE_RATE);
+    result->numberOfOutputs = 0;
+    int index = 0;
+    while (index < NUMBER_OF_INPUTS) {
+        IcmDataBatch batch;
+        size_t numberOfSamples = 1 + (size_t) (rand() % RESAMPLER_MAX_NUMBER_OF_SAMPLES);
+        if (numberOfSamples > (size_t) (NUMBER_OF_INPUTS - index)) {
+            numberOfSamples = (size_t) (NUMBER_OF_INPUTS - index);
+        }
+        for (size_t sample = 0; sample < numberOfSamples; sample++) {
+            const uint64_t ticks = inputTicks[index + sample];
+            batch.ticks[sample] = ticks;
+            batch.gyroscopeX[sample] = Signal(0, (double) ticks);
+            batch.gyroscopeY[sample] = Signal(1, (double) ticks);
+            batch.gyroscopeZ[sample] = Signal(2, (double) ticks);
+            batch.accelerometerX[sample] = Signal(3, (double) ticks);
+            batch.accelerometerY[sample] = Signal(4, (double) ticks);
+            batch.accelerometerZ[sample] = Signal(5, (double) ticks);
+            batch.temperature[sample] = Signal(6, (double) ticks);
+        }
+        index += (int) numberOfSamples;
+        const size_t numberOfOutputs = ResamplerUpdate(&resampler, &batch, numberOfSamples);
+        assert(numberOfOutputs <= RESAMPLER_MAX_NUMBER_OF_OUTPUTS(numberOfSamples));
+        assert(numberOfOutputs <= ICM_MAX_BATCH_SIZE);
+        for (size_t output = 0; output < numberOfOutputs; output++) {
+            assert(result->numberOfOutputs < MAX_NUMBER_OF_OUTPUTS);
+            const int outputIndex = result->numberOfOutputs++;
+            result->ticks[outputIndex] = batch.ticks[output];
+            result->values[outputIndex][0] = batch.gyroscopeX[output];
+            result->values[outputIndex][1] = batch.gyroscopeY[output];
+            result->values[outputIndex][2] = batch.gyroscopeZ[output];
+            result->values[outputIndex][3] = batch.accelerometerX[output];
+            result->values[outputIndex][4] = batch.accelerometerY[output];
+            result->values[outputIndex][5] = batch.accelerometerZ[output];
+            result->values[outputIndex][6] = batch.temperature[output];
+        }
+    }
+}
+
+/**
+ * @brief Returns the grid point number of output ticks.
+ */
+static uint64_t GridPoint(const uint64_t ticks) {
+    return (uint64_t) llround((double) ticks / PERIOD);
+}
+
+/**
+ * @brief Checks that each output is on the grid and equal to the signals at
+ * the grid point. Returns the maximum error.
+ */
+static float CheckOutputs(const Outputs * const result) {
+    float maxError = 0.0f;
+    for (int index = 0; index < result->numberOfOutputs; index++) {
+        const double gridTicks = (double) GridPoint(result->ticks[index]) * PERIOD;
+        assert(fabs((double) result->ticks[index] - gridTicks) <= 1.0);
+        for (int channel = 0; channel < 7; channel++) {
+            maxError = fmaxf(maxError, fabsf(result->values[index][channel] - Signal(channel, gridTicks)));
+        }
+    }
+    assert(maxError < TOLERANCE);
+    return maxError;
+}
+
+/**
+ * @brief Returns the number of missing grid points between consecutive
+ * outputs. Asserts that outputs are in order without duplicates.
+ */
+static int MissingGridPoints(const Outputs * const result) {
+    int missing = 0;
+    for (int index = 1; index < result->numberOfOutputs; index++) {
+        const uint64_t previous = GridPoint(result->ticks[index - 1]);
+        const uint64_t current = GridPoint(result->ticks[index]);
+        assert(current > previous);
+        missing += (int) (current - previous - 1);
+    }
+    return missing;
+}
+
+/**
+ * @brief Each grid point between the first and last input is output once
+ * with drift and jitter.
+ */
+static void TestDriftAndJitter(void) {
+    const double drifts[] = {0.0, 0.05, -0.05};
+    const double jitters[] = {0.0, 0.2};
+    for (size_t drift = 0; drift < (sizeof (drifts) / sizeof (drifts[0])); drift++) {
+        for (size_t jitter = 0; jitter < (sizeof (jitters) / sizeof (jitters[0])); jitter++) {
+            GenerateTicks(Random(0, 1), drifts[drift], jitters[jitter], 0, 0);
+            Run(&outputs);
+            const float maxError = CheckOutputs(&outputs);
+            const int missing = MissingGridPoints(&outputs);
+            const uint64_t first = GridPoint(outputs.ticks[0]);
+            const uint64_t last = GridPoint(outputs.ticks[outputs.numberOfOutputs - 1]);
+            printf("drift %+.0f%%, jitter %.0f%%: %d outputs, %d missing, max error %.6f\n", 100.0 * drifts[drift], 100.0 * jitters[jitter], outputs.numberOfOutputs, missing, maxError);
+            assert(missing == 0);
+            assert((double) (first * PERIOD) > (double) inputTicks[0]);
+            assert(((double) first - 1.0) * PERIOD < (double) inputTicks[1]);
+            assert((double) ((last + 1) * PERIOD) > (double) inputTicks[NUMBER_OF_INPUTS - 2]);
+        }
+    }
+}
+
+/**
+ * @brief Streams with different phases are resampled onto the same grid.
+ */
+static void TestSharedGrid(void) {
+    GenerateTicks(0.1, 0.01, 0.1, 0, 0);
+    Run(&outputs);
+    GenerateTicks(0.7, -0.01, 0.1, 0, 0);
+    Run(&otherOutputs);
+    int numberOfShared = 0;
+    int other = 0;
+    for (int index = 0; index < outputs.numberOfOutputs; index++) {
+        while ((other < otherOutputs.numberOfOutputs) && (otherOutputs.ticks[other] < outputs.ticks[index])) {
+            other++;
+        }
+        if ((other < otherOutputs.numberOfOutputs) && (otherOutputs.ticks[other] == outputs.ticks[index])) {
+            numberOfShared++;
+        }
+    }
+    const uint64_t first = GridPoint(outputs.ticks[0]) > GridPoint(otherOutputs.ticks[0]) ? GridPoint(outputs.ticks[0]) : GridPoint(otherOutputs.ticks[0]);
+    const uint64_t last = GridPoint(outputs.ticks[outputs.numberOfOutputs - 1]) < GridPoint(otherOutputs.ticks[otherOutputs.numberOfOutputs - 1]) ? GridPoint(outputs.ticks[outputs.numberOfOutputs - 1]) : GridPoint(otherOutputs.ticks[otherOutputs.numberOfOutputs - 1]);
+    printf("shared grid: %d of %d overlapping grid points at identical ticks\n", numberOfShared, (int) (last - first + 1));
+    assert(numberOfShared == (int) (last - first + 1));
+}
+
+/**
+ * @brief The resampler restarts after a gap in the input and does not
+ * interpolate across it.
+ */
+static void TestGap(void) {
+    const int gapIndex = NUMBER_OF_INPUTS / 2;
+    GenerateTicks(0.3, 0.0, 0.0, gapIndex, 5.0);
+    Run(&outputs);
+    CheckOutputs(&outputs);
+    const int missing = MissingGridPoints(&outputs);
+    for (int index = 0; index < outputs.numberOfOutputs; index++) {
+        assert((outputs.ticks[index] <= inputTicks[gapIndex]) || (outputs.ticks[index] > inputTicks[gapIndex + 1]));
+    }
+    printf("gap of 5 periods: %d grid points missing\n", missing);
+    assert(missing == 6);
+}
+
+/**
+ * @brief The resampler restarts if the ticks go backwards.
+ */
+static void TestBackwards(void) {
+    const int backwardsIndex = NUMBER_OF_INPUTS / 2;
+    GenerateTicks(0.3, 0.0, 0.0, 0, 0.0);
+    for (int index = backwardsIndex; index < NUMBER_OF_INPUTS; index++) {
+        inputTicks[index] -= (uint64_t) (10.0 * PERIOD);
+    }
+    Run(&outputs);
+    CheckOutputs(&outputs);
+    int numberOfBackwards = 0;
+    for (int index = 1; index < outputs.numberOfOutputs; index++) {
+        numberOfBackwards += outputs.ticks[index] <= outputs.ticks[index - 1] ? 1 : 0;
+    }
+    printf("ticks backwards: %d outputs before previous output\n", numberOfBackwards);
+    assert(numberOfBackwards == 1);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestDriftAndJitter();
+    TestSharedGrid();
+    TestGap();
+    TestBackwards();
+    printf("Resampler: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
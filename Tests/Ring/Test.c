@@ -0,0 +1,292 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the ring buffer. Covers the full and empty conditions,
+ * wraparound of contiguous reads, overflow of the free-running indices, and a
+ * producer and consumer running concurrently in separate threads. The cost of
+ * writing and reading 23-byte records is compared with that of the FIFO.
+ * Durations depend on the host and are not asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Fifo.h"
+#include <pthread.h>
+#include "Ring.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_SLOTS (8)
+#define NUMBER_OF_WRITES (100000)
+#define NUMBER_OF_RECORDS (512)
+#define BLOCK_SIZE (16)
+#define NUMBER_OF_ROUND_TRIPS (10000000)
+
+/**
+ * @brief Slot. The sequence number is written before and after the payload so
+ * that a slot read while being written is detected.
+ */
+typedef struct {
+    uint32_t first;
+    uint32_t payload[6];
+    uint32_t last;
+} Slot;
+
+/**
+ * @brief Record of the size of the ICM FIFO packet previously written to the
+ * FIFO.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint8_t registers[15];
+} __attribute__((__packed__)) Record;
+
+/**
+ * @brief Record padded and aligned as a ring slot.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint8_t registers[15];
+} __attribute__((aligned(8))) PaddedRecord;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static Slot slots[NUMBER_OF_SLOTS];
+static uint8_t fifoData[NUMBER_OF_RECORDS * sizeof (Record)];
+static PaddedRecord records[NUMBER_OF_RECORDS] __attribute__((aligned(16)));
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sleeps briefly so that the other thread may run if there is only one
+ * core.
+ */
+static void Idle(void) {
+    const struct timespec duration = {.tv_nsec = 1000};
+    nanosleep(&duration, NULL);
+}
+
+static void Write(Ring * const ring, const uint32_t value) {
+    Slot * const slot = RingWriteSlot(ring);
+    assert(slot != NULL);
+    slot->first = value;
+    slot->last = value;
+    RingWriteComplete(ring);
+}
+
+/**
+ * @brief Ring is empty after initialisation, full after writing all slots, and
+ * empty again after reading all slots.
+ */
+static void TestFullAndEmpty(const size_t initialIndex) {
+    Ring ring = {.slots = slots, .slotSize = sizeof (slots[0]), .numberOfSlots = NUMBER_OF_SLOTS, .writeIndex = initialIndex, .readIndex = initialIndex};
+    for (int lap = 0; lap < 3; lap++) {
+        assert(RingReadSlot(&ring) == NULL);
+        assert(RingAvailableRead(&ring) == 0);
+        assert(RingAvailableWrite(&ring) == NUMBER_OF_SLOTS);
+        for (uint32_t index = 0; index < NUMBER_OF_SLOTS; index++) {
+            Write(&ring, index);
+        }
+        assert(RingWriteSlot(&ring) == NULL);
+        assert(RingAvailableRead(&ring) == NUMBER_OF_SLOTS);
+        assert(RingAvailableWrite(&ring) == 0);
+        for (uint32_t index = 0; index < NUMBER_OF_SLOTS; index++) {
+            const Slot * const slot = RingReadSlot(&ring);
+            assert((slot != NULL) && (slot->first == index));
+            RingReadComplete(&ring);
+        }
+    }
+    printf("full and empty, initial index %zu: ok\n", initialIndex);
+}
+
+/**
+ * @brief Contiguous reads stop at the end of the slots and continue from the
+ * first slot.
+ */
+static void TestReadSlots(const size_t initialIndex) {
+    Ring ring = {.slots = slots, .slotSize = sizeof (slots[0]), .numberOfSlots = NUMBER_OF_SLOTS, .writeIndex = initialIndex, .readIndex = initialIndex};
+    uint32_t expected = 0;
+    uint32_t written = 0;
+    for (int iteration = 0; iteration < 1000; iteration++) {
+        const int numberOfWrites = rand() % (int) (RingAvailableWrite(&ring) + 1);
+        for (int index = 0; index < numberOfWrites; index++) {
+            Write(&ring, written++);
+        }
+        size_t numberOfSlots;
+        const Slot * const first = RingReadSlots(&ring, &numberOfSlots);
+        const size_t offset = (size_t) (first - slots);
+        assert(numberOfSlots <= RingAvailableRead(&ring));
+        assert((offset + numberOfSlots) <= NUMBER_OF_SLOTS);
+        assert((numberOfSlots == RingAvailableRead(&ring)) || ((offset + numberOfSlots) == NUMBER_OF_SLOTS)); // stops only at end of slots
+        for (size_t index = 0; index < numberOfSlots; index++) {
+            assert(first[index].first == expected++);
+        }
+        RingReadSlotsComplete(&ring, numberOfSlots);
+    }
+    printf("read slots, initial index %zu: ok\n", initialIndex);
+}
+
+/**
+ * @brief Clear discards all slots written.
+ */
+static void TestClear(void) {
+    Ring ring = {.slots = slots, .slotSize = sizeof (slots[0]), .numberOfSlots = NUMBER_OF_SLOTS};
+    Write(&ring, 0);
+    Write(&ring, 1);
+    RingClear(&ring);
+    assert(RingAvailableRead(&ring) == 0);
+    assert(RingAvailableWrite(&ring) == NUMBER_OF_SLOTS);
+    Write(&ring, 2);
+    assert(((const Slot*) RingReadSlot(&ring))->first == 2);
+    printf("clear: ok\n");
+}
+
+/**
+ * @brief Producer thread.
+ */
+static void* Producer(void* const argument) {
+    Ring * const ring = argument;
+    uint32_t value = 0;
+    while (value < NUMBER_OF_WRITES) {
+        Slot * const slot = RingWriteSlot(ring);
+        if (slot == NULL) {
+            Idle();
+            continue;
+        }
+        slot->first = value;
+        for (int index = 0; index < 6; index++) {
+            slot->payload[index] = value;
+        }
+        slot->last = value++;
+        RingWriteComplete(ring);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Producer and consumer in separate threads. The consumer alternates
+ * between single and contiguous reads and checks that every slot is read once,
+ * in order, and after it was written.
+ */
+static void TestConcurrent(const size_t initialIndex) {
+    Ring ring = {.slots = slots, .slotSize = sizeof (slots[0]), .numberOfSlots = NUMBER_OF_SLOTS, .writeIndex = initialIndex, .readIndex = initialIndex};
+    pthread_t producer;
+    pthread_create(&producer, NULL, Producer, &ring);
+    uint32_t expected = 0;
+    while (expected < NUMBER_OF_WRITES) {
+        const bool single = (expected & 1) == 0;
+        size_t numberOfSlots = 1;
+        const Slot* slot;
+        if (single) {
+            slot = RingReadSlot(&ring);
+            numberOfSlots = (slot == NULL) ? 0 : 1;
+        } else {
+            slot = RingReadSlots(&ring, &numberOfSlots);
+        }
+        if (numberOfSlots == 0) {
+            Idle();
+            continue;
+        }
+        for (size_t index = 0; index < numberOfSlots; index++) {
+            const Slot * const check = &slot[index];
+            bool valid = (check->first == expected) && (check->last == expected);
+            for (int payloadIndex = 0; payloadIndex < 6; payloadIndex++) {
+                valid = valid && (check->payload[payloadIndex] == expected);
+            }
+            if (valid == false) {
+                fprintf(stderr, "Slot %u invalid\n", expected);
+                abort();
+            }
+            expected++;
+        }
+        if (single) {
+            RingReadComplete(&ring);
+        } else {
+            RingReadSlotsComplete(&ring, numberOfSlots);
+        }
+    }
+    pthread_join(producer, NULL);
+    assert(RingAvailableRead(&ring) == 0);
+    printf("concurrent, initial index %zu: %d slots read once and in order: ok\n", initialIndex, NUMBER_OF_WRITES);
+}
+
+static double Seconds(void) {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (double) timespec.tv_sec + ((double) timespec.tv_nsec * 1e-9);
+}
+
+/**
+ * @brief Records are written and read in blocks, as ICM samples are, through
+ * the FIFO and the ring. Records written to the ring are read in place. The
+ * sum of the ticks read is the same for both.
+ */
+static void BenchmarkFifo(void) {
+    Fifo fifo = {.data = fifoData, .dataSize = sizeof (fifoData)};
+    Record record = {.registers = {1, 2, 3}};
+    uint64_t sum = 0;
+    double start = Seconds();
+    for (uint64_t block = 0; block < (NUMBER_OF_ROUND_TRIPS / BLOCK_SIZE); block++) {
+        for (int index = 0; index < BLOCK_SIZE; index++) {
+            record.ticks = (block * BLOCK_SIZE) + index;
+            assert(FifoWrite(&fifo, &record, sizeof (record)) == FifoResultOk);
+        }
+        for (int index = 0; index < BLOCK_SIZE; index++) {
+            Record read;
+            assert(FifoRead(&fifo, &read, sizeof (read)) == sizeof (read));
+            sum += read.ticks + read.registers[2];
+        }
+    }
+    const double fifoDuration = Seconds() - start;
+    const uint64_t fifoSum = sum;
+    Ring ring = {.slots = records, .slotSize = sizeof (records[0]), .numberOfSlots = NUMBER_OF_RECORDS};
+    sum = 0;
+    start = Seconds();
+    for (uint64_t block = 0; block < (NUMBER_OF_ROUND_TRIPS / BLOCK_SIZE); block++) {
+        for (int index = 0; index < BLOCK_SIZE; index++) {
+            PaddedRecord * const slot = RingWriteSlot(&ring);
+            assert(slot != NULL);
+            slot->ticks = (block * BLOCK_SIZE) + index;
+            memcpy(slot->registers, record.registers, sizeof (slot->registers));
+            RingWriteComplete(&ring);
+        }
+        for (int index = 0; index < BLOCK_SIZE; index++) {
+            const PaddedRecord * const slot = RingReadSlot(&ring);
+            assert(slot != NULL);
+            sum += slot->ticks + slot->registers[2];
+            RingReadComplete(&ring);
+        }
+    }
+    const double ringDuration = Seconds() - start;
+    assert(sum == fifoSum);
+    printf("benchmark: %d records of %zu bytes, FIFO %.1f ns, ring %.1f ns per write and read, ratio %.2f\n", NUMBER_OF_ROUND_TRIPS, sizeof (Record), fifoDuration * 1e9 / NUMBER_OF_ROUND_TRIPS, ringDuration * 1e9 / NUMBER_OF_ROUND_TRIPS, fifoDuration / ringDuration);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    const size_t overflowIndex = SIZE_MAX - 3; // indices overflow during test
+    TestFullAndEmpty(0);
+    TestFullAndEmpty(overflowIndex);
+    TestReadSlots(0);
+    TestReadSlots(overflowIndex);
+    TestClear();
+    TestConcurrent(0);
+    TestConcurrent(overflowIndex);
+    BenchmarkFifo();
+    printf("Ring: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,313 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Deterministic host simulation of the main loop scheduler. Time is
+ * simulated and each task advances the time by a synthetic runtime. Samples
+ * arrive for each IMU at the sample rate and the IMU task processes samples at
+ * a fixed cost per sample. Commands arrive at pseudo-random times. The
+ * simulation reports the worst-case ICM buffer count and the worst-case
+ * command latency for each scenario.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "definitions.h"
+#include "Imu/Icm/Icm.h"
+#include "Imu/Imu.h"
+#include "Profile/Profile.h"
+#include "Scheduler/Scheduler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define TICKS_PER_MICROSECOND (TIMER_TICKS_PER_SECOND / 1000000U)
+#define DURATION (5) // seconds
+#define BATCH_OVERHEAD (2 * TICKS_PER_MICROSECOND) // per batch of ICM_MAX_BATCH_SIZE samples
+#define INTERRUPT_LOAD (0.1) // fraction of time spent in interrupts
+#define COMMAND_INTERVAL (10000 * TICKS_PER_MICROSECOND) // mean
+#define STALL_INTERVAL (TIMER_TICKS_PER_SECOND)
+
+/**
+ * @brief Scenario.
+ */
+typedef struct {
+    const char* name;
+    uint32_t sampleRate; // samples per second for each IMU
+    double load; // fraction of time required to process all samples
+    uint32_t stall; // microseconds, duration of apply task once per second
+} Scenario;
+
+/**
+ * @brief Simulated ICM buffer.
+ */
+typedef struct {
+    uint64_t period; // ticks
+    uint64_t nextSampleTicks;
+    size_t count;
+    uint32_t overflow;
+} Buffer;
+
+/**
+ * @brief Result.
+ */
+typedef struct {
+    size_t maxBufferCount;
+    uint32_t overflow;
+    uint64_t maxIterationTicks;
+    uint64_t maxCommandLatency;
+    size_t maxBudget;
+} Result;
+
+//------------------------------------------------------------------------------
+// Variables
+
+Icm icms[ICM_NUMBER_OF_ICMS];
+
+#define IMU(n) {.icm = &icms[n]}
+static Imu imuStructures[IMU_NUMBER_OF_IMUS] = {
+    IMU(0), IMU(1), IMU(2), IMU(3), IMU(4), IMU(5), IMU(6), IMU(7), IMU(8), IMU(9),
+    IMU(10), IMU(11), IMU(12), IMU(13), IMU(14), IMU(15), IMU(16), IMU(17), IMU(18), IMU(19),
+};
+#define IMU_POINTER(n) &imuStructures[n]
+Imu * const imus[IMU_NUMBER_OF_IMUS] = {
+    IMU_POINTER(0), IMU_POINTER(1), IMU_POINTER(2), IMU_POINTER(3), IMU_POINTER(4), IMU_POINTER(5), IMU_POINTER(6), IMU_POINTER(7), IMU_POINTER(8), IMU_POINTER(9),
+    IMU_POINTER(10), IMU_POINTER(11), IMU_POINTER(12), IMU_POINTER(13), IMU_POINTER(14), IMU_POINTER(15), IMU_POINTER(16), IMU_POINTER(17), IMU_POINTER(18), IMU_POINTER(19),
+};
+
+static uint64_t ticks;
+static Buffer buffers[ICM_NUMBER_OF_ICMS];
+static uint64_t sampleCost; // ticks
+static uint64_t stallTicks;
+static uint64_t nextStallTicks;
+static uint64_t nextCommandTicks;
+static uint64_t maxCommandLatency;
+
+//------------------------------------------------------------------------------
+// Functions - simulation
+
+/**
+ * @brief Advances the simulated time by a main loop runtime. The time is
+ * extended by the time spent in interrupts. Samples that arrive when the
+ * buffer is full are lost.
+ * @param runtime Main loop runtime in ticks.
+ */
+static void Advance(const uint64_t runtime) {
+    ticks += (uint64_t) ((double) runtime / (1.0 - INTERRUPT_LOAD));
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        Buffer * const buffer = &buffers[index];
+        while (buffer->nextSampleTicks <= ticks) {
+            buffer->nextSampleTicks += buffer->period;
+            if (buffer->count == ICM_NUMBER_OF_SAMPLES) {
+                buffer->overflow++;
+            } else {
+                buffer->count++;
+            }
+        }
+    }
+}
+
+uint32_t TimerGetTicks32(void) {
+    return (uint32_t) ticks;
+}
+
+uint64_t TimerGetTicks64(void) {
+    return ticks;
+}
+
+void ProfileAdd(const ProfileProbe probe, const uint32_t duration) {
+}
+
+void SYS_Tasks(void) {
+    Advance(2 * TICKS_PER_MICROSECOND);
+}
+
+void IcmTasks(Icm * const icm) {
+    Advance(TICKS_PER_MICROSECOND / 5);
+}
+
+size_t IcmBufferCount(Icm * const icm) {
+    return buffers[icm - icms].count;
+}
+
+/**
+ * @brief Processes up to the budget of samples for each IMU in batches of
+ * ICM_MAX_BATCH_SIZE, as ImuBatchTasks.
+ */
+void ImuBatchTasks(const size_t * const budgets) {
+    size_t remaining[IMU_NUMBER_OF_IMUS];
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        remaining[index] = budgets[index];
+    }
+    while (true) {
+        size_t total = 0;
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            Buffer * const buffer = &buffers[imus[index]->icm - icms];
+            size_t numberOfSamples = buffer->count < ICM_MAX_BATCH_SIZE ? buffer->count : ICM_MAX_BATCH_SIZE;
+            if (numberOfSamples > remaining[index]) {
+                numberOfSamples = remaining[index];
+            }
+            buffer->count -= numberOfSamples;
+            remaining[index] -= numberOfSamples;
+            total += numberOfSamples;
+        }
+        if (total == 0) {
+            return;
+        }
+        Advance(BATCH_OVERHEAD + (total * sampleCost));
+    }
+}
+
+void NotificationTasks(void) {
+    Advance(TICKS_PER_MICROSECOND);
+}
+
+void BackpressureTasks(void) {
+    Advance(TICKS_PER_MICROSECOND);
+}
+
+void UsbCdcTasks(void) {
+    Advance(5 * TICKS_PER_MICROSECOND);
+}
+
+/**
+ * @brief Parses commands. The latency of a command is the time from when it
+ * arrives to when it has been parsed.
+ */
+void Ximu3DeviceCommandTasks(void) {
+    Advance(TICKS_PER_MICROSECOND);
+    if (ticks < nextCommandTicks) {
+        return;
+    }
+    Advance(100 * TICKS_PER_MICROSECOND);
+    const uint64_t latency = ticks - nextCommandTicks;
+    if (latency > maxCommandLatency) {
+        maxCommandLatency = latency;
+    }
+    nextCommandTicks = ticks + (uint64_t) (rand() % (2 * COMMAND_INTERVAL));
+}
+
+/**
+ * @brief Applies settings. Stalls once per second to simulate a long-running
+ * task such as a flash write.
+ */
+void Ximu3DeviceApplyTasks(void) {
+    Advance(TICKS_PER_MICROSECOND);
+    if ((stallTicks > 0) && (ticks >= nextStallTicks)) {
+        Advance(stallTicks);
+        nextStallTicks += STALL_INTERVAL;
+    }
+}
+
+/**
+ * @brief Runs a scenario.
+ */
+static Result Run(const Scenario * const scenario) {
+    srand(1);
+    ticks = 0;
+    const uint64_t period = TIMER_TICKS_PER_SECOND / scenario->sampleRate;
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        buffers[index] = (Buffer){.period = period, .nextSampleTicks = ((uint64_t) index * period) / ICM_NUMBER_OF_ICMS};
+    }
+    sampleCost = (uint64_t) ((scenario->load * (1.0 - INTERRUPT_LOAD) * TIMER_TICKS_PER_SECOND) / ((double) scenario->sampleRate * IMU_NUMBER_OF_IMUS));
+    stallTicks = (uint64_t) scenario->stall * TICKS_PER_MICROSECOND;
+    nextStallTicks = TIMER_TICKS_PER_SECOND / 2;
+    nextCommandTicks = COMMAND_INTERVAL;
+    maxCommandLatency = 0;
+
+    // Settle then reset statistics
+    while (ticks < (TIMER_TICKS_PER_SECOND / 10)) {
+        SchedulerTasks();
+    }
+    SchedulerResetStatistics();
+    maxCommandLatency = 0;
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        buffers[index].overflow = 0;
+    }
+
+    // Run
+    Result result = {0};
+    while (ticks < ((uint64_t) DURATION * TIMER_TICKS_PER_SECOND)) {
+        SchedulerTasks();
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            const size_t budget = SchedulerGetImuStatistics(index)->budget;
+            result.maxBudget = budget > result.maxBudget ? budget : result.maxBudget;
+        }
+    }
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        const size_t maxBufferCount = SchedulerGetImuStatistics(index)->maxBufferCount;
+        result.maxBufferCount = maxBufferCount > result.maxBufferCount ? maxBufferCount : result.maxBufferCount;
+        result.overflow += buffers[index].overflow;
+    }
+    result.maxIterationTicks = SchedulerGetMaxIterationTicks();
+    result.maxCommandLatency = maxCommandLatency;
+    printf("%-32s sample cost %5.2f us, max buffer count %3zu, overflow %6u, max budget %3zu, max iteration %6.2f ms, max command latency %6.2f ms\n",
+           scenario->name,
+           (double) sampleCost / TICKS_PER_MICROSECOND,
+           result.maxBufferCount,
+           result.overflow,
+           result.maxBudget,
+           (double) result.maxIterationTicks / (1000 * TICKS_PER_MICROSECOND),
+           (double) result.maxCommandLatency / (1000 * TICKS_PER_MICROSECOND));
+    return result;
+}
+
+/**
+ * @brief Returns the maximum iteration time with every IMU budget at the
+ * maximum. This is the bound on command latency when the IMU task is
+ * backlogged.
+ */
+static double MaxBudgetIterationMilliseconds(void) {
+    const double imuTicks = (double) IMU_NUMBER_OF_IMUS * SCHEDULER_MAX_IMU_BUDGET * sampleCost;
+    return imuTicks / (1.0 - INTERRUPT_LOAD) / (1000 * TICKS_PER_MICROSECOND);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    printf("budget %d to %d samples, high-water mark %d of %d samples\n", SCHEDULER_MIN_IMU_BUDGET, SCHEDULER_MAX_IMU_BUDGET, SCHEDULER_HIGH_WATER_MARK, ICM_NUMBER_OF_SAMPLES);
+
+    // Steady load. The IMU task keeps up and so the buffer count and command latency remain low.
+    const Scenario steady[] = {
+        {.name = "1 kHz, 30% load", .sampleRate = 1000, .load = 0.3},
+        {.name = "1 kHz, 90% load", .sampleRate = 1000, .load = 0.9},
+        {.name = "8 kHz, 30% load", .sampleRate = 8000, .load = 0.3},
+        {.name = "8 kHz, 90% load", .sampleRate = 8000, .load = 0.9},
+    };
+    for (size_t index = 0; index < (sizeof (steady) / sizeof (steady[0])); index++) {
+        const Result result = Run(&steady[index]);
+        assert(result.overflow == 0);
+        assert(result.maxBufferCount <= SCHEDULER_HIGH_WATER_MARK);
+        assert(result.maxCommandLatency < (2 * 1000 * TICKS_PER_MICROSECOND));
+    }
+
+    // 20 ms stall once per second. The backlog exceeds the high-water mark at 8 kHz and the budget increases to recover.
+    const Scenario stall[] = {
+        {.name = "1 kHz, 90% load, 20 ms stall", .sampleRate = 1000, .load = 0.9, .stall = 20000},
+        {.name = "8 kHz, 30% load, 20 ms stall", .sampleRate = 8000, .load = 0.3, .stall = 20000},
+        {.name = "8 kHz, 90% load, 20 ms stall", .sampleRate = 8000, .load = 0.9, .stall = 20000},
+    };
+    for (size_t index = 0; index < (sizeof (stall) / sizeof (stall[0])); index++) {
+        const Result result = Run(&stall[index]);
+        assert(result.overflow == 0);
+        assert(result.maxBufferCount < ICM_NUMBER_OF_SAMPLES);
+        assert(((double) result.maxCommandLatency / (1000 * TICKS_PER_MICROSECOND)) < (20.0 + MaxBudgetIterationMilliseconds() + 1.0));
+    }
+
+    // Overload. Samples are lost but the maximum budget bounds the command latency.
+    const Scenario overload = {.name = "8 kHz, 120% load", .sampleRate = 8000, .load = 1.2};
+    const Result result = Run(&overload);
+    assert(result.overflow > 0);
+    assert(result.maxBudget == SCHEDULER_MAX_IMU_BUDGET);
+    printf("max budget iteration %.2f ms\n", MaxBudgetIterationMilliseconds());
+    assert(((double) result.maxCommandLatency / (1000 * TICKS_PER_MICROSECOND)) < (MaxBudgetIterationMilliseconds() + 1.0));
+
+    printf("Scheduler: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,245 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host benchmark of inertial messages through Send, Mux and the USB
+ * write buffer. Messages are sent with the reserve and commit functions, as
+ * Send does, and with the write path that preceded them, in which each message
+ * is encoded into a local buffer and the mux header and message are written
+ * with two FifoWrite calls. The write buffer is drained in transfers of
+ * USB_CDC_WRITE_TRANSFER_SIZE bytes, as by UsbCdcTasks. The streams are
+ * compared and the messages per second printed. Durations depend on the host
+ * and are not asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Config.h"
+#include <math.h>
+#include "PriorityFifo.h"
+#include "Profile/Profile.h"
+#include "Send/Send.h"
+#include "Serial/Serial.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Timer/Timer.h"
+#include "Timestamp/Timestamp.h"
+#include "Usb/UsbCdc.h"
+#include "Ximu3Device/x-IMU3-Device/Ximu3.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_SAMPLES (1024)
+#define NUMBER_OF_MESSAGES (1000000)
+#define NUMBER_OF_COMPARED_MESSAGES (100000)
+#define STREAM_SIZE (NUMBER_OF_COMPARED_MESSAGES * (XIMU3_SIZE_MUX_HEADER + XIMU3_SIZE_INERTIAL))
+
+//------------------------------------------------------------------------------
+// Variables
+
+Led ledMain, ledA, ledB, ledC, ledD, ledE, ledF, ledG, ledH, ledI, ledJ, ledK, ledL, ledM, ledN, ledO, ledP, ledQ, ledR, ledS, ledT;
+const LedColour ledColourRed;
+
+static uint8_t writeData[USB_CDC_WRITE_BUFFER_SIZE];
+static uint8_t mediumPriorityWriteData[USB_CDC_MEDIUM_PRIORITY_WRITE_BUFFER_SIZE];
+static uint8_t highPriorityWriteData[USB_CDC_HIGH_PRIORITY_WRITE_BUFFER_SIZE];
+static PriorityFifo writeFifo = {.fifos = {
+    {.data = writeData, .dataSize = sizeof (writeData)},
+    {.data = mediumPriorityWriteData, .dataSize = sizeof (mediumPriorityWriteData)},
+    {.data = highPriorityWriteData, .dataSize = sizeof (highPriorityWriteData)},
+}};
+static uint8_t transfer[USB_CDC_WRITE_TRANSFER_SIZE];
+
+static SendInertialData samples[NUMBER_OF_SAMPLES];
+static uint8_t streams[2][STREAM_SIZE];
+static uint8_t* stream;
+static size_t streamSize;
+
+//------------------------------------------------------------------------------
+// Functions - Stand-ins
+
+uint64_t TimerGetTicks64(void) {
+    return 0;
+}
+
+LedResult LedBlink(Led * const led, const LedColour colour) {
+    return LedResultOk;
+}
+
+bool UsbCdcPortOpen(void) {
+    return true;
+}
+
+size_t UsbCdcAvailableWrite(const PriorityFifoPriority priority) {
+    return PriorityFifoAvailableWrite(&writeFifo, priority);
+}
+
+FifoResult UsbCdcWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    return PriorityFifoWrite(&writeFifo, priority, data, numberOfBytes);
+}
+
+FifoResult UsbCdcReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return PriorityFifoReserve(&writeFifo, priority, numberOfBytes, reservation);
+}
+
+void UsbCdcCommit(const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    PriorityFifoCommit(&writeFifo, priority, numberOfBytes);
+}
+
+bool SerialEnabled(void) {
+    return false;
+}
+
+size_t SerialAvailableWrite(const PriorityFifoPriority priority) {
+    return 0;
+}
+
+FifoResult SerialReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return FifoResultError;
+}
+
+void SerialCommit(const PriorityFifoPriority priority, const size_t numberOfBytes) {
+}
+
+//------------------------------------------------------------------------------
+// Functions - Benchmark
+
+static double Seconds(void) {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (double) timespec.tv_sec + ((double) timespec.tv_nsec * 1e-9);
+}
+
+static float Random(const float min, const float max) {
+    return min + ((max - min) * ((float) rand() / (float) RAND_MAX));
+}
+
+/**
+ * @brief Drains the low-priority write buffer in transfers while the number
+ * of bytes available is at least the threshold. Transfers are appended to the stream if the stream is not full.
+ */
+static void Drain(const size_t threshold) {
+    while (FifoAvailableRead(&writeFifo.fifos[PriorityFifoPriorityLow]) >= threshold) {
+        const size_t numberOfBytes = PriorityFifoRead(&writeFifo, transfer, sizeof (transfer));
+        if (numberOfBytes == 0) {
+            return;
+        }
+        if ((stream != NULL) && ((streamSize + numberOfBytes) <= STREAM_SIZE)) {
+            memcpy(&stream[streamSize], transfer, numberOfBytes);
+            streamSize += numberOfBytes;
+        }
+    }
+}
+
+/**
+ * @brief Sends an inertial message with the write path that preceded the
+ * reserve and commit functions. The message is profiled as by SendInertial,
+ * encoded into a local buffer, and the mux header and message are written
+ * separately.
+ */
+static void SendInertialCopy(Send * const send, const SendInertialData * const inertialData) {
+    PROFILE(ProfileProbeSendInertial);
+    const Ximu3DataInertial ximu3Data = {
+        .timestamp = TimestampFrom(inertialData->ticks),
+        .gyroscopeX = inertialData->gyroscope.axis.x,
+        .gyroscopeY = inertialData->gyroscope.axis.y,
+        .gyroscopeZ = inertialData->gyroscope.axis.z,
+        .accelerometerX = inertialData->accelerometer.axis.x,
+        .accelerometerY = inertialData->accelerometer.axis.y,
+        .accelerometerZ = inertialData->accelerometer.axis.z,
+    };
+    uint8_t message[XIMU3_SIZE_INERTIAL];
+    size_t messageSize;
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryInertial(message, sizeof (message), &ximu3Data);
+    } else {
+        messageSize = Ximu3AsciiInertial(message, sizeof (message), &ximu3Data);
+    }
+    if ((UsbCdcPortOpen() == false) || (MuxUsbAvailableWrite(send->channel, PriorityFifoPriorityLow) <= messageSize)) {
+        send->usbBufferOverflow += messageSize;
+        return;
+    }
+    const uint8_t header[XIMU3_SIZE_MUX_HEADER] = {'^', MuxChannelToByte(send->channel)};
+    UsbCdcWrite(PriorityFifoPriorityLow, header, sizeof (header));
+    UsbCdcWrite(PriorityFifoPriorityLow, message, messageSize);
+}
+
+/**
+ * @brief Sends messages from all channels in turn and returns the messages per
+ * second.
+ */
+static double Run(const SendDataMessageMode mode, const bool copy, const int numberOfMessages) {
+    Send * const sends[] = {&sendA, &sendB, &sendC, &sendD, &sendE, &sendF, &sendG, &sendH, &sendI, &sendJ, &sendK, &sendL, &sendM, &sendN, &sendO, &sendP, &sendQ, &sendR, &sendS, &sendT};
+    const int numberOfSends = sizeof (sends) / sizeof (sends[0]);
+    const SendSettings settings = {
+        .dataMessageMode = mode,
+        .inertialMessageRateDivisor = 1,
+        .usbSendMode = SendInterfaceModeNonBlocking,
+        .serialSendMode = SendInterfaceModeDisabled,
+    };
+    for (int index = 0; index < numberOfSends; index++) {
+        SendSetSettings(sends[index], &settings);
+    }
+    PriorityFifoClear(&writeFifo);
+    const double start = Seconds();
+    for (int message = 0; message < numberOfMessages; message++) {
+        Send * const send = sends[message % numberOfSends];
+        const SendInertialData * const sample = &samples[message % NUMBER_OF_SAMPLES];
+        if (copy) {
+            SendInertialCopy(send, sample);
+        } else {
+            SendInertial(send, sample);
+        }
+        Drain(USB_CDC_WRITE_TRANSFER_SIZE);
+    }
+    Drain(1);
+    const double duration = Seconds() - start;
+    for (int index = 0; index < numberOfSends; index++) {
+        assert(SendUsbBufferOverflow(sends[index]) == 0);
+    }
+    return (double) numberOfMessages / duration;
+}
+
+/**
+ * @brief Both write paths write the same stream, which is compared before the
+ * messages per second of each are measured.
+ */
+static void BenchmarkReserve(const SendDataMessageMode mode, const char* const name) {
+    size_t streamSizes[2];
+    for (int copy = 0; copy < 2; copy++) {
+        stream = streams[copy];
+        streamSize = 0;
+        Run(mode, copy == 1, NUMBER_OF_COMPARED_MESSAGES);
+        streamSizes[copy] = streamSize;
+    }
+    stream = NULL;
+    assert((streamSizes[0] > 0) && (streamSizes[0] == streamSizes[1]));
+    assert(memcmp(streams[0], streams[1], streamSizes[0]) == 0);
+    const double reserve = Run(mode, false, NUMBER_OF_MESSAGES);
+    const double copy = Run(mode, true, NUMBER_OF_MESSAGES);
+    printf("%s: %d messages, reserve and commit %.2f M messages/s, write %.2f M messages/s, ratio %.2f\n", name, NUMBER_OF_MESSAGES, reserve * 1e-6, copy * 1e-6, reserve / copy);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    for (int index = 0; index < NUMBER_OF_SAMPLES; index++) {
+        samples[index] = (SendInertialData){
+            .ticks = (uint64_t) index * (TIMER_TICKS_PER_SECOND / 1000),
+            .gyroscope = {.axis = {.x = Random(-2000, 2000), .y = Random(-2000, 2000), .z = Random(-2000, 2000)}},
+            .accelerometer = {.axis = {.x = Random(-16, 16), .y = Random(-16, 16), .z = Random(-16, 16)}},
+        };
+    }
+    BenchmarkReserve(SendDataMessageModeBinary, "binary");
+    BenchmarkReserve(SendDataMessageModeAscii, "ascii");
+    printf("Send: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,14 @@
+/**
+ * @file Config.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the library configuration. The CS pin is active
+ * low as in the firmware.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,279 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the SPI driver used by each ICM bus. A model of the SPI
+ * shifts one byte per byte time from the 16-byte TX FIFO while the FIFO is not
+ * empty, and a model of the RX DMA channel writes each received byte to the
+ * transfer data. The TX interrupt is pending while the TX FIFO is half empty
+ * or more and is serviced after a latency in byte times. The number of TX
+ * interrupts of each ICM transfer is counted and asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Config.h"
+#include "definitions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Spi/Spi3Dma.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define TX_FIFO_SIZE (16)
+#define CS_PIN ((GPIO_PIN) 0)
+#define FIFO_PACKET_SIZE (16)
+#define FIFO_PACKET_HEADER_SIZE (3)
+#define MAX_FIFO_WATERMARK (16)
+#define MAX_TRANSFER_SIZE (FIFO_PACKET_HEADER_SIZE + (MAX_FIFO_WATERMARK * FIFO_PACKET_SIZE))
+#define SAMPLE_TRANSFER_SIZE (15)
+#define CLOCK_FREQUENCY (14000000)
+#define NUMBER_OF_ICMS_PER_BUS (4)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void Spi3TxInterruptHandler(void);
+void Dma3InterruptHandler(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+MockSpixCon mockSpi3Con;
+uint32_t mockSpi3Con2;
+MockSpixStat mockSpi3Stat;
+uint32_t mockSpi3Brg;
+uint32_t mockSpi3Buf = MOCK_SPI_BUF_EMPTY;
+MockDmaCon mockDmaCon;
+MockDch mockDch3;
+
+static uint8_t txFifo[TX_FIFO_SIZE];
+static int txFifoCount;
+static bool spi3TxEnabled;
+static bool dma3Enabled;
+static bool csActive;
+static bool complete;
+
+//------------------------------------------------------------------------------
+// Functions - Harmony
+
+void GPIO_PinSet(GPIO_PIN pin) {
+    assert(pin == CS_PIN);
+    csActive = false;
+}
+
+void GPIO_PinClear(GPIO_PIN pin) {
+    assert(pin == CS_PIN);
+    csActive = true;
+}
+
+void EVIC_SourceEnable(INT_SOURCE source) {
+    if (source == INT_SOURCE_SPI3_TX) {
+        spi3TxEnabled = true;
+    }
+    if (source == INT_SOURCE_DMA3) {
+        dma3Enabled = true;
+    }
+}
+
+void EVIC_SourceDisable(INT_SOURCE source) {
+    if (source == INT_SOURCE_SPI3_TX) {
+        spi3TxEnabled = false;
+    }
+    if (source == INT_SOURCE_DMA3) {
+        dma3Enabled = false;
+    }
+}
+
+void EVIC_SourceStatusClear(INT_SOURCE source) {
+}
+
+uint32_t SpiCalculateSpixbrg(const uint32_t clockFrequency) {
+    return clockFrequency;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Model
+
+/**
+ * @brief Moves a byte written to SPI3BUF to the TX FIFO.
+ */
+static void WriteTxFifo(void) {
+    if (mockSpi3Buf == MOCK_SPI_BUF_EMPTY) {
+        return;
+    }
+    assert(txFifoCount < TX_FIFO_SIZE);
+    txFifo[txFifoCount++] = (uint8_t) mockSpi3Buf;
+    mockSpi3Buf = MOCK_SPI_BUF_EMPTY;
+}
+
+/**
+ * @brief Returns the SPI status register after moving a byte written to
+ * SPI3BUF to the TX FIFO.
+ */
+MockSpixStat * MockSpi3StatBits(void) {
+    WriteTxFifo();
+    mockSpi3Stat.SPITBF = txFifoCount == TX_FIFO_SIZE;
+    return &mockSpi3Stat;
+}
+
+/**
+ * @brief Transfer complete callback.
+ */
+static void TransferComplete(void) {
+    assert(csActive == false);
+    assert(Spi3DmaTransferInProgress() == false);
+    complete = true;
+}
+
+/**
+ * @brief Shifts one byte from the TX FIFO. The device responds with the
+ * complement of each byte and the RX DMA channel writes the byte to the
+ * transfer data. Returns false if the TX FIFO is empty.
+ */
+static bool Shift(void) {
+    WriteTxFifo();
+    if (txFifoCount == 0) {
+        return false;
+    }
+    assert(csActive);
+    const uint8_t byte = txFifo[0];
+    txFifoCount--;
+    memmove(&txFifo[0], &txFifo[1], (size_t) txFifoCount);
+    assert((mockDch3.con.CHEN == 1) && (mockDch3.econ.SIRQEN == 1) && (mockDch3.econ.CHSIRQ == _SPI3_RX_IRQ));
+    assert((mockDch3.ssa == (uintptr_t) &mockSpi3Buf) && (mockDch3.ssiz == 1) && (mockDch3.csiz == 1));
+    ((uint8_t*) mockDch3.dsa)[mockDch3.dptr++] = (uint8_t) ~byte;
+    if (mockDch3.dptr == mockDch3.dsiz) {
+        mockDch3.con.CHEN = 0;
+        mockDch3.interrupt.CHBCIF = 1;
+        mockDch3.dptr = 0;
+        if (dma3Enabled && (mockDch3.interrupt.CHBCIE == 1)) {
+            Dma3InterruptHandler();
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Initialises the SPI.
+ */
+static void Initialise(void) {
+    Spi3DmaInitialise(&(SpiSettings) {.clockFrequency = CLOCK_FREQUENCY});
+    assert((mockSpi3Con.ON == 1) && (mockSpi3Con.MSTEN == 1) && (mockSpi3Con.ENHBUF == 1));
+    assert(mockSpi3Con.STXISEL == 0b10);
+    assert(dma3Enabled && (spi3TxEnabled == false));
+}
+
+/**
+ * @brief Transfers random data with a TX interrupt latency in byte times and
+ * asserts that the received data is that of the device. Returns the number of
+ * TX interrupts. The number of byte times that the bus is idle because the TX
+ * FIFO is empty is written to idle.
+ */
+static int Transfer(const size_t numberOfBytes, const int latency, int * const idle) {
+    uint8_t data[MAX_TRANSFER_SIZE];
+    uint8_t txData[MAX_TRANSFER_SIZE];
+    for (size_t index = 0; index < numberOfBytes; index++) {
+        txData[index] = (uint8_t) rand();
+    }
+    memcpy(data, txData, numberOfBytes);
+    complete = false;
+    Spi3DmaTransfer(CS_PIN, data, numberOfBytes, TransferComplete);
+    assert(Spi3DmaTransferInProgress());
+    int numberOfInterrupts = 0;
+    int pending = 0;
+    *idle = 0;
+    while (complete == false) {
+        if (Shift() == false) {
+            (*idle)++;
+        }
+        if (spi3TxEnabled && (txFifoCount <= (TX_FIFO_SIZE / 2))) {
+            if (pending++ >= latency) {
+                Spi3TxInterruptHandler();
+                numberOfInterrupts++;
+                pending = 0;
+            }
+        } else {
+            pending = 0;
+        }
+    }
+    assert((spi3TxEnabled == false) && (txFifoCount == 0) && (mockSpi3Buf == MOCK_SPI_BUF_EMPTY));
+    for (size_t index = 0; index < numberOfBytes; index++) {
+        assert((data[index] ^ txData[index]) == 0xFF);
+    }
+    return numberOfInterrupts;
+}
+
+/**
+ * @brief Returns the number of TX interrupts of a transfer. The TX FIFO is
+ * filled when the transfer begins and each interrupt writes half the FIFO.
+ */
+static int ExpectedInterrupts(const size_t numberOfBytes) {
+    if (numberOfBytes <= TX_FIFO_SIZE) {
+        return 0;
+    }
+    return (int) ((numberOfBytes - TX_FIFO_SIZE + (TX_FIFO_SIZE / 2) - 1) / (TX_FIFO_SIZE / 2));
+}
+
+//------------------------------------------------------------------------------
+// Functions - Tests
+
+/**
+ * @brief Transfers of every size up to the largest ICM FIFO read are received
+ * in order. The bus is never idle for TX interrupt latencies of less than half
+ * the FIFO, and an interrupt serviced late writes more of the FIFO. The data is
+ * intact for longer latencies.
+ */
+static void TestTransfers(void) {
+    for (int latency = 0; latency <= TX_FIFO_SIZE; latency++) {
+        for (size_t numberOfBytes = 1; numberOfBytes <= MAX_TRANSFER_SIZE; numberOfBytes++) {
+            int idle;
+            const int numberOfInterrupts = Transfer(numberOfBytes, latency, &idle);
+            if (latency == 0) {
+                assert(numberOfInterrupts == ExpectedInterrupts(numberOfBytes));
+            }
+            if (latency < (TX_FIFO_SIZE / 2)) {
+                assert(idle == 0);
+                assert(numberOfInterrupts <= ExpectedInterrupts(numberOfBytes));
+            }
+        }
+    }
+    printf("transfers: 1 to %d bytes, TX interrupt latency 0 to %d byte times: ok\n", MAX_TRANSFER_SIZE, TX_FIFO_SIZE);
+}
+
+/**
+ * @brief Prints the TX interrupts of the ICM transfers. A sample read fits
+ * the TX FIFO. The interrupt rate of FIFO reads is printed for four ICMs per
+ * bus at 1 kHz and at the capacity of the bus.
+ */
+static void TestIcmTransfers(void) {
+    int idle;
+    assert(Transfer(SAMPLE_TRANSFER_SIZE, 0, &idle) == 0);
+    printf("ICM sample read: %d bytes, 0 TX interrupts\n", SAMPLE_TRANSFER_SIZE);
+    const int watermarks[] = {1, 4, 16};
+    for (size_t index = 0; index < (sizeof (watermarks) / sizeof (watermarks[0])); index++) {
+        const size_t numberOfBytes = FIFO_PACKET_HEADER_SIZE + ((size_t) watermarks[index] * FIFO_PACKET_SIZE);
+        const int numberOfInterrupts = Transfer(numberOfBytes, 0, &idle);
+        assert(numberOfInterrupts == ExpectedInterrupts(numberOfBytes));
+        const double perSample = (double) numberOfInterrupts / watermarks[index];
+        const double atCapacity = ((double) CLOCK_FREQUENCY / 8) / numberOfBytes * numberOfInterrupts;
+        printf("ICM FIFO read of %d packets: %zu bytes, %d TX interrupts, %.2f per sample, %.0f per second per bus at %d x 1 kHz, %.0f at %d MHz bus capacity\n",
+               watermarks[index], numberOfBytes, numberOfInterrupts, perSample, perSample * NUMBER_OF_ICMS_PER_BUS * 1000, NUMBER_OF_ICMS_PER_BUS, atCapacity, CLOCK_FREQUENCY / 1000000);
+    }
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    Initialise();
+    TestTransfers();
+    TestIcmTransfers();
+    printf("Spi3Dma: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
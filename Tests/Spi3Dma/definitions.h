@@ -0,0 +1,179 @@
+/**
+ * @file definitions.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the Harmony definitions and the SPI3 and DMA
+ * registers used by Spi3Dma.c. SPI3STATbits is read through a function so
+ * that a byte written to SPI3BUF is moved to the model of the TX FIFO before
+ * the buffer full flag is read. The test models the SPI and the DMA channel.
+ */
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define _SPI3_RX_IRQ (155)
+
+#define GPIO_PIN_NONE ((GPIO_PIN) (-1))
+
+#define MOCK_SPI_BUF_EMPTY (UINT32_MAX)
+
+#define SPI3CON mockSpi3Con.w
+#define SPI3CONbits mockSpi3Con
+#define SPI3CON2 mockSpi3Con2
+#define SPI3STAT mockSpi3Stat.w
+#define SPI3STATbits (*MockSpi3StatBits())
+#define SPI3BRG mockSpi3Brg
+#define SPI3BUF mockSpi3Buf
+
+#define DMACONbits mockDmaCon
+
+#define DCH3CON mockDch3.con.w
+#define DCH3CONbits mockDch3.con
+#define DCH3ECON mockDch3.econ.w
+#define DCH3ECONbits mockDch3.econ
+#define DCH3INT mockDch3.interrupt.w
+#define DCH3INTbits mockDch3.interrupt
+#define DCH3SSA mockDch3.ssa
+#define DCH3DSA mockDch3.dsa
+#define DCH3SSIZ mockDch3.ssiz
+#define DCH3DSIZ mockDch3.dsiz
+#define DCH3SPTR mockDch3.sptr
+#define DCH3DPTR mockDch3.dptr
+#define DCH3CSIZ mockDch3.csiz
+#define DCH3CPTR mockDch3.cptr
+#define DCH3DAT mockDch3.dat
+
+typedef uint32_t GPIO_PIN;
+
+/**
+ * @brief SPI control register.
+ */
+typedef union {
+    struct {
+        uint32_t SRXISEL : 2;
+        uint32_t STXISEL : 2;
+        uint32_t : 1;
+        uint32_t MSTEN : 1;
+        uint32_t CKP : 1;
+        uint32_t : 1;
+        uint32_t CKE : 1;
+        uint32_t SMP : 1;
+        uint32_t : 5;
+        uint32_t ON : 1;
+        uint32_t ENHBUF : 1;
+    };
+    uint32_t w;
+} MockSpixCon;
+
+/**
+ * @brief SPI status register.
+ */
+typedef union {
+    struct {
+        uint32_t : 1;
+        uint32_t SPITBF : 1;
+    };
+    uint32_t w;
+} MockSpixStat;
+
+/**
+ * @brief DMA controller register.
+ */
+typedef struct {
+    uint32_t ON : 1;
+} MockDmaCon;
+
+/**
+ * @brief DMA channel control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 7;
+        uint32_t CHEN : 1;
+    };
+    uint32_t w;
+} MockDchCon;
+
+/**
+ * @brief DMA channel event control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 4;
+        uint32_t SIRQEN : 1;
+        uint32_t : 3;
+        uint32_t CHSIRQ : 8;
+    };
+    uint32_t w;
+} MockDchEcon;
+
+/**
+ * @brief DMA channel interrupt control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 3;
+        uint32_t CHBCIF : 1;
+        uint32_t : 15;
+        uint32_t CHBCIE : 1;
+    };
+    uint32_t w;
+} MockDchInt;
+
+/**
+ * @brief DMA channel registers. Addresses are host addresses.
+ */
+typedef struct {
+    MockDchCon con;
+    MockDchEcon econ;
+    MockDchInt interrupt;
+    uintptr_t ssa;
+    uintptr_t dsa;
+    uint32_t ssiz;
+    uint32_t dsiz;
+    uint32_t sptr;
+    uint32_t dptr;
+    uint32_t csiz;
+    uint32_t cptr;
+    uint32_t dat;
+} MockDch;
+
+typedef enum {
+    INT_SOURCE_SPI3_TX,
+    INT_SOURCE_DMA3,
+} INT_SOURCE;
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern MockSpixCon mockSpi3Con;
+extern uint32_t mockSpi3Con2;
+extern MockSpixStat mockSpi3Stat;
+extern uint32_t mockSpi3Brg;
+extern uint32_t mockSpi3Buf;
+extern MockDmaCon mockDmaCon;
+extern MockDch mockDch3;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+MockSpixStat * MockSpi3StatBits(void);
+void GPIO_PinSet(GPIO_PIN pin);
+void GPIO_PinClear(GPIO_PIN pin);
+void EVIC_SourceEnable(INT_SOURCE source);
+void EVIC_SourceDisable(INT_SOURCE source);
+void EVIC_SourceStatusClear(INT_SOURCE source);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
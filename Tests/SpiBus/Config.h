@@ -0,0 +1,48 @@
+/**
+ * @file Config.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the library configuration. SPI bus 2 uses the
+ * simulated SPI driver of the test. Reads of the SPI bus queue yield to other
+ * threads when the queue is empty to widen the window in which a client may be
+ * queued after the queue has been read.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "definitions.h"
+#include <sched.h>
+#include "Spi/Spi.h"
+#include "Spi/SpiBusQueue.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define SPI_BUS_2_MAX_NUMBER_OF_CLIENTS     (8)
+#define SPI_BUS_2_SPI                       mockSpi
+
+#define SpiBusQueueRead(queue)              SpiBusQueueReadYield(queue)
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern const Spi mockSpi;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+static inline SpiBusClient * SpiBusQueueReadYield(SpiBusQueue * const queue) {
+    SpiBusClient * const client = (SpiBusQueueRead)(queue);
+    if (client == NULL) {
+        sched_yield();
+    }
+    return client;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,313 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host stress test of the SPI bus queue and SPI bus. Threads stand in
+ * for the interrupts of competing ICMs and for the DMA transfer complete
+ * interrupt. Threads run truly concurrently and so exercise more
+ * interleavings than nested interrupts on a single core.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Config.h"
+#include <pthread.h>
+#include "Spi/SpiBus2.h"
+#include "Spi/SpiBusQueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_PRODUCERS (4)
+#define NUMBER_OF_CLIENTS (SPI_BUS_QUEUE_SIZE)
+#define NUMBER_OF_WRITES (20000)
+#define TIMEOUT (20) // seconds
+
+/**
+ * @brief Client of the SPI bus test. The busy flag is claimed by the context
+ * that begins a transfer and released by the transfer complete callback, in
+ * the same way as the ICM FIFO read.
+ */
+typedef struct {
+    SpiBusClient* client;
+    GPIO_PIN csPin;
+    volatile uint8_t data;
+    bool busy;
+    uint32_t numberOfRequests;
+    uint32_t numberOfCompletions;
+    uint32_t seed;
+} TestClient;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static SpiBusQueue queue;
+static SpiBusClient queueClients[NUMBER_OF_CLIENTS];
+static uint32_t numberOfWrites[NUMBER_OF_CLIENTS];
+static uint32_t numberOfReads[NUMBER_OF_CLIENTS];
+
+static TestClient testClients[NUMBER_OF_CLIENTS];
+static bool transferActive;
+static void (*volatile transferComplete) (void);
+static bool stop;
+static uint32_t numberOfTransfers;
+static time_t deadline;
+
+//------------------------------------------------------------------------------
+// Functions - SpiBusQueue
+
+/**
+ * @brief Sleeps briefly so that other threads may run if there is only one
+ * core.
+ */
+static void Idle(void) {
+    const struct timespec duration = {.tv_nsec = 1000};
+    nanosleep(&duration, NULL);
+}
+
+/**
+ * @brief Producer. Each producer owns two clients. A client is written only
+ * once it has been read so that each client is queued at most once, as for
+ * the SPI bus. The number of writes is stored in the client to detect lost or
+ * duplicated slots.
+ */
+static void* QueueProducer(void* const argument) {
+    const int producer = (int) (intptr_t) argument;
+    uint32_t remaining = 2 * NUMBER_OF_WRITES;
+    while (remaining > 0) {
+        Idle();
+        for (int index = 2 * producer; index < ((2 * producer) + 2); index++) {
+            SpiBusClient * const client = &queueClients[index];
+            if (__atomic_load_n(&client->inProgress, __ATOMIC_ACQUIRE) || (numberOfWrites[index] == NUMBER_OF_WRITES)) {
+                continue;
+            }
+            client->inProgress = true;
+            client->numberOfBytes = numberOfWrites[index]++;
+            if (SpiBusQueueWrite(&queue, client) == false) {
+                fprintf(stderr, "Queue full with fewer than %d clients queued\n", NUMBER_OF_CLIENTS);
+                abort();
+            }
+            remaining--;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Consumer. Checks that each client is read once for each write and in
+ * the order written.
+ */
+static void* QueueConsumer(void* const argument) {
+    uint32_t remaining = NUMBER_OF_CLIENTS * NUMBER_OF_WRITES;
+    while (remaining > 0) {
+        SpiBusClient * const client = SpiBusQueueRead(&queue);
+        if (client == NULL) {
+            Idle();
+            continue;
+        }
+        const int index = (int) (client - queueClients);
+        assert((index >= 0) && (index < NUMBER_OF_CLIENTS));
+        if (client->numberOfBytes != numberOfReads[index]) {
+            fprintf(stderr, "Client %d read %zu, expected %u\n", index, client->numberOfBytes, numberOfReads[index]);
+            abort();
+        }
+        numberOfReads[index]++;
+        __atomic_store_n(&client->inProgress, false, __ATOMIC_RELEASE);
+        remaining--;
+    }
+    return NULL;
+}
+
+static void TestQueueFull(void) {
+    SpiBusQueue fullQueue = {0};
+    SpiBusClient clients[SPI_BUS_QUEUE_SIZE + 1];
+    for (int index = 0; index < SPI_BUS_QUEUE_SIZE; index++) {
+        assert(SpiBusQueueWrite(&fullQueue, &clients[index]));
+    }
+    assert(SpiBusQueueWrite(&fullQueue, &clients[SPI_BUS_QUEUE_SIZE]) == false);
+    for (int index = 0; index < SPI_BUS_QUEUE_SIZE; index++) {
+        assert(SpiBusQueueRead(&fullQueue) == &clients[index]);
+    }
+    assert(SpiBusQueueEmpty(&fullQueue));
+    assert(SpiBusQueueRead(&fullQueue) == NULL);
+    printf("queue full: ok\n");
+}
+
+static void TestQueue(void) {
+    pthread_t producers[NUMBER_OF_PRODUCERS];
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, QueueConsumer, NULL);
+    for (int producer = 0; producer < NUMBER_OF_PRODUCERS; producer++) {
+        pthread_create(&producers[producer], NULL, QueueProducer, (void*) (intptr_t) producer);
+    }
+    for (int producer = 0; producer < NUMBER_OF_PRODUCERS; producer++) {
+        pthread_join(producers[producer], NULL);
+    }
+    pthread_join(consumer, NULL);
+    for (int index = 0; index < NUMBER_OF_CLIENTS; index++) {
+        assert(numberOfReads[index] == NUMBER_OF_WRITES);
+    }
+    assert(SpiBusQueueEmpty(&queue));
+    printf("queue: %d producers, %d writes read once and in order: ok\n", NUMBER_OF_PRODUCERS, NUMBER_OF_CLIENTS * NUMBER_OF_WRITES);
+}
+
+//------------------------------------------------------------------------------
+// Functions - SpiBus
+
+/**
+ * @brief Fails if the test has not completed by the deadline. A lost wake-up
+ * leaves a client in progress so that no further transfers are requested.
+ */
+static void CheckDeadline(void) {
+    if (time(NULL) > deadline) {
+        fprintf(stderr, "Transfer not completed\n");
+        abort();
+    }
+}
+
+/**
+ * @brief Simulated SPI driver. Fails if a transfer begins while another is in
+ * progress or if the data does not belong to the client selected by the CS
+ * pin.
+ */
+static void MockTransfer(const GPIO_PIN csPin, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete_) (void)) {
+    if (__atomic_exchange_n(&transferActive, true, __ATOMIC_SEQ_CST)) {
+        fprintf(stderr, "Transfer began while another was in progress\n");
+        abort();
+    }
+    if (data != &testClients[csPin].data) {
+        fprintf(stderr, "Transfer data does not match CS pin\n");
+        abort();
+    }
+    __atomic_store_n(&transferComplete, transferComplete_, __ATOMIC_RELEASE);
+}
+
+static bool MockTransferInProgress(void) {
+    return __atomic_load_n(&transferActive, __ATOMIC_SEQ_CST);
+}
+
+const Spi mockSpi = {
+    .transfer = MockTransfer,
+    .transferInProgress = MockTransferInProgress,
+};
+
+/**
+ * @brief Stands in for the DMA interrupt. Completes each transfer after a
+ * random delay.
+ */
+static void* Dma(void* const argument) {
+    uint32_t seed = 1;
+    while (__atomic_load_n(&stop, __ATOMIC_ACQUIRE) == false) {
+        void (*const complete) (void) = __atomic_exchange_n(&transferComplete, NULL, __ATOMIC_ACQUIRE);
+        if (complete == NULL) {
+            Idle();
+            continue;
+        }
+        for (volatile int delay = rand_r(&seed) % 100; delay > 0; delay--) {
+        }
+        __atomic_store_n(&transferActive, false, __ATOMIC_SEQ_CST);
+        __atomic_fetch_add(&numberOfTransfers, 1, __ATOMIC_RELAXED);
+        complete();
+    }
+    return NULL;
+}
+
+/**
+ * @brief Transfer complete callback. Randomly begins another transfer from
+ * within the callback, as the ICM does to drain the FIFO.
+ */
+static void TransferComplete(void* const context) {
+    TestClient * const testClient = context;
+    __atomic_fetch_add(&testClient->numberOfCompletions, 1, __ATOMIC_RELAXED);
+    if ((rand_r(&testClient->seed) % 4) == 0) {
+        __atomic_fetch_add(&testClient->numberOfRequests, 1, __ATOMIC_RELAXED);
+        SpiBus2Transfer(testClient->client, &testClient->data, 1, TransferComplete, testClient);
+        return;
+    }
+    __atomic_store_n(&testClient->busy, false, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Stands in for the interrupts of the ICMs that share the bus. Each
+ * producer owns two clients.
+ */
+static void* BusProducer(void* const argument) {
+    const int producer = (int) (intptr_t) argument;
+    uint32_t numberOfRequests = 0;
+    while (numberOfRequests < (2 * NUMBER_OF_WRITES)) {
+        CheckDeadline();
+        Idle();
+        for (int index = 2 * producer; index < ((2 * producer) + 2); index++) {
+            TestClient * const testClient = &testClients[index];
+            if (__atomic_exchange_n(&testClient->busy, true, __ATOMIC_SEQ_CST)) {
+                continue;
+            }
+            __atomic_fetch_add(&testClient->numberOfRequests, 1, __ATOMIC_RELAXED);
+            SpiBus2Transfer(testClient->client, &testClient->data, 1, TransferComplete, testClient);
+            numberOfRequests++;
+        }
+    }
+    return NULL;
+}
+
+static bool AllComplete(void) {
+    for (int index = 0; index < NUMBER_OF_CLIENTS; index++) {
+        const TestClient * const testClient = &testClients[index];
+        if (__atomic_load_n(&testClient->busy, __ATOMIC_SEQ_CST) || SpiBus2TransferInProgress(testClient->client)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void TestBus(void) {
+    for (int index = 0; index < NUMBER_OF_CLIENTS; index++) {
+        testClients[index].csPin = (GPIO_PIN) index;
+        testClients[index].client = SpiBus2AddClient(testClients[index].csPin);
+        testClients[index].seed = (uint32_t) index + 1;
+        assert(testClients[index].client != NULL);
+    }
+    assert(SpiBus2AddClient(0) == NULL);
+    deadline = time(NULL) + TIMEOUT;
+    pthread_t producers[NUMBER_OF_PRODUCERS];
+    pthread_t dma;
+    pthread_create(&dma, NULL, Dma, NULL);
+    for (int producer = 0; producer < NUMBER_OF_PRODUCERS; producer++) {
+        pthread_create(&producers[producer], NULL, BusProducer, (void*) (intptr_t) producer);
+    }
+    for (int producer = 0; producer < NUMBER_OF_PRODUCERS; producer++) {
+        pthread_join(producers[producer], NULL);
+    }
+
+    // Wait for all transfers to complete
+    while (AllComplete() == false) {
+        CheckDeadline();
+        Idle();
+    }
+    __atomic_store_n(&stop, true, __ATOMIC_RELEASE);
+    pthread_join(dma, NULL);
+    uint32_t numberOfRequests = 0;
+    for (int index = 0; index < NUMBER_OF_CLIENTS; index++) {
+        assert(testClients[index].numberOfRequests == testClients[index].numberOfCompletions);
+        numberOfRequests += testClients[index].numberOfRequests;
+    }
+    assert(numberOfRequests == numberOfTransfers);
+    assert(MockTransferInProgress() == false);
+    printf("bus: %u transfers from %d producers and callbacks, none overlapping or lost: ok\n", numberOfTransfers, NUMBER_OF_PRODUCERS);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    TestQueueFull();
+    TestQueue();
+    TestBus();
+    printf("SpiBus: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,23 @@
+/**
+ * @file Config.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the library configuration. The read buffer is small
+ * so that the test wraps it many times.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define UART1_READ_BUFFER_SIZE                  (64)
+#define UART1_WRITE_BUFFER_SIZE                 (256)
+#define UART1_MEDIUM_PRIORITY_WRITE_BUFFER_SIZE (128)
+#define UART1_HIGH_PRIORITY_WRITE_BUFFER_SIZE   (128)
+#define UART1_DMA_WRITE_TRANSFER_SIZE           (32)
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
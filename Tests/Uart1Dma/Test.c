@@ -0,0 +1,231 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the UART1 read buffer. A model of the RX DMA channel
+ * writes each received byte to the circular read buffer and sets the
+ * destination half full and block transfer complete interrupt flags. The
+ * interrupt is serviced after a latency in received bytes so that the read
+ * buffer is accessed while the interrupt is pending.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Config.h"
+#include "definitions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Uart/Uart1Dma.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_BYTES (100000)
+#define MAX_BURST (20)
+#define MAX_READ (64)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void Dma7InterruptHandler(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+MockUxMode mockU1Mode;
+MockUxSta mockU1Sta = {.TRMT = 1};
+uint32_t mockU1Brg;
+uint32_t mockU1TxReg;
+uint32_t mockU1RxReg;
+MockDmaCon mockDmaCon;
+MockDch mockDch1;
+MockDch mockDch7;
+
+static bool dma7Enabled;
+static int latency;
+static int numberOfPendingBytes;
+
+//------------------------------------------------------------------------------
+// Functions - Harmony
+
+void EVIC_SourceEnable(INT_SOURCE source) {
+    if (source == INT_SOURCE_DMA7) {
+        dma7Enabled = true;
+    }
+}
+
+void EVIC_SourceDisable(INT_SOURCE source) {
+    if (source == INT_SOURCE_DMA7) {
+        dma7Enabled = false;
+    }
+}
+
+void EVIC_SourceStatusClear(INT_SOURCE source) {
+}
+
+uint32_t UartCalculateUxbrg(const uint32_t baudRate) {
+    return baudRate;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Model
+
+/**
+ * @brief Services the RX DMA interrupt. Bits written to the interrupt clear
+ * register are cleared.
+ */
+static void ServiceInterrupt(void) {
+    Dma7InterruptHandler();
+    mockDch7.interrupt.w &= ~mockDch7.interruptClear;
+    mockDch7.interruptClear = 0;
+}
+
+/**
+ * @brief Receives a byte. The RX DMA channel writes the byte to the read
+ * buffer and the destination pointer returns to zero at the end of each block.
+ */
+static void Receive(const uint8_t byte) {
+    assert((mockDch7.con.CHEN == 1) && (mockDch7.con.CHAEN == 1));
+    assert((mockDch7.econ.SIRQEN == 1) && (mockDch7.econ.CHSIRQ == _UART1_RX_VECTOR));
+    ((uint8_t*) mockDch7.dsa)[mockDch7.dptr++] = byte;
+    if (mockDch7.dptr == (mockDch7.dsiz / 2)) {
+        mockDch7.interrupt.CHDHIF = 1;
+    }
+    if (mockDch7.dptr == mockDch7.dsiz) {
+        mockDch7.interrupt.CHBCIF = 1;
+        mockDch7.dptr = 0;
+    }
+    const bool pending = ((mockDch7.interrupt.CHDHIE == 1) && (mockDch7.interrupt.CHDHIF == 1)) || ((mockDch7.interrupt.CHBCIE == 1) && (mockDch7.interrupt.CHBCIF == 1));
+    if (dma7Enabled && pending && (numberOfPendingBytes++ >= latency)) {
+        ServiceInterrupt();
+        numberOfPendingBytes = 0;
+    }
+}
+
+/**
+ * @brief Initialises the UART with an interrupt latency in received bytes.
+ */
+static void Initialise(const int latency_) {
+    const UartSettings settings = {.baudRate = 3000000};
+    Uart1DmaInitialise(&settings);
+    assert(dma7Enabled);
+    latency = latency_;
+    numberOfPendingBytes = 0;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Tests
+
+/**
+ * @brief Bytes received in bursts are read in order with reads of random size
+ * for interrupt latencies up to a quarter of the read buffer. The sender does
+ * not overrun the read buffer.
+ */
+static void TestWraparound(void) {
+    for (int latency_ = 0; latency_ < (UART1_READ_BUFFER_SIZE / 4); latency_ += 7) {
+        Initialise(latency_);
+        uint8_t sent = 0;
+        uint8_t expected = 0;
+        size_t numberOfReceived = 0;
+        size_t numberOfRead = 0;
+        while (numberOfRead < NUMBER_OF_BYTES) {
+            for (int burst = rand() % (MAX_BURST + 1); burst > 0; burst--) {
+                if ((numberOfReceived == NUMBER_OF_BYTES) || ((numberOfReceived - numberOfRead) == (UART1_READ_BUFFER_SIZE - 1))) {
+                    break;
+                }
+                Receive(sent++);
+                numberOfReceived++;
+            }
+            uint8_t buffer[MAX_READ];
+            const size_t numberOfBytes = Uart1DmaRead(buffer, (size_t) (rand() % (MAX_READ + 1)));
+            for (size_t index = 0; index < numberOfBytes; index++) {
+                assert(buffer[index] == expected++);
+            }
+            numberOfRead += numberOfBytes;
+        }
+        assert(Uart1DmaReceiveBufferOverrun() == false);
+        assert(Uart1DmaAvailableRead() == 0);
+    }
+    printf("wraparound: %d bytes through %d-byte read buffer for each interrupt latency: ok\n", NUMBER_OF_BYTES, UART1_READ_BUFFER_SIZE);
+}
+
+/**
+ * @brief A partial message is readable immediately without further bytes or
+ * interrupts, including across the end of the read buffer.
+ */
+static void TestIdle(void) {
+    Initialise(0);
+    for (int index = 0; index < (UART1_READ_BUFFER_SIZE - 8); index++) {
+        Receive('x');
+    }
+    uint8_t buffer[UART1_READ_BUFFER_SIZE];
+    assert(Uart1DmaRead(buffer, sizeof (buffer)) == (UART1_READ_BUFFER_SIZE - 8));
+    const char* const partial = "{\"ping\":null}";
+    for (size_t index = 0; index < strlen(partial); index++) {
+        Receive((uint8_t) partial[index]);
+    }
+    assert(Uart1DmaAvailableRead() == strlen(partial));
+    char line[UART1_READ_BUFFER_SIZE] = {0};
+    assert(Uart1DmaRead(line, sizeof (line)) == strlen(partial));
+    assert(strcmp(line, partial) == 0);
+    printf("idle: partial message of %zu bytes across end of read buffer readable immediately: ok\n", strlen(partial));
+}
+
+/**
+ * @brief Unread data that is overwritten is discarded and the overrun flag
+ * set for overruns of less than and more than one read buffer. The read buffer
+ * capacity is received without an overrun.
+ */
+static void TestOverrun(void) {
+    const int overruns[] = {1, 10, UART1_READ_BUFFER_SIZE / 2, (2 * UART1_READ_BUFFER_SIZE) + 5};
+    for (size_t overrun = 0; overrun < (sizeof (overruns) / sizeof (overruns[0])); overrun++) {
+        Initialise(3);
+        for (int index = 0; index < (UART1_READ_BUFFER_SIZE - 1 + overruns[overrun]); index++) {
+            Receive((uint8_t) index);
+        }
+        assert(Uart1DmaAvailableRead() == 0);
+        assert(Uart1DmaReceiveBufferOverrun() == true);
+        for (int index = 0; index < 5; index++) {
+            Receive((uint8_t) (100 + index));
+        }
+        uint8_t buffer[8];
+        assert(Uart1DmaRead(buffer, sizeof (buffer)) == 5);
+        assert((buffer[0] == 100) && (buffer[4] == 104));
+        assert(Uart1DmaReceiveBufferOverrun() == false);
+    }
+    for (int index = 0; index < (UART1_READ_BUFFER_SIZE - 1); index++) {
+        Receive((uint8_t) index);
+    }
+    assert(Uart1DmaAvailableRead() == (UART1_READ_BUFFER_SIZE - 1));
+    assert(Uart1DmaReceiveBufferOverrun() == false);
+    printf("overrun: discarded and flagged, %d bytes without overrun: ok\n", UART1_READ_BUFFER_SIZE - 1);
+}
+
+/**
+ * @brief Clearing the read buffer discards unread data but not data received
+ * after.
+ */
+static void TestClear(void) {
+    Uart1DmaClearReadBuffer();
+    assert(Uart1DmaAvailableRead() == 0);
+    Receive('a');
+    assert(Uart1DmaAvailableRead() == 1);
+    assert(Uart1DmaReadByte() == 'a');
+    printf("clear: ok\n");
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestWraparound();
+    TestIdle();
+    TestOverrun();
+    TestClear();
+    printf("Uart1Dma: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
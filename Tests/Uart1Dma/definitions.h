@@ -0,0 +1,205 @@
+/**
+ * @file definitions.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the Harmony definitions and the UART1 and DMA
+ * registers used by Uart1Dma.c. The bit positions of the DMA interrupt flags
+ * are those of the device so that the masks may be used to clear them. The
+ * test models the DMA channels.
+ */
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define _UART1_RX_VECTOR (113)
+#define _UART1_TX_VECTOR (114)
+
+#define _DCH7INT_CHBCIF_MASK (1U << 3)
+#define _DCH7INT_CHDHIF_MASK (1U << 5)
+
+#define U1MODE mockU1Mode.w
+#define U1MODEbits mockU1Mode
+#define U1STA mockU1Sta.w
+#define U1STAbits mockU1Sta
+#define U1BRG mockU1Brg
+#define U1TXREG mockU1TxReg
+#define U1RXREG mockU1RxReg
+
+#define DMACONbits mockDmaCon
+
+#define DCH1CON mockDch1.con.w
+#define DCH1CONbits mockDch1.con
+#define DCH1ECON mockDch1.econ.w
+#define DCH1ECONbits mockDch1.econ
+#define DCH1INT mockDch1.interrupt.w
+#define DCH1INTbits mockDch1.interrupt
+#define DCH1SSA mockDch1.ssa
+#define DCH1DSA mockDch1.dsa
+#define DCH1SSIZ mockDch1.ssiz
+#define DCH1DSIZ mockDch1.dsiz
+#define DCH1SPTR mockDch1.sptr
+#define DCH1DPTR mockDch1.dptr
+#define DCH1CSIZ mockDch1.csiz
+#define DCH1CPTR mockDch1.cptr
+#define DCH1DAT mockDch1.dat
+
+#define DCH7CON mockDch7.con.w
+#define DCH7CONbits mockDch7.con
+#define DCH7ECON mockDch7.econ.w
+#define DCH7ECONbits mockDch7.econ
+#define DCH7INT mockDch7.interrupt.w
+#define DCH7INTbits mockDch7.interrupt
+#define DCH7INTCLR mockDch7.interruptClear
+#define DCH7SSA mockDch7.ssa
+#define DCH7DSA mockDch7.dsa
+#define DCH7SSIZ mockDch7.ssiz
+#define DCH7DSIZ mockDch7.dsiz
+#define DCH7SPTR mockDch7.sptr
+#define DCH7DPTR mockDch7.dptr
+#define DCH7CSIZ mockDch7.csiz
+#define DCH7CPTR mockDch7.cptr
+#define DCH7DAT mockDch7.dat
+
+/**
+ * @brief UART mode register.
+ */
+typedef union {
+    struct {
+        uint32_t STSEL : 1;
+        uint32_t PDSEL : 2;
+        uint32_t BRGH : 1;
+        uint32_t RXINV : 1;
+        uint32_t : 3;
+        uint32_t UEN : 2;
+        uint32_t : 5;
+        uint32_t ON : 1;
+    };
+    uint32_t w;
+} MockUxMode;
+
+/**
+ * @brief UART status and control register.
+ */
+typedef union {
+    struct {
+        uint32_t URXDA : 1;
+        uint32_t OERR : 1;
+        uint32_t : 4;
+        uint32_t URXISEL : 2;
+        uint32_t TRMT : 1;
+        uint32_t : 1;
+        uint32_t UTXEN : 1;
+        uint32_t : 1;
+        uint32_t URXEN : 1;
+        uint32_t UTXINV : 1;
+    };
+    uint32_t w;
+} MockUxSta;
+
+/**
+ * @brief DMA controller register.
+ */
+typedef struct {
+    uint32_t ON : 1;
+} MockDmaCon;
+
+/**
+ * @brief DMA channel control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 4;
+        uint32_t CHAEN : 1;
+        uint32_t : 2;
+        uint32_t CHEN : 1;
+    };
+    uint32_t w;
+} MockDchCon;
+
+/**
+ * @brief DMA channel event control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 4;
+        uint32_t SIRQEN : 1;
+        uint32_t : 3;
+        uint32_t CHSIRQ : 8;
+    };
+    uint32_t w;
+} MockDchEcon;
+
+/**
+ * @brief DMA channel interrupt control register.
+ */
+typedef union {
+    struct {
+        uint32_t : 3;
+        uint32_t CHBCIF : 1;
+        uint32_t : 1;
+        uint32_t CHDHIF : 1;
+        uint32_t : 13;
+        uint32_t CHBCIE : 1;
+        uint32_t : 1;
+        uint32_t CHDHIE : 1;
+    };
+    uint32_t w;
+} MockDchInt;
+
+/**
+ * @brief DMA channel registers. Addresses are host addresses.
+ */
+typedef struct {
+    MockDchCon con;
+    MockDchEcon econ;
+    MockDchInt interrupt;
+    uint32_t interruptClear;
+    uintptr_t ssa;
+    uintptr_t dsa;
+    uint32_t ssiz;
+    uint32_t dsiz;
+    uint32_t sptr;
+    uint32_t dptr;
+    uint32_t csiz;
+    uint32_t cptr;
+    uint32_t dat;
+} MockDch;
+
+typedef enum {
+    INT_SOURCE_UART1_RX,
+    INT_SOURCE_DMA1,
+    INT_SOURCE_DMA7,
+} INT_SOURCE;
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern MockUxMode mockU1Mode;
+extern MockUxSta mockU1Sta;
+extern uint32_t mockU1Brg;
+extern uint32_t mockU1TxReg;
+extern uint32_t mockU1RxReg;
+extern MockDmaCon mockDmaCon;
+extern MockDch mockDch1;
+extern MockDch mockDch7;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void EVIC_SourceEnable(INT_SOURCE source);
+void EVIC_SourceDisable(INT_SOURCE source);
+void EVIC_SourceStatusClear(INT_SOURCE source);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
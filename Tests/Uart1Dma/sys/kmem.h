@@ -0,0 +1,24 @@
+/**
+ * @file kmem.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the XC32 kernel memory macros. Physical addresses
+ * are host addresses.
+ */
+
+#ifndef KMEM_H
+#define KMEM_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define KVA_TO_PA(v) ((uintptr_t) (v))
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
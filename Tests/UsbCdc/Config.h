@@ -0,0 +1,24 @@
+/**
+ * @file Config.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the library configuration. The USB CDC buffer sizes
+ * are those of the firmware.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define USB_CDC_READ_BUFFER_SIZE                  (4096)
+#define USB_CDC_WRITE_BUFFER_SIZE                 (16384)
+#define USB_CDC_MEDIUM_PRIORITY_WRITE_BUFFER_SIZE (2048)
+#define USB_CDC_HIGH_PRIORITY_WRITE_BUFFER_SIZE   (1024)
+#define USB_CDC_WRITE_TRANSFER_SIZE               (2048)
+#define USB_CDC_NUMBER_OF_WRITE_TRANSFERS         (4)
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
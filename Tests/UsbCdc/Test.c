@@ -0,0 +1,270 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the USB CDC write transfers. A model of the Harmony CDC
+ * function driver queues up to a write queue size of transfers and, as the
+ * driver does, truncates a transfer flagged as more data pending to a multiple
+ * of the maximum packet size. A model of the bus sends the queued transfers in
+ * order at a fixed rate and calls the write complete event as each transfer
+ * completes. UsbCdcTasks is called once per main loop period, and the
+ * throughput of a write queue size of one is compared with that of the
+ * firmware. The rates are simulated and so the throughput is asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include "Config.h"
+#include "definitions.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Usb/UsbCdc.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define BUS_RATE (40) // bytes per microsecond
+#define OFFERED_RATE (100) // bytes per microsecond
+#define SIMULATED_DURATION (1000000) // microseconds
+#define MESSAGE_SIZE (100)
+#define MAX_PACKET_SIZE (512)
+
+/**
+ * @brief Transfer queued by the model of the CDC function driver.
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t numberOfBytesSent;
+} Transfer;
+
+//------------------------------------------------------------------------------
+// Variables
+
+MockUsbOtg mockUsbOtg;
+
+static USB_DEVICE_EVENT_HANDLER deviceEventHandler;
+static USB_DEVICE_CDC_EVENT_HANDLER cdcEventHandler;
+static bool configured;
+static int writeQueueSize;
+static Transfer transfers[USB_CDC_NUMBER_OF_WRITE_TRANSFERS];
+static int numberOfTransfers;
+static uint8_t nextByte;
+static uint8_t expectedByte;
+static bool resynchronise;
+static size_t numberOfBytesReceived;
+
+//------------------------------------------------------------------------------
+// Functions - Harmony
+
+USB_DEVICE_HANDLE USB_DEVICE_Open(const USB_DEVICE_INDEX instanceIndex, const DRV_IO_INTENT intent) {
+    return 1;
+}
+
+void USB_DEVICE_EventHandlerSet(USB_DEVICE_HANDLE usbDeviceHandle, const USB_DEVICE_EVENT_HANDLER callBackFunc, uintptr_t context) {
+    deviceEventHandler = callBackFunc;
+}
+
+void USB_DEVICE_Attach(USB_DEVICE_HANDLE usbDeviceHandle) {
+}
+
+void USB_DEVICE_Detach(USB_DEVICE_HANDLE usbDeviceHandle) {
+}
+
+void USB_DEVICE_ControlSend(USB_DEVICE_HANDLE usbDeviceHandle, void * data, size_t length) {
+}
+
+void USB_DEVICE_ControlReceive(USB_DEVICE_HANDLE usbDeviceHandle, void * data, size_t length) {
+}
+
+void USB_DEVICE_ControlStatus(USB_DEVICE_HANDLE usbDeviceHandle, USB_DEVICE_CONTROL_STATUS status) {
+}
+
+void USB_DEVICE_CDC_EventHandlerSet(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_EVENT_HANDLER eventHandler, uintptr_t context) {
+    cdcEventHandler = eventHandler;
+}
+
+USB_DEVICE_CDC_RESULT USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_TRANSFER_HANDLE * transferHandle, void * data, size_t size) {
+    return USB_DEVICE_CDC_RESULT_OK;
+}
+
+USB_DEVICE_CDC_RESULT USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_TRANSFER_HANDLE * transferHandle, const void * data, size_t size, USB_DEVICE_CDC_TRANSFER_FLAGS flags) {
+    if (configured == false) {
+        return USB_DEVICE_CDC_RESULT_ERROR_INSTANCE_NOT_CONFIGURED;
+    }
+    if (flags == USB_DEVICE_CDC_TRANSFER_FLAGS_MORE_DATA_PENDING) {
+        if (size < MAX_PACKET_SIZE) {
+            return USB_DEVICE_CDC_RESULT_ERROR_TRANSFER_SIZE_INVALID;
+        }
+        size -= size % MAX_PACKET_SIZE;
+    }
+    if (numberOfTransfers == writeQueueSize) {
+        return USB_DEVICE_CDC_RESULT_ERROR_TRANSFER_QUEUE_FULL;
+    }
+    assert((size > 0) && (size <= USB_CDC_WRITE_TRANSFER_SIZE));
+    transfers[numberOfTransfers++] = (Transfer){.data = data, .size = size};
+    *transferHandle = (USB_DEVICE_CDC_TRANSFER_HANDLE) numberOfTransfers;
+    return USB_DEVICE_CDC_RESULT_OK;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Model
+
+/**
+ * @brief Removes the first transfer from the queue and calls the write
+ * complete event.
+ */
+static void Complete(void) {
+    USB_DEVICE_CDC_EVENT_DATA_WRITE_COMPLETE writeComplete = {.length = transfers[0].size};
+    numberOfTransfers--;
+    memmove(&transfers[0], &transfers[1], numberOfTransfers * sizeof (Transfer));
+    cdcEventHandler(USB_DEVICE_CDC_INDEX_0, USB_DEVICE_CDC_EVENT_WRITE_COMPLETE, &writeComplete, 0);
+}
+
+/**
+ * @brief Sends the queued transfers in order for a period. The data of a
+ * transfer is read from the transfer buffer as it is sent and compared with
+ * the bytes written.
+ */
+static void Bus(const int period) {
+    size_t budget = (size_t) period * BUS_RATE;
+    while ((budget > 0) && (numberOfTransfers > 0)) {
+        Transfer * const transfer = &transfers[0];
+        while ((budget > 0) && (transfer->numberOfBytesSent < transfer->size)) {
+            const uint8_t byte = transfer->data[transfer->numberOfBytesSent++];
+            assert(resynchronise || (byte == expectedByte));
+            expectedByte = byte + 1;
+            resynchronise = false;
+            numberOfBytesReceived++;
+            budget--;
+        }
+        if (transfer->numberOfBytesSent == transfer->size) {
+            Complete();
+        }
+    }
+}
+
+/**
+ * @brief Writes messages of consecutive bytes while there is space in the
+ * write buffer, up to a number of bytes.
+ */
+static void Offer(const size_t numberOfBytes) {
+    for (size_t offered = 0; offered < numberOfBytes; offered += MESSAGE_SIZE) {
+        if (UsbCdcAvailableWrite(PriorityFifoPriorityLow) < MESSAGE_SIZE) {
+            return;
+        }
+        uint8_t message[MESSAGE_SIZE];
+        for (size_t index = 0; index < sizeof (message); index++) {
+            message[index] = nextByte++;
+        }
+        assert(UsbCdcWrite(PriorityFifoPriorityLow, message, sizeof (message)) == FifoResultOk);
+    }
+}
+
+/**
+ * @brief Configures the device and opens the port.
+ */
+static void Connect(void) {
+    UsbCdcTasks();
+    configured = true;
+    USB_DEVICE_EVENT_DATA_CONFIGURED configuredData = {.configurationValue = 1};
+    deviceEventHandler(USB_DEVICE_EVENT_CONFIGURED, &configuredData, 0);
+    USB_CDC_CONTROL_LINE_STATE controlLineState = {.dtr = 1};
+    cdcEventHandler(USB_DEVICE_CDC_INDEX_0, USB_DEVICE_CDC_EVENT_SET_CONTROL_LINE_STATE, &controlLineState, 0);
+    assert(UsbCdcHostConnected() && UsbCdcPortOpen());
+}
+
+/**
+ * @brief Sends all data in the write buffer.
+ */
+static void Drain(void) {
+    while (true) {
+        UsbCdcTasks();
+        if (numberOfTransfers == 0) {
+            break;
+        }
+        Bus(SIMULATED_DURATION);
+    }
+    assert(UsbCdcAvailableWrite(PriorityFifoPriorityLow) == (UsbCdcWriteCapacity(PriorityFifoPriorityLow) - sizeof (uint16_t)));
+}
+
+/**
+ * @brief Offers data at the offered rate and calls UsbCdcTasks once per main
+ * loop period for the simulated duration. Returns the throughput in MB/s.
+ */
+static double Run(const int queueSize, const int period) {
+    writeQueueSize = queueSize;
+    numberOfBytesReceived = 0;
+    for (int time = 0; time < SIMULATED_DURATION; time += period) {
+        Offer((size_t) period * OFFERED_RATE);
+        UsbCdcTasks();
+        Bus(period);
+    }
+    const double throughput = (double) numberOfBytesReceived / SIMULATED_DURATION;
+    Drain();
+    return throughput;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Tests
+
+/**
+ * @brief A bus slower than the offered data is kept busy if the write queue
+ * holds the transfers of the firmware, for main loop periods of up to the
+ * duration of the transfers.
+ */
+static void TestThroughput(void) {
+    const int periods[] = {10, 100};
+    for (size_t index = 0; index < (sizeof (periods) / sizeof (periods[0])); index++) {
+        const double single = Run(1, periods[index]);
+        const double pipelined = Run(USB_CDC_NUMBER_OF_WRITE_TRANSFERS, periods[index]);
+        printf("throughput: %d us loop period, %d MB/s bus, write queue size 1 %.1f MB/s, %d %.1f MB/s\n", periods[index], BUS_RATE, single, USB_CDC_NUMBER_OF_WRITE_TRANSFERS, pipelined);
+        assert(pipelined > (0.99 * BUS_RATE));
+        assert(pipelined > single);
+    }
+}
+
+/**
+ * @brief Transfers aborted by a reset complete before or after the reset
+ * event. The write queue is filled again once the device is configured.
+ */
+static void TestReset(void) {
+    for (int completeFirst = 0; completeFirst < 2; completeFirst++) {
+        writeQueueSize = USB_CDC_NUMBER_OF_WRITE_TRANSFERS;
+        Offer(USB_CDC_WRITE_BUFFER_SIZE);
+        UsbCdcTasks();
+        assert(numberOfTransfers == USB_CDC_NUMBER_OF_WRITE_TRANSFERS);
+        if (completeFirst == 1) {
+            while (numberOfTransfers > 0) {
+                Complete();
+            }
+        }
+        configured = false;
+        deviceEventHandler(USB_DEVICE_EVENT_RESET, NULL, 0);
+        while (numberOfTransfers > 0) {
+            Complete();
+        }
+        assert(UsbCdcHostConnected() == false);
+        Connect();
+        resynchronise = true;
+        UsbCdcTasks();
+        assert(numberOfTransfers == USB_CDC_NUMBER_OF_WRITE_TRANSFERS);
+        Drain();
+    }
+    printf("reset: ok\n");
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    Connect();
+    TestThroughput();
+    TestReset();
+    printf("UsbCdc: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,136 @@
+/**
+ * @file definitions.h
+ * @author Seb Madgwick
+ * @brief Host stand-in for the Harmony USB device and CDC function driver
+ * declarations used by UsbCdc.c. The test models the driver and the bus.
+ */
+
+#ifndef DEFINITIONS_H
+#define DEFINITIONS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define __PIC32MZ__
+
+#define USBOTGbits mockUsbOtg
+
+#define USB_DEVICE_INDEX_0 (0)
+#define USB_DEVICE_CDC_INDEX_0 (0)
+
+#define USB_DEVICE_HANDLE_INVALID ((USB_DEVICE_HANDLE) (-1))
+#define USB_DEVICE_CDC_TRANSFER_HANDLE_INVALID ((USB_DEVICE_CDC_TRANSFER_HANDLE) (-1))
+
+/**
+ * @brief USB OTG register.
+ */
+typedef struct {
+    uint32_t VBUS : 2;
+} MockUsbOtg;
+
+typedef uintptr_t USB_DEVICE_HANDLE;
+typedef uintptr_t USB_DEVICE_CDC_TRANSFER_HANDLE;
+typedef int USB_DEVICE_INDEX;
+typedef int USB_DEVICE_CDC_INDEX;
+
+typedef enum {
+    DRV_IO_INTENT_READWRITE,
+} DRV_IO_INTENT;
+
+typedef enum {
+    USB_DEVICE_EVENT_RESET,
+    USB_DEVICE_EVENT_SUSPENDED,
+    USB_DEVICE_EVENT_DECONFIGURED,
+    USB_DEVICE_EVENT_CONFIGURED,
+    USB_DEVICE_EVENT_POWER_DETECTED,
+    USB_DEVICE_EVENT_POWER_REMOVED,
+} USB_DEVICE_EVENT;
+
+typedef struct {
+    uint8_t configurationValue;
+} USB_DEVICE_EVENT_DATA_CONFIGURED;
+
+typedef enum {
+    USB_DEVICE_CONTROL_STATUS_OK,
+} USB_DEVICE_CONTROL_STATUS;
+
+typedef enum {
+    USB_DEVICE_CDC_EVENT_GET_LINE_CODING,
+    USB_DEVICE_CDC_EVENT_SET_LINE_CODING,
+    USB_DEVICE_CDC_EVENT_SET_CONTROL_LINE_STATE,
+    USB_DEVICE_CDC_EVENT_SEND_BREAK,
+    USB_DEVICE_CDC_EVENT_READ_COMPLETE,
+    USB_DEVICE_CDC_EVENT_CONTROL_TRANSFER_DATA_RECEIVED,
+    USB_DEVICE_CDC_EVENT_WRITE_COMPLETE,
+} USB_DEVICE_CDC_EVENT;
+
+typedef enum {
+    USB_DEVICE_CDC_RESULT_OK,
+    USB_DEVICE_CDC_RESULT_ERROR_TRANSFER_SIZE_INVALID,
+    USB_DEVICE_CDC_RESULT_ERROR_TRANSFER_QUEUE_FULL,
+    USB_DEVICE_CDC_RESULT_ERROR_INSTANCE_NOT_CONFIGURED,
+} USB_DEVICE_CDC_RESULT;
+
+typedef enum {
+    USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE,
+    USB_DEVICE_CDC_TRANSFER_FLAGS_MORE_DATA_PENDING,
+} USB_DEVICE_CDC_TRANSFER_FLAGS;
+
+typedef struct {
+    uint32_t dwDTERate;
+    uint8_t bCharFormat;
+    uint8_t bParityType;
+    uint8_t bDataBits;
+} USB_CDC_LINE_CODING;
+
+typedef struct {
+    unsigned dtr : 1;
+    unsigned carrier : 1;
+} USB_CDC_CONTROL_LINE_STATE;
+
+typedef struct {
+    USB_DEVICE_CDC_TRANSFER_HANDLE handle;
+    size_t length;
+} USB_DEVICE_CDC_EVENT_DATA_READ_COMPLETE;
+
+typedef struct {
+    USB_DEVICE_CDC_TRANSFER_HANDLE handle;
+    size_t length;
+} USB_DEVICE_CDC_EVENT_DATA_WRITE_COMPLETE;
+
+typedef void USB_DEVICE_EVENT_RESPONSE;
+typedef USB_DEVICE_EVENT_RESPONSE(*USB_DEVICE_EVENT_HANDLER) (USB_DEVICE_EVENT event, void * eventData, uintptr_t context);
+
+typedef void USB_DEVICE_CDC_EVENT_RESPONSE;
+typedef USB_DEVICE_CDC_EVENT_RESPONSE(*USB_DEVICE_CDC_EVENT_HANDLER) (USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_EVENT event, void * pData, uintptr_t context);
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern MockUsbOtg mockUsbOtg;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+USB_DEVICE_HANDLE USB_DEVICE_Open(const USB_DEVICE_INDEX instanceIndex, const DRV_IO_INTENT intent);
+void USB_DEVICE_EventHandlerSet(USB_DEVICE_HANDLE usbDeviceHandle, const USB_DEVICE_EVENT_HANDLER callBackFunc, uintptr_t context);
+void USB_DEVICE_Attach(USB_DEVICE_HANDLE usbDeviceHandle);
+void USB_DEVICE_Detach(USB_DEVICE_HANDLE usbDeviceHandle);
+void USB_DEVICE_ControlSend(USB_DEVICE_HANDLE usbDeviceHandle, void * data, size_t length);
+void USB_DEVICE_ControlReceive(USB_DEVICE_HANDLE usbDeviceHandle, void * data, size_t length);
+void USB_DEVICE_ControlStatus(USB_DEVICE_HANDLE usbDeviceHandle, USB_DEVICE_CONTROL_STATUS status);
+void USB_DEVICE_CDC_EventHandlerSet(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_EVENT_HANDLER eventHandler, uintptr_t context);
+USB_DEVICE_CDC_RESULT USB_DEVICE_CDC_Read(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_TRANSFER_HANDLE * transferHandle, void * data, size_t size);
+USB_DEVICE_CDC_RESULT USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX instanceIndex, USB_DEVICE_CDC_TRANSFER_HANDLE * transferHandle, const void * data, size_t size, USB_DEVICE_CDC_TRANSFER_FLAGS flags);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
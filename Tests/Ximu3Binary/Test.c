@@ -0,0 +1,423 @@
+/**
+ * @file Test.c
+ * @author Seb Madgwick
+ * @brief Host test of the binary data messages. Each message is decoded as
+ * described by the doc comments of Ximu3Binary.c and compared with the data
+ * that was written. The bytes per sample and encode cost of compact inertial
+ * messages are compared with those of inertial messages for simulated motion.
+ * Durations depend on the host and are not asserted.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Ximu3Device/x-IMU3-Device/Ximu3Ascii.h"
+#include "Ximu3Device/x-IMU3-Device/Ximu3Binary.h"
+#include "Ximu3Device/x-IMU3-Device/Ximu3Size.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define NUMBER_OF_MESSAGES (100000)
+#define SAMPLE_RATE (1000)
+#define NUMBER_OF_SAMPLES (60 * SAMPLE_RATE)
+#define NUMBER_OF_REPETITIONS (20)
+
+/**
+ * @brief Decoder of one message.
+ */
+typedef struct {
+    uint8_t bytes[256];
+    size_t numberOfBytes;
+    size_t index;
+} Decoder;
+
+//------------------------------------------------------------------------------
+// Variables
+
+static Ximu3DataInertial inertialSamples[NUMBER_OF_SAMPLES];
+static Ximu3DataCompactInertial compactInertialSamples[NUMBER_OF_SAMPLES];
+
+//------------------------------------------------------------------------------
+// Functions
+
+static double Seconds(void) {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (double) timespec.tv_sec + ((double) timespec.tv_nsec * 1e-9);
+}
+
+static double Random(const double min, const double max) {
+    return min + ((max - min) * ((double) rand() / (double) RAND_MAX));
+}
+
+/**
+ * @brief Removes the byte stuffing of a message. Asserts that the message is
+ * terminated and that the termination only appears at the end.
+ */
+static Decoder Unstuff(const uint8_t * const message, const size_t messageSize) {
+    Decoder decoder = {0};
+    assert(messageSize > 0);
+    assert(message[messageSize - 1] == '\n');
+    for (size_t index = 0; index < (messageSize - 1); index++) {
+        assert(message[index] != '\n');
+        if (message[index] == 0xDB) {
+            index++;
+            assert((message[index] == 0xDC) || (message[index] == 0xDD));
+            decoder.bytes[decoder.numberOfBytes++] = message[index] == 0xDC ? '\n' : 0xDB;
+        } else {
+            decoder.bytes[decoder.numberOfBytes++] = message[index];
+        }
+    }
+    return decoder;
+}
+
+static uint8_t ReadByte(Decoder * const decoder) {
+    assert(decoder->index < decoder->numberOfBytes);
+    return decoder->bytes[decoder->index++];
+}
+
+static uint64_t ReadVarint(Decoder * const decoder) {
+    uint64_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        assert(shift < 64);
+        const uint8_t byte = ReadByte(decoder);
+        value |= (uint64_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+}
+
+static int32_t ReadZigZag(Decoder * const decoder) {
+    const uint32_t value = (uint32_t) ReadVarint(decoder);
+    return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+static uint32_t ReadUint32(Decoder * const decoder) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        value |= (uint32_t) ReadByte(decoder) << shift;
+    }
+    return value;
+}
+
+/**
+ * @brief Returns a random int16 value. Values are often the extremes so that
+ * differences span the full range.
+ */
+static int16_t RandomInt16(const int16_t previous) {
+    switch (rand() % 4) {
+        case 0:
+            return (rand() % 2) == 0 ? INT16_MIN : INT16_MAX;
+        case 1:
+            return (int16_t) Random(INT16_MIN, INT16_MAX);
+        default:
+            return (int16_t) fmax(INT16_MIN, fmin(INT16_MAX, previous + Random(-100, 100)));
+    }
+}
+
+/**
+ * @brief Decodes a compact inertial message and updates the decoded values.
+ * Returns the timestamp.
+ */
+static uint64_t DecodeCompactInertial(const uint8_t * const message, const size_t messageSize, const uint64_t previousTimestamp, int16_t * const values) {
+    Decoder decoder = Unstuff(message, messageSize);
+    assert(ReadByte(&decoder) == (0x80 + XIMU3_ASCII_ID_COMPACT_INERTIAL));
+    const uint64_t timestamp = ReadVarint(&decoder);
+    const bool keyframe = (timestamp & 1) != 0;
+    for (int index = 0; index < 6; index++) {
+        values[index] = (int16_t) ((keyframe ? 0 : values[index]) + ReadZigZag(&decoder));
+    }
+    assert(decoder.index == decoder.numberOfBytes);
+    return (keyframe ? 0 : previousTimestamp) + (timestamp >> 1);
+}
+
+/**
+ * @brief Returns a random unit quaternion.
+ */
+static void RandomQuaternion(float * const elements) {
+    float norm;
+    do {
+        norm = 0.0f;
+        for (int index = 0; index < 4; index++) {
+            elements[index] = (float) Random(-1, 1);
+            norm += elements[index] * elements[index];
+        }
+    } while ((norm > 1.0f) || (norm < 0.01f));
+    norm = sqrtf(norm);
+    for (int index = 0; index < 4; index++) {
+        elements[index] /= norm;
+    }
+}
+
+/**
+ * @brief Decodes a compressed quaternion message. Returns the timestamp.
+ */
+static uint64_t DecodeCompressedQuaternion(const uint8_t * const message, const size_t messageSize, const uint64_t previousTimestamp, float * const elements) {
+    Decoder decoder = Unstuff(message, messageSize);
+    assert(ReadByte(&decoder) == (0x80 + XIMU3_ASCII_ID_COMPRESSED_QUATERNION));
+    const uint64_t timestamp = ReadVarint(&decoder);
+    const bool keyframe = (timestamp & 1) != 0;
+    const uint32_t value = ReadUint32(&decoder);
+    assert(decoder.index == decoder.numberOfBytes);
+    const int largest = (int) (value >> 30);
+    float sumOfSquares = 0.0f;
+    int shift = 20;
+    for (int index = 0; index < 4; index++) {
+        if (index == largest) {
+            continue;
+        }
+        const uint32_t quantised = (value >> shift) & 0x3FF;
+        elements[index] = (((float) quantised / 1023.0f) * 2.0f - 1.0f) / 1.41421356f;
+        sumOfSquares += elements[index] * elements[index];
+        shift -= 10;
+    }
+    elements[largest] = sqrtf(fmaxf(0.0f, 1.0f - sumOfSquares));
+    return (keyframe ? 0 : previousTimestamp) + (timestamp >> 1);
+}
+
+/**
+ * @brief Returns the angle in degrees between two quaternions.
+ */
+static float AngleBetween(const float * const a, const float * const b) {
+    float dot = 0.0f;
+    for (int index = 0; index < 4; index++) {
+        dot += a[index] * b[index];
+    }
+    return 2.0f * acosf(fminf(1.0f, fabsf(dot))) * (180.0f / (float) M_PI);
+}
+
+/**
+ * @brief Random quaternions, and quaternions with equal or zero elements,
+ * are decoded to within the quantisation error. Timestamps are decoded from
+ * the difference to the previous timestamp. Keyframes are sent periodically
+ * and after a lost message, and the timestamp of each keyframe is decoded
+ * without the previous timestamp.
+ */
+static void TestCompressedQuaternion(void) {
+    float maxError = 0.0f;
+    size_t maxSize = 0;
+    int numberOfKeyframes = 0;
+    int numberOfLostMessages = 0;
+    uint64_t timestamp = 0;
+    uint64_t previousTimestamp = 0;
+    uint64_t decodedTimestamp = 0;
+    const float special[][4] = {
+        {1, 0, 0, 0},
+        {0, 0, 0, -1},
+        {0.70710678f, 0.70710678f, 0, 0},
+        {-0.5f, 0.5f, -0.5f, 0.5f},
+        {0.70710678f, 0, 0, -0.70710678f},
+    };
+    const int numberOfSpecial = sizeof (special) / sizeof (special[0]);
+    for (int message = 0; message < NUMBER_OF_MESSAGES; message++) {
+        float elements[4];
+        if (message < numberOfSpecial) {
+            for (int index = 0; index < 4; index++) {
+                elements[index] = special[message][index];
+            }
+        } else {
+            RandomQuaternion(elements);
+        }
+        timestamp += (message == 0) ? (uint64_t) 1 << 40 : (uint64_t) Random(1, message % 100 == 0 ? 1e9 : 1000);
+        if ((message % 1000) == 0) {
+            previousTimestamp = 0; // periodic keyframe
+        }
+        const Ximu3DataCompressedQuaternion data = {
+            .timestamp = timestamp,
+            .previousTimestamp = previousTimestamp,
+            .w = elements[0],
+            .x = elements[1],
+            .y = elements[2],
+            .z = elements[3],
+        };
+        uint8_t buffer[XIMU3_SIZE_BINARY_COMPRESSED_QUATERNION];
+        const size_t messageSize = Ximu3BinaryCompressedQuaternion(buffer, sizeof (buffer), &data);
+        maxSize = messageSize > maxSize ? messageSize : maxSize;
+        numberOfKeyframes += previousTimestamp == 0 ? 1 : 0;
+        if ((rand() % 100) == 0) {
+            numberOfLostMessages++;
+            previousTimestamp = 0; // next message is a keyframe
+            continue;
+        }
+        float decoded[4];
+        decodedTimestamp = DecodeCompressedQuaternion(buffer, messageSize, decodedTimestamp, decoded);
+        assert(decodedTimestamp == timestamp);
+        maxError = fmaxf(maxError, AngleBetween(elements, decoded));
+        previousTimestamp = timestamp;
+    }
+    printf("compressed quaternion: %d messages, %d keyframes, %d lost, max size %zu bytes, max error %.3f degrees\n", NUMBER_OF_MESSAGES, numberOfKeyframes, numberOfLostMessages, maxSize, maxError);
+    assert(numberOfLostMessages > 0);
+    assert(maxError < 0.3f);
+}
+
+/**
+ * @brief Values with differences spanning the full int16 range, and large
+ * timestamp differences, are decoded exactly. Keyframes reset the decoded
+ * values.
+ */
+static void TestCompactInertial(void) {
+    size_t maxSize = 0;
+    int numberOfKeyframes = 0;
+    uint64_t timestamp = 0;
+    int16_t values[6] = {0};
+    int16_t decoded[6] = {0};
+    uint64_t decodedTimestamp = 0;
+    for (int message = 0; message < NUMBER_OF_MESSAGES; message++) {
+        const uint64_t previousTimestamp = ((message % 1000) == 0) ? 0 : timestamp;
+        timestamp += (uint64_t) Random(1, message % 100 == 0 ? 1e12 : 1000);
+        int16_t previousValues[6];
+        for (int index = 0; index < 6; index++) {
+            previousValues[index] = values[index];
+            values[index] = RandomInt16(values[index]);
+        }
+        const Ximu3DataCompactInertial data = {
+            .timestamp = timestamp,
+            .previousTimestamp = previousTimestamp,
+            .gyroscopeX = values[0],
+            .gyroscopeY = values[1],
+            .gyroscopeZ = values[2],
+            .accelerometerX = values[3],
+            .accelerometerY = values[4],
+            .accelerometerZ = values[5],
+            .previousGyroscopeX = previousValues[0],
+            .previousGyroscopeY = previousValues[1],
+            .previousGyroscopeZ = previousValues[2],
+            .previousAccelerometerX = previousValues[3],
+            .previousAccelerometerY = previousValues[4],
+            .previousAccelerometerZ = previousValues[5],
+        };
+        uint8_t buffer[XIMU3_SIZE_BINARY_COMPACT_INERTIAL];
+        const size_t messageSize = Ximu3BinaryCompactInertial(buffer, sizeof (buffer), &data);
+        maxSize = messageSize > maxSize ? messageSize : maxSize;
+        numberOfKeyframes += previousTimestamp == 0 ? 1 : 0;
+        decodedTimestamp = DecodeCompactInertial(buffer, messageSize, decodedTimestamp, decoded);
+        assert(decodedTimestamp == timestamp);
+        for (int index = 0; index < 6; index++) {
+            assert(decoded[index] == values[index]);
+        }
+    }
+    printf("compact inertial: %d messages, %d keyframes, max size %zu bytes\n", NUMBER_OF_MESSAGES, numberOfKeyframes, maxSize);
+}
+
+/**
+ * @brief Returns the value quantised as by Send.
+ */
+static int16_t Quantise(const float value, const float scale) {
+    return (int16_t) fmaxf(INT16_MIN, fminf(INT16_MAX, roundf(value * scale)));
+}
+
+/**
+ * @brief Simulates one minute of 1 kHz samples alternating each second between
+ * rest and motion of up to 200 degrees per second and 2 g, with sensor noise.
+ * Keyframes are sent once per second, as by Send.
+ */
+static void Simulate(void) {
+    int16_t previous[6] = {0};
+    for (int sample = 0; sample < NUMBER_OF_SAMPLES; sample++) {
+        const double seconds = (double) sample / SAMPLE_RATE;
+        const double motion = ((sample / SAMPLE_RATE) % 2) == 0 ? 0.0 : 1.0;
+        float values[6];
+        for (int index = 0; index < 3; index++) {
+            const double phase = (2.0 * M_PI * (1.0 + index) * seconds) + index;
+            values[index] = (float) ((motion * 200.0 * sin(phase)) + Random(-0.1, 0.1));
+            values[index + 3] = (float) ((index == 2 ? 1.0 : 0.0) + (motion * 2.0 * cos(phase)) + Random(-0.002, 0.002));
+        }
+        const uint64_t timestamp = (uint64_t) (1000000 * seconds) + 1;
+        inertialSamples[sample] = (Ximu3DataInertial){
+            .timestamp = timestamp,
+            .gyroscopeX = values[0],
+            .gyroscopeY = values[1],
+            .gyroscopeZ = values[2],
+            .accelerometerX = values[3],
+            .accelerometerY = values[4],
+            .accelerometerZ = values[5],
+        };
+        int16_t quantised[6];
+        for (int index = 0; index < 6; index++) {
+            quantised[index] = Quantise(values[index], index < 3 ? XIMU3_COMPACT_GYROSCOPE_SCALE : XIMU3_COMPACT_ACCELEROMETER_SCALE);
+        }
+        compactInertialSamples[sample] = (Ximu3DataCompactInertial){
+            .timestamp = timestamp,
+            .previousTimestamp = (sample % SAMPLE_RATE) == 0 ? 0 : inertialSamples[sample - 1].timestamp,
+            .gyroscopeX = quantised[0],
+            .gyroscopeY = quantised[1],
+            .gyroscopeZ = quantised[2],
+            .accelerometerX = quantised[3],
+            .accelerometerY = quantised[4],
+            .accelerometerZ = quantised[5],
+            .previousGyroscopeX = previous[0],
+            .previousGyroscopeY = previous[1],
+            .previousGyroscopeZ = previous[2],
+            .previousAccelerometerX = previous[3],
+            .previousAccelerometerY = previous[4],
+            .previousAccelerometerZ = previous[5],
+        };
+        for (int index = 0; index < 6; index++) {
+            previous[index] = quantised[index];
+        }
+    }
+}
+
+/**
+ * @brief Compact inertial messages of simulated motion are decoded exactly.
+ * The bytes per sample and encode cost are compared with those of inertial
+ * messages.
+ */
+static void BenchmarkCompactInertial(void) {
+    Simulate();
+    uint8_t buffer[XIMU3_SIZE_BINARY_COMPACT_INERTIAL > XIMU3_SIZE_BINARY_INERTIAL ? XIMU3_SIZE_BINARY_COMPACT_INERTIAL : XIMU3_SIZE_BINARY_INERTIAL];
+    int16_t decoded[6] = {0};
+    uint64_t decodedTimestamp = 0;
+    size_t maxSize = 0;
+    for (int sample = 0; sample < NUMBER_OF_SAMPLES; sample++) {
+        const Ximu3DataCompactInertial * const data = &compactInertialSamples[sample];
+        const size_t messageSize = Ximu3BinaryCompactInertial(buffer, sizeof (buffer), data);
+        maxSize = messageSize > maxSize ? messageSize : maxSize;
+        decodedTimestamp = DecodeCompactInertial(buffer, messageSize, decodedTimestamp, decoded);
+        assert(decodedTimestamp == data->timestamp);
+        assert((decoded[0] == data->gyroscopeX) && (decoded[1] == data->gyroscopeY) && (decoded[2] == data->gyroscopeZ));
+        assert((decoded[3] == data->accelerometerX) && (decoded[4] == data->accelerometerY) && (decoded[5] == data->accelerometerZ));
+    }
+    size_t numberOfBytes[2] = {0};
+    double durations[2];
+    for (int compact = 0; compact < 2; compact++) {
+        const double start = Seconds();
+        for (int repetition = 0; repetition < NUMBER_OF_REPETITIONS; repetition++) {
+            for (int sample = 0; sample < NUMBER_OF_SAMPLES; sample++) {
+                if (compact == 1) {
+                    numberOfBytes[compact] += Ximu3BinaryCompactInertial(buffer, sizeof (buffer), &compactInertialSamples[sample]);
+                } else {
+                    numberOfBytes[compact] += Ximu3BinaryInertial(buffer, sizeof (buffer), &inertialSamples[sample]);
+                }
+            }
+        }
+        durations[compact] = (Seconds() - start) * 1e9 / (NUMBER_OF_REPETITIONS * NUMBER_OF_SAMPLES);
+    }
+    const double bytesPerSample[2] = {
+        (double) numberOfBytes[0] / (NUMBER_OF_REPETITIONS * NUMBER_OF_SAMPLES),
+        (double) numberOfBytes[1] / (NUMBER_OF_REPETITIONS * NUMBER_OF_SAMPLES),
+    };
+    printf("benchmark: %d samples, binary %.1f bytes/sample %.1f ns/sample, compact %.1f bytes/sample (max %zu) %.1f ns/sample\n", NUMBER_OF_SAMPLES, bytesPerSample[0], durations[0], bytesPerSample[1], maxSize, durations[1]);
+    assert(bytesPerSample[1] < bytesPerSample[0]);
+}
+
+int main(void) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    srand(1);
+    TestCompactInertial();
+    TestCompressedQuaternion();
+    BenchmarkCompactInertial();
+    printf("Ximu3Binary: passed\n");
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,220 @@
+/**
+ * @file Backpressure.c
+ * @author Seb Madgwick
+ * @brief Adaptive message rates. The rate divisors of all send structures are
+ * increased while the write buffers are filling and restored as headroom
+ * returns.
+ *
+ * The occupancy of the low-priority write buffer of each enabled interface is
+ * polled periodically. The level is increased while the occupancy is above the
+ * high threshold and not falling, i.e. while data is buffered faster than it
+ * is sent. The level is decreased after the occupancy has remained below the
+ * low threshold for the restore period. Each level doubles the rate divisor
+ * multiplier of one message type, in the configured order, up to the maximum
+ * multiplier before moving on to the next message type. The frame and joint
+ * angles messages are reduced last because they are used by the application
+ * rather than for recording.
+ *
+ * Each message is created once and written to all enabled interfaces, so the
+ * multipliers apply to all interfaces and are driven by the interface with the
+ * highest occupancy. A slow interface therefore reduces the message rates of a
+ * fast interface. Per-interface multipliers would require each message to be
+ * downsampled and created separately for each interface, doubling the
+ * processing of every message for the case of both interfaces enabled. The
+ * serial interface should be disabled if it is not required.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Backpressure.h"
+#include <inttypes.h>
+#include "Periodic.h"
+#include "Send/Send.h"
+#include "Serial/Serial.h"
+#include <stdbool.h>
+#include "Usb/UsbCdc.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Message type.
+ */
+typedef enum {
+    MessageTypeTemperature,
+    MessageTypeInertial,
+    MessageTypeAhrs,
+    MessageTypeFrame,
+    MessageTypeJointAngles,
+} MessageType;
+
+/**
+ * @brief Number of message types.
+ */
+#define NUMBER_OF_MESSAGE_TYPES (5)
+
+/**
+ * @brief Poll period in seconds.
+ */
+#define POLL_PERIOD (0.01f)
+
+/**
+ * @brief Occupancy above which the level is increased.
+ */
+#define HIGH_THRESHOLD (0.5f)
+
+/**
+ * @brief Occupancy below which the level is decreased.
+ */
+#define LOW_THRESHOLD (0.125f)
+
+/**
+ * @brief Number of poll periods that the occupancy must remain below the low
+ * threshold before the level is decreased.
+ */
+#define RESTORE_PERIOD (100)
+
+/**
+ * @brief Maximum rate divisor multiplier of each message type as a power of 2.
+ */
+#define MAX_SHIFT (4)
+
+/**
+ * @brief Maximum level.
+ */
+#define MAX_LEVEL (NUMBER_OF_MESSAGE_TYPES * MAX_SHIFT)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static float Occupancy(void);
+static void SetLevel(const int level_);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static const MessageType orders[][NUMBER_OF_MESSAGE_TYPES] = {
+    [BackpressureOrderTemperatureInertialAhrs] = {MessageTypeTemperature, MessageTypeInertial, MessageTypeAhrs, MessageTypeFrame, MessageTypeJointAngles},
+    [BackpressureOrderTemperatureAhrsInertial] = {MessageTypeTemperature, MessageTypeAhrs, MessageTypeInertial, MessageTypeFrame, MessageTypeJointAngles},
+    [BackpressureOrderInertialTemperatureAhrs] = {MessageTypeInertial, MessageTypeTemperature, MessageTypeAhrs, MessageTypeFrame, MessageTypeJointAngles},
+    [BackpressureOrderInertialAhrsTemperature] = {MessageTypeInertial, MessageTypeAhrs, MessageTypeTemperature, MessageTypeFrame, MessageTypeJointAngles},
+    [BackpressureOrderAhrsTemperatureInertial] = {MessageTypeAhrs, MessageTypeTemperature, MessageTypeInertial, MessageTypeFrame, MessageTypeJointAngles},
+    [BackpressureOrderAhrsInertialTemperature] = {MessageTypeAhrs, MessageTypeInertial, MessageTypeTemperature, MessageTypeFrame, MessageTypeJointAngles},
+};
+static BackpressureSettings settings;
+static int level;
+static float previousOccupancy;
+static int restoreCount;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the settings. The rate divisors are restored.
+ * @param settings_ Settings.
+ */
+void BackpressureSetSettings(const BackpressureSettings * const settings_) {
+    settings = *settings_;
+    previousOccupancy = 0.0f;
+    restoreCount = 0;
+    if (level != 0) {
+        SetLevel(0);
+    }
+}
+
+/**
+ * @brief Module tasks. This function should be called repeatedly within the
+ * main program loop.
+ */
+void BackpressureTasks(void) {
+
+    // Do nothing if disabled or poll period not elapsed
+    if (settings.order == BackpressureOrderDisabled) {
+        return;
+    }
+    if (PERIODIC_POLL(POLL_PERIOD) == false) {
+        return;
+    }
+
+    // Increase level while occupancy high and not falling
+    const float occupancy = Occupancy();
+    const bool falling = occupancy < previousOccupancy;
+    previousOccupancy = occupancy;
+    if (occupancy > HIGH_THRESHOLD) {
+        restoreCount = 0;
+        if ((falling == false) && (level < MAX_LEVEL)) {
+            SetLevel(level + 1);
+        }
+        return;
+    }
+
+    // Decrease level after occupancy low for restore period
+    if (occupancy >= LOW_THRESHOLD) {
+        restoreCount = 0;
+        return;
+    }
+    if (++restoreCount < RESTORE_PERIOD) {
+        return;
+    }
+    restoreCount = 0;
+    if (level > 0) {
+        SetLevel(level - 1);
+    }
+}
+
+/**
+ * @brief Returns the highest occupancy of the low-priority write buffer of all
+ * enabled interfaces.
+ * @return Occupancy between 0 (empty) and 1 (full).
+ */
+static float Occupancy(void) {
+    float occupancy = 0.0f;
+    if (UsbCdcPortOpen()) {
+        const float usbOccupancy = 1.0f - ((float) UsbCdcAvailableWrite(PriorityFifoPriorityLow) / (float) UsbCdcWriteCapacity(PriorityFifoPriorityLow));
+        if (usbOccupancy > occupancy) {
+            occupancy = usbOccupancy;
+        }
+    }
+    if (SerialEnabled()) {
+        const float serialOccupancy = 1.0f - ((float) SerialAvailableWrite(PriorityFifoPriorityLow) / (float) SerialWriteCapacity(PriorityFifoPriorityLow));
+        if (serialOccupancy > occupancy) {
+            occupancy = serialOccupancy;
+        }
+    }
+    return occupancy;
+}
+
+/**
+ * @brief Sets the level and sends the rate divisor multipliers as a
+ * notification.
+ * @param level_ Level.
+ */
+static void SetLevel(const int level_) {
+    level = level_;
+
+    // Calculate rate divisor multipliers
+    uint32_t multipliers[NUMBER_OF_MESSAGE_TYPES] = {1, 1, 1, 1, 1};
+    if (settings.order != BackpressureOrderDisabled) {
+        int remaining = level;
+        for (int index = 0; index < NUMBER_OF_MESSAGE_TYPES; index++) {
+            const int shift = remaining < MAX_SHIFT ? remaining : MAX_SHIFT;
+            multipliers[orders[settings.order][index]] = 1U << shift;
+            remaining -= shift;
+        }
+    }
+    const SendRateDivisorMultipliers rateDivisorMultipliers = {
+        .inertial = multipliers[MessageTypeInertial],
+        .ahrs = multipliers[MessageTypeAhrs],
+        .temperature = multipliers[MessageTypeTemperature],
+        .jointAngles = multipliers[MessageTypeJointAngles],
+        .frame = multipliers[MessageTypeFrame],
+    };
+    SendSetRateDivisorMultipliers(&rateDivisorMultipliers);
+
+    // Send notification
+    SendNotification(&sendMain, "Rate divisor multipliers. Inertial %" PRIu32 ", AHRS %" PRIu32 ", temperature %" PRIu32 ", joint angles %" PRIu32 ", frame %" PRIu32 ".", rateDivisorMultipliers.inertial, rateDivisorMultipliers.ahrs, rateDivisorMultipliers.temperature, rateDivisorMultipliers.jointAngles, rateDivisorMultipliers.frame);
+}
+
+//------------------------------------------------------------------------------
+// End of file
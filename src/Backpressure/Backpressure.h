@@ -0,0 +1,50 @@
+/**
+ * @file Backpressure.h
+ * @author Seb Madgwick
+ * @brief Adaptive message rates. The rate divisors of all send structures are
+ * increased while the write buffers are filling and restored as headroom
+ * returns.
+ */
+
+#ifndef BACKPRESSURE_H
+#define BACKPRESSURE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Order in which message rates are reduced. The rates of the frame and
+ * then joint angles messages are reduced after the message types of the order.
+ */
+typedef enum {
+    BackpressureOrderDisabled,
+    BackpressureOrderTemperatureInertialAhrs,
+    BackpressureOrderTemperatureAhrsInertial,
+    BackpressureOrderInertialTemperatureAhrs,
+    BackpressureOrderInertialAhrsTemperature,
+    BackpressureOrderAhrsTemperatureInertial,
+    BackpressureOrderAhrsInertialTemperature,
+} BackpressureOrder;
+
+/**
+ * @brief Settings.
+ */
+typedef struct {
+    BackpressureOrder order;
+} BackpressureSettings;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void BackpressureSetSettings(const BackpressureSettings * const settings_);
+void BackpressureTasks(void);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,222 @@
+/**
+ * @file Frame.c
+ * @author Seb Madgwick
+ * @brief Synchronous frames of the sample of all sensors at each frame tick.
+ *
+ * Frame n is at n * rate divisor sample periods, in timer ticks, so the frame
+ * ticks are on the resampler grid and do not depend on any one sensor. The
+ * rate divisor is the frame message rate divisor multiplied by the backpressure
+ * rate divisor multiplier. Pending frames are sent and the frames restarted if
+ * the rate divisor or sample rate changes.
+ *
+ * The sample of each sensor nearest the frame tick is selected from the
+ * samples either side of it. This is the sample at the frame tick if
+ * resampling is enabled. A sensor is not present in the frame if it has no
+ * sample at the frame tick, for example, because samples were lost or the
+ * sensor is not connected.
+ *
+ * Sensors are processed in turn and so may be at different frames. A frame is
+ * pending until each expected sensor has either set its sample or set a sample
+ * after the frame tick. Frames are sent in order. The expected sensors are
+ * those that have set a sample since a frame was sent without them.
+ *
+ * All sensors must have the same sample rate.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Frame.h"
+#include <stdbool.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum interval between the samples either side of a frame tick in
+ * sample periods. A sample was lost if this is exceeded.
+ */
+#define MAX_INTERVAL (1.5)
+
+/**
+ * @brief Tolerance in timer ticks so that a sample at a frame tick is after
+ * the frame tick despite the truncation of the sample ticks.
+ */
+#define TOLERANCE (1.5)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static void SetPending(Frame * const frame, const int index, const uint64_t number, const uint64_t ticks, const SendFrameSensor * const sensor);
+static void Restart(Frame * const frame, const uint64_t number);
+static bool IsComplete(const Frame * const frame);
+static void SendOldest(Frame * const frame);
+
+//------------------------------------------------------------------------------
+// Variables
+
+Frame frame = {.send = &sendMain};
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the settings. Pending frames are discarded.
+ * @param frame Frame structure.
+ * @param settings Settings.
+ */
+void FrameSetSettings(Frame * const frame, const FrameSettings * const settings) {
+    frame->settings = *settings;
+    for (int index = 0; index < FRAME_NUMBER_OF_PENDING_FRAMES; index++) {
+        frame->pending[index].presence = 0;
+    }
+    for (int index = 0; index < FRAME_NUMBER_OF_SENSORS; index++) {
+        frame->previousTicks[index] = 0;
+    }
+    frame->framePeriod = 0.0;
+    frame->expected = 0;
+}
+
+/**
+ * @brief Sets the sample of a sensor. This function should be called for
+ * each sample in order. The sensor will be present in the frame if this sample
+ * or the previous sample is the sample nearest a frame tick.
+ * @param frame Frame structure.
+ * @param index Sensor index.
+ * @param ticks Ticks of the sample.
+ * @param sampleRate Sample rate in Hz.
+ * @param sensor Sensor.
+ */
+void FrameSetSensor(Frame * const frame, const int index, const uint64_t ticks, const float sampleRate, const SendFrameSensor * const sensor) {
+
+    // Do nothing if message disabled
+    const uint32_t rateDivisor = frame->settings.frameMessageRateDivisor * SendGetRateDivisorMultipliers()->frame;
+    if (rateDivisor == 0) {
+        return;
+    }
+
+    // Set pending frame if frame tick between previous sample and this sample
+    const uint64_t previousTicks = frame->previousTicks[index];
+    const double period = (double) TIMER_TICKS_PER_SECOND / (double) sampleRate;
+    const double framePeriod = period * (double) rateDivisor;
+    const uint64_t number = (uint64_t) (((double) ticks + TOLERANCE) / framePeriod);
+    const double frameTicks = (double) number * framePeriod;
+    if ((previousTicks != 0) && (((double) previousTicks + TOLERANCE) < frameTicks) && ((double) (ticks - previousTicks) <= (MAX_INTERVAL * period))) {
+        if (frame->framePeriod != framePeriod) {
+            frame->framePeriod = framePeriod;
+            Restart(frame, number);
+        }
+        const bool previousNearest = (frameTicks - (double) previousTicks) < ((double) ticks - frameTicks);
+        SetPending(frame, index, number, (uint64_t) frameTicks, previousNearest ? &frame->previousSensors[index] : sensor);
+    }
+
+    // Store sample
+    frame->previousTicks[index] = ticks;
+    frame->previousSensors[index] = *sensor;
+    frame->latest[index] = number;
+    frame->expected |= 1UL << index;
+}
+
+/**
+ * @brief Sets the sample of a sensor in a pending frame.
+ * @param frame Frame structure.
+ * @param index Sensor index.
+ * @param number Frame number.
+ * @param ticks Ticks of the frame.
+ * @param sensor Sensor.
+ */
+static void SetPending(Frame * const frame, const int index, const uint64_t number, const uint64_t ticks, const SendFrameSensor * const sensor) {
+
+    // Restart if too far ahead of pending frames
+    if ((number >= frame->oldest) && ((number - frame->oldest) >= (2 * FRAME_NUMBER_OF_PENDING_FRAMES))) {
+        Restart(frame, number);
+    }
+
+    // Do nothing if frame already sent
+    if (number < frame->oldest) {
+        return;
+    }
+
+    // Send frames without the sensors that are behind, which are then no longer expected
+    while ((number - frame->oldest) >= FRAME_NUMBER_OF_PENDING_FRAMES) {
+        const uint32_t presence = frame->pending[frame->oldest % FRAME_NUMBER_OF_PENDING_FRAMES].presence;
+        if (presence != 0) {
+            frame->expected &= presence;
+        }
+        SendOldest(frame);
+    }
+
+    // Set sensor
+    FramePending * const pending = &frame->pending[number % FRAME_NUMBER_OF_PENDING_FRAMES];
+    pending->ticks = ticks;
+    pending->sensors[index] = *sensor;
+    pending->presence |= 1UL << index;
+}
+
+/**
+ * @brief Sends pending frames, in order, for which the sample of each expected
+ * sensor has been set. This function should be called after the samples of
+ * all sensors are set.
+ * @param frame Frame structure.
+ */
+void FrameUpdate(Frame * const frame) {
+    if (frame->settings.frameMessageRateDivisor == 0) {
+        return;
+    }
+    while ((frame->expected != 0) && IsComplete(frame)) {
+        SendOldest(frame);
+    }
+}
+
+/**
+ * @brief Sends all pending frames and restarts the frames from a frame
+ * number.
+ * @param frame Frame structure.
+ * @param number Frame number.
+ */
+static void Restart(Frame * const frame, const uint64_t number) {
+    for (int count = 0; count < FRAME_NUMBER_OF_PENDING_FRAMES; count++) {
+        SendOldest(frame);
+    }
+    frame->oldest = number;
+    frame->expected = 0;
+}
+
+/**
+ * @brief Returns true if each expected sensor has set its sample of the oldest
+ * frame or a sample after the frame tick.
+ * @param frame Frame structure.
+ * @return True if the oldest frame is complete.
+ */
+static bool IsComplete(const Frame * const frame) {
+    const uint32_t missing = frame->expected & ~frame->pending[frame->oldest % FRAME_NUMBER_OF_PENDING_FRAMES].presence;
+    for (int index = 0; index < FRAME_NUMBER_OF_SENSORS; index++) {
+        if (((missing & (1UL << index)) != 0) && (frame->latest[index] < frame->oldest)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sends the oldest frame if any sensors are present.
+ * @param frame Frame structure.
+ */
+static void SendOldest(Frame * const frame) {
+    FramePending * const pending = &frame->pending[frame->oldest % FRAME_NUMBER_OF_PENDING_FRAMES];
+    if (pending->presence != 0) {
+        const SendFrameData frameData = {
+            .ticks = pending->ticks,
+            .presence = pending->presence,
+            .sensors = pending->sensors,
+            .numberOfSensors = FRAME_NUMBER_OF_SENSORS,
+        };
+        SendFrame(frame->send, &frameData);
+        pending->presence = 0;
+    }
+    frame->oldest++;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,77 @@
+/**
+ * @file Frame.h
+ * @author Seb Madgwick
+ * @brief Synchronous frames of the sample of all sensors at each frame tick.
+ */
+
+#ifndef FRAME_H
+#define FRAME_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Send/Send.h"
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of sensors. Sensors are in the order of the IMUs.
+ */
+#define FRAME_NUMBER_OF_SENSORS (20)
+
+/**
+ * @brief Number of frames that may be pending while the samples of all
+ * sensors are gathered. A frame is sent without the sensors that are behind
+ * if another sensor is this many frames ahead.
+ */
+#define FRAME_NUMBER_OF_PENDING_FRAMES (16)
+
+/**
+ * @brief Settings.
+ */
+typedef struct {
+    uint32_t frameMessageRateDivisor;
+} FrameSettings;
+
+/**
+ * @brief Pending frame. All structure members are private.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint32_t presence;
+    SendFrameSensor sensors[FRAME_NUMBER_OF_SENSORS];
+} FramePending;
+
+/**
+ * @brief Frame structure.
+ */
+typedef struct {
+    FrameSettings settings; // private
+    FramePending pending[FRAME_NUMBER_OF_PENDING_FRAMES]; // private
+    double framePeriod; // private
+    uint64_t oldest; // private
+    uint64_t latest[FRAME_NUMBER_OF_SENSORS]; // private
+    uint32_t expected; // private
+    uint64_t previousTicks[FRAME_NUMBER_OF_SENSORS]; // private
+    SendFrameSensor previousSensors[FRAME_NUMBER_OF_SENSORS]; // private
+    Send * const send; // private
+} Frame;
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern Frame frame;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void FrameSetSettings(Frame * const frame, const FrameSettings * const settings);
+void FrameSetSensor(Frame * const frame, const int index, const uint64_t ticks, const float sampleRate, const SendFrameSensor * const sensor);
+void FrameUpdate(Frame * const frame);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
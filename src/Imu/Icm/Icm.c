@@ -7,7 +7,72 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Cache.h"
+#include "definitions.h"
 #include "Icm.h"
+#include "IcmConfig.h"
+#include "Profile/Profile.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum duration of the initialisation before the ICM is considered
+ * to have failed.
+ */
+#define INITIALISATION_TIMEOUT (200 * TIMER_TICKS_PER_MILLISECOND)
+
+/**
+ * @brief Maximum duration of a transfer in progress when the ICM is
+ * reconfigured or deinitialised.
+ */
+#define TRANSFER_TIMEOUT (10 * TIMER_TICKS_PER_MILLISECOND)
+
+/**
+ * @brief ICM structure initialiser. n is the ICM number in IcmConfig.h.
+ */
+#define ICM(n) { \
+    .spiBus = &ICM##n##_SPI_BUS, \
+    .csPin = ICM##n##_CS_PIN, \
+    .intPin = ICM##n##_INT_PIN, \
+    .spiPacket = &spiPackets[n - 1], \
+    .spiFifoPacket = &spiFifoPackets[n - 1], \
+    .ring = {.slots = samples[n - 1], .slotSize = sizeof (IcmSample), .numberOfSlots = ICM_NUMBER_OF_SAMPLES}, \
+}
+
+/**
+ * @brief Conversion from register values to units of degrees per second, g,
+ * and degrees Celsius. The scales include the sign of each axis so that the
+ * sensor axes are aligned with the device axes.
+ */
+typedef struct {
+    float gyroscopeX;
+    float gyroscopeY;
+    float gyroscopeZ;
+    float accelerometerX;
+    float accelerometerY;
+    float accelerometerZ;
+    float temperature;
+    float temperatureOffset;
+} Conversion;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static bool Stop(Icm * const icm);
+static void ResetAcquisition(Icm * const icm);
+static void AddRegisterWrite(Icm * const icm, const uint8_t bank, const uint8_t address, const uint8_t value);
+static void ReadRegister(Icm * const icm, const uint8_t address);
+static void WriteRegister(Icm * const icm, const uint8_t address, const uint8_t value);
+static void ExternalInterrupt(GPIO_PIN pin, uintptr_t context);
+static void TransferComplete(void* const context);
+static void ReadFifo(Icm * const icm);
+static void FifoTransferComplete(void* const context);
+static void InvalidateSamples(const Icm * const icm, const IcmSample * const samples, const size_t numberOfSamples);
+static void ConvertBatch(const IcmSample * const samples, const size_t numberOfSamples, IcmDataBatch * const batch, const size_t offset);
 
 //------------------------------------------------------------------------------
 // Variables
@@ -18,6 +83,44 @@ const SpiSettings icmSpiSettings = {
     .clockPhase = SpiClockPhaseIdleToActive,
 };
 
+static const Conversion conversion = {
+    .gyroscopeX = -1.0f / 16.4f,
+    .gyroscopeY = -1.0f / 16.4f,
+    .gyroscopeZ = 1.0f / 16.4f,
+    .accelerometerX = -1.0f / 2048.0f,
+    .accelerometerY = -1.0f / 2048.0f,
+    .accelerometerZ = 1.0f / 2048.0f,
+    .temperature = 1.0f / 132.48f,
+    .temperatureOffset = 25.0f,
+};
+
+static volatile __attribute__((coherent)) IcmSpiPacket spiPackets[ICM_NUMBER_OF_ICMS];
+static volatile __attribute__((coherent)) IcmSpiFifoPacket spiFifoPackets[ICM_NUMBER_OF_ICMS];
+static __attribute__((aligned(CACHE_LINE_BYTES))) IcmSample samples[ICM_NUMBER_OF_ICMS][ICM_NUMBER_OF_SAMPLES]; // cacheable so that samples are not read from uncached memory
+
+Icm icms[ICM_NUMBER_OF_ICMS] = {
+    ICM(1),
+    ICM(2),
+    ICM(3),
+    ICM(4),
+    ICM(5),
+    ICM(6),
+    ICM(7),
+    ICM(8),
+    ICM(9),
+    ICM(10),
+    ICM(11),
+    ICM(12),
+    ICM(13),
+    ICM(14),
+    ICM(15),
+    ICM(16),
+    ICM(17),
+    ICM(18),
+    ICM(19),
+    ICM(20),
+};
+
 const IcmAaf icmAaf42Hz = {.delt = 1, .deltsqr = 1, .bitshift = 15};
 const IcmAaf icmAaf84Hz = {.delt = 2, .deltsqr = 4, .bitshift = 13};
 const IcmAaf icmAaf126Hz = {.delt = 3, .deltsqr = 9, .bitshift = 12};
@@ -276,5 +379,673 @@ const char* IcmTestResultToString(const IcmTestResult result) {
     return ""; // avoid compiler warning
 }
 
+/**
+ * @brief Initialises the module. This function does not block. The ICM is
+ * reset, configured, and powered on by IcmTasks so that all ICMs may be
+ * initialised concurrently. If the ICM is already running then only the
+ * registers that differ from the current configuration are written and the
+ * ICM is not reset. If the sample rate, FIFO watermark, or sensor timestamp
+ * differ then buffered samples are discarded and the FIFO is flushed so that
+ * samples acquired with the previous configuration are not interpreted with the
+ * new configuration.
+ * @param icm ICM structure.
+ * @param settings Settings.
+ */
+void IcmInitialise(Icm * const icm, const IcmSettings * const settings) {
+
+    // Add SPI bus client
+    if (icm->spiBusClient == NULL) {
+        icm->spiBusClient = icm->spiBus->addClient(icm->csPin);
+    }
+
+    // Limit settings
+    uint32_t fifoWatermark = settings->fifoWatermark > ICM_MAX_FIFO_WATERMARK ? ICM_MAX_FIFO_WATERMARK : settings->fifoWatermark;
+    if (settings->sensorTimestampEnabled && (fifoWatermark == 0)) {
+        fifoWatermark = 1; // sensor timestamp only available in FIFO
+    }
+    const uint32_t samplePeriod = TIMER_TICKS_PER_SECOND / settings->sampleRate;
+
+    // Reconfigure without reset if the ICM is running with a known configuration
+    const bool reset = (icm->state != IcmStateRunning) || (icm->shadowRegistersValid == false) || (icm->deviceId != ICM_WHO_AM_I_RESET_VALUE);
+    const bool acquisitionChanged = (fifoWatermark != icm->fifoWatermark) || (samplePeriod != icm->samplePeriod) || (settings->sensorTimestampEnabled != icm->sensorTimestampEnabled);
+    if (reset) {
+        IcmDeinitialise(icm);
+    } else {
+        if (Stop(icm) == false) {
+            icm->state = IcmStateIdle; // failed
+            return;
+        }
+        icm->numberOfRegisterWrites = 0;
+        icm->registerWriteIndex = 0;
+        if (acquisitionChanged) {
+            ResetAcquisition(icm);
+        }
+    }
+
+    // Store settings
+    icm->fifoWatermark = fifoWatermark;
+    icm->samplePeriod = samplePeriod;
+    icm->sensorTimestampEnabled = settings->sensorTimestampEnabled;
+
+    // Configure endianness
+    IcmIntfConfig0Register intfConfig0Register = {.value = ICM_INTF_CONFIG0_RESET_VALUE};
+    intfConfig0Register.sensorDataEndian = 0; // sensor data is reported in Little Endian format
+    intfConfig0Register.fifoCountEndian = 0; // FIFO count is reported in Little Endian format
+    intfConfig0Register.fifoCountRec = 1; // FIFO count is reported in records
+    AddRegisterWrite(icm, 0, ICM_INTF_CONFIG0_ADDRESS, intfConfig0Register.value);
+
+    // Configure interrupt pin
+    IcmIntConfigRegister intConfigRegister = {.value = ICM_INT_CONFIG_RESET_VALUE};
+    intConfigRegister.int1DriveCircuit = 1; // push pull
+    AddRegisterWrite(icm, 0, ICM_INT_CONFIG_ADDRESS, intConfigRegister.value);
+
+    // Configure interrupt pulse
+    IcmIntConfig1Register intConfig1Register = {.value = ICM_INT_CONFIG1_RESET_VALUE};
+    intConfig1Register.intTpulseDuration = 1; // interrupt pulse duration is 8 us. Required if ODR > 4kHz, optional for ODR < 4kHz.
+    intConfig1Register.intTdeassertDisable = 1; // disables de-assert duration. Required if ODR > 4kHz, optional for ODR < 4kHz
+    intConfig1Register.intAsyncReset = 1; // user should change setting to 0 from default setting of 1, for proper INT1 and INT2 pin operation
+    AddRegisterWrite(icm, 0, ICM_INT_CONFIG1_ADDRESS, intConfig1Register.value);
+
+    // Configure interrupt source
+    IcmIntSource0Register intSource0Register = {.value = ICM_INT_SOURCE0_RESET_VALUE};
+    if (icm->fifoWatermark > 0) {
+        intSource0Register.fifoThsInt1En = 1; // FIFO threshold interrupt routed to INT1
+    } else {
+        intSource0Register.uiDrdyInt1En = 1; // UI data ready interrupt routed to INT1
+    }
+    AddRegisterWrite(icm, 0, ICM_INT_SOURCE0_ADDRESS, intSource0Register.value);
+
+    // Configure gyroscope anti-aliasing filter
+    const IcmAaf gyroscopeAaf = IcmAntiAliasingToAaf(settings->gyroscopeAntiAliasing);
+    IcmGyroConfigStatic2Register gyroConfigStatic2Register = {.value = ICM_GYRO_CONFIG_STATIC2_RESET_VALUE};
+    gyroConfigStatic2Register.gyroAafDis = settings->gyroscopeAntiAliasing == IcmAntiAliasingDisabled ? 1 : 0;
+    gyroConfigStatic2Register.gyroNfDis = settings->gyroscopeNotchFilterEnabled == false ? 1 : 0;
+    AddRegisterWrite(icm, 1, ICM_GYRO_CONFIG_STATIC2_ADDRESS, gyroConfigStatic2Register.value);
+
+    IcmGyroConfigStatic3Register gyroConfigStatic3Register = {.value = ICM_GYRO_CONFIG_STATIC3_RESET_VALUE};
+    gyroConfigStatic3Register.gyroAafDelt = gyroscopeAaf.delt;
+    AddRegisterWrite(icm, 1, ICM_GYRO_CONFIG_STATIC3_ADDRESS, gyroConfigStatic3Register.value);
+
+    IcmGyroConfigStatic4Register gyroConfigStatic4Register = {.value = ICM_GYRO_CONFIG_STATIC4_RESET_VALUE};
+    gyroConfigStatic4Register.gyroAafDeltsqrLsb = gyroscopeAaf.deltsqr & 0xFF;
+    AddRegisterWrite(icm, 1, ICM_GYRO_CONFIG_STATIC4_ADDRESS, gyroConfigStatic4Register.value);
+
+    IcmGyroConfigStatic5Register gyroConfigStatic5Register = {.value = ICM_GYRO_CONFIG_STATIC5_RESET_VALUE};
+    gyroConfigStatic5Register.gyroAafDeltsqrMsb = gyroscopeAaf.deltsqr >> 8;
+    gyroConfigStatic5Register.gyroAafBitshift = gyroscopeAaf.bitshift;
+    AddRegisterWrite(icm, 1, ICM_GYRO_CONFIG_STATIC5_ADDRESS, gyroConfigStatic5Register.value);
+
+    // Configure accelerometer anti-aliasing filter
+    const IcmAaf accelerometerAaf = IcmAntiAliasingToAaf(settings->accelerometerAntiAliasing);
+    IcmAccelConfigStatic2Register accelConfigStatic2Register = {.value = ICM_ACCEL_CONFIG_STATIC2_RESET_VALUE};
+    accelConfigStatic2Register.accelAafDis = settings->accelerometerAntiAliasing == IcmAntiAliasingDisabled ? 1 : 0;
+    accelConfigStatic2Register.accelAafDelt = accelerometerAaf.delt;
+    AddRegisterWrite(icm, 2, ICM_ACCEL_CONFIG_STATIC2_ADDRESS, accelConfigStatic2Register.value);
+
+    IcmAccelConfigStatic3Register accelConfigStatic3Register = {.value = ICM_ACCEL_CONFIG_STATIC3_RESET_VALUE};
+    accelConfigStatic3Register.accelAafDeltsqrLsb = accelerometerAaf.deltsqr & 0xFF;
+    AddRegisterWrite(icm, 2, ICM_ACCEL_CONFIG_STATIC3_ADDRESS, accelConfigStatic3Register.value);
+
+    IcmAccelConfigStatic4Register accelConfigStatic4Register = {.value = ICM_ACCEL_CONFIG_STATIC4_RESET_VALUE};
+    accelConfigStatic4Register.accelAafDeltsqrMsb = accelerometerAaf.deltsqr >> 8;
+    accelConfigStatic4Register.accelAafBitshift = accelerometerAaf.bitshift;
+    AddRegisterWrite(icm, 2, ICM_ACCEL_CONFIG_STATIC4_ADDRESS, accelConfigStatic4Register.value);
+
+    // Configure gyroscope ODR
+    IcmGyroConfig0Register gyroConfig0Register = {.value = ICM_GYRO_CONFIG0_RESET_VALUE};
+    gyroConfig0Register.gyroOdr = IcmSampleRateToOdr(settings->sampleRate);
+    AddRegisterWrite(icm, 0, ICM_GYRO_CONFIG0_ADDRESS, gyroConfig0Register.value);
+
+    // Configure accelerometer ODR
+    IcmAccelConfig0Register accelConfig0Register = {.value = ICM_ACCEL_CONFIG0_RESET_VALUE};
+    accelConfig0Register.accelOdr = IcmSampleRateToOdr(settings->sampleRate);
+    AddRegisterWrite(icm, 0, ICM_ACCEL_CONFIG0_ADDRESS, accelConfig0Register.value);
+
+    // Configure timestamp
+    const uint32_t timestampResolution = settings->sampleRate < IcmSampleRate25Hz ? 16 : 1; // 16-bit timestamp must not wrap between samples
+    IcmTmstConfigRegister tmstConfigRegister = {.value = ICM_TMST_CONFIG_RESET_VALUE};
+    tmstConfigRegister.tmstRes = timestampResolution == 16 ? 1 : 0;
+    AddRegisterWrite(icm, 0, ICM_TMST_CONFIG_ADDRESS, tmstConfigRegister.value);
+    if (reset || acquisitionChanged) {
+        IcmTimestampInitialise(&icm->timestamp, timestampResolution);
+    }
+
+    // Configure FIFO. Registers are written even if the FIFO is unused so that the configuration sequence is always the same length.
+    IcmFifoConfig1Register fifoConfig1Register = {.value = ICM_FIFO_CONFIG1_RESET_VALUE};
+    IcmFifoConfig2Register fifoConfig2Register = {.value = ICM_FIFO_CONFIG2_RESET_VALUE};
+    IcmFifoConfig3Register fifoConfig3Register = {.value = ICM_FIFO_CONFIG3_RESET_VALUE};
+    IcmFifoConfigRegister fifoConfigRegister = {.value = ICM_FIFO_CONFIG_RESET_VALUE};
+    if (icm->fifoWatermark > 0) {
+        fifoConfig1Register.fifoAccelEn = 1;
+        fifoConfig1Register.fifoGyroEn = 1;
+        fifoConfig1Register.fifoTempEn = 1;
+        fifoConfig1Register.fifoWmGtTh = 1; // interrupt generated on every ODR while FIFO count is greater than or equal to watermark
+        fifoConfig2Register.fifoWmLsb = icm->fifoWatermark & 0xFF;
+        fifoConfig3Register.fifoWmMsb = icm->fifoWatermark >> 8;
+        fifoConfigRegister.fifoMode = 0b01; // stream-to-FIFO mode
+    }
+    AddRegisterWrite(icm, 0, ICM_FIFO_CONFIG1_ADDRESS, fifoConfig1Register.value);
+    AddRegisterWrite(icm, 0, ICM_FIFO_CONFIG2_ADDRESS, fifoConfig2Register.value);
+    AddRegisterWrite(icm, 0, ICM_FIFO_CONFIG3_ADDRESS, fifoConfig3Register.value);
+    AddRegisterWrite(icm, 0, ICM_FIFO_CONFIG_ADDRESS, fifoConfigRegister.value);
+
+    // Turn on gyroscope and accelerometer
+    IcmPwrMgmt0Register pwrMgmt0Register = {.value = ICM_PWR_MGMT0_RESET_VALUE};
+    pwrMgmt0Register.gyroMode = 0b11;
+    pwrMgmt0Register.accelMode = 0b11;
+    AddRegisterWrite(icm, 0, ICM_PWR_MGMT0_ADDRESS, pwrMgmt0Register.value);
+
+    // Begin initialisation
+    icm->reset = reset;
+    icm->fifoFlush = (reset == false) && acquisitionChanged; // FIFO is flushed by reset
+    icm->deadline = TimerGetTicks64() + INITIALISATION_TIMEOUT;
+    icm->state = reset ? IcmStateReadDeviceId : IcmStateConfigure;
+}
+
+/**
+ * @brief Deinitialises the module.
+ * @param icm ICM structure.
+ */
+void IcmDeinitialise(Icm * const icm) {
+    Stop(icm);
+    icm->state = IcmStateIdle;
+    icm->numberOfRegisterWrites = 0;
+    icm->registerWriteIndex = 0;
+    icm->shadowRegistersValid = false;
+    ResetAcquisition(icm);
+    icm->bufferOverflow = 0;
+}
+
+/**
+ * @brief Disables the interrupt and waits for the transfer in progress to
+ * complete.
+ * @param icm ICM structure.
+ * @return True if the transfer completed before the timeout.
+ */
+static bool Stop(Icm * const icm) {
+    GPIO_PinIntDisable(icm->intPin);
+    const uint64_t timeout = TimerGetTicks64() + TRANSFER_TIMEOUT;
+    while (icm->spiBus->transferInProgress(icm->spiBusClient)) {
+        if (TimerGetTicks64() > timeout) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Resets the acquisition state and discards buffered samples. The
+ * interrupt must be disabled and no transfer may be in progress. Samples
+ * written by the CPU in FIFO mode may remain dirty in the cache and so must
+ * not be read once data-ready mode invalidates the samples read.
+ * @param icm ICM structure.
+ */
+static void ResetAcquisition(Icm * const icm) {
+    icm->fifoReadPending = false;
+    icm->fifoReadInProgress = false;
+    icm->fifoBacklog = 0;
+    icm->previousPacketTicks = 0;
+    icm->firstSampleTicks = 0;
+    RingClear(&icm->ring);
+}
+
+/**
+ * @brief Module tasks. This function should be called repeatedly within the
+ * main program loop. Each call begins at most one register transfer so that
+ * the initialisation of ICMs on different SPI buses overlaps. The ICM is
+ * considered to have failed and returns to idle if the initialisation is not
+ * complete within the timeout.
+ * @param icm ICM structure.
+ */
+void IcmTasks(Icm * const icm) {
+    if ((icm->state != IcmStateIdle) && (icm->state != IcmStateRunning) && (TimerGetTicks64() > icm->deadline)) {
+        GPIO_PinIntDisable(icm->intPin);
+        icm->state = IcmStateIdle; // failed
+        return;
+    }
+    if (icm->spiBus->transferInProgress(icm->spiBusClient)) {
+        return;
+    }
+    switch (icm->state) {
+        case IcmStateIdle:
+            return;
+        case IcmStateReadDeviceId:
+            ReadRegister(icm, ICM_WHO_AM_I_ADDRESS);
+            icm->state = IcmStateSoftReset;
+            return;
+        case IcmStateSoftReset: {
+            icm->deviceId = icm->spiPacket->data[0];
+            IcmDeviceConfigRegister deviceConfigRegister = {.value = ICM_DEVICE_CONFIG_RESET_VALUE};
+            deviceConfigRegister.softResetConfig = 1;
+            WriteRegister(icm, ICM_DEVICE_CONFIG_ADDRESS, deviceConfigRegister.value);
+            icm->bank = 0;
+            icm->timeout = TimerGetTicks64() + TIMER_TICKS_PER_MILLISECOND;
+            icm->state = IcmStateWaitForReset;
+            return;
+        }
+        case IcmStateWaitForReset:
+            if (TimerGetTicks64() < icm->timeout) {
+                return;
+            }
+            icm->state = IcmStateConfigure;
+            return;
+        case IcmStateConfigure:
+            while (icm->registerWriteIndex < icm->numberOfRegisterWrites) {
+                const int index = icm->registerWriteIndex;
+                const IcmRegisterWrite * const registerWrite = &icm->registerWrites[index];
+                if (icm->shadowRegistersValid && (icm->shadowRegisters[index] == registerWrite->value)) {
+                    icm->registerWriteIndex++; // skip unchanged register
+                    continue;
+                }
+                if (icm->bank != registerWrite->bank) {
+                    WriteRegister(icm, ICM_REG_BANK_SEL_ADDRESS, registerWrite->bank);
+                    icm->bank = registerWrite->bank;
+                    return;
+                }
+                WriteRegister(icm, registerWrite->address, registerWrite->value);
+                icm->shadowRegisters[index] = registerWrite->value;
+                icm->registerWriteIndex++;
+                return;
+            }
+            if (icm->bank != 0) {
+                WriteRegister(icm, ICM_REG_BANK_SEL_ADDRESS, 0); // sensor data registers are in bank 0
+                icm->bank = 0;
+                return;
+            }
+            if (icm->fifoFlush) {
+                IcmSignalPathResetRegister signalPathResetRegister = {.value = ICM_SIGNAL_PATH_RESET_RESET_VALUE};
+                signalPathResetRegister.fifoFlush = 1; // discard packets acquired with the previous configuration
+                WriteRegister(icm, ICM_SIGNAL_PATH_RESET_ADDRESS, signalPathResetRegister.value);
+                icm->fifoFlush = false;
+                return;
+            }
+            icm->shadowRegistersValid = true;
+            icm->timeout = TimerGetTicks64() + (icm->reset ? (45 * TIMER_TICKS_PER_MILLISECOND) : 0); // gyroscope start-up time
+            icm->state = IcmStateWaitForPowerOn;
+            return;
+        case IcmStateWaitForPowerOn:
+            if (TimerGetTicks64() < icm->timeout) {
+                return;
+            }
+            GPIO_PinInterruptCallbackRegister(icm->intPin, ExternalInterrupt, (uintptr_t) icm);
+            GPIO_PinIntEnable(icm->intPin, GPIO_INTERRUPT_ON_BOTH_EDGES); // only both edges supported
+            icm->state = IcmStateRunning;
+            return;
+        case IcmStateRunning:
+            return;
+    }
+}
+
+/**
+ * @brief Returns true once the initialisation is complete or has failed.
+ * @param icm ICM structure.
+ * @return True once the initialisation is complete or has failed.
+ */
+bool IcmInitialisationComplete(const Icm * const icm) {
+    return (icm->state == IcmStateRunning) || (icm->state == IcmStateIdle);
+}
+
+/**
+ * @brief Returns the timer ticks of the first sample since initialisation.
+ * @param icm ICM structure.
+ * @return Timer ticks of the first sample since initialisation. 0 if no sample
+ * has been received.
+ */
+uint64_t IcmFirstSampleTicks(const Icm * const icm) {
+    return icm->firstSampleTicks;
+}
+
+/**
+ * @brief Adds a register write to the configuration sequence. The register
+ * bank is selected as required when the sequence is written.
+ * @param icm ICM structure.
+ * @param bank Register bank.
+ * @param address Address.
+ * @param value Value.
+ */
+static void AddRegisterWrite(Icm * const icm, const uint8_t bank, const uint8_t address, const uint8_t value) {
+    if (icm->numberOfRegisterWrites >= ICM_MAX_NUMBER_OF_REGISTER_WRITES) {
+        return;
+    }
+    icm->registerWrites[icm->numberOfRegisterWrites++] = (IcmRegisterWrite){.bank = bank, .address = address, .value = value};
+}
+
+/**
+ * @brief Begins a register read. The value will be available in the SPI packet
+ * once the transfer is complete.
+ * @param icm ICM structure.
+ * @param address Address.
+ */
+static void ReadRegister(Icm * const icm, const uint8_t address) {
+    *icm->spiPacket = (IcmSpiPacket){.rw = 1, .address = address};
+    icm->spiBus->transfer(icm->spiBusClient, icm->spiPacket, 2, NULL, NULL);
+}
+
+/**
+ * @brief Begins a register write.
+ * @param icm ICM structure.
+ * @param address Address.
+ * @param value Value.
+ */
+static void WriteRegister(Icm * const icm, const uint8_t address, const uint8_t value) {
+    *icm->spiPacket = (IcmSpiPacket){.rw = 0, .address = address, .value = value};
+    icm->spiBus->transfer(icm->spiBusClient, icm->spiPacket, 2, NULL, NULL);
+}
+
+/**
+ * @brief External interrupt callback.
+ * @param pin Pin.
+ * @param context Context.
+ */
+static void ExternalInterrupt(GPIO_PIN pin, uintptr_t context) {
+    PROFILE(ProfileProbeIcmInterrupt);
+    if (GPIO_PinRead(pin) == true) { // ignore rising edges
+        return;
+    }
+    Icm * const icm = (Icm *) context;
+    if (icm->fifoWatermark > 0) {
+        icm->ticks = TimerGetTicks64();
+        icm->fifoReadPending = true;
+        ReadFifo(icm);
+        return;
+    }
+    if (icm->spiBus->transferInProgress(icm->spiBusClient)) {
+        icm->bufferOverflow++; // data registers will be overwritten before they can be read
+        return;
+    }
+    icm->ticks = TimerGetTicks64();
+    IcmSample * const sample = RingWriteSlot(&icm->ring);
+    if (sample == NULL) {
+        icm->bufferOverflow++;
+        return;
+    }
+    sample->ticks = icm->ticks;
+    sample->command = 0x80 | ICM_TEMP_DATA1_ADDRESS; // read
+    CacheWritebackInvalidate(sample, sizeof (IcmSample)); // ring is cacheable so the sample must be in memory before the DMA transfer
+    icm->spiBus->transfer(icm->spiBusClient, &sample->command, sizeof (sample->command) + sizeof (sample->registers), TransferComplete, icm); // registers are read directly into the ring
+}
+
+/**
+ * @brief Begins a FIFO read if a FIFO read is not already in progress and
+ * either an interrupt is pending or packets remain in the FIFO. The read is
+ * sized to the remaining packets so that a backlog is drained by successive
+ * reads. This function is called by both the external interrupt and the FIFO
+ * transfer complete callback, which may interrupt each other.
+ * @param icm ICM structure.
+ */
+static void ReadFifo(Icm * const icm) {
+    do {
+        if (__atomic_exchange_n(&icm->fifoReadInProgress, true, __ATOMIC_SEQ_CST)) {
+            return; // FIFO will be read again once the current read is complete
+        }
+        const bool interrupt = __atomic_exchange_n(&icm->fifoReadPending, false, __ATOMIC_SEQ_CST);
+        if (interrupt || (icm->fifoBacklog > 0)) {
+            icm->fifoReadSize = icm->fifoBacklog > icm->fifoWatermark ? icm->fifoBacklog : icm->fifoWatermark;
+            if (icm->fifoReadSize > ICM_MAX_FIFO_WATERMARK) {
+                icm->fifoReadSize = ICM_MAX_FIFO_WATERMARK;
+            }
+            icm->spiFifoPacket->rw = 1;
+            icm->spiFifoPacket->address = ICM_FIFO_COUNTH_ADDRESS;
+            icm->spiBus->transfer(icm->spiBusClient, icm->spiFifoPacket, offsetof(IcmSpiFifoPacket, fifoData) + (icm->fifoReadSize * sizeof (IcmFifoDataPacket)), FifoTransferComplete, icm);
+            return;
+        }
+        __atomic_store_n(&icm->fifoReadInProgress, false, __ATOMIC_SEQ_CST);
+    } while (icm->fifoReadPending); // an interrupt may have occurred after the pending flag was read
+}
+
+/**
+ * @brief Transfer complete callback. The sample has been read directly into
+ * the ring and so only needs to be made available to read.
+ * @param context Context.
+ */
+static void TransferComplete(void* const context) {
+    PROFILE(ProfileProbeIcmTransfer);
+    Icm * const icm = context;
+    if (icm->firstSampleTicks == 0) {
+        icm->firstSampleTicks = icm->ticks;
+    }
+    RingWriteComplete(&icm->ring);
+}
+
+/**
+ * @brief FIFO transfer complete callback. The ICM interrupts for every sample
+ * while the FIFO count is greater than or equal to the watermark. If this was
+ * true when the FIFO count was read then the newest packet in the FIFO is
+ * anchored to the most recent interrupt at or before that time. Otherwise, the
+ * packets follow on from the previous packet. If the sensor timestamp is
+ * enabled then the ticks of each packet are mapped from the sensor timestamp.
+ * Otherwise, the ticks of each packet are extrapolated from the anchor or the
+ * previous packet. Packets lost to FIFO overflow are counted as buffer
+ * overflow.
+ * @param context Context.
+ */
+static void FifoTransferComplete(void* const context) {
+    PROFILE(ProfileProbeIcmTransfer);
+    Icm * const icm = context;
+
+    // Count valid packets
+    const uint32_t fifoCount = icm->spiFifoPacket->fifoCount;
+    uint32_t numberOfPackets = 0;
+    uint64_t sensorTimes[ICM_MAX_FIFO_WATERMARK];
+    while (numberOfPackets < icm->fifoReadSize) {
+        if (icm->spiFifoPacket->fifoData[numberOfPackets].header.headerMsg == 1) { // FIFO empty
+            break;
+        }
+        if (icm->sensorTimestampEnabled) {
+            sensorTimes[numberOfPackets] = IcmTimestampUnwrap(&icm->timestamp, icm->spiFifoPacket->fifoData[numberOfPackets].timestamp);
+        }
+        numberOfPackets++;
+    }
+    icm->fifoBacklog = fifoCount > numberOfPackets ? fifoCount - numberOfPackets : 0;
+    if (numberOfPackets > 0) {
+
+        // Anchor newest packet to interrupt ticks
+        const bool anchored = (fifoCount >= icm->fifoWatermark) && (fifoCount > 0);
+        uint64_t firstPacketTicks;
+        if (anchored) {
+            const uint64_t countTicks = TimerGetTicks64() - ((uint64_t) (offsetof(IcmSpiFifoPacket, fifoData) + (icm->fifoReadSize * sizeof (IcmFifoDataPacket))) * 8 * TIMER_TICKS_PER_SECOND / icmSpiSettings.clockFrequency);
+            uint64_t newestPacketTicks;
+            do {
+                newestPacketTicks = icm->ticks;
+            } while (newestPacketTicks != icm->ticks); // ticks may be written by the external interrupt while being read
+            if (newestPacketTicks > countTicks) {
+                newestPacketTicks -= ((newestPacketTicks - countTicks + icm->samplePeriod - 1) / icm->samplePeriod) * icm->samplePeriod; // interrupts after FIFO count was read
+            }
+            firstPacketTicks = newestPacketTicks - ((uint64_t) (fifoCount - 1) * icm->samplePeriod);
+        } else {
+            firstPacketTicks = icm->previousPacketTicks + icm->samplePeriod;
+        }
+
+        // Count packets lost to FIFO overflow
+        if (anchored && (icm->previousPacketTicks != 0) && (fifoCount >= ICM_FIFO_CAPACITY)) {
+            const uint64_t numberOfPeriods = ((firstPacketTicks - icm->previousPacketTicks) + (icm->samplePeriod / 2)) / icm->samplePeriod;
+            if (numberOfPeriods > 1) {
+                icm->bufferOverflow += numberOfPeriods - 1;
+            }
+        }
+
+        // Update sensor timestamp estimate
+        if (icm->sensorTimestampEnabled && anchored && (numberOfPackets >= fifoCount)) {
+            IcmTimestampUpdate(&icm->timestamp, sensorTimes[fifoCount - 1], firstPacketTicks + ((uint64_t) (fifoCount - 1) * icm->samplePeriod));
+        }
+
+        // Write packets to ring
+        for (uint32_t index = 0; index < numberOfPackets; index++) {
+            const uint64_t ticks = icm->sensorTimestampEnabled ? IcmTimestampToTicks(&icm->timestamp, sensorTimes[index]) : firstPacketTicks + ((uint64_t) index * icm->samplePeriod);
+            icm->previousPacketTicks = ticks;
+            if (icm->firstSampleTicks == 0) {
+                icm->firstSampleTicks = ticks;
+            }
+            IcmSample * const sample = RingWriteSlot(&icm->ring);
+            if (sample == NULL) {
+                icm->bufferOverflow++;
+                continue;
+            }
+            const volatile IcmFifoDataPacket * const fifoDataPacket = &icm->spiFifoPacket->fifoData[index];
+            sample->ticks = ticks;
+            sample->registers = (IcmSensorRegisters){
+                .tempData = (int16_t) fifoDataPacket->tempData * 64, // FIFO temperature sensitivity is 1/64 of register sensitivity
+                .accelDataX = fifoDataPacket->accelDataX,
+                .accelDataY = fifoDataPacket->accelDataY,
+                .accelDataZ = fifoDataPacket->accelDataZ,
+                .gyroDataX = fifoDataPacket->gyroDataX,
+                .gyroDataY = fifoDataPacket->gyroDataY,
+                .gyroDataZ = fifoDataPacket->gyroDataZ,
+            };
+            RingWriteComplete(&icm->ring);
+        }
+    }
+
+    // Read remaining packets
+    __atomic_store_n(&icm->fifoReadInProgress, false, __ATOMIC_SEQ_CST);
+    ReadFifo(icm);
+}
+
+/**
+ * @brief Gets data.
+ * @param icm ICM structure.
+ * @param data Data.
+ * @return Result.
+ */
+IcmResult IcmGetData(Icm * const icm, IcmData * const data) {
+    const IcmSample * const sample = RingReadSlot(&icm->ring);
+    if (sample == NULL) {
+        return IcmResultError;
+    }
+    InvalidateSamples(icm, sample, 1);
+    data->ticks = sample->ticks;
+    data->gyroscopeX = (float) sample->registers.gyroDataX * conversion.gyroscopeX;
+    data->gyroscopeY = (float) sample->registers.gyroDataY * conversion.gyroscopeY;
+    data->gyroscopeZ = (float) sample->registers.gyroDataZ * conversion.gyroscopeZ;
+    data->accelerometerX = (float) sample->registers.accelDataX * conversion.accelerometerX;
+    data->accelerometerY = (float) sample->registers.accelDataY * conversion.accelerometerY;
+    data->accelerometerZ = (float) sample->registers.accelDataZ * conversion.accelerometerZ;
+    data->temperature = ((float) sample->registers.tempData * conversion.temperature) + conversion.temperatureOffset;
+    RingReadComplete(&icm->ring);
+    return IcmResultOk;
+}
+
+/**
+ * @brief Gets up to the specified number of samples as a batch.
+ * @param icm ICM structure.
+ * @param batch Batch.
+ * @param numberOfSamples Maximum number of samples. Limited to
+ * ICM_MAX_BATCH_SIZE.
+ * @return Number of samples in the batch.
+ */
+size_t IcmGetDataBatch(Icm * const icm, IcmDataBatch * const batch, size_t numberOfSamples) {
+    if (numberOfSamples > ICM_MAX_BATCH_SIZE) {
+        numberOfSamples = ICM_MAX_BATCH_SIZE;
+    }
+    size_t offset = 0;
+    while (offset < numberOfSamples) { // up to two blocks if data wraps around end of ring
+        size_t numberOfSlots;
+        const IcmSample * const samples = RingReadSlots(&icm->ring, &numberOfSlots);
+        if (numberOfSlots == 0) {
+            break;
+        }
+        if (numberOfSlots > (numberOfSamples - offset)) {
+            numberOfSlots = numberOfSamples - offset;
+        }
+        InvalidateSamples(icm, samples, numberOfSlots);
+        ConvertBatch(samples, numberOfSlots, batch, offset);
+        RingReadSlotsComplete(&icm->ring, numberOfSlots);
+        offset += numberOfSlots;
+    }
+    return offset;
+}
+
+/**
+ * @brief Invalidates the cache lines of samples written by DMA so that the
+ * registers are read from memory. Samples written by the CPU in FIFO mode are
+ * not invalidated because they may not have been written back. The transfer
+ * of each sample in data-ready mode writes back and invalidates the cache lines
+ * of the sample, including those shared with adjacent samples, and so cache
+ * lines of the ring are never dirty when this function is called.
+ * @param icm ICM structure.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ */
+static void InvalidateSamples(const Icm * const icm, const IcmSample * const samples, const size_t numberOfSamples) {
+    if (icm->fifoWatermark == 0) {
+        CacheInvalidate(samples, numberOfSamples * sizeof (IcmSample));
+    }
+}
+
+/**
+ * @brief Converts samples to a batch. Each output array is written by a
+ * separate loop with no dependencies between iterations so that the compiler
+ * may unroll and vectorise each loop.
+ * @param samples Samples.
+ * @param numberOfSamples Number of samples.
+ * @param batch Batch.
+ * @param offset Index of the first sample in the batch.
+ */
+static void ConvertBatch(const IcmSample * const samples, const size_t numberOfSamples, IcmDataBatch * const batch, const size_t offset) {
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        batch->ticks[offset + index] = samples[index].ticks;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        batch->gyroscopeX[offset + index] = (float) samples[index].registers.gyroDataX * conversion.gyroscopeX;
+        batch->gyroscopeY[offset + index] = (float) samples[index].registers.gyroDataY * conversion.gyroscopeY;
+        batch->gyroscopeZ[offset + index] = (float) samples[index].registers.gyroDataZ * conversion.gyroscopeZ;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        batch->accelerometerX[offset + index] = (float) samples[index].registers.accelDataX * conversion.accelerometerX;
+        batch->accelerometerY[offset + index] = (float) samples[index].registers.accelDataY * conversion.accelerometerY;
+        batch->accelerometerZ[offset + index] = (float) samples[index].registers.accelDataZ * conversion.accelerometerZ;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        batch->temperature[offset + index] = ((float) samples[index].registers.tempData * conversion.temperature) + conversion.temperatureOffset;
+    }
+}
+
+/**
+ * @brief Returns the number of samples available to read.
+ * @param icm ICM structure.
+ * @return Number of samples available to read.
+ */
+size_t IcmBufferCount(Icm * const icm) {
+    return RingAvailableRead(&icm->ring);
+}
+
+/**
+ * @brief Returns the number of samples lost due to buffer overflow. Calling
+ * this function will reset the value.
+ * @param icm ICM structure.
+ * @return Number of samples lost due to buffer overflow.
+ */
+uint32_t IcmBufferOverflow(Icm * const icm) {
+    return __sync_lock_test_and_set(&icm->bufferOverflow, 0);
+}
+
+/**
+ * @brief Performs self-test.
+ * @param icm ICM structure.
+ * @return Test result.
+ */
+IcmTestResult IcmTest(Icm * const icm) {
+
+    // Check device ID
+    if (icm->deviceId != ICM_WHO_AM_I_RESET_VALUE) {
+        return IcmTestResultInvalidId;
+    }
+
+    // Check interrupt
+    const uint64_t timeout = TimerGetTicks64() + (TIMER_TICKS_PER_SECOND / 10) + ((uint64_t) icm->fifoWatermark * icm->samplePeriod);
+    while (true) {
+        IcmData data;
+        if (IcmGetData(icm, &data) == IcmResultOk) {
+            break;
+        }
+        if (TimerGetTicks64() > timeout) {
+            return IcmTestResultInterruptFailed;
+        }
+    }
+
+    // Self-test passed
+    return IcmTestResultPassed;
+}
+
 //------------------------------------------------------------------------------
 // End of file
@@ -11,8 +11,12 @@
 // Includes
 
 #include "IcmRegisters.h"
+#include "IcmTimestamp.h"
+#include "Ring.h"
 #include "Spi/Spi.h"
+#include "Spi/SpiBus.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 //------------------------------------------------------------------------------
@@ -31,6 +35,27 @@ typedef struct {
     };
 } __attribute__((__packed__)) IcmSpiPacket;
 
+/**
+ * @brief Maximum FIFO watermark.
+ */
+#define ICM_MAX_FIFO_WATERMARK (16)
+
+/**
+ * @brief FIFO capacity in packets. The FIFO size is 2 kB.
+ */
+#define ICM_FIFO_CAPACITY (2048 / sizeof (IcmFifoDataPacket))
+
+/**
+ * @brief SPI FIFO packet. Reads FIFO_COUNTH, FIFO_COUNTL, and the FIFO data
+ * in a single transfer.
+ */
+typedef struct {
+    unsigned int address : 7;
+    unsigned int rw : 1;
+    uint16_t fifoCount;
+    IcmFifoDataPacket fifoData[ICM_MAX_FIFO_WATERMARK];
+} __attribute__((__packed__)) IcmSpiFifoPacket;
+
 /**
  * @brief Anti-alias filter.
  */
@@ -41,12 +66,16 @@ typedef struct {
 } IcmAaf;
 
 /**
- * @brief FIFO packet.
+ * @brief Sample. The SPI command byte immediately precedes the registers so
+ * that the registers may be read directly into the sample. The structure is
+ * aligned so that ticks may be accessed directly in the ring buffer.
  */
 typedef struct {
     uint64_t ticks;
+    uint8_t reserved;
+    uint8_t command;
     IcmSensorRegisters registers;
-} __attribute__((__packed__)) IcmFifoPacket;
+} __attribute__((aligned(8))) IcmSample;
 
 /**
  * @brief Anti-aliasing.
@@ -144,6 +173,8 @@ typedef struct {
     IcmAntiAliasing gyroscopeAntiAliasing;
     IcmAntiAliasing accelerometerAntiAliasing;
     IcmSampleRate sampleRate;
+    uint32_t fifoWatermark;
+    bool sensorTimestampEnabled;
 } IcmSettings;
 
 /**
@@ -168,6 +199,25 @@ typedef struct {
     float temperature;
 } IcmData;
 
+/**
+ * @brief Maximum number of samples in a data batch.
+ */
+#define ICM_MAX_BATCH_SIZE (8)
+
+/**
+ * @brief Data batch. Each member is an array indexed by sample.
+ */
+typedef struct {
+    uint64_t ticks[ICM_MAX_BATCH_SIZE];
+    float gyroscopeX[ICM_MAX_BATCH_SIZE];
+    float gyroscopeY[ICM_MAX_BATCH_SIZE];
+    float gyroscopeZ[ICM_MAX_BATCH_SIZE];
+    float accelerometerX[ICM_MAX_BATCH_SIZE];
+    float accelerometerY[ICM_MAX_BATCH_SIZE];
+    float accelerometerZ[ICM_MAX_BATCH_SIZE];
+    float temperature[ICM_MAX_BATCH_SIZE];
+} IcmDataBatch;
+
 /**
  * @brief Test result.
  */
@@ -178,19 +228,84 @@ typedef enum {
 } IcmTestResult;
 
 /**
- * @brief ICM interface.
+ * @brief Maximum number of register writes required to configure the ICM.
+ */
+#define ICM_MAX_NUMBER_OF_REGISTER_WRITES (24)
+
+/**
+ * @brief Register write.
+ */
+typedef struct {
+    uint8_t bank;
+    uint8_t address;
+    uint8_t value;
+} IcmRegisterWrite;
+
+/**
+ * @brief Initialisation state.
+ */
+typedef enum {
+    IcmStateIdle,
+    IcmStateReadDeviceId,
+    IcmStateSoftReset,
+    IcmStateWaitForReset,
+    IcmStateConfigure,
+    IcmStateWaitForPowerOn,
+    IcmStateRunning,
+} IcmState;
+
+/**
+ * @brief Number of ICMs.
+ */
+#define ICM_NUMBER_OF_ICMS (20)
+
+/**
+ * @brief Number of samples buffered for each ICM. Must be a power of 2.
+ */
+#define ICM_NUMBER_OF_SAMPLES (512)
+
+/**
+ * @brief ICM structure. All structure members are private.
  */
 typedef struct {
-    void (*const initialise) (const IcmSettings * const settings);
-    void (*const deinitialise) (void);
-    IcmResult(*const getData)(IcmData * const data);
-    uint32_t(*const bufferOverflow)(void);
+    const SpiBus * const spiBus;
+    const GPIO_PIN csPin;
+    const GPIO_PIN intPin;
+    volatile IcmSpiPacket * const spiPacket;
+    volatile IcmSpiFifoPacket * const spiFifoPacket;
+    SpiBusClient* spiBusClient;
+    IcmState state;
+    IcmRegisterWrite registerWrites[ICM_MAX_NUMBER_OF_REGISTER_WRITES];
+    int numberOfRegisterWrites;
+    int registerWriteIndex;
+    uint8_t shadowRegisters[ICM_MAX_NUMBER_OF_REGISTER_WRITES];
+    bool shadowRegistersValid;
+    uint8_t bank;
+    bool reset;
+    bool fifoFlush;
+    uint64_t timeout;
+    uint64_t deadline;
+    uint8_t deviceId;
+    uint32_t fifoWatermark;
+    uint32_t samplePeriod;
+    bool sensorTimestampEnabled;
+    IcmTimestamp timestamp;
+    volatile uint64_t ticks;
+    volatile bool fifoReadPending;
+    volatile bool fifoReadInProgress;
+    uint32_t fifoReadSize;
+    uint32_t fifoBacklog;
+    uint64_t previousPacketTicks;
+    volatile uint64_t firstSampleTicks;
+    Ring ring;
+    volatile uint32_t bufferOverflow;
 } Icm;
 
 //------------------------------------------------------------------------------
 // Variable declarations
 
 extern const SpiSettings icmSpiSettings;
+extern Icm icms[ICM_NUMBER_OF_ICMS];
 
 //------------------------------------------------------------------------------
 // Function declarations
@@ -198,6 +313,16 @@ extern const SpiSettings icmSpiSettings;
 IcmAaf IcmAntiAliasingToAaf(const IcmAntiAliasing antiAliasing);
 int IcmSampleRateToOdr(const IcmSampleRate sampleRate);
 const char* IcmTestResultToString(const IcmTestResult result);
+void IcmInitialise(Icm * const icm, const IcmSettings * const settings);
+void IcmDeinitialise(Icm * const icm);
+void IcmTasks(Icm * const icm);
+bool IcmInitialisationComplete(const Icm * const icm);
+uint64_t IcmFirstSampleTicks(const Icm * const icm);
+IcmResult IcmGetData(Icm * const icm, IcmData * const data);
+size_t IcmGetDataBatch(Icm * const icm, IcmDataBatch * const batch, size_t numberOfSamples);
+size_t IcmBufferCount(Icm * const icm);
+uint32_t IcmBufferOverflow(Icm * const icm);
+IcmTestResult IcmTest(Icm * const icm);
 
 #endif
 
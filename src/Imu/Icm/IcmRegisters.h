@@ -15,29 +15,43 @@
 //------------------------------------------------------------------------------
 // Definitions - Register bank 0
 
-#define ICM_DEVICE_CONFIG_ADDRESS       (0x11)
-#define ICM_INT_CONFIG_ADDRESS          (0x14)
-#define ICM_TEMP_DATA1_ADDRESS          (0x1D)
-#define ICM_INTF_CONFIG0_ADDRESS        (0x4C)
-#define ICM_INTF_CONFIG1_ADDRESS        (0x4D)
-#define ICM_PWR_MGMT0_ADDRESS           (0x4E)
-#define ICM_GYRO_CONFIG0_ADDRESS        (0x4F)
-#define ICM_ACCEL_CONFIG0_ADDRESS       (0x50)
-#define ICM_INT_CONFIG1_ADDRESS         (0x64)
-#define ICM_INT_SOURCE0_ADDRESS         (0x65)
-#define ICM_WHO_AM_I_ADDRESS            (0x75)
-#define ICM_REG_BANK_SEL_ADDRESS        (0x76)
-
-#define ICM_DEVICE_CONFIG_RESET_VALUE   (0x00)
-#define ICM_INTF_CONFIG0_RESET_VALUE    (0x30)
-#define ICM_INT_CONFIG_RESET_VALUE      (0x00)
-#define ICM_INT_CONFIG1_RESET_VALUE     (0x10)
-#define ICM_INT_SOURCE0_RESET_VALUE     (0x10)
-#define ICM_GYRO_CONFIG0_RESET_VALUE    (0x06)
-#define ICM_ACCEL_CONFIG0_RESET_VALUE   (0x06)
-#define ICM_PWR_MGMT0_RESET_VALUE       (0x00)
-#define ICM_WHO_AM_I_RESET_VALUE        (0x47)
-#define ICM_INTF_CONFIG1_RESET_VALUE    (0x91)
+#define ICM_DEVICE_CONFIG_ADDRESS         (0x11)
+#define ICM_INT_CONFIG_ADDRESS            (0x14)
+#define ICM_FIFO_CONFIG_ADDRESS           (0x16)
+#define ICM_TEMP_DATA1_ADDRESS            (0x1D)
+#define ICM_FIFO_COUNTH_ADDRESS           (0x2E)
+#define ICM_FIFO_DATA_ADDRESS             (0x30)
+#define ICM_SIGNAL_PATH_RESET_ADDRESS     (0x4B)
+#define ICM_INTF_CONFIG0_ADDRESS          (0x4C)
+#define ICM_INTF_CONFIG1_ADDRESS          (0x4D)
+#define ICM_PWR_MGMT0_ADDRESS             (0x4E)
+#define ICM_GYRO_CONFIG0_ADDRESS          (0x4F)
+#define ICM_ACCEL_CONFIG0_ADDRESS         (0x50)
+#define ICM_TMST_CONFIG_ADDRESS           (0x54)
+#define ICM_FIFO_CONFIG1_ADDRESS          (0x5F)
+#define ICM_FIFO_CONFIG2_ADDRESS          (0x60)
+#define ICM_FIFO_CONFIG3_ADDRESS          (0x61)
+#define ICM_INT_CONFIG1_ADDRESS           (0x64)
+#define ICM_INT_SOURCE0_ADDRESS           (0x65)
+#define ICM_WHO_AM_I_ADDRESS              (0x75)
+#define ICM_REG_BANK_SEL_ADDRESS          (0x76)
+
+#define ICM_DEVICE_CONFIG_RESET_VALUE     (0x00)
+#define ICM_INTF_CONFIG0_RESET_VALUE      (0x30)
+#define ICM_INT_CONFIG_RESET_VALUE        (0x00)
+#define ICM_FIFO_CONFIG_RESET_VALUE       (0x00)
+#define ICM_SIGNAL_PATH_RESET_RESET_VALUE (0x00)
+#define ICM_INT_CONFIG1_RESET_VALUE       (0x10)
+#define ICM_INT_SOURCE0_RESET_VALUE       (0x10)
+#define ICM_GYRO_CONFIG0_RESET_VALUE      (0x06)
+#define ICM_ACCEL_CONFIG0_RESET_VALUE     (0x06)
+#define ICM_TMST_CONFIG_RESET_VALUE       (0x23)
+#define ICM_FIFO_CONFIG1_RESET_VALUE      (0x00)
+#define ICM_FIFO_CONFIG2_RESET_VALUE      (0x00)
+#define ICM_FIFO_CONFIG3_RESET_VALUE      (0x00)
+#define ICM_PWR_MGMT0_RESET_VALUE         (0x00)
+#define ICM_WHO_AM_I_RESET_VALUE          (0x47)
+#define ICM_INTF_CONFIG1_RESET_VALUE      (0x91)
 
 typedef union {
 
@@ -64,6 +78,15 @@ typedef union {
     uint8_t value;
 } IcmIntConfigRegister;
 
+typedef union {
+
+    struct {
+        unsigned : 6;
+        unsigned fifoMode : 2;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmFifoConfigRegister;
+
 typedef struct {
     int16_t tempData;
     int16_t accelDataX;
@@ -74,6 +97,47 @@ typedef struct {
     int16_t gyroDataZ;
 } __attribute__((__packed__)) IcmSensorRegisters;
 
+typedef union {
+
+    struct {
+        unsigned headerOdrGyro : 1;
+        unsigned headerOdrAccel : 1;
+        unsigned headerTimestampFsync : 2;
+        unsigned header20 : 1;
+        unsigned headerGyro : 1;
+        unsigned headerAccel : 1;
+        unsigned headerMsg : 1;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmFifoHeader;
+
+typedef struct {
+    IcmFifoHeader header;
+    int16_t accelDataX;
+    int16_t accelDataY;
+    int16_t accelDataZ;
+    int16_t gyroDataX;
+    int16_t gyroDataY;
+    int16_t gyroDataZ;
+    int8_t tempData;
+    uint16_t timestamp;
+} __attribute__((__packed__)) IcmFifoDataPacket;
+
+typedef union {
+
+    struct {
+        unsigned : 1;
+        unsigned fifoFlush : 1;
+        unsigned tmstStrobe : 1;
+        unsigned abortAndReset : 1;
+        unsigned : 1;
+        unsigned dmpMemResetEn : 1;
+        unsigned dmpInitEn : 1;
+        unsigned : 1;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmSignalPathResetRegister;
+
 typedef union {
 
     struct {
@@ -130,6 +194,51 @@ typedef union {
     uint8_t value;
 } IcmAccelConfig0Register;
 
+typedef union {
+
+    struct {
+        unsigned tmstEn : 1;
+        unsigned tmstFsyncEn : 1;
+        unsigned tmstDeltaEn : 1;
+        unsigned tmstRes : 1;
+        unsigned tmstToRegsEn : 1;
+        unsigned : 3;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmTmstConfigRegister;
+
+typedef union {
+
+    struct {
+        unsigned fifoAccelEn : 1;
+        unsigned fifoGyroEn : 1;
+        unsigned fifoTempEn : 1;
+        unsigned fifoTmstFsyncEn : 1;
+        unsigned fifoHiresEn : 1;
+        unsigned fifoWmGtTh : 1;
+        unsigned fifoResumePartialRd : 1;
+        unsigned : 1;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmFifoConfig1Register;
+
+typedef union {
+
+    struct {
+        unsigned fifoWmLsb : 8;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmFifoConfig2Register;
+
+typedef union {
+
+    struct {
+        unsigned fifoWmMsb : 4;
+        unsigned : 4;
+    } __attribute__((__packed__));
+    uint8_t value;
+} IcmFifoConfig3Register;
+
 typedef union {
 
     struct {
@@ -0,0 +1,129 @@
+/**
+ * @file IcmTimestamp.c
+ * @author Seb Madgwick
+ * @brief Maps the ICM-42688-P timestamp to timer ticks.
+ *
+ * The sensor timestamp is clocked by the ICM internal oscillator and so drifts
+ * relative to the timer. A second-order tracking loop estimates the offset and
+ * period of the sensor timestamp in timer ticks using the timer ticks of each
+ * interrupt as a noisy reference. Interrupt latency and SPI bus queueing
+ * therefore only affect the estimate, not the timestamp of each sample.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "IcmTimestamp.h"
+#include <math.h>
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Offset gain.
+ */
+#define OFFSET_GAIN (0.05)
+
+/**
+ * @brief Period gain.
+ */
+#define PERIOD_GAIN (0.001)
+
+/**
+ * @brief Maximum period error as a fraction of the nominal period.
+ */
+#define MAX_PERIOD_ERROR (0.05)
+
+/**
+ * @brief Error threshold in timer ticks. The estimate is reset if this
+ * threshold is exceeded.
+ */
+#define RESET_THRESHOLD ((double) TIMER_TICKS_PER_SECOND / 100.0)
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the timestamp structure.
+ * @param timestamp Timestamp structure.
+ * @param resolution Sensor timestamp resolution in microseconds.
+ */
+void IcmTimestampInitialise(IcmTimestamp * const timestamp, const uint32_t resolution) {
+    *timestamp = (IcmTimestamp){
+        .nominalPeriod = ((double) TIMER_TICKS_PER_SECOND / 1000000.0) * (double) resolution,
+    };
+}
+
+/**
+ * @brief Returns the unwrapped sensor time for a 16-bit sensor timestamp. This
+ * function must be called for consecutive samples in the order in which they
+ * were sampled.
+ * @param timestamp Timestamp structure.
+ * @param value 16-bit sensor timestamp.
+ * @return Unwrapped sensor time.
+ */
+uint64_t IcmTimestampUnwrap(IcmTimestamp * const timestamp, const uint16_t value) {
+    if (timestamp->previousValueValid) {
+        timestamp->sensorTime += (uint16_t) (value - timestamp->previousValue);
+    } else {
+        timestamp->sensorTime = value;
+        timestamp->previousValueValid = true;
+    }
+    timestamp->previousValue = value;
+    return timestamp->sensorTime;
+}
+
+/**
+ * @brief Updates the estimate using the timer ticks obtained at the time of
+ * the interrupt for a sample.
+ * @param timestamp Timestamp structure.
+ * @param sensorTime Unwrapped sensor time of the sample.
+ * @param ticks Timer ticks of the interrupt.
+ */
+void IcmTimestampUpdate(IcmTimestamp * const timestamp, const uint64_t sensorTime, const uint64_t ticks) {
+
+    // Reset estimate if not initialised
+    if (timestamp->initialised == false) {
+        timestamp->initialised = true;
+        timestamp->referenceSensorTime = sensorTime;
+        timestamp->referenceTicks = (double) ticks;
+        timestamp->period = timestamp->nominalPeriod;
+        return;
+    }
+
+    // Calculate error
+    const double elapsed = (double) (int64_t) (sensorTime - timestamp->referenceSensorTime);
+    if (elapsed <= 0.0) {
+        return;
+    }
+    const double predictedTicks = timestamp->referenceTicks + (timestamp->period * elapsed);
+    const double error = (double) ticks - predictedTicks;
+
+    // Reset estimate if error exceeds threshold
+    if (fabs(error) > RESET_THRESHOLD) {
+        timestamp->initialised = false;
+        IcmTimestampUpdate(timestamp, sensorTime, ticks);
+        return;
+    }
+
+    // Update offset and period
+    timestamp->referenceSensorTime = sensorTime;
+    timestamp->referenceTicks = predictedTicks + (OFFSET_GAIN * error);
+    timestamp->period += PERIOD_GAIN * (error / elapsed);
+    timestamp->period = fmin(fmax(timestamp->period, timestamp->nominalPeriod * (1.0 - MAX_PERIOD_ERROR)), timestamp->nominalPeriod * (1.0 + MAX_PERIOD_ERROR));
+}
+
+/**
+ * @brief Returns the timer ticks for a sensor time.
+ * @param timestamp Timestamp structure.
+ * @param sensorTime Unwrapped sensor time.
+ * @return Timer ticks.
+ */
+uint64_t IcmTimestampToTicks(const IcmTimestamp * const timestamp, const uint64_t sensorTime) {
+    const double elapsed = (double) (int64_t) (sensorTime - timestamp->referenceSensorTime);
+    return (uint64_t) (timestamp->referenceTicks + (timestamp->period * elapsed) + 0.5);
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,44 @@
+/**
+ * @file IcmTimestamp.h
+ * @author Seb Madgwick
+ * @brief Maps the ICM-42688-P timestamp to timer ticks.
+ */
+
+#ifndef ICM_TIMESTAMP_H
+#define ICM_TIMESTAMP_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Timestamp structure.
+ */
+typedef struct {
+    double nominalPeriod; // private
+    bool previousValueValid; // private
+    uint16_t previousValue; // private
+    uint64_t sensorTime; // private
+    bool initialised; // private
+    uint64_t referenceSensorTime; // private
+    double referenceTicks; // private
+    double period; // private
+} IcmTimestamp;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void IcmTimestampInitialise(IcmTimestamp * const timestamp, const uint32_t resolution);
+uint64_t IcmTimestampUnwrap(IcmTimestamp * const timestamp, const uint16_t value);
+void IcmTimestampUpdate(IcmTimestamp * const timestamp, const uint64_t sensorTime, const uint64_t ticks);
+uint64_t IcmTimestampToTicks(const IcmTimestamp * const timestamp, const uint64_t sensorTime);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -7,27 +7,10 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Frame/Frame.h"
 #include "Imu.h"
-#include "Imu/Icm/Icm1.h"
-#include "Imu/Icm/Icm10.h"
-#include "Imu/Icm/Icm11.h"
-#include "Imu/Icm/Icm12.h"
-#include "Imu/Icm/Icm13.h"
-#include "Imu/Icm/Icm14.h"
-#include "Imu/Icm/Icm15.h"
-#include "Imu/Icm/Icm16.h"
-#include "Imu/Icm/Icm17.h"
-#include "Imu/Icm/Icm18.h"
-#include "Imu/Icm/Icm19.h"
-#include "Imu/Icm/Icm2.h"
-#include "Imu/Icm/Icm20.h"
-#include "Imu/Icm/Icm3.h"
-#include "Imu/Icm/Icm4.h"
-#include "Imu/Icm/Icm5.h"
-#include "Imu/Icm/Icm6.h"
-#include "Imu/Icm/Icm7.h"
-#include "Imu/Icm/Icm8.h"
-#include "Imu/Icm/Icm9.h"
+#include "Kinematics/Kinematics.h"
+#include "Profile/Profile.h"
 #include <stddef.h>
 #include "Timer/Timer.h"
 
@@ -39,132 +22,375 @@
  */
 #define MAX_WRITE_SIZE (256)
 
+//------------------------------------------------------------------------------
+// Function declarations
+
+static size_t GetData(Imu * const imu, IcmDataBatch * const batch, const size_t budget);
+static void Calibrate(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples);
+static void UpdateBias(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples);
+static size_t Resample(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples);
+static void SendData(Imu * const imu, const IcmDataBatch * const batch, const size_t numberOfSamples);
+static void UpdateAhrs(Imu * const imu, const IcmDataBatch * const batch, FusionQuaternion * const quaternions, const size_t numberOfSamples);
+static void UpdateKinematics(void);
+static void UpdateFrame(const int index, const IcmDataBatch * const batch, const FusionQuaternion * const quaternions, const size_t numberOfSamples);
+static inline __attribute__((always_inline)) FusionQuaternion Preintegrate(const FusionQuaternion deltaQuaternion, const FusionVector gyroscope, const float deltaTime);
+static FusionVector DeltaQuaternionToGyroscope(const FusionQuaternion deltaQuaternion, const float deltaTime);
+static inline __attribute__((always_inline)) FusionVector ApplyCalibration(const FusionVector uncalibrated, const ImuCalibration * const calibration);
+static ImuCalibration CalculateCalibration(const FusionMatrix misalignment, const FusionVector sensitivity, const FusionVector offset, const FusionRemapAlignment alignment);
+static FusionVector RemapInverse(const FusionVector vector, const FusionRemapAlignment alignment);
+
 //------------------------------------------------------------------------------
 // Variables
 
-Imu imuA = {.icm = &icm1, .send = &sendA};
-Imu imuB = {.icm = &icm2, .send = &sendB};
-Imu imuC = {.icm = &icm3, .send = &sendC};
-Imu imuD = {.icm = &icm4, .send = &sendD};
-Imu imuE = {.icm = &icm5, .send = &sendE};
-Imu imuF = {.icm = &icm6, .send = &sendF};
-Imu imuG = {.icm = &icm7, .send = &sendG};
-Imu imuH = {.icm = &icm8, .send = &sendH};
-Imu imuI = {.icm = &icm9, .send = &sendI};
-Imu imuJ = {.icm = &icm10, .send = &sendJ};
-Imu imuK = {.icm = &icm11, .send = &sendK};
-Imu imuL = {.icm = &icm12, .send = &sendL};
-Imu imuM = {.icm = &icm13, .send = &sendM};
-Imu imuN = {.icm = &icm14, .send = &sendN};
-Imu imuO = {.icm = &icm15, .send = &sendO};
-Imu imuP = {.icm = &icm16, .send = &sendP};
-Imu imuQ = {.icm = &icm17, .send = &sendQ};
-Imu imuR = {.icm = &icm18, .send = &sendR};
-Imu imuS = {.icm = &icm19, .send = &sendS};
-Imu imuT = {.icm = &icm20, .send = &sendT};
+Imu imuA = {.icm = &icms[0], .send = &sendA};
+Imu imuB = {.icm = &icms[1], .send = &sendB};
+Imu imuC = {.icm = &icms[2], .send = &sendC};
+Imu imuD = {.icm = &icms[3], .send = &sendD};
+Imu imuE = {.icm = &icms[4], .send = &sendE};
+Imu imuF = {.icm = &icms[5], .send = &sendF};
+Imu imuG = {.icm = &icms[6], .send = &sendG};
+Imu imuH = {.icm = &icms[7], .send = &sendH};
+Imu imuI = {.icm = &icms[8], .send = &sendI};
+Imu imuJ = {.icm = &icms[9], .send = &sendJ};
+Imu imuK = {.icm = &icms[10], .send = &sendK};
+Imu imuL = {.icm = &icms[11], .send = &sendL};
+Imu imuM = {.icm = &icms[12], .send = &sendM};
+Imu imuN = {.icm = &icms[13], .send = &sendN};
+Imu imuO = {.icm = &icms[14], .send = &sendO};
+Imu imuP = {.icm = &icms[15], .send = &sendP};
+Imu imuQ = {.icm = &icms[16], .send = &sendQ};
+Imu imuR = {.icm = &icms[17], .send = &sendR};
+Imu imuS = {.icm = &icms[18], .send = &sendS};
+Imu imuT = {.icm = &icms[19], .send = &sendT};
+Imu * const imus[IMU_NUMBER_OF_IMUS] = {&imuA, &imuB, &imuC, &imuD, &imuE, &imuF, &imuG, &imuH, &imuI, &imuJ, &imuK, &imuL, &imuM, &imuN, &imuO, &imuP, &imuQ, &imuR, &imuS, &imuT};
 
 //------------------------------------------------------------------------------
 // Functions
 
 /**
- * @brief Module tasks. This function should be called repeatedly within the
- * main program loop.
- * @param imu IMU structure.
+ * @brief Module tasks for all IMUs. This function should be called repeatedly
+ * within the main program loop. Samples are gathered from all IMUs before each
+ * processing stage is completed for all IMUs in turn. Each stage loops over
+ * the samples of an IMU with the same calibration and state. The kinematics
+ * and frame are updated after the AHRS of all IMUs.
+ * @param budgets Maximum number of samples to process for each IMU.
  */
-void ImuTasks(Imu * const imu) {
-
-    // Do nothing if not initialised
-    if (imu->initialised == false) {
-        return;
+void ImuBatchTasks(const size_t * const budgets) {
+    PROFILE(ProfileProbeImuTasks);
+    static IcmDataBatch batches[IMU_NUMBER_OF_IMUS];
+    static FusionQuaternion quaternions[IMU_NUMBER_OF_IMUS][ICM_MAX_BATCH_SIZE];
+    size_t numberOfSamples[IMU_NUMBER_OF_IMUS];
+    size_t remaining[IMU_NUMBER_OF_IMUS];
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        remaining[index] = budgets[index];
     }
-
-    // Process available data
-    while (SendAvailable(imu->send, MAX_WRITE_SIZE)) {
+    while (true) {
 
         // Get data
-        IcmData icmData;
-        if (imu->icm->getData(&icmData) != IcmResultOk) {
+        size_t total = 0;
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            numberOfSamples[index] = GetData(imus[index], &batches[index], remaining[index]);
+            remaining[index] -= numberOfSamples[index];
+            total += numberOfSamples[index];
+        }
+        if (total == 0) {
+            return;
+        }
+
+        // Process data
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            Calibrate(imus[index], &batches[index], numberOfSamples[index]);
+        }
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            UpdateBias(imus[index], &batches[index], numberOfSamples[index]);
+        }
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            numberOfSamples[index] = Resample(imus[index], &batches[index], numberOfSamples[index]);
+        }
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            SendData(imus[index], &batches[index], numberOfSamples[index]);
+        }
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            UpdateAhrs(imus[index], &batches[index], quaternions[index], numberOfSamples[index]);
+        }
+        UpdateKinematics();
+        for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+            UpdateFrame(index, &batches[index], quaternions[index], numberOfSamples[index]);
+        }
+        FrameUpdate(&frame);
+    }
+}
+
+/**
+ * @brief Gets a batch of data. The number of samples is limited to the budget
+ * and so that all data can be sent. The batch size is reduced if resampling is
+ * enabled because resampling may increase the number of samples.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param budget Maximum number of samples.
+ * @return Number of samples.
+ */
+static size_t GetData(Imu * const imu, IcmDataBatch * const batch, const size_t budget) {
+    if (imu->initialised == false) {
+        return 0;
+    }
+    const size_t maxBatchSize = imu->settings.resamplingEnabled ? RESAMPLER_MAX_NUMBER_OF_SAMPLES : ICM_MAX_BATCH_SIZE;
+    size_t numberOfSamples = budget < maxBatchSize ? budget : maxBatchSize;
+    while (numberOfSamples > 0) {
+        const size_t numberOfOutputs = imu->settings.resamplingEnabled ? RESAMPLER_MAX_NUMBER_OF_OUTPUTS(numberOfSamples) : numberOfSamples;
+        if (SendAvailable(imu->send, numberOfOutputs * MAX_WRITE_SIZE)) {
             break;
         }
+        numberOfSamples /= 2;
+    }
+    if (numberOfSamples == 0) {
+        return 0;
+    }
+    return IcmGetDataBatch(imu->icm, batch, numberOfSamples);
+}
 
-        // Apply calibration
+/**
+ * @brief Applies the calibration and axis alignment to a batch. The batch is
+ * overwritten with the calibrated data.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param numberOfSamples Number of samples.
+ */
+static void Calibrate(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples) {
+    for (size_t index = 0; index < numberOfSamples; index++) {
         FusionVector gyroscope = {
-            .axis.x = icmData.gyroscopeX,
-            .axis.y = icmData.gyroscopeY,
-            .axis.z = icmData.gyroscopeZ,
+            .axis.x = batch->gyroscopeX[index],
+            .axis.y = batch->gyroscopeY[index],
+            .axis.z = batch->gyroscopeZ[index],
         };
+        gyroscope = ApplyCalibration(gyroscope, &imu->gyroscopeCalibration);
+        batch->gyroscopeX[index] = gyroscope.axis.x;
+        batch->gyroscopeY[index] = gyroscope.axis.y;
+        batch->gyroscopeZ[index] = gyroscope.axis.z;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
         FusionVector accelerometer = {
-            .axis.x = icmData.accelerometerX,
-            .axis.y = icmData.accelerometerY,
-            .axis.z = icmData.accelerometerZ,
+            .axis.x = batch->accelerometerX[index],
+            .axis.y = batch->accelerometerY[index],
+            .axis.z = batch->accelerometerZ[index],
         };
-        gyroscope = FusionModelInertial(gyroscope, imu->settings.gyroscopeMisalignment, imu->settings.gyroscopeSensitivity, imu->settings.gyroscopeOffset);
-        accelerometer = FusionModelInertial(accelerometer, imu->settings.accelerometerMisalignment, imu->settings.accelerometerSensitivity, imu->settings.accelerometerOffset);
+        accelerometer = ApplyCalibration(accelerometer, &imu->accelerometerCalibration);
+        batch->accelerometerX[index] = accelerometer.axis.x;
+        batch->accelerometerY[index] = accelerometer.axis.y;
+        batch->accelerometerZ[index] = accelerometer.axis.z;
+    }
+}
 
-        // Update bias algorithm
-        if (imu->settings.gyroscopeBiasCorrectionEnabled) {
-            gyroscope = FusionBiasUpdate(&imu->bias, gyroscope);
-        }
+/**
+ * @brief Updates the bias algorithm. The batch is overwritten with the
+ * offset-corrected gyroscope.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param numberOfSamples Number of samples.
+ */
+static void UpdateBias(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples) {
+    if (imu->settings.gyroscopeBiasCorrectionEnabled == false) {
+        return;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        FusionVector gyroscope = {
+            .axis.x = batch->gyroscopeX[index],
+            .axis.y = batch->gyroscopeY[index],
+            .axis.z = batch->gyroscopeZ[index],
+        };
+        gyroscope = FusionBiasUpdate(&imu->bias, gyroscope);
+        batch->gyroscopeX[index] = gyroscope.axis.x;
+        batch->gyroscopeY[index] = gyroscope.axis.y;
+        batch->gyroscopeZ[index] = gyroscope.axis.z;
+    }
+}
 
-        // Axis alignment
-        gyroscope = FusionRemap(gyroscope, imu->settings.axesRemap);
-        accelerometer = FusionRemap(accelerometer, imu->settings.axesRemap);
+/**
+ * @brief Resamples a batch onto the tick grid shared by all IMUs if resampling
+ * is enabled. The batch is overwritten with the resampled data.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param numberOfSamples Number of samples.
+ * @return Number of resampled samples.
+ */
+static size_t Resample(Imu * const imu, IcmDataBatch * const batch, const size_t numberOfSamples) {
+    if (imu->settings.resamplingEnabled == false) {
+        return numberOfSamples;
+    }
+    return ResamplerUpdate(&imu->resampler, batch, numberOfSamples);
+}
+
+/**
+ * @brief Sends inertial and temperature data.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param numberOfSamples Number of samples.
+ */
+static void SendData(Imu * const imu, const IcmDataBatch * const batch, const size_t numberOfSamples) {
+    for (size_t index = 0; index < numberOfSamples; index++) {
 
         // Send inertial data
         const SendInertialData inertialData = {
-            .ticks = icmData.ticks,
-            .gyroscope = gyroscope,
-            .accelerometer = accelerometer,
+            .ticks = batch->ticks[index],
+            .gyroscope = {.axis = {.x = batch->gyroscopeX[index], .y = batch->gyroscopeY[index], .z = batch->gyroscopeZ[index]}},
+            .accelerometer = {.axis = {.x = batch->accelerometerX[index], .y = batch->accelerometerY[index], .z = batch->accelerometerZ[index]}},
         };
         SendInertial(imu->send, &inertialData);
 
         // Send temperature data
         const SendTemperatureData temperatureData = {
-            .ticks = icmData.ticks,
-            .temperature = icmData.temperature,
+            .ticks = batch->ticks[index],
+            .temperature = batch->temperature[index],
         };
         SendTemperature(imu->send, &temperatureData);
+    }
+}
 
-        // Downsampling
-        if (imu->settings.ahrsUpdateRateDivisor == 0) {
+/**
+ * @brief Updates the AHRS algorithm and sends AHRS data. The quaternion of
+ * each sample between AHRS updates is the quaternion of the previous AHRS
+ * update rotated by the delta quaternion so that it does not lag the sample.
+ * @param imu IMU structure.
+ * @param batch Batch.
+ * @param quaternions Quaternion of each sample.
+ * @param numberOfSamples Number of samples.
+ */
+static void UpdateAhrs(Imu * const imu, const IcmDataBatch * const batch, FusionQuaternion * const quaternions, const size_t numberOfSamples) {
+    if (imu->settings.ahrsUpdateRateDivisor == 0) {
+        for (size_t index = 0; index < numberOfSamples; index++) {
+            quaternions[index] = FusionAhrsGetQuaternion(&imu->ahrs);
+        }
+        return;
+    }
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        FusionVector gyroscope = {.axis = {.x = batch->gyroscopeX[index], .y = batch->gyroscopeY[index], .z = batch->gyroscopeZ[index]}};
+        FusionVector accelerometer = {.axis = {.x = batch->accelerometerX[index], .y = batch->accelerometerY[index], .z = batch->accelerometerZ[index]}};
+        const uint64_t ticks = batch->ticks[index];
+
+        // Calculate delta time
+        const bool invalid = imu->previousTicks == 0;
+        float deltaTime = (float) ((double) (ticks - imu->previousTicks) * (1.0 / (double) TIMER_TICKS_PER_SECOND));
+        imu->previousTicks = ticks;
+        if (invalid) {
+            quaternions[index] = FusionAhrsGetQuaternion(&imu->ahrs);
             continue;
         }
+
+        // Downsampling
         if (imu->settings.ahrsUpdateRateDivisor > 1) {
             if (imu->downsampledCount == 0) {
-                imu->downsampledGyroscope = FUSION_VECTOR_ZERO;
+                imu->deltaQuaternion = FUSION_QUATERNION_IDENTITY;
                 imu->downsampledAccelerometer = FUSION_VECTOR_ZERO;
+                imu->downsampledDeltaTime = 0.0f;
             }
-            imu->downsampledGyroscope = FusionVectorAdd(imu->downsampledGyroscope, gyroscope);
+            imu->deltaQuaternion = Preintegrate(imu->deltaQuaternion, gyroscope, deltaTime);
             imu->downsampledAccelerometer = FusionVectorAdd(imu->downsampledAccelerometer, accelerometer);
+            imu->downsampledDeltaTime += deltaTime;
             if (++imu->downsampledCount < imu->settings.ahrsUpdateRateDivisor) {
+                quaternions[index] = FusionQuaternionProduct(FusionAhrsGetQuaternion(&imu->ahrs), imu->deltaQuaternion);
                 continue;
             }
-            const float reciprocal = 1.0f / (float) imu->downsampledCount;
-            gyroscope = FusionVectorScale(imu->downsampledGyroscope, reciprocal);
-            accelerometer = FusionVectorScale(imu->downsampledAccelerometer, reciprocal);
+            deltaTime = imu->downsampledDeltaTime;
+            gyroscope = DeltaQuaternionToGyroscope(imu->deltaQuaternion, deltaTime);
+            accelerometer = FusionVectorScale(imu->downsampledAccelerometer, 1.0f / (float) imu->downsampledCount);
         }
         imu->downsampledCount = 0;
 
-        // Calculate delta time
-        const bool invalid = imu->previousTicks == 0;
-        const float deltaTime = (float) ((double) (icmData.ticks - imu->previousTicks) * (1.0 / (double) TIMER_TICKS_PER_SECOND));
-        imu->previousTicks = icmData.ticks;
-        if (invalid) {
-            continue;
-        }
-
         // Update AHRS algorithm
-        FusionAhrsUpdateNoMagnetometer(&imu->ahrs, gyroscope, accelerometer, deltaTime);
+        {
+            PROFILE(ProfileProbeAhrsUpdate);
+            FusionAhrsUpdateNoMagnetometer(&imu->ahrs, gyroscope, accelerometer, deltaTime);
+        }
+        imu->ahrsTicks = ticks;
+        imu->numberOfAhrsUpdates++;
+        quaternions[index] = FusionAhrsGetQuaternion(&imu->ahrs);
 
         // Send AHRS data
         const SendAhrsData ahrsData = {
-            .ticks = icmData.ticks,
+            .ticks = ticks,
             .ahrs = &imu->ahrs,
         };
         SendAhrs(imu->send, &ahrsData);
     }
 }
 
+/**
+ * @brief Updates the kinematics from the latest quaternion of each IMU if the
+ * AHRS of the carpus IMU has been updated.
+ */
+static void UpdateKinematics(void) {
+    Imu * const carpus = imus[0];
+    if (carpus->numberOfAhrsUpdates == 0) {
+        return;
+    }
+    FusionQuaternion quaternions[IMU_NUMBER_OF_IMUS];
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        quaternions[index] = FusionAhrsGetQuaternion(&imus[index]->ahrs);
+    }
+    KinematicsUpdate(&kinematics, carpus->ahrsTicks, carpus->numberOfAhrsUpdates, quaternions);
+    carpus->numberOfAhrsUpdates = 0;
+}
+
+/**
+ * @brief Sets the sample and quaternion of an IMU for the frame. The frame
+ * selects the samples at each frame tick.
+ * @param index IMU index.
+ * @param batch Batch.
+ * @param quaternions Quaternion of each sample.
+ * @param numberOfSamples Number of samples.
+ */
+static void UpdateFrame(const int index, const IcmDataBatch * const batch, const FusionQuaternion * const quaternions, const size_t numberOfSamples) {
+    for (size_t sample = 0; sample < numberOfSamples; sample++) {
+        const SendFrameSensor sensor = {
+            .gyroscope = {.axis = {.x = batch->gyroscopeX[sample], .y = batch->gyroscopeY[sample], .z = batch->gyroscopeZ[sample]}},
+            .accelerometer = {.axis = {.x = batch->accelerometerX[sample], .y = batch->accelerometerY[sample], .z = batch->accelerometerZ[sample]}},
+            .quaternion = quaternions[sample],
+        };
+        FrameSetSensor(&frame, index, batch->ticks[sample], imus[index]->settings.sampleRate, &sensor);
+    }
+}
+
+/**
+ * @brief Integrates the gyroscope into a delta quaternion. The integration is
+ * identical to that of the AHRS algorithm so that the rotation of successive
+ * samples, including coning, is retained between AHRS updates.
+ * @param deltaQuaternion Delta quaternion.
+ * @param gyroscope Gyroscope in degrees per second.
+ * @param deltaTime Delta time in seconds.
+ * @return Updated delta quaternion.
+ */
+static inline __attribute__((always_inline)) FusionQuaternion Preintegrate(const FusionQuaternion deltaQuaternion, const FusionVector gyroscope, const float deltaTime) {
+    const FusionVector halfGyroscope = FusionVectorScale(gyroscope, FusionDegreesToRadians(0.5f) * deltaTime);
+    return FusionQuaternionNormalise(FusionQuaternionAdd(deltaQuaternion, FusionQuaternionVectorProduct(deltaQuaternion, halfGyroscope)));
+}
+
+/**
+ * @brief Returns the gyroscope for which a single AHRS update of the delta
+ * time will rotate by the delta quaternion. The AHRS algorithm integrates q +
+ * 0.5 * q * w * dt and normalises the result, so the vector part of the delta
+ * quaternion divided by the scalar part is equal to 0.5 * w * dt.
+ * @param deltaQuaternion Delta quaternion.
+ * @param deltaTime Delta time in seconds.
+ * @return Gyroscope in degrees per second.
+ */
+static FusionVector DeltaQuaternionToGyroscope(const FusionQuaternion deltaQuaternion, const float deltaTime) {
+    if ((deltaQuaternion.element.w <= 0.0f) || (deltaTime <= 0.0f)) { // rotation of 180 degrees or more cannot be represented
+        return FUSION_VECTOR_ZERO;
+    }
+    const FusionVector vector = {.axis = {.x = deltaQuaternion.element.x, .y = deltaQuaternion.element.y, .z = deltaQuaternion.element.z}};
+    return FusionVectorScale(vector, FusionRadiansToDegrees(2.0f) / (deltaQuaternion.element.w * deltaTime));
+}
+
+/**
+ * @brief Applies the calibration.
+ * @param uncalibrated Uncalibrated gyroscope or accelerometer.
+ * @param calibration Calibration.
+ * @return Calibrated and remapped gyroscope or accelerometer.
+ */
+static inline __attribute__((always_inline)) FusionVector ApplyCalibration(const FusionVector uncalibrated, const ImuCalibration * const calibration) {
+    return FusionMatrixMultiply(calibration->matrix, FusionVectorSubtract(uncalibrated, calibration->offset));
+}
+
 /**
  * @brief Sets the settings.
  * @param imu IMU structure.
@@ -191,6 +417,21 @@ void ImuSetSettings(Imu * const imu, const ImuSettings * const settings) {
         FusionAhrsRestart(&imu->ahrs);
     }
 
+    // Initialise resampler
+    if ((imu->initialised == false) || (imu->settings.sampleRate != settings->sampleRate) || (imu->settings.resamplingEnabled != settings->resamplingEnabled)) {
+        ResamplerInitialise(&imu->resampler, settings->sampleRate);
+    }
+
+    // Express bias offset in new axes
+    if (imu->initialised && (imu->settings.axesRemap != settings->axesRemap)) {
+        const FusionVector offset = RemapInverse(FusionBiasGetOffset(&imu->bias), imu->settings.axesRemap);
+        FusionBiasSetOffset(&imu->bias, FusionRemap(offset, settings->axesRemap));
+    }
+
+    // Calculate calibration
+    imu->gyroscopeCalibration = CalculateCalibration(settings->gyroscopeMisalignment, settings->gyroscopeSensitivity, settings->gyroscopeOffset, settings->axesRemap);
+    imu->accelerometerCalibration = CalculateCalibration(settings->accelerometerMisalignment, settings->accelerometerSensitivity, settings->accelerometerOffset, settings->axesRemap);
+
     // Update settings
     imu->settings = *settings;
 
@@ -208,6 +449,50 @@ void ImuSetSettings(Imu * const imu, const ImuSettings * const settings) {
     imu->initialised = true;
 }
 
+/**
+ * @brief Calculates the calibration equivalent to FusionModelInertial followed
+ * by FusionRemap. Each column of the matrix is the remapped product of the
+ * misalignment matrix column and the sensitivity.
+ * @param misalignment Misalignment matrix.
+ * @param sensitivity Sensitivity.
+ * @param offset Offset.
+ * @param alignment Axes alignment.
+ * @return Calibration.
+ */
+static ImuCalibration CalculateCalibration(const FusionMatrix misalignment, const FusionVector sensitivity, const FusionVector offset, const FusionRemapAlignment alignment) {
+    ImuCalibration calibration = {.offset = offset};
+    for (int column = 0; column < 3; column++) {
+        FusionVector vector = {
+            .axis.x = misalignment.array[column] * sensitivity.array[column],
+            .axis.y = misalignment.array[3 + column] * sensitivity.array[column],
+            .axis.z = misalignment.array[6 + column] * sensitivity.array[column],
+        };
+        vector = FusionRemap(vector, alignment);
+        calibration.matrix.array[column] = vector.axis.x;
+        calibration.matrix.array[3 + column] = vector.axis.y;
+        calibration.matrix.array[6 + column] = vector.axis.z;
+    }
+    return calibration;
+}
+
+/**
+ * @brief Reverses FusionRemap. The remap is an orthogonal matrix so the
+ * inverse is the transpose, and each column of the matrix is a remapped unit
+ * vector.
+ * @param vector Remapped vector.
+ * @param alignment Axes alignment.
+ * @return Vector in sensor axes.
+ */
+static FusionVector RemapInverse(const FusionVector vector, const FusionRemapAlignment alignment) {
+    FusionVector result;
+    for (int column = 0; column < 3; column++) {
+        FusionVector unit = FUSION_VECTOR_ZERO;
+        unit.array[column] = 1.0f;
+        result.array[column] = FusionVectorDot(FusionRemap(unit, alignment), vector);
+    }
+    return result;
+}
+
 /**
  * @brief Restarts the AHRS algorithm.
  * @param imu IMU structure.
@@ -12,8 +12,10 @@
 
 #include "Fusion/Fusion.h"
 #include "Icm/Icm.h"
+#include "Resampler/Resampler.h"
 #include "Send/Send.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 //------------------------------------------------------------------------------
@@ -32,25 +34,46 @@ typedef struct {
     float sampleRate;
     FusionRemapAlignment axesRemap;
     bool gyroscopeBiasCorrectionEnabled;
+    bool resamplingEnabled;
     uint32_t ahrsUpdateRateDivisor;
     FusionConvention ahrsAxesConvention;
     float ahrsGain;
     float ahrsAccelerationRejection;
 } ImuSettings;
 
+/**
+ * @brief Calibration combining the misalignment, sensitivity, and axes remap
+ * into a single matrix. All structure members are private.
+ */
+typedef struct {
+    FusionMatrix matrix;
+    FusionVector offset;
+} ImuCalibration;
+
+/**
+ * @brief Number of IMUs.
+ */
+#define IMU_NUMBER_OF_IMUS (ICM_NUMBER_OF_ICMS)
+
 /**
  * @brief IMU structure.
  */
 typedef struct {
     ImuSettings settings; // private
-    const Icm * const icm; // private
+    Icm * const icm; // private
     bool initialised; // private
+    ImuCalibration gyroscopeCalibration; // private
+    ImuCalibration accelerometerCalibration; // private
     FusionBias bias; // private
+    Resampler resampler; // private
     FusionAhrs ahrs; // private
-    FusionVector downsampledGyroscope; // private
+    FusionQuaternion deltaQuaternion; // private
     FusionVector downsampledAccelerometer; // private
+    float downsampledDeltaTime; // private
     uint32_t downsampledCount; // private
     uint64_t previousTicks; // private
+    uint64_t ahrsTicks; // private
+    uint32_t numberOfAhrsUpdates; // private
     Send * const send; // private
 } Imu;
 
@@ -77,11 +100,12 @@ extern Imu imuQ;
 extern Imu imuR;
 extern Imu imuS;
 extern Imu imuT;
+extern Imu * const imus[IMU_NUMBER_OF_IMUS];
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-void ImuTasks(Imu * const imu);
+void ImuBatchTasks(const size_t * const budgets);
 void ImuSetSettings(Imu * const imu, const ImuSettings * const settings);
 void ImuRestart(Imu * const imu);
 void ImuSetHeading(Imu * const imu, const float heading);
@@ -0,0 +1,114 @@
+/**
+ * @file Resampler.c
+ * @author Seb Madgwick
+ * @brief Resamples a stream of samples onto a tick grid shared by all
+ * streams of the same sample rate.
+ *
+ * Grid point n is at n * period timer ticks, so the grid does not depend on
+ * when each ICM started. Each grid point is linearly interpolated from the
+ * samples either side of it. An output sample is available as soon as the
+ * first input sample after the grid point is received, so the lookahead is
+ * one sample and the added latency is at most one sample period plus the
+ * timestamp jitter.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <math.h>
+#include "Resampler.h"
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum interval between samples in sample periods. The resampler
+ * restarts from the next sample if this is exceeded, for example, if samples
+ * are lost.
+ */
+#define MAX_INTERVAL (2.0)
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) float Interpolate(const float previous, const float current, const float fraction);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the resampler.
+ * @param resampler Resampler structure.
+ * @param sampleRate Sample rate in Hz.
+ */
+void ResamplerInitialise(Resampler * const resampler, const float sampleRate) {
+    resampler->period = (double) TIMER_TICKS_PER_SECOND / (double) sampleRate;
+    resampler->valid = false;
+}
+
+/**
+ * @brief Resamples a batch. The batch is overwritten with the samples at each
+ * grid point between the previous sample and the latest sample.
+ * @param resampler Resampler structure.
+ * @param batch Batch.
+ * @param numberOfSamples Number of samples. Must not exceed
+ * RESAMPLER_MAX_NUMBER_OF_SAMPLES.
+ * @return Number of resampled samples.
+ */
+size_t ResamplerUpdate(Resampler * const resampler, IcmDataBatch * const batch, const size_t numberOfSamples) {
+    const IcmDataBatch input = *batch;
+    size_t numberOfOutputs = 0;
+    for (size_t index = 0; index < numberOfSamples; index++) {
+        const uint64_t ticks = input.ticks[index];
+
+        // Restart if interval invalid
+        const double interval = (double) (ticks - resampler->previousTicks);
+        if ((resampler->valid == false) || (ticks <= resampler->previousTicks) || (interval > (MAX_INTERVAL * resampler->period))) {
+            resampler->valid = true;
+        } else {
+
+            // Interpolate each grid point after the previous sample
+            const double previous = (double) resampler->previousTicks;
+            double gridPoint = (floor(previous / resampler->period) + 1.0) * resampler->period;
+            while ((gridPoint <= (double) ticks) && (numberOfOutputs < ICM_MAX_BATCH_SIZE)) {
+                const float fraction = (float) ((gridPoint - previous) / interval);
+                batch->ticks[numberOfOutputs] = (uint64_t) gridPoint;
+                batch->gyroscopeX[numberOfOutputs] = Interpolate(resampler->previousGyroscopeX, input.gyroscopeX[index], fraction);
+                batch->gyroscopeY[numberOfOutputs] = Interpolate(resampler->previousGyroscopeY, input.gyroscopeY[index], fraction);
+                batch->gyroscopeZ[numberOfOutputs] = Interpolate(resampler->previousGyroscopeZ, input.gyroscopeZ[index], fraction);
+                batch->accelerometerX[numberOfOutputs] = Interpolate(resampler->previousAccelerometerX, input.accelerometerX[index], fraction);
+                batch->accelerometerY[numberOfOutputs] = Interpolate(resampler->previousAccelerometerY, input.accelerometerY[index], fraction);
+                batch->accelerometerZ[numberOfOutputs] = Interpolate(resampler->previousAccelerometerZ, input.accelerometerZ[index], fraction);
+                batch->temperature[numberOfOutputs] = Interpolate(resampler->previousTemperature, input.temperature[index], fraction);
+                numberOfOutputs++;
+                gridPoint += resampler->period;
+            }
+        }
+
+        // Store sample
+        resampler->previousTicks = ticks;
+        resampler->previousGyroscopeX = input.gyroscopeX[index];
+        resampler->previousGyroscopeY = input.gyroscopeY[index];
+        resampler->previousGyroscopeZ = input.gyroscopeZ[index];
+        resampler->previousAccelerometerX = input.accelerometerX[index];
+        resampler->previousAccelerometerY = input.accelerometerY[index];
+        resampler->previousAccelerometerZ = input.accelerometerZ[index];
+        resampler->previousTemperature = input.temperature[index];
+    }
+    return numberOfOutputs;
+}
+
+/**
+ * @brief Returns the linear interpolation between two values.
+ * @param previous Previous value.
+ * @param current Current value.
+ * @param fraction Fraction of the interval from the previous value.
+ * @return Interpolated value.
+ */
+static inline __attribute__((always_inline)) float Interpolate(const float previous, const float current, const float fraction) {
+    return previous + ((current - previous) * fraction);
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,60 @@
+/**
+ * @file Resampler.h
+ * @author Seb Madgwick
+ * @brief Resamples a stream of samples onto a tick grid shared by all
+ * streams of the same sample rate.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Imu/Icm/Icm.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of input samples per update. Each input sample may
+ * produce up to two output samples, and one more may result from the
+ * interval before the first input sample, so the output is limited to
+ * ICM_MAX_BATCH_SIZE samples.
+ */
+#define RESAMPLER_MAX_NUMBER_OF_SAMPLES ((ICM_MAX_BATCH_SIZE - 1) / 2)
+
+/**
+ * @brief Maximum number of output samples for a number of input samples.
+ */
+#define RESAMPLER_MAX_NUMBER_OF_OUTPUTS(numberOfSamples) ((2 * (numberOfSamples)) + 1)
+
+/**
+ * @brief Resampler structure. All structure members are private.
+ */
+typedef struct {
+    double period;
+    bool valid;
+    uint64_t previousTicks;
+    float previousGyroscopeX;
+    float previousGyroscopeY;
+    float previousGyroscopeZ;
+    float previousAccelerometerX;
+    float previousAccelerometerY;
+    float previousAccelerometerZ;
+    float previousTemperature;
+} Resampler;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void ResamplerInitialise(Resampler * const resampler, const float sampleRate);
+size_t ResamplerUpdate(Resampler * const resampler, IcmDataBatch * const batch, const size_t numberOfSamples);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,180 @@
+/**
+ * @file Kinematics.c
+ * @author Seb Madgwick
+ * @brief Hand kinematics. Joint angles are calculated from the relative
+ * rotation between the parent and child segment of each joint. The AHRS of
+ * each segment has an independent heading and so the headings must be aligned
+ * by zeroing the kinematics while the hand is held flat with the fingers
+ * extended.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Kinematics.h"
+#include <math.h>
+#include "Profile/Profile.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Joint.
+ */
+typedef struct {
+    int parent;
+    int child;
+} Joint;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static float Heading(const FusionQuaternion quaternion);
+static FusionQuaternion Conjugate(const FusionQuaternion quaternion);
+
+//------------------------------------------------------------------------------
+// Variables
+
+/**
+ * @brief Joints along each finger chain. Segment indexes are those of the IMUs
+ * in Ximu3Device.c, where A (0) is the carpus and each finger is ordered from
+ * the metacarpal to the distal segment.
+ */
+static const Joint joints[KINEMATICS_NUMBER_OF_JOINTS] = {
+    {0, 1}, {1, 2}, {2, 3}, // I
+    {0, 4}, {4, 5}, {5, 6}, {6, 7}, // II
+    {0, 8}, {8, 9}, {9, 10}, {10, 11}, // III
+    {0, 12}, {12, 13}, {13, 14}, {14, 15}, // IV
+    {0, 16}, {16, 17}, {17, 18}, {18, 19}, // V
+};
+
+Kinematics kinematics = {.send = &sendMain};
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Sets the settings.
+ * @param kinematics Kinematics structure.
+ * @param settings Settings.
+ */
+void KinematicsSetSettings(Kinematics * const kinematics, const KinematicsSettings * const settings) {
+    kinematics->settings = *settings;
+    kinematics->downsampledCount = 0;
+}
+
+/**
+ * @brief Zeros the kinematics. The headings are aligned by the next update.
+ * The hand must be held flat with the fingers extended.
+ * @param kinematics Kinematics structure.
+ */
+void KinematicsZero(Kinematics * const kinematics) {
+    kinematics->zeroPending = true;
+}
+
+/**
+ * @brief Updates the kinematics and sends joint angles. This function should
+ * be called after the AHRS of the carpus segment is updated.
+ * @param kinematics Kinematics structure.
+ * @param ticks Ticks of the latest carpus AHRS update.
+ * @param numberOfUpdates Number of carpus AHRS updates since the previous call.
+ * @param quaternions Quaternion of each segment.
+ */
+void KinematicsUpdate(Kinematics * const kinematics, const uint64_t ticks, const uint32_t numberOfUpdates, const FusionQuaternion * const quaternions) {
+
+    // Zero
+    if (kinematics->zeroPending) {
+        kinematics->zeroPending = false;
+        KinematicsAlignHeadings(kinematics, quaternions);
+    }
+
+    // Message disabled
+    const uint32_t rateDivisor = kinematics->settings.jointAnglesMessageRateDivisor * SendGetRateDivisorMultipliers()->jointAngles;
+    if (rateDivisor == 0) {
+        kinematics->downsampledCount = 0;
+        return;
+    }
+
+    // Downsampling
+    kinematics->downsampledCount += numberOfUpdates;
+    if (kinematics->downsampledCount < rateDivisor) {
+        return;
+    }
+    kinematics->downsampledCount = 0;
+
+    // Send joint angles
+    PROFILE(ProfileProbeKinematics);
+    const KinematicsJointAngles jointAngles = KinematicsCalculateJointAngles(kinematics, quaternions);
+    const SendJointAnglesData jointAnglesData = {
+        .ticks = ticks,
+        .angles = jointAngles.array,
+        .numberOfAngles = sizeof (jointAngles.array) / sizeof (float),
+    };
+    SendJointAngles(kinematics->send, &jointAnglesData);
+}
+
+/**
+ * @brief Aligns the heading of each segment to that of the carpus segment.
+ * The heading offset of each segment is a rotation around the vertical axis
+ * of the Earth and so does not affect the inclination of the segment.
+ * @param kinematics Kinematics structure.
+ * @param quaternions Quaternion of each segment with the hand held flat and the
+ * fingers extended.
+ */
+void KinematicsAlignHeadings(Kinematics * const kinematics, const FusionQuaternion * const quaternions) {
+    const float carpusHeading = Heading(quaternions[0]);
+    for (int index = 0; index < KINEMATICS_NUMBER_OF_SEGMENTS; index++) {
+        const float halfOffset = 0.5f * (carpusHeading - Heading(quaternions[index]));
+        kinematics->headingOffsets[index] = (FusionQuaternion){.element = {.w = cosf(halfOffset), .x = 0.0f, .y = 0.0f, .z = sinf(halfOffset)}};
+    }
+    kinematics->headingsAligned = true;
+}
+
+/**
+ * @brief Returns the heading of the X axis of a segment in radians.
+ * @param quaternion Quaternion.
+ * @return Heading in radians.
+ */
+static float Heading(const FusionQuaternion quaternion) {
+    const FusionMatrix matrix = FusionQuaternionToMatrix(quaternion);
+    return atan2f(matrix.element.yx, matrix.element.xx);
+}
+
+/**
+ * @brief Returns the conjugate of a quaternion.
+ * @param quaternion Quaternion.
+ * @return Conjugate.
+ */
+static FusionQuaternion Conjugate(const FusionQuaternion quaternion) {
+    return (FusionQuaternion){.element = {.w = quaternion.element.w, .x = -quaternion.element.x, .y = -quaternion.element.y, .z = -quaternion.element.z}};
+}
+
+/**
+ * @brief Calculates the joint angles. The relative rotation of each joint is
+ * the conjugate of the parent quaternion multiplied by the child quaternion,
+ * after the headings have been aligned. Flexion and abduction are calculated
+ * from the X axis of the child segment in the parent segment axes. This
+ * decomposition is valid for flexion beyond 90 degrees and is only singular
+ * for abduction of 90 degrees.
+ * @param kinematics Kinematics structure.
+ * @param quaternions Quaternion of each segment.
+ * @return Joint angles.
+ */
+KinematicsJointAngles KinematicsCalculateJointAngles(const Kinematics * const kinematics, const FusionQuaternion * const quaternions) {
+    KinematicsJointAngles jointAngles;
+    for (int index = 0; index < KINEMATICS_NUMBER_OF_JOINTS; index++) {
+        FusionQuaternion parent = quaternions[joints[index].parent];
+        FusionQuaternion child = quaternions[joints[index].child];
+        if (kinematics->headingsAligned) {
+            parent = FusionQuaternionProduct(kinematics->headingOffsets[joints[index].parent], parent);
+            child = FusionQuaternionProduct(kinematics->headingOffsets[joints[index].child], child);
+        }
+        const FusionMatrix matrix = FusionQuaternionToMatrix(FusionQuaternionProduct(Conjugate(parent), child));
+        jointAngles.joint[index].flexion = FusionRadiansToDegrees(atan2f(-matrix.element.zx, matrix.element.xx));
+        jointAngles.joint[index].abduction = FusionRadiansToDegrees(FusionArcSin(matrix.element.yx));
+    }
+    return jointAngles;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,87 @@
+/**
+ * @file Kinematics.h
+ * @author Seb Madgwick
+ * @brief Hand kinematics. Joint angles are calculated from the relative
+ * rotation between the parent and child segment of each joint. The AHRS of
+ * each segment has an independent heading and so the headings must be aligned
+ * by zeroing the kinematics while the hand is held flat with the fingers
+ * extended.
+ */
+
+#ifndef KINEMATICS_H
+#define KINEMATICS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Imu/Fusion/Fusion.h"
+#include "Send/Send.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of segments. Segments are in the order of the IMUs.
+ */
+#define KINEMATICS_NUMBER_OF_SEGMENTS (20)
+
+/**
+ * @brief Number of joints.
+ */
+#define KINEMATICS_NUMBER_OF_JOINTS (KINEMATICS_NUMBER_OF_SEGMENTS - 1)
+
+/**
+ * @brief Settings.
+ */
+typedef struct {
+    uint32_t jointAnglesMessageRateDivisor;
+} KinematicsSettings;
+
+/**
+ * @brief Joint angles in degrees. Flexion and abduction are the angles of the
+ * X axis of the child segment in the parent segment axes. Flexion is the angle
+ * around the Y axis, from -180 to 180 degrees. Abduction is the angle out of the
+ * X-Z plane, from -90 to 90 degrees. Rotation around the X axis of the child
+ * segment is not included.
+ */
+typedef union {
+    float array[2 * KINEMATICS_NUMBER_OF_JOINTS];
+
+    struct {
+        float flexion;
+        float abduction;
+    } joint[KINEMATICS_NUMBER_OF_JOINTS];
+} KinematicsJointAngles;
+
+/**
+ * @brief Kinematics structure.
+ */
+typedef struct {
+    KinematicsSettings settings; // private
+    uint32_t downsampledCount; // private
+    bool zeroPending; // private
+    bool headingsAligned; // private
+    FusionQuaternion headingOffsets[KINEMATICS_NUMBER_OF_SEGMENTS]; // private
+    Send * const send; // private
+} Kinematics;
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+extern Kinematics kinematics;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void KinematicsSetSettings(Kinematics * const kinematics, const KinematicsSettings * const settings);
+void KinematicsZero(Kinematics * const kinematics);
+void KinematicsUpdate(Kinematics * const kinematics, const uint64_t ticks, const uint32_t numberOfUpdates, const FusionQuaternion * const quaternions);
+void KinematicsAlignHeadings(Kinematics * const kinematics, const FusionQuaternion * const quaternions);
+KinematicsJointAngles KinematicsCalculateJointAngles(const Kinematics * const kinematics, const FusionQuaternion * const quaternions);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -220,7 +220,7 @@ static inline __attribute__((always_inline)) void SpiBusTransfer(SpiBusClient *
     if (SpiBus1TransferInProgress(client)) {
         return;
     }
-    SpiBus1Transfer(client, data, numberOfBytes, NULL);
+    SpiBus1Transfer(client, data, numberOfBytes, NULL, NULL);
 }
 
 /**
@@ -19,21 +19,24 @@
  * @brief Interface.
  */
 typedef struct {
-    size_t(*const availableWrite)(void);
-    FifoResult(*const write)(const void* const data, const size_t numberOfBytes);
+    size_t(*const availableWrite)(const PriorityFifoPriority priority);
+    FifoResult(*const reserve)(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+    void(*const commit)(const PriorityFifoPriority priority, const size_t numberOfBytes);
 } Interface;
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-static inline __attribute__((always_inline)) size_t AvailableWrite(const Interface * const interface, const MuxChannel channel);
-static inline __attribute__((always_inline)) FifoResult Write(const Interface * const interface, const MuxChannel channel, const void* const data, const size_t numberOfBytes);
+static inline __attribute__((always_inline)) size_t AvailableWrite(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority);
+static inline __attribute__((always_inline)) FifoResult Write(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+static inline __attribute__((always_inline)) FifoResult Reserve(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+static inline __attribute__((always_inline)) void Commit(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes);
 
 //------------------------------------------------------------------------------
 // Variables
 
-static const Interface usb = {.availableWrite = UsbCdcAvailableWrite, .write = UsbCdcWrite};
-static const Interface serial = {.availableWrite = SerialAvailableWrite, .write = SerialWrite};
+static const Interface usb = {.availableWrite = UsbCdcAvailableWrite, .reserve = UsbCdcReserve, .commit = UsbCdcCommit};
+static const Interface serial = {.availableWrite = SerialAvailableWrite, .reserve = SerialReserve, .commit = SerialCommit};
 
 //------------------------------------------------------------------------------
 // Functions
@@ -92,56 +95,111 @@ uint8_t MuxChannelToByte(const MuxChannel channel) {
 }
 
 /**
- * @brief Returns the space available in the write buffer.
+ * @brief Returns the space available in the write buffer of the priority.
  * @param channel Channel.
- * @return Space available in the write buffer.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
  */
-size_t MuxUsbAvailableWrite(const MuxChannel channel) {
-    return AvailableWrite(&usb, channel);
+size_t MuxUsbAvailableWrite(const MuxChannel channel, const PriorityFifoPriority priority) {
+    return AvailableWrite(&usb, channel, priority);
 }
 
 /**
  * @brief Writes data to the write buffer.
  * @param channel Channel.
+ * @param priority Priority.
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @return Result.
  */
-FifoResult MuxUsbWrite(const MuxChannel channel, const void* const data, const size_t numberOfBytes) {
-    return Write(&usb, channel, data, numberOfBytes);
+FifoResult MuxUsbWrite(const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    return Write(&usb, channel, priority, data, numberOfBytes);
 }
 
 /**
- * @brief Returns the space available in the write buffer.
+ * @brief Reserves space in the write buffer to be written to directly. The
+ * header is written to the write buffer and excluded from the reservation.
+ * MuxUsbCommit must be called after the data has been written.
  * @param channel Channel.
- * @return Space available in the write buffer.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+FifoResult MuxUsbReserve(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return Reserve(&usb, channel, priority, numberOfBytes, reservation);
+}
+
+/**
+ * @brief Makes the header and data written to a reservation available to
+ * write.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+void MuxUsbCommit(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    Commit(&usb, channel, priority, numberOfBytes);
+}
+
+/**
+ * @brief Returns the space available in the write buffer of the priority.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
  */
-size_t MuxSerialAvailableWrite(const MuxChannel channel) {
-    return AvailableWrite(&serial, channel);
+size_t MuxSerialAvailableWrite(const MuxChannel channel, const PriorityFifoPriority priority) {
+    return AvailableWrite(&serial, channel, priority);
 }
 
 /**
  * @brief Writes data to the write buffer.
  * @param channel Channel.
+ * @param priority Priority.
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @return Result.
  */
-FifoResult MuxSerialWrite(const MuxChannel channel, const void* const data, const size_t numberOfBytes) {
-    return Write(&serial, channel, data, numberOfBytes);
+FifoResult MuxSerialWrite(const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    return Write(&serial, channel, priority, data, numberOfBytes);
+}
+
+/**
+ * @brief Reserves space in the write buffer to be written to directly. The
+ * header is written to the write buffer and excluded from the reservation.
+ * MuxSerialCommit must be called after the data has been written.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+FifoResult MuxSerialReserve(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return Reserve(&serial, channel, priority, numberOfBytes, reservation);
 }
 
 /**
- * @brief Returns the space available in the write buffer.
+ * @brief Makes the header and data written to a reservation available to
+ * write.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+void MuxSerialCommit(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    Commit(&serial, channel, priority, numberOfBytes);
+}
+
+/**
+ * @brief Returns the space available in the write buffer of the priority.
  * @param interface Interface.
  * @param channel Channel.
- * @return Space available in the write buffer.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
  */
-static inline __attribute__((always_inline)) size_t AvailableWrite(const Interface * const interface, const MuxChannel channel) {
+static inline __attribute__((always_inline)) size_t AvailableWrite(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority) {
     if (channel == MuxChannelNone) {
-        return interface->availableWrite();
+        return interface->availableWrite(priority);
     }
-    const size_t available = interface->availableWrite();
+    const size_t available = interface->availableWrite(priority);
     if (available < XIMU3_SIZE_MUX_HEADER) {
         return 0;
     }
@@ -149,25 +207,62 @@ static inline __attribute__((always_inline)) size_t AvailableWrite(const Interfa
 }
 
 /**
- * @brief Writes data to the write buffer.
+ * @brief Writes data to the write buffer. The header and data are made
+ * available to write at the same time.
  * @param interface Interface.
  * @param channel Channel.
+ * @param priority Priority.
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @return Result.
  */
-static inline __attribute__((always_inline)) FifoResult Write(const Interface * const interface, const MuxChannel channel, const void* const data, const size_t numberOfBytes) {
+static inline __attribute__((always_inline)) FifoResult Write(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    FifoReservation reservation;
+    if (Reserve(interface, channel, priority, numberOfBytes, &reservation) != FifoResultOk) {
+        return FifoResultError;
+    }
+    FifoReservationWrite(&reservation, 0, data, numberOfBytes);
+    Commit(interface, channel, priority, numberOfBytes);
+    return FifoResultOk;
+}
+
+/**
+ * @brief Reserves space in the write buffer and writes the header.
+ * @param interface Interface.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+static inline __attribute__((always_inline)) FifoResult Reserve(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
     if (channel == MuxChannelNone) {
-        return interface->write(data, numberOfBytes);
+        return interface->reserve(priority, numberOfBytes, reservation);
     }
-    const uint8_t header[] = {'^', MuxChannelToByte(channel)};
-    if (interface->availableWrite() < (sizeof (header) + numberOfBytes)) {
+    if (interface->reserve(priority, XIMU3_SIZE_MUX_HEADER + numberOfBytes, reservation) != FifoResultOk) {
         return FifoResultError;
     }
-    interface->write(header, sizeof (header));
-    interface->write(data, numberOfBytes);
+    const uint8_t header[XIMU3_SIZE_MUX_HEADER] = {'^', MuxChannelToByte(channel)};
+    FifoReservationWrite(reservation, 0, header, sizeof (header));
+    FifoReservationSkip(reservation, sizeof (header));
     return FifoResultOk;
 }
 
+/**
+ * @brief Makes the header and data written to a reservation available to
+ * write.
+ * @param interface Interface.
+ * @param channel Channel.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+static inline __attribute__((always_inline)) void Commit(const Interface * const interface, const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    if (channel == MuxChannelNone) {
+        interface->commit(priority, numberOfBytes);
+        return;
+    }
+    interface->commit(priority, XIMU3_SIZE_MUX_HEADER + numberOfBytes);
+}
+
 //------------------------------------------------------------------------------
 // End of file
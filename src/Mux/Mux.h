@@ -11,6 +11,7 @@
 // Includes
 
 #include "Fifo.h"
+#include "PriorityFifo.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -48,10 +49,14 @@ typedef enum {
 // Function declarations
 
 uint8_t MuxChannelToByte(const MuxChannel channel);
-size_t MuxUsbAvailableWrite(const MuxChannel channel);
-FifoResult MuxUsbWrite(const MuxChannel channel, const void* const data, const size_t numberOfBytes);
-size_t MuxSerialAvailableWrite(const MuxChannel channel);
-FifoResult MuxSerialWrite(const MuxChannel channel, const void* const data, const size_t numberOfBytes);
+size_t MuxUsbAvailableWrite(const MuxChannel channel, const PriorityFifoPriority priority);
+FifoResult MuxUsbWrite(const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+FifoResult MuxUsbReserve(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+void MuxUsbCommit(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes);
+size_t MuxSerialAvailableWrite(const MuxChannel channel, const PriorityFifoPriority priority);
+FifoResult MuxSerialWrite(const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+FifoResult MuxSerialReserve(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+void MuxSerialCommit(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes);
 
 #endif
 
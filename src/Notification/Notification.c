@@ -11,14 +11,16 @@
 #include <inttypes.h>
 #include "OnChange.h"
 #include "Periodic.h"
+#include "Profile/Profile.h"
 #include "Send/Send.h"
 #include "Usb/UsbCdc.h"
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-static inline __attribute__((always_inline)) void ImuBufferOverflow(Send * const send, Imu * const imu);
+static inline __attribute__((always_inline)) void ImuBufferOverflow(Imu * const imu);
 static inline __attribute__((always_inline)) void SendBufferOverflow(Send * const send);
+static void SendProfile(void);
 
 //------------------------------------------------------------------------------
 // Functions
@@ -53,66 +55,36 @@ void NotificationTasks(void) {
             break;
     }
 
+    // Profile
+    if (PERIODIC_POLL(ProfileGetStreamPeriod())) {
+        SendProfile();
+    }
+
     // Do nothing else until polling period elapsed
     if (PERIODIC_POLL(1.0f) == false) {
         return;
     }
 
     // IMU buffer overflow
-    ImuBufferOverflow(&sendA, &imuA);
-    ImuBufferOverflow(&sendB, &imuB);
-    ImuBufferOverflow(&sendC, &imuC);
-    ImuBufferOverflow(&sendD, &imuD);
-    ImuBufferOverflow(&sendE, &imuE);
-    ImuBufferOverflow(&sendF, &imuF);
-    ImuBufferOverflow(&sendG, &imuG);
-    ImuBufferOverflow(&sendH, &imuH);
-    ImuBufferOverflow(&sendI, &imuI);
-    ImuBufferOverflow(&sendJ, &imuJ);
-    ImuBufferOverflow(&sendK, &imuK);
-    ImuBufferOverflow(&sendL, &imuL);
-    ImuBufferOverflow(&sendM, &imuM);
-    ImuBufferOverflow(&sendN, &imuN);
-    ImuBufferOverflow(&sendO, &imuO);
-    ImuBufferOverflow(&sendP, &imuP);
-    ImuBufferOverflow(&sendQ, &imuQ);
-    ImuBufferOverflow(&sendR, &imuR);
-    ImuBufferOverflow(&sendS, &imuS);
-    ImuBufferOverflow(&sendT, &imuT);
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        ImuBufferOverflow(imus[index]);
+    }
 
     // Send buffer overflow
     SendBufferOverflow(&sendMain);
-    SendBufferOverflow(&sendA);
-    SendBufferOverflow(&sendB);
-    SendBufferOverflow(&sendC);
-    SendBufferOverflow(&sendD);
-    SendBufferOverflow(&sendE);
-    SendBufferOverflow(&sendF);
-    SendBufferOverflow(&sendG);
-    SendBufferOverflow(&sendH);
-    SendBufferOverflow(&sendI);
-    SendBufferOverflow(&sendJ);
-    SendBufferOverflow(&sendK);
-    SendBufferOverflow(&sendL);
-    SendBufferOverflow(&sendM);
-    SendBufferOverflow(&sendN);
-    SendBufferOverflow(&sendO);
-    SendBufferOverflow(&sendP);
-    SendBufferOverflow(&sendQ);
-    SendBufferOverflow(&sendR);
-    SendBufferOverflow(&sendS);
-    SendBufferOverflow(&sendT);
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        SendBufferOverflow(imus[index]->send);
+    }
 }
 
 /**
  * @brief IMU buffer overflow.
- * @param send Send structure.
  * @param imu IMU structure.
  */
-static inline __attribute__((always_inline)) void ImuBufferOverflow(Send * const send, Imu * const imu) {
-    const uint32_t numberOfSamples = imu->icm->bufferOverflow();
+static inline __attribute__((always_inline)) void ImuBufferOverflow(Imu * const imu) {
+    const uint32_t numberOfSamples = IcmBufferOverflow(imu->icm);
     if (numberOfSamples > 0) {
-        SendError(send, "IMU buffer overflow. %" PRIu32 " samples lost. %s blocking.", numberOfSamples, SendWhoseBlocking());
+        SendError(imu->send, "IMU buffer overflow. %" PRIu32 " samples lost. %s blocking.", numberOfSamples, SendWhoseBlocking());
     }
 }
 
@@ -131,5 +103,20 @@ static inline __attribute__((always_inline)) void SendBufferOverflow(Send * cons
     }
 }
 
+/**
+ * @brief Sends the minimum, mean, and maximum duration of each profile probe.
+ */
+static void SendProfile(void) {
+    for (int index = 0; index < ProfileNumberOfProbes; index++) {
+        const ProfileStatistics statistics = ProfileGetStatistics((ProfileProbe) index);
+        if (statistics.numberOfDurations == 0) {
+            continue;
+        }
+        const uint32_t mean = (uint32_t) (statistics.total / statistics.numberOfDurations);
+        SendNotification(&sendMain, "%s min %.1f us, mean %.1f us, max %.1f us", ProfileProbeToString((ProfileProbe) index),
+                (double) ProfileCountsToMicroseconds(statistics.min), (double) ProfileCountsToMicroseconds(mean), (double) ProfileCountsToMicroseconds(statistics.max));
+    }
+}
+
 //------------------------------------------------------------------------------
 // End of file
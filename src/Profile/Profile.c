@@ -0,0 +1,140 @@
+/**
+ * @file Profile.c
+ * @author Seb Madgwick
+ * @brief Execution time profiler. Durations are measured using the CP0 Count
+ * register, or a monotonic clock when compiled for a host.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Profile.h"
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// Variables
+
+static ProfileStatistics statistics[ProfileNumberOfProbes];
+static float streamPeriod;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Adds a duration. Each probe must only be added from one interrupt
+ * priority level or from the main program loop.
+ * @param probe Probe.
+ * @param duration Duration in counts.
+ */
+void ProfileAdd(const ProfileProbe probe, const uint32_t duration) {
+    ProfileStatistics * const statistics_ = &statistics[probe];
+    if ((statistics_->numberOfDurations == 0) || (duration < statistics_->min)) {
+        statistics_->min = duration;
+    }
+    if (duration > statistics_->max) {
+        statistics_->max = duration;
+    }
+    statistics_->total += duration;
+    statistics_->numberOfDurations++;
+    int bin = (duration == 0) ? 0 : (32 - __builtin_clz(duration)) - 4;
+    if (bin < 0) {
+        bin = 0;
+    }
+    if (bin >= PROFILE_HISTOGRAM_SIZE) {
+        bin = PROFILE_HISTOGRAM_SIZE - 1;
+    }
+    statistics_->histogram[bin]++;
+}
+
+/**
+ * @brief Returns the probe name.
+ * @param probe Probe.
+ * @return Probe name.
+ */
+const char* ProfileProbeToString(const ProfileProbe probe) {
+    switch (probe) {
+        case ProfileProbeImuTasks:
+            return "ImuTasks";
+        case ProfileProbeAhrsUpdate:
+            return "AhrsUpdate";
+        case ProfileProbeSendInertial:
+            return "SendInertial";
+        case ProfileProbeSendTemperature:
+            return "SendTemperature";
+        case ProfileProbeSendAhrs:
+            return "SendAhrs";
+        case ProfileProbeKinematics:
+            return "Kinematics";
+        case ProfileProbeIcmInterrupt:
+            return "IcmInterrupt";
+        case ProfileProbeIcmTransfer:
+            return "IcmTransfer";
+        case ProfileProbeUsbCdcTasks:
+            return "UsbCdcTasks";
+        case ProfileProbeCommandTasks:
+            return "CommandTasks";
+        case ProfileNumberOfProbes:
+            break;
+    }
+    return ""; // avoid compiler warning
+}
+
+/**
+ * @brief Returns the probe with the specified name.
+ * @param string Probe name.
+ * @param probe Probe.
+ * @return True if the probe exists.
+ */
+bool ProfileProbeFromString(const char* const string, ProfileProbe * const probe) {
+    for (int index = 0; index < ProfileNumberOfProbes; index++) {
+        if (strcmp(string, ProfileProbeToString((ProfileProbe) index)) == 0) {
+            *probe = (ProfileProbe) index;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns the statistics.
+ * @param probe Probe.
+ * @return Statistics.
+ */
+ProfileStatistics ProfileGetStatistics(const ProfileProbe probe) {
+    return statistics[probe];
+}
+
+/**
+ * @brief Converts counts to microseconds.
+ * @param counts Counts.
+ * @return Microseconds.
+ */
+float ProfileCountsToMicroseconds(const uint32_t counts) {
+    return (float) counts * (1000000.0f / (float) PROFILE_COUNTS_PER_SECOND);
+}
+
+/**
+ * @brief Resets the statistics of all probes.
+ */
+void ProfileReset(void) {
+    memset(statistics, 0, sizeof (statistics));
+}
+
+/**
+ * @brief Sets the period at which statistics are sent as notifications.
+ * @param period Period in seconds. Zero to disable.
+ */
+void ProfileSetStreamPeriod(const float period) {
+    streamPeriod = period;
+}
+
+/**
+ * @brief Returns the period at which statistics are sent as notifications.
+ * @return Period in seconds. Zero if disabled.
+ */
+float ProfileGetStreamPeriod(void) {
+    return streamPeriod;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,136 @@
+/**
+ * @file Profile.h
+ * @author Seb Madgwick
+ * @brief Execution time profiler. Durations are measured using the CP0 Count
+ * register, or a monotonic clock when compiled for a host.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __XC32
+#include "definitions.h"
+#else
+#include <time.h>
+#endif
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Comment out this line to compile out all profiling.
+ */
+#define PROFILE_ENABLED
+
+/**
+ * @brief Counts per second.
+ */
+#ifdef __XC32
+#define PROFILE_COUNTS_PER_SECOND (CPU_CLOCK_FREQUENCY / 2U)
+#else
+#define PROFILE_COUNTS_PER_SECOND (1000000000U)
+#endif
+
+/**
+ * @brief Number of histogram bins. Bin n contains the durations of less than
+ * 2^(n + 4) counts and greater than or equal to the upper bound of the previous
+ * bin. The last bin contains all longer durations.
+ */
+#define PROFILE_HISTOGRAM_SIZE (16)
+
+/**
+ * @brief Probe.
+ */
+typedef enum {
+    ProfileProbeImuTasks,
+    ProfileProbeAhrsUpdate,
+    ProfileProbeSendInertial,
+    ProfileProbeSendTemperature,
+    ProfileProbeSendAhrs,
+    ProfileProbeKinematics,
+    ProfileProbeIcmInterrupt,
+    ProfileProbeIcmTransfer,
+    ProfileProbeUsbCdcTasks,
+    ProfileProbeCommandTasks,
+    ProfileNumberOfProbes,
+} ProfileProbe;
+
+/**
+ * @brief Statistics. Durations are in counts.
+ */
+typedef struct {
+    uint32_t numberOfDurations;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[PROFILE_HISTOGRAM_SIZE];
+} ProfileStatistics;
+
+/**
+ * @brief Scope. All structure members are private.
+ */
+typedef struct {
+    ProfileProbe probe;
+    uint32_t start;
+} ProfileScope;
+
+/**
+ * @brief Measures the duration from this line to the end of the enclosing
+ * scope, including early returns. Only one probe may be used in each scope.
+ * Compiles to nothing if profiling is disabled.
+ * @param probe_ Probe.
+ */
+#ifdef PROFILE_ENABLED
+#define PROFILE(probe_) __attribute__((cleanup(ProfileScopeEnd))) const ProfileScope profileScope = {.probe = probe_, .start = ProfileGetCount()}
+#else
+#define PROFILE(probe_)
+#endif
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void ProfileAdd(const ProfileProbe probe, const uint32_t duration);
+const char* ProfileProbeToString(const ProfileProbe probe);
+bool ProfileProbeFromString(const char* const string, ProfileProbe * const probe);
+ProfileStatistics ProfileGetStatistics(const ProfileProbe probe);
+float ProfileCountsToMicroseconds(const uint32_t counts);
+void ProfileReset(void);
+void ProfileSetStreamPeriod(const float period);
+float ProfileGetStreamPeriod(void);
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns the count.
+ * @return Count.
+ */
+static inline __attribute__((always_inline)) uint32_t ProfileGetCount(void) {
+#ifdef __XC32
+    return _CP0_GET_COUNT();
+#else
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    return (uint32_t) (((uint64_t) timespec.tv_sec * 1000000000U) + (uint64_t) timespec.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Adds the duration of a scope. This function is called automatically
+ * at the end of the scope declared by PROFILE.
+ * @param scope Scope.
+ */
+static inline __attribute__((always_inline)) void ProfileScopeEnd(const ProfileScope * const scope) {
+    ProfileAdd(scope->probe, ProfileGetCount() - scope->start);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
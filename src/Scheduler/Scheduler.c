@@ -0,0 +1,197 @@
+/**
+ * @file Scheduler.c
+ * @author Seb Madgwick
+ * @brief Main loop scheduler. Each iteration calls every task once. The IMU
+ * task is limited to a budget of samples for each IMU so that no task waits
+ * for a backlogged IMU. Each budget is doubled while the ICM buffer count is
+ * above the high-water mark and halved while the buffer is nearly empty.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Backpressure/Backpressure.h"
+#include "definitions.h"
+#include "Imu/Icm/Icm.h"
+#include "Imu/Imu.h"
+#include "Notification/Notification.h"
+#include "Profile/Profile.h"
+#include "Scheduler.h"
+#include "Timer/Timer.h"
+#include "Usb/UsbCdc.h"
+#include "Ximu3Device/Ximu3Device.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Task.
+ */
+typedef struct {
+    void (*const function)(void);
+    SchedulerTaskStatistics statistics;
+} Task;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static void IcmTasksAll(void);
+static void ImuTasksAll(void);
+static void UsbTasks(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static Task tasks[] = {
+    {.function = SYS_Tasks, .statistics = {.name = "System"}},
+    {.function = IcmTasksAll, .statistics = {.name = "ICM"}},
+    {.function = ImuTasksAll, .statistics = {.name = "IMU"}},
+    {.function = NotificationTasks, .statistics = {.name = "Notification"}},
+    {.function = BackpressureTasks, .statistics = {.name = "Backpressure"}},
+    {.function = UsbTasks, .statistics = {.name = "USB"}},
+    {.function = Ximu3DeviceCommandTasks, .statistics = {.name = "Command"}},
+    {.function = Ximu3DeviceApplyTasks, .statistics = {.name = "Apply"}},
+};
+
+static const int numberOfTasks = (int) (sizeof (tasks) / sizeof (Task));
+
+static SchedulerImuStatistics imuStatistics[IMU_NUMBER_OF_IMUS];
+static size_t budgets[IMU_NUMBER_OF_IMUS];
+static uint32_t maxIterationTicks;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Module tasks. This function should be called repeatedly within the
+ * main program loop. Each call is one iteration of all tasks.
+ */
+void SchedulerTasks(void) {
+    const uint32_t iterationStartTicks = TimerGetTicks32();
+    for (int index = 0; index < numberOfTasks; index++) {
+        Task * const task = &tasks[index];
+        const uint32_t startTicks = TimerGetTicks32();
+        task->function();
+        const uint32_t ticks = TimerGetTicks32() - startTicks;
+        task->statistics.numberOfCalls++;
+        task->statistics.totalTicks += ticks;
+        if (ticks > task->statistics.maxTicks) {
+            task->statistics.maxTicks = ticks;
+        }
+    }
+    const uint32_t iterationTicks = TimerGetTicks32() - iterationStartTicks;
+    if (iterationTicks > maxIterationTicks) {
+        maxIterationTicks = iterationTicks;
+    }
+}
+
+/**
+ * @brief ICM tasks for all ICMs.
+ */
+static void IcmTasksAll(void) {
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        IcmTasks(&icms[index]);
+    }
+}
+
+/**
+ * @brief IMU tasks for all IMUs. The budget of each IMU is updated from the
+ * ICM buffer count before the samples are processed.
+ */
+static void ImuTasksAll(void) {
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        const size_t bufferCount = IcmBufferCount(imus[index]->icm);
+        budgets[index] = SchedulerUpdateBudget(budgets[index], bufferCount);
+        imuStatistics[index].budget = budgets[index];
+        if (bufferCount > imuStatistics[index].maxBufferCount) {
+            imuStatistics[index].maxBufferCount = bufferCount;
+        }
+    }
+    ImuBatchTasks(budgets);
+}
+
+/**
+ * @brief USB tasks.
+ */
+static void UsbTasks(void) {
+    PROFILE(ProfileProbeUsbCdcTasks);
+    UsbCdcTasks();
+}
+
+/**
+ * @brief Returns the updated IMU budget. The budget is doubled if the buffer
+ * count is above the high-water mark and halved if the buffer count is less
+ * than the minimum budget. The budget is limited to between the minimum and
+ * maximum budgets.
+ * @param budget Budget.
+ * @param bufferCount ICM buffer count.
+ * @return Updated budget.
+ */
+size_t SchedulerUpdateBudget(const size_t budget, const size_t bufferCount) {
+    size_t updated = budget;
+    if (bufferCount > SCHEDULER_HIGH_WATER_MARK) {
+        updated = budget * 2;
+    } else if (bufferCount < SCHEDULER_MIN_IMU_BUDGET) {
+        updated = budget / 2;
+    }
+    if (updated < SCHEDULER_MIN_IMU_BUDGET) {
+        return SCHEDULER_MIN_IMU_BUDGET;
+    }
+    if (updated > SCHEDULER_MAX_IMU_BUDGET) {
+        return SCHEDULER_MAX_IMU_BUDGET;
+    }
+    return updated;
+}
+
+/**
+ * @brief Returns the number of tasks.
+ * @return Number of tasks.
+ */
+int SchedulerGetNumberOfTasks(void) {
+    return numberOfTasks;
+}
+
+/**
+ * @brief Returns the task statistics.
+ * @param index Task index.
+ * @return Task statistics.
+ */
+const SchedulerTaskStatistics* SchedulerGetTaskStatistics(const int index) {
+    return &tasks[index].statistics;
+}
+
+/**
+ * @brief Returns the IMU statistics.
+ * @param index IMU index.
+ * @return IMU statistics.
+ */
+const SchedulerImuStatistics* SchedulerGetImuStatistics(const int index) {
+    return &imuStatistics[index];
+}
+
+/**
+ * @brief Returns the maximum iteration time in timer ticks. This is the
+ * worst-case latency for a task to be called again.
+ * @return Maximum iteration time in timer ticks.
+ */
+uint32_t SchedulerGetMaxIterationTicks(void) {
+    return maxIterationTicks;
+}
+
+/**
+ * @brief Resets the statistics.
+ */
+void SchedulerResetStatistics(void) {
+    for (int index = 0; index < numberOfTasks; index++) {
+        tasks[index].statistics.numberOfCalls = 0;
+        tasks[index].statistics.totalTicks = 0;
+        tasks[index].statistics.maxTicks = 0;
+    }
+    for (int index = 0; index < IMU_NUMBER_OF_IMUS; index++) {
+        imuStatistics[index].maxBufferCount = 0;
+    }
+    maxIterationTicks = 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
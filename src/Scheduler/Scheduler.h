@@ -0,0 +1,79 @@
+/**
+ * @file Scheduler.h
+ * @author Seb Madgwick
+ * @brief Main loop scheduler.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Imu/Imu.h"
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Minimum number of samples processed for each IMU per iteration. One
+ * batch so that samples are always processed in full batches. The scheduler
+ * simulation in Tests/Scheduler shows that the budget remains at the minimum
+ * for steady loads of up to 90% at 1 kHz and 8 kHz, with a maximum buffer count
+ * of 2 samples and a maximum command latency of 1.9 ms.
+ */
+#define SCHEDULER_MIN_IMU_BUDGET (ICM_MAX_BATCH_SIZE)
+
+/**
+ * @brief Maximum number of samples processed for each IMU per iteration. Half
+ * the ICM buffer so that a full buffer is drained in two iterations. This
+ * bounds the iteration time, and so the command latency, to the time taken to
+ * process this number of samples for all IMUs. The simulation measures a
+ * maximum command latency of 38 ms when overloaded at 8 kHz.
+ */
+#define SCHEDULER_MAX_IMU_BUDGET (ICM_NUMBER_OF_SAMPLES / 2)
+
+/**
+ * @brief ICM buffer count above which the IMU budget is increased. A quarter of
+ * the ICM buffer so that transient backlogs are processed at the minimum
+ * budget and a sustained backlog is detected with three quarters of the buffer
+ * remaining. The simulation of a 20 ms stall at 8 kHz and 90% load measures a
+ * maximum buffer count of 179 samples.
+ */
+#define SCHEDULER_HIGH_WATER_MARK (ICM_NUMBER_OF_SAMPLES / 4)
+
+/**
+ * @brief Task statistics. Runtimes are in timer ticks.
+ */
+typedef struct {
+    const char* name;
+    uint32_t numberOfCalls;
+    uint64_t totalTicks;
+    uint32_t maxTicks;
+} SchedulerTaskStatistics;
+
+/**
+ * @brief IMU statistics.
+ */
+typedef struct {
+    size_t budget;
+    size_t maxBufferCount;
+} SchedulerImuStatistics;
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void SchedulerTasks(void);
+size_t SchedulerUpdateBudget(const size_t budget, const size_t bufferCount);
+int SchedulerGetNumberOfTasks(void);
+const SchedulerTaskStatistics* SchedulerGetTaskStatistics(const int index);
+const SchedulerImuStatistics* SchedulerGetImuStatistics(const int index);
+uint32_t SchedulerGetMaxIterationTicks(void);
+void SchedulerResetStatistics(void);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
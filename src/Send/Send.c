@@ -7,12 +7,24 @@
  * High     Error data messages
  * Medium   Command responses and notification data messages
  * Low      All other data messages
+ *
+ * Each priority is written to a separate write buffer of each interface. The
+ * interface sends messages strictly by priority so that higher-priority
+ * messages are not delayed by lower-priority messages already buffered.
+ *
+ * Compact data message mode sends inertial messages as compact inertial
+ * messages and all other data messages as binary.
+ *
+ * Data messages are encoded directly into the write buffer of an interface if
+ * space for the maximum message size is available as a contiguous region.
+ * Otherwise, messages are encoded into a local buffer and then copied.
  */
 
 //------------------------------------------------------------------------------
 // Includes
 
 #include "Fifo.h"
+#include "Profile/Profile.h"
 #include "Send.h"
 #include "Serial/Serial.h"
 #include <stdarg.h>
@@ -30,50 +42,58 @@
  */
 typedef struct {
     bool(*const enabled)(void);
-    size_t(*const availableWrite)(const MuxChannel channel);
-    FifoResult(*const write)(const MuxChannel channel, const void* const data, const size_t numberOfBytes);
+    size_t(*const availableWrite)(const MuxChannel channel, const PriorityFifoPriority priority);
+    FifoResult(*const write)(const MuxChannel channel, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+    FifoResult(*const reserve)(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+    void(*const commit)(const MuxChannel channel, const PriorityFifoPriority priority, const size_t numberOfBytes);
 } Interface;
 
 /**
- * @brief Priority.
+ * @brief Data message.
  */
-typedef enum {
-    PriorityLow,
-    PriorityMedium,
-    PriorityHigh,
-} Priority;
-
-/**
- * @brief Medium-priority buffer size.
- */
-#define MEDIUM_PRIORITY_BUFFER_SIZE (2048)
+typedef struct {
+    PriorityFifoPriority priority;
+    uint8_t* destination;
+    FifoReservation usbReservation;
+    bool usbReserved;
+    FifoReservation serialReservation;
+    bool serialReserved;
+} DataMessage;
 
 /**
- * @brief High-priority buffer size.
+ * @brief Maximum interval between absolute timestamps of compressed quaternion
+ * and compact inertial messages in microseconds.
  */
-#define HIGH_PRIORITY_BUFFER_SIZE (1024)
+#define KEYFRAME_INTERVAL (1000000)
 
 //------------------------------------------------------------------------------
 // Function declarations
 
+static void SendCompactInertial(Send * const send, const uint64_t ticks, const FusionVector gyroscope, const FusionVector accelerometer);
+static inline __attribute__((always_inline)) int16_t Quantise(const float value, const float scale);
 static void SendAhrsStatus(Send * const send, const uint64_t ticks, const FusionAhrsFlags * const flags);
 static void SendQuaternion(Send * const send, const SendAhrsData * const ahrsData);
+static void SendCompressedQuaternion(Send * const send, const SendAhrsData * const ahrsData);
 static void SendRotationMatrix(Send * const send, const SendAhrsData * const ahrsData);
 static void SendEulerAngles(Send * const send, const SendAhrsData * const ahrsData);
 static void SendLinearAcceleration(Send * const send, const SendAhrsData * const ahrsData);
 static void SendEarthAcceleration(Send * const send, const SendAhrsData * const ahrsData);
-static void SendDataMessage(Send * const send, const void* const data, const size_t numberOfBytes, const Priority priority);
-static inline __attribute__((always_inline)) size_t Write(const MuxChannel channel, const Interface * const interface, const void* const data, const size_t numberOfBytes, const Priority priority);
-static inline __attribute__((always_inline)) bool AvailableWrite(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const Priority priority);
+static uint8_t* BeginDataMessage(Send * const send, DataMessage * const dataMessage, uint8_t * const buffer, const size_t bufferSize, const PriorityFifoPriority priority);
+static void EndDataMessage(Send * const send, const DataMessage * const dataMessage, const size_t numberOfBytes);
+static inline __attribute__((always_inline)) bool Reserve(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const PriorityFifoPriority priority, FifoReservation * const reservation);
+static inline __attribute__((always_inline)) size_t Commit(const MuxChannel channel, const Interface * const interface, const FifoReservation * const reservation, const bool reserved, const void* const data, const size_t numberOfBytes, const PriorityFifoPriority priority);
+static inline __attribute__((always_inline)) size_t Write(const MuxChannel channel, const Interface * const interface, const void* const data, const size_t numberOfBytes, const PriorityFifoPriority priority);
+static inline __attribute__((always_inline)) bool AvailableWrite(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const PriorityFifoPriority priority);
 static inline __attribute__((always_inline)) bool Blocked(const MuxChannel channel, const SendInterfaceMode mode, const Interface * const interface, const size_t numberOfBytes);
 
 //------------------------------------------------------------------------------
 // Variables
 
-static const Interface usb = {.enabled = UsbCdcPortOpen, .availableWrite = MuxUsbAvailableWrite, .write = MuxUsbWrite};
-static const Interface serial = {.enabled = SerialEnabled, .availableWrite = MuxSerialAvailableWrite, .write = MuxSerialWrite};
+static const Interface usb = {.enabled = UsbCdcPortOpen, .availableWrite = MuxUsbAvailableWrite, .write = MuxUsbWrite, .reserve = MuxUsbReserve, .commit = MuxUsbCommit};
+static const Interface serial = {.enabled = SerialEnabled, .availableWrite = MuxSerialAvailableWrite, .write = MuxSerialWrite, .reserve = MuxSerialReserve, .commit = MuxSerialCommit};
 
 static const char* whoseBlocking = "";
+static SendRateDivisorMultipliers rateDivisorMultipliers = {.inertial = 1, .ahrs = 1, .temperature = 1, .jointAngles = 1, .frame = 1};
 
 Send sendMain = {.channel = MuxChannelNone, .led = &ledMain};
 Send sendA = {.channel = MuxChannelA, .led = &ledA};
@@ -107,6 +127,26 @@ Send sendT = {.channel = MuxChannelT, .led = &ledT};
  */
 void SendSetSettings(Send * const send, const SendSettings * const settings) {
     send->settings = *settings;
+    send->compactInertialTimestamp = 0;
+    send->compressedQuaternionTimestamp = 0;
+}
+
+/**
+ * @brief Sets the rate divisor multipliers. The rate divisor of each message
+ * type of all send structures is multiplied by the multiplier. The joint
+ * angles and frame multipliers are applied by the kinematics and frame.
+ * @param rateDivisorMultipliers_ Rate divisor multipliers.
+ */
+void SendSetRateDivisorMultipliers(const SendRateDivisorMultipliers * const rateDivisorMultipliers_) {
+    rateDivisorMultipliers = *rateDivisorMultipliers_;
+}
+
+/**
+ * @brief Returns the rate divisor multipliers.
+ * @return Rate divisor multipliers.
+ */
+const SendRateDivisorMultipliers * SendGetRateDivisorMultipliers(void) {
+    return &rateDivisorMultipliers;
 }
 
 /**
@@ -115,9 +155,11 @@ void SendSetSettings(Send * const send, const SendSettings * const settings) {
  * @param inertialData Inertial data.
  */
 void SendInertial(Send * const send, const SendInertialData * const inertialData) {
+    PROFILE(ProfileProbeSendInertial);
 
     // Message disabled
-    if (send->settings.inertialMessageRateDivisor == 0) {
+    const uint32_t rateDivisor = send->settings.inertialMessageRateDivisor * rateDivisorMultipliers.inertial;
+    if (rateDivisor == 0) {
         send->downsampledInertialCount = 0;
         return;
     }
@@ -125,14 +167,14 @@ void SendInertial(Send * const send, const SendInertialData * const inertialData
     // Downsampling
     FusionVector gyroscope = inertialData->gyroscope;
     FusionVector accelerometer = inertialData->accelerometer;
-    if (send->settings.inertialMessageRateDivisor > 1) {
+    if (rateDivisor > 1) {
         if (send->downsampledInertialCount == 0) {
             send->downsampledGyroscope = FUSION_VECTOR_ZERO;
             send->downsampledAccelerometer = FUSION_VECTOR_ZERO;
         }
         send->downsampledGyroscope = FusionVectorAdd(send->downsampledGyroscope, gyroscope);
         send->downsampledAccelerometer = FusionVectorAdd(send->downsampledAccelerometer, accelerometer);
-        if (++send->downsampledInertialCount < send->settings.inertialMessageRateDivisor) {
+        if (++send->downsampledInertialCount < rateDivisor) {
             return;
         }
         const float reciprocal = 1.0f / (float) send->downsampledInertialCount;
@@ -141,6 +183,12 @@ void SendInertial(Send * const send, const SendInertialData * const inertialData
     }
     send->downsampledInertialCount = 0;
 
+    // Send compact message
+    if (send->settings.dataMessageMode == SendDataMessageModeCompact) {
+        SendCompactInertial(send, inertialData->ticks, gyroscope, accelerometer);
+        return;
+    }
+
     // Send message
     const Ximu3DataInertial ximu3Data = {
         .timestamp = TimestampFrom(inertialData->ticks),
@@ -151,14 +199,81 @@ void SendInertial(Send * const send, const SendInertialData * const inertialData
         .accelerometerY = accelerometer.axis.y,
         .accelerometerZ = accelerometer.axis.z,
     };
-    uint8_t message[XIMU3_SIZE_INERTIAL];
+    uint8_t buffer[XIMU3_SIZE_INERTIAL];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryInertial(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryInertial(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiInertial(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiInertial(message, sizeof (buffer), &ximu3Data);
+    }
+    EndDataMessage(send, &dataMessage, messageSize);
+}
+
+/**
+ * @brief Sends a compact inertial message. The timestamp and values are
+ * relative to those of the previous message. Absolute values are sent for the
+ * first message, after a message is lost, and at least once per keyframe
+ * interval so that the host can resynchronise.
+ * @param send Send structure.
+ * @param ticks Ticks.
+ * @param gyroscope Gyroscope in degrees per second.
+ * @param accelerometer Accelerometer in g.
+ */
+static void SendCompactInertial(Send * const send, const uint64_t ticks, const FusionVector gyroscope, const FusionVector accelerometer) {
+    const uint64_t timestamp = TimestampFrom(ticks);
+    uint64_t previousTimestamp = send->compactInertialTimestamp;
+    if ((timestamp < previousTimestamp) || ((timestamp - previousTimestamp) >= KEYFRAME_INTERVAL)) {
+        previousTimestamp = 0;
+    }
+    const Ximu3DataCompactInertial ximu3Data = {
+        .timestamp = timestamp,
+        .previousTimestamp = previousTimestamp,
+        .gyroscopeX = Quantise(gyroscope.axis.x, XIMU3_COMPACT_GYROSCOPE_SCALE),
+        .gyroscopeY = Quantise(gyroscope.axis.y, XIMU3_COMPACT_GYROSCOPE_SCALE),
+        .gyroscopeZ = Quantise(gyroscope.axis.z, XIMU3_COMPACT_GYROSCOPE_SCALE),
+        .accelerometerX = Quantise(accelerometer.axis.x, XIMU3_COMPACT_ACCELEROMETER_SCALE),
+        .accelerometerY = Quantise(accelerometer.axis.y, XIMU3_COMPACT_ACCELEROMETER_SCALE),
+        .accelerometerZ = Quantise(accelerometer.axis.z, XIMU3_COMPACT_ACCELEROMETER_SCALE),
+        .previousGyroscopeX = send->compactInertial[0],
+        .previousGyroscopeY = send->compactInertial[1],
+        .previousGyroscopeZ = send->compactInertial[2],
+        .previousAccelerometerX = send->compactInertial[3],
+        .previousAccelerometerY = send->compactInertial[4],
+        .previousAccelerometerZ = send->compactInertial[5],
+    };
+    uint8_t buffer[XIMU3_SIZE_BINARY_COMPACT_INERTIAL];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
+    const size_t messageSize = Ximu3BinaryCompactInertial(message, sizeof (buffer), &ximu3Data);
+    const size_t bufferOverflow = send->usbBufferOverflow + send->serialBufferOverflow;
+    EndDataMessage(send, &dataMessage, messageSize);
+    send->compactInertialTimestamp = (send->usbBufferOverflow + send->serialBufferOverflow) == bufferOverflow ? timestamp : 0;
+    send->compactInertial[0] = ximu3Data.gyroscopeX;
+    send->compactInertial[1] = ximu3Data.gyroscopeY;
+    send->compactInertial[2] = ximu3Data.gyroscopeZ;
+    send->compactInertial[3] = ximu3Data.accelerometerX;
+    send->compactInertial[4] = ximu3Data.accelerometerY;
+    send->compactInertial[5] = ximu3Data.accelerometerZ;
+}
+
+/**
+ * @brief Returns the value quantised to a 16-bit integer. The value is
+ * limited to the range of a 16-bit integer.
+ * @param value Value.
+ * @param scale Scale in LSB per unit.
+ * @return Value quantised to a 16-bit integer.
+ */
+static inline __attribute__((always_inline)) int16_t Quantise(const float value, const float scale) {
+    const float scaled = value * scale;
+    if (scaled >= (float) INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (scaled <= (float) INT16_MIN) {
+        return INT16_MIN;
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    return (int16_t) (scaled + ((scaled < 0.0f) ? -0.5f : 0.5f));
 }
 
 /**
@@ -167,9 +282,11 @@ void SendInertial(Send * const send, const SendInertialData * const inertialData
  * @param ahrsData AHRS data.
  */
 void SendAhrs(Send * const send, const SendAhrsData * const ahrsData) {
+    PROFILE(ProfileProbeSendAhrs);
 
     // Message disabled
-    if (send->settings.ahrsMessageRateDivisor == 0) {
+    const uint32_t rateDivisor = send->settings.ahrsMessageRateDivisor * rateDivisorMultipliers.ahrs;
+    if (rateDivisor == 0) {
         send->downsampledAhrsCount = 0;
         return;
     }
@@ -182,7 +299,7 @@ void SendAhrs(Send * const send, const SendAhrsData * const ahrsData) {
     }
 
     // AHRS outputs
-    if ((send->settings.ahrsMessageRateDivisor > 1) && (++send->downsampledAhrsCount < send->settings.ahrsMessageRateDivisor)) {
+    if ((rateDivisor > 1) && (++send->downsampledAhrsCount < rateDivisor)) {
         return;
     }
     send->downsampledAhrsCount = 0;
@@ -202,6 +319,9 @@ void SendAhrs(Send * const send, const SendAhrsData * const ahrsData) {
         case SendAhrsMessageTypeEarthAcceleration:
             SendEarthAcceleration(send, ahrsData);
             break;
+        case SendAhrsMessageTypeCompressedQuaternion:
+            SendCompressedQuaternion(send, ahrsData);
+            break;
     }
 }
 
@@ -219,14 +339,16 @@ static void SendAhrsStatus(Send * const send, const uint64_t ticks, const Fusion
         .accelerationRecovery = flags->accelerationRecovery,
         .magneticRecovery = flags->magneticRecovery,
     };
-    uint8_t message[XIMU3_SIZE_AHRS_STATUS];
+    uint8_t buffer[XIMU3_SIZE_AHRS_STATUS];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryAhrsStatus(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryAhrsStatus(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiAhrsStatus(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiAhrsStatus(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -243,14 +365,53 @@ static void SendQuaternion(Send * const send, const SendAhrsData * const ahrsDat
         .y = quaternion.element.y,
         .z = quaternion.element.z,
     };
-    uint8_t message[XIMU3_SIZE_QUATERNION];
+    uint8_t buffer[XIMU3_SIZE_QUATERNION];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryQuaternion(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryQuaternion(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiQuaternion(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiQuaternion(message, sizeof (buffer), &ximu3Data);
+    }
+    EndDataMessage(send, &dataMessage, messageSize);
+}
+
+/**
+ * @brief Sends a compressed quaternion message. The timestamp is relative to
+ * that of the previous message. An absolute timestamp, flagged as a keyframe,
+ * is sent for the first message, after a message is lost, and at least once
+ * per keyframe interval so that the host can resynchronise. A quaternion message is sent instead in
+ * ASCII mode.
+ * @param send Send structure.
+ * @param ahrsData AHRS data.
+ */
+static void SendCompressedQuaternion(Send * const send, const SendAhrsData * const ahrsData) {
+    if (send->settings.dataMessageMode == SendDataMessageModeAscii) {
+        SendQuaternion(send, ahrsData);
+        return;
+    }
+    const FusionQuaternion quaternion = FusionAhrsGetQuaternion(ahrsData->ahrs);
+    const uint64_t timestamp = TimestampFrom(ahrsData->ticks);
+    uint64_t previousTimestamp = send->compressedQuaternionTimestamp;
+    if ((timestamp < previousTimestamp) || ((timestamp - previousTimestamp) >= KEYFRAME_INTERVAL)) {
+        previousTimestamp = 0;
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    const Ximu3DataCompressedQuaternion ximu3Data = {
+        .timestamp = timestamp,
+        .previousTimestamp = previousTimestamp,
+        .w = quaternion.element.w,
+        .x = quaternion.element.x,
+        .y = quaternion.element.y,
+        .z = quaternion.element.z,
+    };
+    uint8_t buffer[XIMU3_SIZE_COMPRESSED_QUATERNION];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
+    const size_t messageSize = Ximu3BinaryCompressedQuaternion(message, sizeof (buffer), &ximu3Data);
+    const size_t bufferOverflow = send->usbBufferOverflow + send->serialBufferOverflow;
+    EndDataMessage(send, &dataMessage, messageSize);
+    send->compressedQuaternionTimestamp = (send->usbBufferOverflow + send->serialBufferOverflow) == bufferOverflow ? timestamp : 0;
 }
 
 /**
@@ -272,14 +433,16 @@ static void SendRotationMatrix(Send * const send, const SendAhrsData * const ahr
         .zy = matrix.element.zy,
         .zz = matrix.element.zz,
     };
-    uint8_t message[XIMU3_SIZE_ROTATION_MATRIX];
+    uint8_t buffer[XIMU3_SIZE_ROTATION_MATRIX];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryRotationMatrix(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryRotationMatrix(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiRotationMatrix(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiRotationMatrix(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -295,14 +458,16 @@ static void SendEulerAngles(Send * const send, const SendAhrsData * const ahrsDa
         .pitch = euler.angle.pitch,
         .yaw = euler.angle.yaw,
     };
-    uint8_t message[XIMU3_SIZE_EULER_ANGLES];
+    uint8_t buffer[XIMU3_SIZE_EULER_ANGLES];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryEulerAngles(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryEulerAngles(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiEulerAngles(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiEulerAngles(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -323,14 +488,16 @@ static void SendLinearAcceleration(Send * const send, const SendAhrsData * const
         .linearAccelerationY = linearAcceleration.axis.y,
         .linearAccelerationZ = linearAcceleration.axis.z,
     };
-    uint8_t message[XIMU3_SIZE_LINEAR_ACCELERATION];
+    uint8_t buffer[XIMU3_SIZE_LINEAR_ACCELERATION];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryLinearAcceleration(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryLinearAcceleration(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiLinearAcceleration(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiLinearAcceleration(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -351,14 +518,16 @@ static void SendEarthAcceleration(Send * const send, const SendAhrsData * const
         .earthAccelerationY = earthAcceleration.axis.y,
         .earthAccelerationZ = earthAcceleration.axis.z,
     };
-    uint8_t message[XIMU3_SIZE_EARTH_ACCELERATION];
+    uint8_t buffer[XIMU3_SIZE_EARTH_ACCELERATION];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryEarthAcceleration(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryEarthAcceleration(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiEarthAcceleration(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiEarthAcceleration(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -367,21 +536,23 @@ static void SendEarthAcceleration(Send * const send, const SendAhrsData * const
  * @param temperatureData Temperature data.
  */
 void SendTemperature(Send * const send, const SendTemperatureData * const temperatureData) {
+    PROFILE(ProfileProbeSendTemperature);
 
     // Message disabled
-    if (send->settings.temperatureMessageRateDivisor == 0) {
+    const uint32_t rateDivisor = send->settings.temperatureMessageRateDivisor * rateDivisorMultipliers.temperature;
+    if (rateDivisor == 0) {
         send->downsampledTemperatureCount = 0;
         return;
     }
 
     // Downsampling
     float temperature = temperatureData->temperature;
-    if (send->settings.temperatureMessageRateDivisor > 1) {
+    if (rateDivisor > 1) {
         if (send->downsampledTemperatureCount == 0) {
             send->downsampledTemperature = 0.0f;
         }
         send->downsampledTemperature += temperature;
-        if (++send->downsampledTemperatureCount < send->settings.temperatureMessageRateDivisor) {
+        if (++send->downsampledTemperatureCount < rateDivisor) {
             return;
         }
         temperature = send->downsampledTemperature / (float) send->downsampledTemperatureCount;
@@ -393,14 +564,80 @@ void SendTemperature(Send * const send, const SendTemperatureData * const temper
         .timestamp = TimestampFrom(temperatureData->ticks),
         .temperature = temperature,
     };
-    uint8_t message[XIMU3_SIZE_TEMPERATURE];
+    uint8_t buffer[XIMU3_SIZE_TEMPERATURE];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
+    size_t messageSize;
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryTemperature(message, sizeof (buffer), &ximu3Data);
+    } else {
+        messageSize = Ximu3AsciiTemperature(message, sizeof (buffer), &ximu3Data);
+    }
+    EndDataMessage(send, &dataMessage, messageSize);
+}
+
+/**
+ * @brief Sends a joint angles message.
+ * @param send Send structure.
+ * @param jointAnglesData Joint angles data.
+ */
+void SendJointAngles(Send * const send, const SendJointAnglesData * const jointAnglesData) {
+    const Ximu3DataJointAngles ximu3Data = {
+        .timestamp = TimestampFrom(jointAnglesData->ticks),
+        .angles = jointAnglesData->angles,
+        .numberOfAngles = jointAnglesData->numberOfAngles,
+    };
+    uint8_t buffer[XIMU3_SIZE_JOINT_ANGLES];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
+    size_t messageSize;
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryJointAngles(message, sizeof (buffer), &ximu3Data);
+    } else {
+        messageSize = Ximu3AsciiJointAngles(message, sizeof (buffer), &ximu3Data);
+    }
+    EndDataMessage(send, &dataMessage, messageSize);
+}
+
+/**
+ * @brief Sends a frame message.
+ * @param send Send structure.
+ * @param frameData Frame data.
+ */
+void SendFrame(Send * const send, const SendFrameData * const frameData) {
+    static Ximu3DataFrameSensor sensors[XIMU3_SIZE_NUMBER_OF_SENSORS]; // static because sensors are too large for the stack
+    const size_t numberOfSensors = frameData->numberOfSensors < XIMU3_SIZE_NUMBER_OF_SENSORS ? frameData->numberOfSensors : XIMU3_SIZE_NUMBER_OF_SENSORS;
+    for (size_t index = 0; index < numberOfSensors; index++) {
+        const SendFrameSensor * const sensor = &frameData->sensors[index];
+        sensors[index] = (Ximu3DataFrameSensor) {
+            .gyroscopeX = sensor->gyroscope.axis.x,
+            .gyroscopeY = sensor->gyroscope.axis.y,
+            .gyroscopeZ = sensor->gyroscope.axis.z,
+            .accelerometerX = sensor->accelerometer.axis.x,
+            .accelerometerY = sensor->accelerometer.axis.y,
+            .accelerometerZ = sensor->accelerometer.axis.z,
+            .quaternionW = sensor->quaternion.element.w,
+            .quaternionX = sensor->quaternion.element.x,
+            .quaternionY = sensor->quaternion.element.y,
+            .quaternionZ = sensor->quaternion.element.z,
+        };
+    }
+    const Ximu3DataFrame ximu3Data = {
+        .timestamp = TimestampFrom(frameData->ticks),
+        .presence = frameData->presence,
+        .sensors = sensors,
+        .numberOfSensors = numberOfSensors,
+    };
+    static uint8_t buffer[XIMU3_SIZE_FRAME]; // static because message is too large for the stack
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityLow);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryTemperature(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryFrame(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiTemperature(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiFrame(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityLow);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -423,14 +660,16 @@ void SendNotification(Send * const send, const char* const format, ...) {
         .timestamp = TimestampGet(),
         .notification = notification,
     };
-    uint8_t message[XIMU3_SIZE_NOTIFICATION];
+    uint8_t buffer[XIMU3_SIZE_NOTIFICATION];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityMedium);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryNotification(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryNotification(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiNotification(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiNotification(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityMedium);
+    EndDataMessage(send, &dataMessage, messageSize);
 }
 
 /**
@@ -453,32 +692,61 @@ void SendError(Send * const send, const char* const format, ...) {
         .timestamp = TimestampGet(),
         .error = error,
     };
-    uint8_t message[XIMU3_SIZE_ERROR];
+    uint8_t buffer[XIMU3_SIZE_ERROR];
+    DataMessage dataMessage;
+    uint8_t * const message = BeginDataMessage(send, &dataMessage, buffer, sizeof (buffer), PriorityFifoPriorityHigh);
     size_t messageSize;
-    if (send->settings.dataMessageMode == SendDataMessageModeBinary) {
-        messageSize = Ximu3BinaryError(message, sizeof (message), &ximu3Data);
+    if (send->settings.dataMessageMode != SendDataMessageModeAscii) {
+        messageSize = Ximu3BinaryError(message, sizeof (buffer), &ximu3Data);
     } else {
-        messageSize = Ximu3AsciiError(message, sizeof (message), &ximu3Data);
+        messageSize = Ximu3AsciiError(message, sizeof (buffer), &ximu3Data);
     }
-    SendDataMessage(send, message, messageSize, PriorityHigh);
+    EndDataMessage(send, &dataMessage, messageSize);
 
     // Blink LED
     LedBlink(send->led, ledColourRed);
 }
 
 /**
- * @brief Sends a data message.
+ * @brief Begins a data message and returns the destination that the message
+ * must be written to. Space for the buffer size is reserved in the write
+ * buffer of each interface if available. The destination is the first
+ * contiguous reservation, or the buffer if there is none. EndDataMessage must
+ * be called after the message has been written.
  * @param send Send structure.
- * @param data Data.
- * @param numberOfBytes Number of bytes.
+ * @param dataMessage Data message.
+ * @param buffer Buffer.
+ * @param bufferSize Buffer size. Must be the maximum message size.
  * @param priority Priority.
+ * @return Destination.
  */
-static void SendDataMessage(Send * const send, const void* const data, const size_t numberOfBytes, const Priority priority) {
+static uint8_t* BeginDataMessage(Send * const send, DataMessage * const dataMessage, uint8_t * const buffer, const size_t bufferSize, const PriorityFifoPriority priority) {
+    dataMessage->priority = priority;
+    dataMessage->destination = buffer;
+    dataMessage->usbReserved = (send->settings.usbSendMode != SendInterfaceModeDisabled) && Reserve(send->channel, &usb, bufferSize, priority, &dataMessage->usbReservation);
+    dataMessage->serialReserved = (send->settings.serialSendMode != SendInterfaceModeDisabled) && Reserve(send->channel, &serial, bufferSize, priority, &dataMessage->serialReservation);
+    if (dataMessage->usbReserved && (dataMessage->usbReservation.secondSize == 0)) {
+        dataMessage->destination = dataMessage->usbReservation.first;
+    } else if (dataMessage->serialReserved && (dataMessage->serialReservation.secondSize == 0)) {
+        dataMessage->destination = dataMessage->serialReservation.first;
+    }
+    return dataMessage->destination;
+}
+
+/**
+ * @brief Ends a data message. The message is copied to each reservation that
+ * is not the destination, and written to each interface without a
+ * reservation.
+ * @param send Send structure.
+ * @param dataMessage Data message.
+ * @param numberOfBytes Number of bytes.
+ */
+static void EndDataMessage(Send * const send, const DataMessage * const dataMessage, const size_t numberOfBytes) {
     if (send->settings.usbSendMode != SendInterfaceModeDisabled) {
-        send->usbBufferOverflow += Write(send->channel, &usb, data, numberOfBytes, priority);
+        send->usbBufferOverflow += Commit(send->channel, &usb, &dataMessage->usbReservation, dataMessage->usbReserved, dataMessage->destination, numberOfBytes, dataMessage->priority);
     }
     if (send->settings.serialSendMode != SendInterfaceModeDisabled) {
-        send->serialBufferOverflow += Write(send->channel, &serial, data, numberOfBytes, priority);
+        send->serialBufferOverflow += Commit(send->channel, &serial, &dataMessage->serialReservation, dataMessage->serialReserved, dataMessage->destination, numberOfBytes, dataMessage->priority);
     }
 }
 
@@ -489,7 +757,7 @@ static void SendDataMessage(Send * const send, const void* const data, const siz
  * @param numberOfBytes Number of bytes.
  */
 void SendResponseUsb(Send * const send, const void* const data, const size_t numberOfBytes) {
-    send->usbBufferOverflow += Write(send->channel, &usb, data, numberOfBytes, PriorityMedium);
+    send->usbBufferOverflow += Write(send->channel, &usb, data, numberOfBytes, PriorityFifoPriorityMedium);
 }
 
 /**
@@ -499,7 +767,7 @@ void SendResponseUsb(Send * const send, const void* const data, const size_t num
  * @param numberOfBytes Number of bytes.
  */
 void SendResponseSerial(Send * const send, const void* const data, const size_t numberOfBytes) {
-    send->serialBufferOverflow += Write(send->channel, &serial, data, numberOfBytes, PriorityMedium);
+    send->serialBufferOverflow += Write(send->channel, &serial, data, numberOfBytes, PriorityFifoPriorityMedium);
 }
 
 /**
@@ -512,19 +780,61 @@ void SendResponseSerial(Send * const send, const void* const data, const size_t
  * @param priority Priority.
  * @return Number of bytes lost due to buffer overflow.
  */
-static inline __attribute__((always_inline)) size_t Write(const MuxChannel channel, const Interface * const interface, const void* const data, const size_t numberOfBytes, const Priority priority) {
+static inline __attribute__((always_inline)) size_t Write(const MuxChannel channel, const Interface * const interface, const void* const data, const size_t numberOfBytes, const PriorityFifoPriority priority) {
     if (interface->enabled() == false) {
         return 0;
     }
     if (AvailableWrite(channel, interface, numberOfBytes, priority) == false) {
         return numberOfBytes;
     }
-    if (interface->write(channel, data, numberOfBytes) != FifoResultOk) {
+    if (interface->write(channel, priority, data, numberOfBytes) != FifoResultOk) {
         return numberOfBytes;
     }
     return 0;
 }
 
+/**
+ * @brief Reserves space in the write buffer and returns true if successful.
+ * @param channel Channel.
+ * @param interface Interface.
+ * @param numberOfBytes Number of bytes.
+ * @param priority Priority.
+ * @param reservation Reservation.
+ * @return True if successful.
+ */
+static inline __attribute__((always_inline)) bool Reserve(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const PriorityFifoPriority priority, FifoReservation * const reservation) {
+    if (interface->enabled() == false) {
+        return false;
+    }
+    if (AvailableWrite(channel, interface, numberOfBytes, priority) == false) {
+        return false;
+    }
+    return interface->reserve(channel, priority, numberOfBytes, reservation) == FifoResultOk;
+}
+
+/**
+ * @brief Commits a reservation, or writes the data if there is no reservation,
+ * and returns the number of bytes lost due to buffer overflow.
+ * @param channel Channel.
+ * @param interface Interface.
+ * @param reservation Reservation.
+ * @param reserved True if reserved.
+ * @param data Data.
+ * @param numberOfBytes Number of bytes.
+ * @param priority Priority.
+ * @return Number of bytes lost due to buffer overflow.
+ */
+static inline __attribute__((always_inline)) size_t Commit(const MuxChannel channel, const Interface * const interface, const FifoReservation * const reservation, const bool reserved, const void* const data, const size_t numberOfBytes, const PriorityFifoPriority priority) {
+    if (reserved == false) {
+        return Write(channel, interface, data, numberOfBytes, priority);
+    }
+    if (data != reservation->first) {
+        FifoReservationWrite(reservation, 0, data, numberOfBytes);
+    }
+    interface->commit(channel, priority, numberOfBytes);
+    return 0;
+}
+
 /**
  * @brief Returns true if there is enough space available in the write buffer.
  * @param channel Channel.
@@ -533,16 +843,8 @@ static inline __attribute__((always_inline)) size_t Write(const MuxChannel chann
  * @param priority Priority.
  * @return True if there is enough space available in the write buffer.
  */
-static inline __attribute__((always_inline)) bool AvailableWrite(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const Priority priority) {
-    switch (priority) {
-        case PriorityLow:
-            return interface->availableWrite(channel) > (numberOfBytes + HIGH_PRIORITY_BUFFER_SIZE + MEDIUM_PRIORITY_BUFFER_SIZE);
-        case PriorityMedium:
-            return interface->availableWrite(channel) > (numberOfBytes + HIGH_PRIORITY_BUFFER_SIZE);
-        case PriorityHigh:
-            return interface->availableWrite(channel) > numberOfBytes;
-    }
-    return false; // avoid compiler warning
+static inline __attribute__((always_inline)) bool AvailableWrite(const MuxChannel channel, const Interface * const interface, const size_t numberOfBytes, const PriorityFifoPriority priority) {
+    return interface->availableWrite(channel, priority) > numberOfBytes;
 }
 
 /**
@@ -574,7 +876,7 @@ bool SendAvailable(Send * const send, const size_t numberOfBytes) {
  * @return True if the interface is blocked.
  */
 static inline __attribute__((always_inline)) bool Blocked(const MuxChannel channel, const SendInterfaceMode mode, const Interface * const interface, const size_t numberOfBytes) {
-    return (mode == SendInterfaceModeBlocking) && interface->enabled() && (AvailableWrite(channel, interface, numberOfBytes, PriorityLow) == false);
+    return (mode == SendInterfaceModeBlocking) && interface->enabled() && (AvailableWrite(channel, interface, numberOfBytes, PriorityFifoPriorityLow) == false);
 }
 
 /**
@@ -26,6 +26,7 @@
 typedef enum {
     SendDataMessageModeBinary,
     SendDataMessageModeAscii,
+    SendDataMessageModeCompact,
 } SendDataMessageMode;
 
 /**
@@ -37,6 +38,7 @@ typedef enum {
     SendAhrsMessageTypeEulerAngles,
     SendAhrsMessageTypeLinearAcceleration,
     SendAhrsMessageTypeEarthAcceleration,
+    SendAhrsMessageTypeCompressedQuaternion,
 } SendAhrsMessageType;
 
 /**
@@ -61,6 +63,17 @@ typedef struct {
     SendInterfaceMode serialSendMode;
 } SendSettings;
 
+/**
+ * @brief Rate divisor multipliers.
+ */
+typedef struct {
+    uint32_t inertial;
+    uint32_t ahrs;
+    uint32_t temperature;
+    uint32_t jointAngles;
+    uint32_t frame;
+} SendRateDivisorMultipliers;
+
 /**
  * @brief Send structure.
  */
@@ -70,8 +83,11 @@ typedef struct {
     FusionVector downsampledGyroscope; // private
     FusionVector downsampledAccelerometer; // private
     uint32_t downsampledInertialCount; // private
+    uint64_t compactInertialTimestamp; // private
+    int16_t compactInertial[6]; // private
     FusionAhrsFlags flags; // private
     uint32_t downsampledAhrsCount; // private
+    uint64_t compressedQuaternionTimestamp; // private
     float downsampledTemperature; // private
     uint32_t downsampledTemperatureCount; // private
     size_t usbBufferOverflow; // private
@@ -104,6 +120,35 @@ typedef struct {
     float temperature;
 } SendTemperatureData;
 
+/**
+ * @brief Joint angles data.
+ */
+typedef struct {
+    uint64_t ticks;
+    const float* angles;
+    size_t numberOfAngles;
+} SendJointAnglesData;
+
+/**
+ * @brief Frame sensor.
+ */
+typedef struct {
+    FusionVector gyroscope;
+    FusionVector accelerometer;
+    FusionQuaternion quaternion;
+} SendFrameSensor;
+
+/**
+ * @brief Frame data. Bit n of the presence bitmap is set if sensor n is
+ * present.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint32_t presence;
+    const SendFrameSensor* sensors;
+    size_t numberOfSensors;
+} SendFrameData;
+
 //------------------------------------------------------------------------------
 // Variable declarations
 
@@ -133,9 +178,13 @@ extern Send sendT;
 // Function declarations
 
 void SendSetSettings(Send * const send, const SendSettings * const settings);
+void SendSetRateDivisorMultipliers(const SendRateDivisorMultipliers * const rateDivisorMultipliers_);
+const SendRateDivisorMultipliers * SendGetRateDivisorMultipliers(void);
 void SendInertial(Send * const send, const SendInertialData * const inertialData);
 void SendAhrs(Send * const send, const SendAhrsData * const ahrsData);
 void SendTemperature(Send * const send, const SendTemperatureData * const temperatureData);
+void SendJointAngles(Send * const send, const SendJointAnglesData * const jointAnglesData);
+void SendFrame(Send * const send, const SendFrameData * const frameData);
 void SendNotification(Send * const send, const char* const format, ...);
 void SendError(Send * const send, const char* const format, ...);
 void SendResponseUsb(Send * const send, const void* const data, const size_t numberOfBytes);
@@ -8,7 +8,7 @@
 // Includes
 
 #include "Serial.h"
-#include "Uart/Uart1DmaTx.h"
+#include "Uart/Uart1Dma.h"
 
 //------------------------------------------------------------------------------
 // Variables
@@ -28,9 +28,9 @@ void SerialSetSettings(const SerialSettings * const settings_) {
         UartSettings uartSettings = uartSettingsDefault;
         uartSettings.baudRate = settings.baudRate;
         uartSettings.rtsCtsEnabled = settings.rtsCtsEnabled;
-        Uart1DmaTxInitialise(&uartSettings);
+        Uart1DmaInitialise(&uartSettings);
     } else {
-        Uart1DmaTxDeinitialise();
+        Uart1DmaDeinitialise();
     }
 }
 
@@ -49,25 +49,58 @@ bool SerialEnabled(void) {
  * @return Number of bytes read.
  */
 size_t SerialRead(void* const destination, size_t numberOfBytes) {
-    return Uart1DmaTxRead(destination, numberOfBytes);
+    return Uart1DmaRead(destination, numberOfBytes);
 }
 
 /**
- * @brief Returns the space available in the write buffer.
- * @return Space available in the write buffer.
+ * @brief Returns the capacity of the write buffer of the priority.
+ * @param priority Priority.
+ * @return Capacity of the write buffer of the priority.
  */
-size_t SerialAvailableWrite(void) {
-    return Uart1DmaTxAvailableWrite();
+size_t SerialWriteCapacity(const PriorityFifoPriority priority) {
+    return Uart1DmaWriteCapacity(priority);
 }
 
 /**
- * @brief Writes data to the write buffer.
+ * @brief Returns the space available in the write buffer of the priority.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
+ */
+size_t SerialAvailableWrite(const PriorityFifoPriority priority) {
+    return Uart1DmaAvailableWrite(priority);
+}
+
+/**
+ * @brief Writes a message to the write buffer of the priority.
+ * @param priority Priority.
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @return Result.
  */
-FifoResult SerialWrite(const void* const data, const size_t numberOfBytes) {
-    return Uart1DmaTxWrite(data, numberOfBytes);
+FifoResult SerialWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    return Uart1DmaWrite(priority, data, numberOfBytes);
+}
+
+/**
+ * @brief Reserves space in the write buffer of the priority for a message to
+ * be written to directly. SerialCommit must be called after the message has
+ * been written.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+FifoResult SerialReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return Uart1DmaReserve(priority, numberOfBytes, reservation);
+}
+
+/**
+ * @brief Makes a message written to a reservation available to transmit.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+void SerialCommit(const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    Uart1DmaCommit(priority, numberOfBytes);
 }
 
 //------------------------------------------------------------------------------
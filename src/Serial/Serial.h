@@ -11,6 +11,7 @@
 // Includes
 
 #include "Fifo.h"
+#include "PriorityFifo.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -32,8 +33,11 @@ typedef struct {
 void SerialSetSettings(const SerialSettings * const settings_);
 bool SerialEnabled(void);
 size_t SerialRead(void* const destination, size_t numberOfBytes);
-size_t SerialAvailableWrite(void);
-FifoResult SerialWrite(const void* const data, const size_t numberOfBytes);
+size_t SerialWriteCapacity(const PriorityFifoPriority priority);
+size_t SerialAvailableWrite(const PriorityFifoPriority priority);
+FifoResult SerialWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+FifoResult SerialReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+void SerialCommit(const PriorityFifoPriority priority, const size_t numberOfBytes);
 
 #endif
 
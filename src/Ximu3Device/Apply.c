@@ -8,8 +8,11 @@
 // Includes
 
 #include "Apply.h"
+#include "Backpressure/Backpressure.h"
+#include "Frame/Frame.h"
 #include "Imu/Icm/Icm.h"
 #include "Imu/Imu.h"
+#include "Kinematics/Kinematics.h"
 #include "Send/Send.h"
 #include "Serial/Serial.h"
 #include "Timer/Timer.h"
@@ -21,6 +24,9 @@ static void ApplySerial(Context * const context);
 static void ApplyIcm(Context * const context);
 static void ApplyImu(Context * const context);
 static void ApplySend(Context * const context);
+static void ApplyBackpressure(Context * const context);
+static void ApplyKinematics(Context * const context);
+static void ApplyFrame(Context * const context);
 
 //------------------------------------------------------------------------------
 // Functions
@@ -46,6 +52,9 @@ void ApplyNow(Context * const context) {
     ApplyIcm(context);
     ApplyImu(context);
     ApplySend(context);
+    ApplyBackpressure(context);
+    ApplyKinematics(context);
+    ApplyFrame(context);
     Ximu3SettingsClearApplyPending(context->settings);
 }
 
@@ -99,7 +108,9 @@ static void ApplyIcm(Context * const context) {
     if ((Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexGyroscopeNotchFilterEnabled)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexGyroscopeAntiAliasing)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexAccelerometerAntiAliasing)
-        || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexSampleRate)) == false) {
+        || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexSampleRate)
+        || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexFifoWatermark)
+        || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexSensorTimestampEnabled)) == false) {
         return;
     }
 
@@ -109,8 +120,10 @@ static void ApplyIcm(Context * const context) {
         .gyroscopeAntiAliasing = Ximu3SettingsGet(context->settings)->gyroscopeAntiAliasing,
         .accelerometerAntiAliasing = Ximu3SettingsGet(context->settings)->accelerometerAntiAliasing,
         .sampleRate = Ximu3SettingsGet(context->settings)->sampleRate,
+        .fifoWatermark = Ximu3SettingsGet(context->settings)->fifoWatermark,
+        .sensorTimestampEnabled = Ximu3SettingsGet(context->settings)->sensorTimestampEnabled,
     };
-    context->imu->icm->initialise(&icmSettings);
+    IcmInitialise(context->imu->icm, &icmSettings);
 }
 
 /**
@@ -134,6 +147,7 @@ static void ApplyImu(Context * const context) {
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexSampleRate)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexAxesRemap)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexGyroscopeBiasCorrectionEnabled)
+        || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexResamplingEnabled)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexAhrsUpdateRateDivisor)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexAhrsAxesConvention)
         || Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexAhrsGain)
@@ -152,6 +166,7 @@ static void ApplyImu(Context * const context) {
         .sampleRate = Ximu3SettingsGet(context->settings)->sampleRate,
         .axesRemap = Ximu3SettingsGet(context->settings)->axesRemap,
         .gyroscopeBiasCorrectionEnabled = Ximu3SettingsGet(context->settings)->gyroscopeBiasCorrectionEnabled,
+        .resamplingEnabled = Ximu3SettingsGet(context->settings)->resamplingEnabled,
         .ahrsUpdateRateDivisor = Ximu3SettingsGet(context->settings)->ahrsUpdateRateDivisor,
         .ahrsAxesConvention = Ximu3SettingsGet(context->settings)->ahrsAxesConvention,
         .ahrsGain = Ximu3SettingsGet(context->settings)->ahrsGain,
@@ -190,5 +205,74 @@ static void ApplySend(Context * const context) {
     SendSetSettings(context->send, &sendSettings);
 }
 
+/**
+ * @brief Applies backpressure settings.
+ * @param context Context.
+ */
+static void ApplyBackpressure(Context * const context) {
+
+    // Do nothing if not applicable
+    if (context->isMain == false) {
+        return;
+    }
+
+    // Do nothing if settings unchanged
+    if (Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexBackpressureOrder) == false) {
+        return;
+    }
+
+    // Apply settings
+    const BackpressureSettings backpressureSettings = {
+        .order = Ximu3SettingsGet(context->settings)->backpressureOrder,
+    };
+    BackpressureSetSettings(&backpressureSettings);
+}
+
+/**
+ * @brief Applies kinematics settings.
+ * @param context Context.
+ */
+static void ApplyKinematics(Context * const context) {
+
+    // Do nothing if not applicable
+    if (context->isMain == false) {
+        return;
+    }
+
+    // Do nothing if settings unchanged
+    if (Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexJointAnglesMessageRateDivisor) == false) {
+        return;
+    }
+
+    // Apply settings
+    const KinematicsSettings kinematicsSettings = {
+        .jointAnglesMessageRateDivisor = Ximu3SettingsGet(context->settings)->jointAnglesMessageRateDivisor,
+    };
+    KinematicsSetSettings(&kinematics, &kinematicsSettings);
+}
+
+/**
+ * @brief Applies frame settings.
+ * @param context Context.
+ */
+static void ApplyFrame(Context * const context) {
+
+    // Do nothing if not applicable
+    if (context->isMain == false) {
+        return;
+    }
+
+    // Do nothing if settings unchanged
+    if (Ximu3SettingsApplyPending(context->settings, Ximu3SettingsIndexFrameMessageRateDivisor) == false) {
+        return;
+    }
+
+    // Apply settings
+    const FrameSettings frameSettings = {
+        .frameMessageRateDivisor = Ximu3SettingsGet(context->settings)->frameMessageRateDivisor,
+    };
+    FrameSetSettings(&frame, &frameSettings);
+}
+
 //------------------------------------------------------------------------------
 // End of file
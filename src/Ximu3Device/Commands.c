@@ -13,9 +13,12 @@
 #include "Eeprom/Eeprom.h"
 #include "Haptic/Haptic.h"
 #include "Imu/Imu.h"
+#include "Kinematics/Kinematics.h"
 #include "Led/Led.h"
+#include "Profile/Profile.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "Timestamp/Timestamp.h"
 #include "x-IMU3-Device/Ximu3.h"
 
@@ -121,6 +124,26 @@ void CommandsHeading(const char* * const value, Ximu3CommandResponse * const res
     Ximu3CommandRespond(response);
 }
 
+/**
+ * @brief Zero command. Aligns the headings of all segments for the joint
+ * angles. The hand must be held flat with the fingers extended.
+ * @param value Value.
+ * @param response Response.
+ * @param context Context.
+ */
+void CommandsZero(const char* * const value, Ximu3CommandResponse * const response, void* const context) {
+    const Context * const context_ = context;
+    if (context_->isMain == false) {
+        Ximu3CommandRespondError(response, "Command not applicable");
+        return;
+    }
+    if (Ximu3CommandParseNull(value, response) != Ximu3ResultOk) {
+        return;
+    }
+    KinematicsZero(&kinematics);
+    Ximu3CommandRespond(response);
+}
+
 /**
  * @brief Note command.
  * @param value Value.
@@ -282,6 +305,89 @@ void CommandsErase(const char* * const value, Ximu3CommandResponse * const respo
     Ximu3CommandRespond(response);
 }
 
+/**
+ * @brief Stats command. A null value responds with the minimum, mean, and
+ * maximum duration of each probe in microseconds. A probe name responds with
+ * the statistics and histogram of that probe. A number sets the period in
+ * seconds at which statistics are sent as notifications. The string "reset"
+ * resets the statistics.
+ * @param value Value.
+ * @param response Response.
+ * @param context Context.
+ */
+void CommandsStats(const char* * const value, Ximu3CommandResponse * const response, void* const context) {
+#ifndef PROFILE_ENABLED
+    Ximu3CommandRespondError(response, "Profiling disabled");
+#else
+
+    // Parse type
+    JsonType type;
+    if (JsonParseType(value, &type) != JsonResultOk) {
+        Ximu3CommandRespondError(response, "Invalid value");
+        return;
+    }
+
+    // Parse null
+    if (type == JsonTypeNull) {
+        if (Ximu3CommandParseNull(value, response) != Ximu3ResultOk) {
+            return;
+        }
+        size_t length = (size_t) snprintf(response->value, sizeof (response->value), "{");
+        for (int index = 0; (index < ProfileNumberOfProbes) && (length < sizeof (response->value)); index++) {
+            const ProfileStatistics statistics = ProfileGetStatistics((ProfileProbe) index);
+            const uint32_t mean = statistics.numberOfDurations == 0 ? 0 : (uint32_t) (statistics.total / statistics.numberOfDurations);
+            length += (size_t) snprintf(&response->value[length], sizeof (response->value) - length, "%s\"%s\":[%.1f,%.1f,%.1f]", index == 0 ? "" : ",", ProfileProbeToString((ProfileProbe) index),
+                    (double) ProfileCountsToMicroseconds(statistics.min), (double) ProfileCountsToMicroseconds(mean), (double) ProfileCountsToMicroseconds(statistics.max));
+        }
+        if (length < sizeof (response->value)) {
+            snprintf(&response->value[length], sizeof (response->value) - length, "}");
+        }
+        Ximu3CommandRespond(response);
+        return;
+    }
+
+    // Parse number
+    if (type == JsonTypeNumber) {
+        float period;
+        if (Ximu3CommandParseNumber(value, response, &period) != Ximu3ResultOk) {
+            return;
+        }
+        ProfileSetStreamPeriod(period);
+        Ximu3CommandRespond(response);
+        return;
+    }
+
+    // Parse string
+    char string[XIMU3_SIZE_VALUE];
+    if (Ximu3CommandParseString(value, response, string, sizeof (string), NULL) != Ximu3ResultOk) {
+        return;
+    }
+    if (strcmp(string, "reset") == 0) {
+        ProfileReset();
+        Ximu3CommandRespond(response);
+        return;
+    }
+    ProfileProbe probe;
+    if (ProfileProbeFromString(string, &probe) == false) {
+        Ximu3CommandRespondError(response, "Invalid probe");
+        return;
+    }
+
+    // Respond with probe statistics
+    const ProfileStatistics statistics = ProfileGetStatistics(probe);
+    const uint32_t mean = statistics.numberOfDurations == 0 ? 0 : (uint32_t) (statistics.total / statistics.numberOfDurations);
+    size_t length = (size_t) snprintf(response->value, sizeof (response->value), "{\"count\":%u,\"min\":%.3f,\"mean\":%.3f,\"max\":%.3f,\"histogram\":[", (unsigned int) statistics.numberOfDurations,
+            (double) ProfileCountsToMicroseconds(statistics.min), (double) ProfileCountsToMicroseconds(mean), (double) ProfileCountsToMicroseconds(statistics.max));
+    for (int index = 0; (index < PROFILE_HISTOGRAM_SIZE) && (length < sizeof (response->value)); index++) {
+        length += (size_t) snprintf(&response->value[length], sizeof (response->value) - length, "%s%u", index == 0 ? "" : ",", (unsigned int) statistics.histogram[index]);
+    }
+    if (length < sizeof (response->value)) {
+        snprintf(&response->value[length], sizeof (response->value) - length, "]}");
+    }
+    Ximu3CommandRespond(response);
+#endif
+}
+
 /**
  * @brief Returns true if factory mode enabled.
  * @return True if factory mode enabled.
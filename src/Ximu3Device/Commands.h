@@ -22,6 +22,7 @@ void CommandsApply(const char* * const value, Ximu3CommandResponse * const respo
 void CommandsSave(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsRestart(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsHeading(const char* * const value, Ximu3CommandResponse * const response, void* const context);
+void CommandsZero(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsNote(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsTimestamp(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsBlink(const char* * const value, Ximu3CommandResponse * const response, void* const context);
@@ -30,6 +31,7 @@ void CommandsColour(const char* * const value, Ximu3CommandResponse * const resp
 void CommandsHaptic(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsFactory(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 void CommandsErase(const char* * const value, Ximu3CommandResponse * const response, void* const context);
+void CommandsStats(const char* * const value, Ximu3CommandResponse * const response, void* const context);
 bool CommandsOverrideReadOnly(void* const context);
 
 #endif
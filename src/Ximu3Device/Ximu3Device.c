@@ -16,6 +16,7 @@
 #include "Interfaces.h"
 #include "Led/Led.h"
 #include "Nvm.h"
+#include "Profile/Profile.h"
 #include "Send/Send.h"
 #include <string.h>
 #include "x-IMU3-Device/Ximu3.h"
@@ -46,6 +47,7 @@ static const Ximu3CommandMap commands[] = {
     {"save", CommandsSave},
     {"restart", CommandsRestart},
     {"heading", CommandsHeading},
+    {"zero", CommandsZero},
     {"note", CommandsNote},
     {"timestamp", CommandsTimestamp},
     {"blink", CommandsBlink},
@@ -55,6 +57,7 @@ static const Ximu3CommandMap commands[] = {
     {"haptic", CommandsHaptic},
     {"factory", CommandsFactory},
     {"erase", CommandsErase},
+    {"stats", CommandsStats},
 };
 
 static const int numberOfCommands = (int) (sizeof (commands) / sizeof (Ximu3CommandMap));
@@ -154,12 +157,22 @@ void Ximu3DeviceInitialise(void) {
 }
 
 /**
- * @brief Module tasks. This function should be called repeatedly within the
- * main program loop.
+ * @brief Command tasks. This function should be called repeatedly within the
+ * main program loop together with Ximu3DeviceApplyTasks.
  */
-void Ximu3DeviceTasks(void) {
+void Ximu3DeviceCommandTasks(void) {
+    PROFILE(ProfileProbeCommandTasks);
     for (int index = 0; index < numberOfDevices; index++) {
         Ximu3CommandTasks(&bridges[index]);
+    }
+}
+
+/**
+ * @brief Apply tasks. This function should be called repeatedly within the
+ * main program loop together with Ximu3DeviceCommandTasks.
+ */
+void Ximu3DeviceApplyTasks(void) {
+    for (int index = 0; index < numberOfDevices; index++) {
         ApplyTasks(&contexts[index]);
     }
 }
@@ -11,7 +11,8 @@
 // Function declarations
 
 void Ximu3DeviceInitialise(void);
-void Ximu3DeviceTasks(void);
+void Ximu3DeviceCommandTasks(void);
+void Ximu3DeviceApplyTasks(void);
 
 #endif
 
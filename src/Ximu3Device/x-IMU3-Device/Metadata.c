@@ -25,8 +25,11 @@ static const char* const names[] = {
     "Gyroscope Anti-aliasing",
     "Accelerometer Anti-aliasing",
     "Sample Rate",
+    "FIFO Watermark",
+    "Sensor Timestamp Enabled",
     "Axes Remap",
     "Gyroscope Bias Correction Enabled",
+    "Resampling Enabled",
     "AHRS Update Rate Divisor",
     "AHRS Axes Convention",
     "AHRS Gain",
@@ -36,8 +39,11 @@ static const char* const names[] = {
     "Inertial Message Rate Divisor",
     "AHRS Message Rate Divisor",
     "Temperature Message Rate Divisor",
+    "Joint Angles Message Rate Divisor",
+    "Frame Message Rate Divisor",
     "USB Send Mode",
     "Serial Send Mode",
+    "Backpressure Order",
 };
 
 static const char* const keys[] = {
@@ -63,8 +69,11 @@ static const char* const keys[] = {
     "gyroscope_anti_aliasing",
     "accelerometer_anti_aliasing",
     "sample_rate",
+    "fifo_watermark",
+    "sensor_timestamp_enabled",
     "axes_remap",
     "gyroscope_bias_correction_enabled",
+    "resampling_enabled",
     "ahrs_update_rate_divisor",
     "ahrs_axes_convention",
     "ahrs_gain",
@@ -74,8 +83,11 @@ static const char* const keys[] = {
     "inertial_message_rate_divisor",
     "ahrs_message_rate_divisor",
     "temperature_message_rate_divisor",
+    "joint_angles_message_rate_divisor",
+    "frame_message_rate_divisor",
     "usb_send_mode",
     "serial_send_mode",
+    "backpressure_order",
 };
 
 const MetadataType types[] = {
@@ -101,8 +113,11 @@ const MetadataType types[] = {
     MetadataTypeIcmAntiAliasing,
     MetadataTypeIcmAntiAliasing,
     MetadataTypeIcmSampleRate,
+    MetadataTypeUint32,
+    MetadataTypeBool,
     MetadataTypeFusionRemapAlignment,
     MetadataTypeBool,
+    MetadataTypeBool,
     MetadataTypeUint32,
     MetadataTypeFusionConvention,
     MetadataTypeFloat,
@@ -112,8 +127,11 @@ const MetadataType types[] = {
     MetadataTypeUint32,
     MetadataTypeUint32,
     MetadataTypeUint32,
+    MetadataTypeUint32,
+    MetadataTypeUint32,
     MetadataTypeSendInterfaceMode,
     MetadataTypeSendInterfaceMode,
+    MetadataTypeBackpressureOrder,
 };
 
 const size_t sizes[] = {
@@ -139,8 +157,11 @@ const size_t sizes[] = {
     sizeof (((Ximu3SettingsValues *) 0)->gyroscopeAntiAliasing),
     sizeof (((Ximu3SettingsValues *) 0)->accelerometerAntiAliasing),
     sizeof (((Ximu3SettingsValues *) 0)->sampleRate),
+    sizeof (((Ximu3SettingsValues *) 0)->fifoWatermark),
+    sizeof (((Ximu3SettingsValues *) 0)->sensorTimestampEnabled),
     sizeof (((Ximu3SettingsValues *) 0)->axesRemap),
     sizeof (((Ximu3SettingsValues *) 0)->gyroscopeBiasCorrectionEnabled),
+    sizeof (((Ximu3SettingsValues *) 0)->resamplingEnabled),
     sizeof (((Ximu3SettingsValues *) 0)->ahrsUpdateRateDivisor),
     sizeof (((Ximu3SettingsValues *) 0)->ahrsAxesConvention),
     sizeof (((Ximu3SettingsValues *) 0)->ahrsGain),
@@ -150,8 +171,11 @@ const size_t sizes[] = {
     sizeof (((Ximu3SettingsValues *) 0)->inertialMessageRateDivisor),
     sizeof (((Ximu3SettingsValues *) 0)->ahrsMessageRateDivisor),
     sizeof (((Ximu3SettingsValues *) 0)->temperatureMessageRateDivisor),
+    sizeof (((Ximu3SettingsValues *) 0)->jointAnglesMessageRateDivisor),
+    sizeof (((Ximu3SettingsValues *) 0)->frameMessageRateDivisor),
     sizeof (((Ximu3SettingsValues *) 0)->usbSendMode),
     sizeof (((Ximu3SettingsValues *) 0)->serialSendMode),
+    sizeof (((Ximu3SettingsValues *) 0)->backpressureOrder),
 };
 
 const void* const defaults[] = {
@@ -177,8 +201,11 @@ const void* const defaults[] = {
     (void*) (&(IcmAntiAliasing) {IcmAntiAliasing42Hz}),
     (void*) (&(IcmAntiAliasing) {IcmAntiAliasing42Hz}),
     (void*) (&(IcmSampleRate) {IcmSampleRate100Hz}),
+    (void*) (&(uint32_t) {0}),
+    (void*) (&(bool) {false}),
     (void*) (&(FusionRemapAlignment) {FusionRemapAlignmentPXPYPZ}),
     (void*) (&(bool) {false}),
+    (void*) (&(bool) {false}),
     (void*) (&(uint32_t) {1}),
     (void*) (&(FusionConvention) {FusionConventionNwu}),
     (void*) (&(float) {0.5f}),
@@ -188,8 +215,11 @@ const void* const defaults[] = {
     (void*) (&(uint32_t) {1}),
     (void*) (&(uint32_t) {1}),
     (void*) (&(uint32_t) {0}),
+    (void*) (&(uint32_t) {0}),
+    (void*) (&(uint32_t) {0}),
     (void*) (&(SendInterfaceMode) {SendInterfaceModeBlocking}),
     (void*) (&(SendInterfaceMode) {SendInterfaceModeDisabled}),
+    (void*) (&(BackpressureOrder) {BackpressureOrderTemperatureInertialAhrs}),
 };
 
 const bool preserveds[] = {
@@ -228,6 +258,12 @@ const bool preserveds[] = {
     false,
     false,
     false,
+    false,
+    false,
+    false,
+    false,
+    false,
+    false,
 };
 
 const bool readOnlys[] = {
@@ -266,6 +302,12 @@ const bool readOnlys[] = {
     false,
     false,
     false,
+    false,
+    false,
+    false,
+    false,
+    false,
+    false,
 };
 
 static void* GetValue(Ximu3Settings * const settings, const Ximu3SettingsIndex index) {
@@ -314,10 +356,16 @@ static void* GetValue(Ximu3Settings * const settings, const Ximu3SettingsIndex i
             return &settings->values.accelerometerAntiAliasing;
         case Ximu3SettingsIndexSampleRate:
             return &settings->values.sampleRate;
+        case Ximu3SettingsIndexFifoWatermark:
+            return &settings->values.fifoWatermark;
+        case Ximu3SettingsIndexSensorTimestampEnabled:
+            return &settings->values.sensorTimestampEnabled;
         case Ximu3SettingsIndexAxesRemap:
             return &settings->values.axesRemap;
         case Ximu3SettingsIndexGyroscopeBiasCorrectionEnabled:
             return &settings->values.gyroscopeBiasCorrectionEnabled;
+        case Ximu3SettingsIndexResamplingEnabled:
+            return &settings->values.resamplingEnabled;
         case Ximu3SettingsIndexAhrsUpdateRateDivisor:
             return &settings->values.ahrsUpdateRateDivisor;
         case Ximu3SettingsIndexAhrsAxesConvention:
@@ -336,10 +384,16 @@ static void* GetValue(Ximu3Settings * const settings, const Ximu3SettingsIndex i
             return &settings->values.ahrsMessageRateDivisor;
         case Ximu3SettingsIndexTemperatureMessageRateDivisor:
             return &settings->values.temperatureMessageRateDivisor;
+        case Ximu3SettingsIndexJointAnglesMessageRateDivisor:
+            return &settings->values.jointAnglesMessageRateDivisor;
+        case Ximu3SettingsIndexFrameMessageRateDivisor:
+            return &settings->values.frameMessageRateDivisor;
         case Ximu3SettingsIndexUsbSendMode:
             return &settings->values.usbSendMode;
         case Ximu3SettingsIndexSerialSendMode:
             return &settings->values.serialSendMode;
+        case Ximu3SettingsIndexBackpressureOrder:
+            return &settings->values.backpressureOrder;
 
     }
     return NULL; // avoid compiler warning
@@ -10,6 +10,7 @@
 #include "Ximu3Settings.h"
 
 typedef enum {
+    MetadataTypeBackpressureOrder,
     MetadataTypeBool,
     MetadataTypeFloat,
     MetadataTypeFusionConvention,
@@ -194,6 +194,55 @@ size_t Ximu3AsciiAhrsStatus(void* const destination, const size_t destinationSiz
     return destinationIndex;
 }
 
+/**
+ * @brief Writes an ASCII joint angles data message.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3AsciiJointAngles(void* const destination, const size_t destinationSize, const Ximu3DataJointAngles * const data) {
+    size_t destinationIndex = 0;
+    WriteHeader(destination, destinationSize, &destinationIndex, XIMU3_ASCII_ID_JOINT_ANGLES, data->timestamp);
+    for (size_t index = 0; index < data->numberOfAngles; index++) {
+        WriteFloat(destination, destinationSize, &destinationIndex, data->angles[index]);
+    }
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
+/**
+ * @brief Writes an ASCII frame data message. Each sensor is written as a
+ * presence flag followed by the sensor values if present.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3AsciiFrame(void* const destination, const size_t destinationSize, const Ximu3DataFrame * const data) {
+    size_t destinationIndex = 0;
+    WriteHeader(destination, destinationSize, &destinationIndex, XIMU3_ASCII_ID_FRAME, data->timestamp);
+    for (size_t index = 0; index < data->numberOfSensors; index++) {
+        const bool present = (data->presence & (1UL << index)) != 0;
+        WriteFloat(destination, destinationSize, &destinationIndex, (float) present);
+        if (present) {
+            const Ximu3DataFrameSensor * const sensor = &data->sensors[index];
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeZ);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerZ);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionW);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionZ);
+        }
+    }
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
 /**
  * @brief Writes an ASCII serial accessory data message.
  * @param destination Destination.
@@ -21,6 +21,7 @@
 #define XIMU3_ASCII_ID_MAGNETOMETER         'M'
 #define XIMU3_ASCII_ID_HIGH_G_ACCELEROMETER 'H'
 #define XIMU3_ASCII_ID_PRESSURE             'P' /* reserved for future use */
+#define XIMU3_ASCII_ID_COMPACT_INERTIAL     'X' /* binary only */
 
 // AHRS
 #define XIMU3_ASCII_ID_QUATERNION           'Q'
@@ -31,6 +32,9 @@
 #define XIMU3_ASCII_ID_DELTA                'D' /* reserved for future use */
 #define XIMU3_ASCII_ID_AHRS_STATUS          'U'
 #define XIMU3_ASCII_ID_MAGNETIC_COMPASS     'K' /* reserved for future use */
+#define XIMU3_ASCII_ID_JOINT_ANGLES         'J'
+#define XIMU3_ASCII_ID_FRAME                'Z'
+#define XIMU3_ASCII_ID_COMPRESSED_QUATERNION 'V' /* binary only */
 
 // External
 #define XIMU3_ASCII_ID_GNSS                 'G' /* reserved for future use */
@@ -60,6 +64,8 @@ size_t Ximu3AsciiEulerAngles(void* const destination, const size_t destinationSi
 size_t Ximu3AsciiLinearAcceleration(void* const destination, const size_t destinationSize, const Ximu3DataLinearAcceleration * const data);
 size_t Ximu3AsciiEarthAcceleration(void* const destination, const size_t destinationSize, const Ximu3DataEarthAcceleration * const data);
 size_t Ximu3AsciiAhrsStatus(void* const destination, const size_t destinationSize, const Ximu3DataAhrsStatus * const data);
+size_t Ximu3AsciiJointAngles(void* const destination, const size_t destinationSize, const Ximu3DataJointAngles * const data);
+size_t Ximu3AsciiFrame(void* const destination, const size_t destinationSize, const Ximu3DataFrame * const data);
 size_t Ximu3AsciiSerialAccessory(void* const destination, const size_t destinationSize, const Ximu3DataSerialAccessory * const data);
 size_t Ximu3AsciiSync(void* const destination, const size_t destinationSize, const Ximu3DataSync * const data);
 size_t Ximu3AsciiLtc(void* const destination, const size_t destinationSize, const Ximu3DataLtc * const data);
@@ -7,6 +7,7 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include <math.h>
 #include <string.h>
 #include "Ximu3Ascii.h"
 #include "Ximu3Binary.h"
@@ -25,6 +26,10 @@
 
 static inline void WriteHeader(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const char asciiId, const uint64_t timestamp);
 static inline void WriteFloat(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const float value_);
+static inline void WriteAngle(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const float angle);
+static inline void WriteVarint(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const uint64_t value);
+static inline void WriteDifference(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const int16_t value, const int16_t previousValue);
+static inline void WriteSmallestThree(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const float w, const float x, const float y, const float z);
 static inline void WriteString(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const char* string);
 static inline void WriteTermination(void* const destination, const size_t destinationSize, size_t * const destinationIndex);
 static inline void WriteByte(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const uint8_t byte);
@@ -52,6 +57,30 @@ size_t Ximu3BinaryInertial(void* const destination, const size_t destinationSize
     return destinationIndex;
 }
 
+/**
+ * @brief Writes a binary compact inertial data message. The ID is followed by
+ * the timestamp as an unsigned LEB128 varint, shifted left by one bit with bit
+ * 0 set for a keyframe, and the difference of each value as a zig-zag varint.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3BinaryCompactInertial(void* const destination, const size_t destinationSize, const Ximu3DataCompactInertial * const data) {
+    size_t destinationIndex = 0;
+    const bool keyframe = data->previousTimestamp == 0;
+    WriteByte(destination, destinationSize, &destinationIndex, 0x80 + (uint8_t) XIMU3_ASCII_ID_COMPACT_INERTIAL);
+    WriteVarint(destination, destinationSize, &destinationIndex, ((data->timestamp - data->previousTimestamp) << 1) | (keyframe ? 1 : 0));
+    WriteDifference(destination, destinationSize, &destinationIndex, data->gyroscopeX, keyframe ? 0 : data->previousGyroscopeX);
+    WriteDifference(destination, destinationSize, &destinationIndex, data->gyroscopeY, keyframe ? 0 : data->previousGyroscopeY);
+    WriteDifference(destination, destinationSize, &destinationIndex, data->gyroscopeZ, keyframe ? 0 : data->previousGyroscopeZ);
+    WriteDifference(destination, destinationSize, &destinationIndex, data->accelerometerX, keyframe ? 0 : data->previousAccelerometerX);
+    WriteDifference(destination, destinationSize, &destinationIndex, data->accelerometerY, keyframe ? 0 : data->previousAccelerometerY);
+    WriteDifference(destination, destinationSize, &destinationIndex, data->accelerometerZ, keyframe ? 0 : data->previousAccelerometerZ);
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
 /**
  * @brief Writes a binary magnetometer data message.
  * @param destination Destination.
@@ -104,6 +133,26 @@ size_t Ximu3BinaryQuaternion(void* const destination, const size_t destinationSi
     return destinationIndex;
 }
 
+/**
+ * @brief Writes a binary compressed quaternion data message. The ID is
+ * followed by the timestamp as an unsigned LEB128 varint, shifted left by one
+ * bit with bit 0 set for a keyframe, and the quaternion as a 32-bit
+ * smallest-three encoding.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3BinaryCompressedQuaternion(void* const destination, const size_t destinationSize, const Ximu3DataCompressedQuaternion * const data) {
+    size_t destinationIndex = 0;
+    const bool keyframe = data->previousTimestamp == 0;
+    WriteByte(destination, destinationSize, &destinationIndex, 0x80 + (uint8_t) XIMU3_ASCII_ID_COMPRESSED_QUATERNION);
+    WriteVarint(destination, destinationSize, &destinationIndex, ((data->timestamp - data->previousTimestamp) << 1) | (keyframe ? 1 : 0));
+    WriteSmallestThree(destination, destinationSize, &destinationIndex, data->w, data->x, data->y, data->z);
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
 /**
  * @brief Writes a binary rotation matrix data message.
  * @param destination Destination.
@@ -204,6 +253,58 @@ size_t Ximu3BinaryAhrsStatus(void* const destination, const size_t destinationSi
     return destinationIndex;
 }
 
+/**
+ * @brief Writes a binary joint angles data message. Each angle is written as a
+ * 16-bit integer in units of 0.01 degrees.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3BinaryJointAngles(void* const destination, const size_t destinationSize, const Ximu3DataJointAngles * const data) {
+    size_t destinationIndex = 0;
+    WriteHeader(destination, destinationSize, &destinationIndex, XIMU3_ASCII_ID_JOINT_ANGLES, data->timestamp);
+    for (size_t index = 0; index < data->numberOfAngles; index++) {
+        WriteAngle(destination, destinationSize, &destinationIndex, data->angles[index]);
+    }
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
+/**
+ * @brief Writes a binary frame data message. The presence bitmap is written
+ * as a 32-bit integer followed by the values of each sensor that is present.
+ * @param destination Destination.
+ * @param destinationSize Destination size.
+ * @param data Data.
+ * @return Message size.
+ */
+size_t Ximu3BinaryFrame(void* const destination, const size_t destinationSize, const Ximu3DataFrame * const data) {
+    size_t destinationIndex = 0;
+    WriteHeader(destination, destinationSize, &destinationIndex, XIMU3_ASCII_ID_FRAME, data->timestamp);
+    WriteByte(destination, destinationSize, &destinationIndex, (data->presence >> 0) & 0xFF);
+    WriteByte(destination, destinationSize, &destinationIndex, (data->presence >> 8) & 0xFF);
+    WriteByte(destination, destinationSize, &destinationIndex, (data->presence >> 16) & 0xFF);
+    WriteByte(destination, destinationSize, &destinationIndex, (data->presence >> 24) & 0xFF);
+    for (size_t index = 0; index < data->numberOfSensors; index++) {
+        if ((data->presence & (1UL << index)) != 0) {
+            const Ximu3DataFrameSensor * const sensor = &data->sensors[index];
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->gyroscopeZ);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->accelerometerZ);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionW);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionX);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionY);
+            WriteFloat(destination, destinationSize, &destinationIndex, sensor->quaternionZ);
+        }
+    }
+    WriteTermination(destination, destinationSize, &destinationIndex);
+    return destinationIndex;
+}
+
 /**
  * @brief Writes a binary serial accessory data message.
  * @param destination Destination.
@@ -378,6 +479,100 @@ static inline void WriteFloat(void* const destination, const size_t destinationS
     WriteByte(destination, destinationSize, destinationIndex, (value >> 24) & 0xFF);
 }
 
+/**
+ * @brief Writes an angle as a 16-bit integer in units of 0.01 degrees.
+ * @param destination Destination.
+ * @param destinationIndex Destination index.
+ * @param angle Angle in degrees.
+ */
+static inline void WriteAngle(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const float angle) {
+    float scaled = angle * 100.0f;
+    if (scaled > (float) INT16_MAX) {
+        scaled = (float) INT16_MAX;
+    }
+    if (scaled < (float) INT16_MIN) {
+        scaled = (float) INT16_MIN;
+    }
+    const uint16_t value = (uint16_t) (int16_t) (scaled + ((scaled < 0.0f) ? -0.5f : 0.5f));
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 0) & 0xFF);
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 8) & 0xFF);
+}
+
+/**
+ * @brief Writes an unsigned LEB128 varint. Each byte contains 7 bits of the
+ * value, least significant first, and the most significant bit is set if
+ * more bytes follow.
+ * @param destination Destination.
+ * @param destinationIndex Destination index.
+ * @param value Value.
+ */
+static inline void WriteVarint(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const uint64_t value) {
+    uint64_t remaining = value;
+    while (remaining >= 0x80) {
+        WriteByte(destination, destinationSize, destinationIndex, (uint8_t) (remaining & 0x7F) | 0x80);
+        remaining >>= 7;
+    }
+    WriteByte(destination, destinationSize, destinationIndex, (uint8_t) remaining);
+}
+
+/**
+ * @brief Writes the difference between two 16-bit integers as a zig-zag
+ * varint. Zig-zag encoding maps signed differences to unsigned values so that
+ * small positive and negative differences are both written as a single byte.
+ * @param destination Destination.
+ * @param destinationIndex Destination index.
+ * @param value Value.
+ * @param previousValue Previous value.
+ */
+static inline void WriteDifference(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const int16_t value, const int16_t previousValue) {
+    const int32_t difference = (int32_t) value - (int32_t) previousValue;
+    WriteVarint(destination, destinationSize, destinationIndex, ((uint32_t) difference << 1) ^ (uint32_t) (difference >> 31));
+}
+
+/**
+ * @brief Writes a quaternion as a 32-bit smallest-three encoding. The
+ * largest component is omitted and made positive by negating the quaternion.
+ * Bits 31 to 30 are the index of the largest component (w, x, y, z) and bits
+ * 29 to 0 are the remaining three components in order, each quantised to 10
+ * bits over the range -1/sqrt(2) to 1/sqrt(2).
+ * @param destination Destination.
+ * @param destinationIndex Destination index.
+ * @param w W element.
+ * @param x X element.
+ * @param y Y element.
+ * @param z Z element.
+ */
+static inline void WriteSmallestThree(void* const destination, const size_t destinationSize, size_t * const destinationIndex, const float w, const float x, const float y, const float z) {
+    const float elements[4] = {w, x, y, z};
+    uint32_t largest = 0;
+    for (uint32_t index = 1; index < 4; index++) {
+        if (fabsf(elements[index]) > fabsf(elements[largest])) {
+            largest = index;
+        }
+    }
+    const float norm = sqrtf((w * w) + (x * x) + (y * y) + (z * z));
+    const float scale = ((elements[largest] < 0.0f) ? -1.0f : 1.0f) / ((norm > 0.0f) ? norm : 1.0f);
+    uint32_t value = largest;
+    for (uint32_t index = 0; index < 4; index++) {
+        if (index == largest) {
+            continue;
+        }
+        const float normalised = ((elements[index] * scale * 1.41421356f) + 1.0f) * 0.5f; // 0 to 1
+        float quantised = roundf(normalised * 1023.0f);
+        if (quantised < 0.0f) {
+            quantised = 0.0f;
+        }
+        if (quantised > 1023.0f) {
+            quantised = 1023.0f;
+        }
+        value = (value << 10) | (uint32_t) quantised;
+    }
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 0) & 0xFF);
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 8) & 0xFF);
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 16) & 0xFF);
+    WriteByte(destination, destinationSize, destinationIndex, (value >> 24) & 0xFF);
+}
+
 /**
  * @brief Writes a string.
  * @param destination Destination.
@@ -17,14 +17,18 @@
 // Function declarations
 
 size_t Ximu3BinaryInertial(void* const destination, const size_t destinationSize, const Ximu3DataInertial * const data);
+size_t Ximu3BinaryCompactInertial(void* const destination, const size_t destinationSize, const Ximu3DataCompactInertial * const data);
 size_t Ximu3BinaryMagnetometer(void* const destination, const size_t destinationSize, const Ximu3DataMagnetometer * const data);
 size_t Ximu3BinaryHighGAccelerometer(void* const destination, const size_t destinationSize, const Ximu3DataHighGAccelerometer * const data);
 size_t Ximu3BinaryQuaternion(void* const destination, const size_t destinationSize, const Ximu3DataQuaternion * const data);
+size_t Ximu3BinaryCompressedQuaternion(void* const destination, const size_t destinationSize, const Ximu3DataCompressedQuaternion * const data);
 size_t Ximu3BinaryRotationMatrix(void* const destination, const size_t destinationSize, const Ximu3DataRotationMatrix * const data);
 size_t Ximu3BinaryEulerAngles(void* const destination, const size_t destinationSize, const Ximu3DataEulerAngles * const data);
 size_t Ximu3BinaryLinearAcceleration(void* const destination, const size_t destinationSize, const Ximu3DataLinearAcceleration * const data);
 size_t Ximu3BinaryEarthAcceleration(void* const destination, const size_t destinationSize, const Ximu3DataEarthAcceleration * const data);
 size_t Ximu3BinaryAhrsStatus(void* const destination, const size_t destinationSize, const Ximu3DataAhrsStatus * const data);
+size_t Ximu3BinaryJointAngles(void* const destination, const size_t destinationSize, const Ximu3DataJointAngles * const data);
+size_t Ximu3BinaryFrame(void* const destination, const size_t destinationSize, const Ximu3DataFrame * const data);
 size_t Ximu3BinarySerialAccessory(void* const destination, const size_t destinationSize, const Ximu3DataSerialAccessory * const data);
 size_t Ximu3BinarySync(void* const destination, const size_t destinationSize, const Ximu3DataSync * const data);
 size_t Ximu3BinaryLtc(void* const destination, const size_t destinationSize, const Ximu3DataLtc * const data);
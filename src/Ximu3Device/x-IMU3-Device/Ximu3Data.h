@@ -30,6 +30,39 @@ typedef struct {
     float accelerometerZ;
 } Ximu3DataInertial;
 
+/**
+ * @brief Compact inertial gyroscope scale in LSB per degree per second.
+ */
+#define XIMU3_COMPACT_GYROSCOPE_SCALE (16.4f)
+
+/**
+ * @brief Compact inertial accelerometer scale in LSB per g.
+ */
+#define XIMU3_COMPACT_ACCELEROMETER_SCALE (2048.0f)
+
+/**
+ * @brief Compact inertial data message. The gyroscope and accelerometer are in
+ * LSB of the compact inertial scales. The timestamp and each value are written
+ * relative to the previous timestamp and values, or as absolute values (a
+ * keyframe) if the previous timestamp is zero.
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint64_t previousTimestamp;
+    int16_t gyroscopeX;
+    int16_t gyroscopeY;
+    int16_t gyroscopeZ;
+    int16_t accelerometerX;
+    int16_t accelerometerY;
+    int16_t accelerometerZ;
+    int16_t previousGyroscopeX;
+    int16_t previousGyroscopeY;
+    int16_t previousGyroscopeZ;
+    int16_t previousAccelerometerX;
+    int16_t previousAccelerometerY;
+    int16_t previousAccelerometerZ;
+} Ximu3DataCompactInertial;
+
 /**
  * @brief Magnetometer data message.
  */
@@ -61,6 +94,20 @@ typedef struct {
     float z;
 } Ximu3DataQuaternion;
 
+/**
+ * @brief Compressed quaternion data message. The timestamp is written
+ * relative to the previous timestamp, or as an absolute timestamp (a keyframe)
+ * if the previous timestamp is zero.
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint64_t previousTimestamp;
+    float w;
+    float x;
+    float y;
+    float z;
+} Ximu3DataCompressedQuaternion;
+
 /**
  * @brief Rotation matrix data message.
  */
@@ -126,6 +173,42 @@ typedef struct {
     bool magneticRecovery;
 } Ximu3DataAhrsStatus;
 
+/**
+ * @brief Joint angles data message. Angles are in degrees.
+ */
+typedef struct {
+    uint64_t timestamp;
+    const float* angles;
+    size_t numberOfAngles;
+} Ximu3DataJointAngles;
+
+/**
+ * @brief Frame sensor.
+ */
+typedef struct {
+    float gyroscopeX;
+    float gyroscopeY;
+    float gyroscopeZ;
+    float accelerometerX;
+    float accelerometerY;
+    float accelerometerZ;
+    float quaternionW;
+    float quaternionX;
+    float quaternionY;
+    float quaternionZ;
+} Ximu3DataFrameSensor;
+
+/**
+ * @brief Frame data message. Bit n of the presence bitmap is set if sensor n
+ * is present. Sensors that are not present are not written.
+ */
+typedef struct {
+    uint64_t timestamp;
+    uint32_t presence;
+    const Ximu3DataFrameSensor* sensors;
+    size_t numberOfSensors;
+} Ximu3DataFrame;
+
 /**
  * @brief Serial accessory data message.
  */
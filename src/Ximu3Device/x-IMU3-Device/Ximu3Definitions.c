@@ -70,12 +70,21 @@ Ximu3Result Ximu3SettingsIndexFrom(Ximu3SettingsIndex * const index, const int i
         case Ximu3SettingsIndexSampleRate:
             *index = Ximu3SettingsIndexSampleRate;
             break;
+        case Ximu3SettingsIndexFifoWatermark:
+            *index = Ximu3SettingsIndexFifoWatermark;
+            break;
+        case Ximu3SettingsIndexSensorTimestampEnabled:
+            *index = Ximu3SettingsIndexSensorTimestampEnabled;
+            break;
         case Ximu3SettingsIndexAxesRemap:
             *index = Ximu3SettingsIndexAxesRemap;
             break;
         case Ximu3SettingsIndexGyroscopeBiasCorrectionEnabled:
             *index = Ximu3SettingsIndexGyroscopeBiasCorrectionEnabled;
             break;
+        case Ximu3SettingsIndexResamplingEnabled:
+            *index = Ximu3SettingsIndexResamplingEnabled;
+            break;
         case Ximu3SettingsIndexAhrsUpdateRateDivisor:
             *index = Ximu3SettingsIndexAhrsUpdateRateDivisor;
             break;
@@ -103,12 +112,21 @@ Ximu3Result Ximu3SettingsIndexFrom(Ximu3SettingsIndex * const index, const int i
         case Ximu3SettingsIndexTemperatureMessageRateDivisor:
             *index = Ximu3SettingsIndexTemperatureMessageRateDivisor;
             break;
+        case Ximu3SettingsIndexJointAnglesMessageRateDivisor:
+            *index = Ximu3SettingsIndexJointAnglesMessageRateDivisor;
+            break;
+        case Ximu3SettingsIndexFrameMessageRateDivisor:
+            *index = Ximu3SettingsIndexFrameMessageRateDivisor;
+            break;
         case Ximu3SettingsIndexUsbSendMode:
             *index = Ximu3SettingsIndexUsbSendMode;
             break;
         case Ximu3SettingsIndexSerialSendMode:
             *index = Ximu3SettingsIndexSerialSendMode;
             break;
+        case Ximu3SettingsIndexBackpressureOrder:
+            *index = Ximu3SettingsIndexBackpressureOrder;
+            break;
         default:
             return Ximu3ResultError;
     }
@@ -3,6 +3,7 @@
 #ifndef XIMU3_DEFINITIONS_H
 #define XIMU3_DEFINITIONS_H
 
+#include "Backpressure/Backpressure.h"
 #include "Imu/Fusion/Fusion.h"
 #include "Imu/Icm/Icm.h"
 #include "Send/Send.h"
@@ -11,7 +12,7 @@
 
 #define XIMU3_MAX_KEY_LENGTH (33)
 
-#define XIMU3_NUMBER_OF_SETTINGS (35)
+#define XIMU3_NUMBER_OF_SETTINGS (41)
 
 #define XIMU3_TERMINATION '\n'
 
@@ -49,8 +50,11 @@ typedef struct {
     IcmAntiAliasing gyroscopeAntiAliasing;
     IcmAntiAliasing accelerometerAntiAliasing;
     IcmSampleRate sampleRate;
+    uint32_t fifoWatermark;
+    bool sensorTimestampEnabled;
     FusionRemapAlignment axesRemap;
     bool gyroscopeBiasCorrectionEnabled;
+    bool resamplingEnabled;
     uint32_t ahrsUpdateRateDivisor;
     FusionConvention ahrsAxesConvention;
     float ahrsGain;
@@ -60,8 +64,11 @@ typedef struct {
     uint32_t inertialMessageRateDivisor;
     uint32_t ahrsMessageRateDivisor;
     uint32_t temperatureMessageRateDivisor;
+    uint32_t jointAnglesMessageRateDivisor;
+    uint32_t frameMessageRateDivisor;
     SendInterfaceMode usbSendMode;
     SendInterfaceMode serialSendMode;
+    BackpressureOrder backpressureOrder;
 } Ximu3SettingsValues;
 
 typedef enum {
@@ -87,8 +94,11 @@ typedef enum {
     Ximu3SettingsIndexGyroscopeAntiAliasing,
     Ximu3SettingsIndexAccelerometerAntiAliasing,
     Ximu3SettingsIndexSampleRate,
+    Ximu3SettingsIndexFifoWatermark,
+    Ximu3SettingsIndexSensorTimestampEnabled,
     Ximu3SettingsIndexAxesRemap,
     Ximu3SettingsIndexGyroscopeBiasCorrectionEnabled,
+    Ximu3SettingsIndexResamplingEnabled,
     Ximu3SettingsIndexAhrsUpdateRateDivisor,
     Ximu3SettingsIndexAhrsAxesConvention,
     Ximu3SettingsIndexAhrsGain,
@@ -98,8 +108,11 @@ typedef enum {
     Ximu3SettingsIndexInertialMessageRateDivisor,
     Ximu3SettingsIndexAhrsMessageRateDivisor,
     Ximu3SettingsIndexTemperatureMessageRateDivisor,
+    Ximu3SettingsIndexJointAnglesMessageRateDivisor,
+    Ximu3SettingsIndexFrameMessageRateDivisor,
     Ximu3SettingsIndexUsbSendMode,
     Ximu3SettingsIndexSerialSendMode,
+    Ximu3SettingsIndexBackpressureOrder,
 } Ximu3SettingsIndex;
 
 Ximu3Result Ximu3SettingsIndexFrom(Ximu3SettingsIndex * const index, const int integer);
@@ -120,6 +120,19 @@ static void SetValue(const Metadata * const metadata, const void* const value) {
 
     // Set value
     switch (metadata->type) {
+        case MetadataTypeBackpressureOrder:
+            switch (*(BackpressureOrder*) value) {
+                case BackpressureOrderDisabled:
+                case BackpressureOrderTemperatureInertialAhrs:
+                case BackpressureOrderTemperatureAhrsInertial:
+                case BackpressureOrderInertialTemperatureAhrs:
+                case BackpressureOrderInertialAhrsTemperature:
+                case BackpressureOrderAhrsTemperatureInertial:
+                case BackpressureOrderAhrsInertialTemperature:
+                    memcpy(metadata->value, value, metadata->size);
+                    return;
+            }
+            break;
         case MetadataTypeBool:
         case MetadataTypeUint32:
             memcpy(metadata->value, value, metadata->size);
@@ -278,6 +291,7 @@ static void SetValue(const Metadata * const metadata, const void* const value) {
                 case SendAhrsMessageTypeEulerAngles:
                 case SendAhrsMessageTypeLinearAcceleration:
                 case SendAhrsMessageTypeEarthAcceleration:
+                case SendAhrsMessageTypeCompressedQuaternion:
                     memcpy(metadata->value, value, metadata->size);
                     return;
             }
@@ -286,6 +300,7 @@ static void SetValue(const Metadata * const metadata, const void* const value) {
             switch (*(SendDataMessageMode*) value) {
                 case SendDataMessageModeBinary:
                 case SendDataMessageModeAscii:
+                case SendDataMessageModeCompact:
                     memcpy(metadata->value, value, metadata->size);
                     return;
             }
@@ -80,6 +80,7 @@ void Ximu3SettingsJsonGetValue(Ximu3Settings * const settings, char* const desti
         case MetadataTypeFloat:
             snprintf(destination, destinationSize, "%f", *(float*) metadata.value);
             break;
+        case MetadataTypeBackpressureOrder:
         case MetadataTypeFusionConvention:
         case MetadataTypeFusionRemapAlignment:
         case MetadataTypeIcmAntiAliasing:
@@ -218,6 +219,7 @@ JsonResult Ximu3SettingsJsonSetKeyValue(Ximu3Settings * const settings, const ch
             return ParseBool(settings, index, value, overrideReadOnly);
         case MetadataTypeFloat:
             return ParseFloat(settings, index, value, overrideReadOnly);
+        case MetadataTypeBackpressureOrder:
         case MetadataTypeFusionConvention:
         case MetadataTypeFusionRemapAlignment:
         case MetadataTypeIcmAntiAliasing:
@@ -17,22 +17,33 @@
 #define XIMU3_SIZE_MUX_HEADER                   (2)
 
 #define XIMU3_SIZE_CHAR_ARRAY                   (255)
+#define XIMU3_SIZE_NUMBER_OF_ANGLES             (40)
+#define XIMU3_SIZE_NUMBER_OF_SENSORS            (20)
 
 #define XIMU3_SIZE_BYTE_STUFFING(n)             (2 * (n)) /* worst case after byte stuffing */
 
 #define XIMU3_SIZE_BINARY_OVERHEAD              (2 + XIMU3_SIZE_BYTE_STUFFING(8)) /* ID + termination + 64-bit timestamp */
 #define XIMU3_SIZE_BINARY_FLOAT                 XIMU3_SIZE_BYTE_STUFFING(4) /* 32-bit float */
+#define XIMU3_SIZE_BINARY_ANGLE                 XIMU3_SIZE_BYTE_STUFFING(2) /* 16-bit integer in units of 0.01 degrees */
+#define XIMU3_SIZE_BINARY_PRESENCE              XIMU3_SIZE_BYTE_STUFFING(4) /* 32-bit bitmap */
+#define XIMU3_SIZE_BINARY_VARINT_TIMESTAMP      XIMU3_SIZE_BYTE_STUFFING(10) /* 64-bit varint */
+#define XIMU3_SIZE_BINARY_SMALLEST_THREE        XIMU3_SIZE_BYTE_STUFFING(4) /* 2-bit index and 3 x 10-bit components */
+#define XIMU3_SIZE_BINARY_VARINT_DIFFERENCE     XIMU3_SIZE_BYTE_STUFFING(3) /* zig-zag varint of 16-bit integer difference */
 #define XIMU3_SIZE_BINARY_CHAR_ARRAY            XIMU3_SIZE_BYTE_STUFFING(XIMU3_SIZE_CHAR_ARRAY)
 
 #define XIMU3_SIZE_BINARY_INERTIAL              (XIMU3_SIZE_BINARY_OVERHEAD + (6 * XIMU3_SIZE_BINARY_FLOAT))
+#define XIMU3_SIZE_BINARY_COMPACT_INERTIAL      (2 + XIMU3_SIZE_BINARY_VARINT_TIMESTAMP + (6 * XIMU3_SIZE_BINARY_VARINT_DIFFERENCE)) /* ID + termination + varint timestamp */
 #define XIMU3_SIZE_BINARY_MAGNETOMETER          (XIMU3_SIZE_BINARY_OVERHEAD + (3 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_HIGH_G_ACCELEROMETER  (XIMU3_SIZE_BINARY_OVERHEAD + (3 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_QUATERNION            (XIMU3_SIZE_BINARY_OVERHEAD + (4 * XIMU3_SIZE_BINARY_FLOAT))
+#define XIMU3_SIZE_BINARY_COMPRESSED_QUATERNION (2 + XIMU3_SIZE_BINARY_VARINT_TIMESTAMP + XIMU3_SIZE_BINARY_SMALLEST_THREE) /* ID + termination + varint timestamp */
 #define XIMU3_SIZE_BINARY_ROTATION_MATRIX       (XIMU3_SIZE_BINARY_OVERHEAD + (9 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_EULER_ANGLES          (XIMU3_SIZE_BINARY_OVERHEAD + (3 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_LINEAR_ACCELERATION   (XIMU3_SIZE_BINARY_OVERHEAD + (7 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_EARTH_ACCELERATION    (XIMU3_SIZE_BINARY_OVERHEAD + (7 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_AHRS_STATUS           (XIMU3_SIZE_BINARY_OVERHEAD + (4 * XIMU3_SIZE_BINARY_FLOAT))
+#define XIMU3_SIZE_BINARY_JOINT_ANGLES          (XIMU3_SIZE_BINARY_OVERHEAD + (XIMU3_SIZE_NUMBER_OF_ANGLES * XIMU3_SIZE_BINARY_ANGLE))
+#define XIMU3_SIZE_BINARY_FRAME                 (XIMU3_SIZE_BINARY_OVERHEAD + XIMU3_SIZE_BINARY_PRESENCE + (XIMU3_SIZE_NUMBER_OF_SENSORS * 10 * XIMU3_SIZE_BINARY_FLOAT))
 #define XIMU3_SIZE_BINARY_SERIAL_ACCESSORY      (XIMU3_SIZE_BINARY_OVERHEAD + XIMU3_SIZE_BINARY_CHAR_ARRAY)
 #define XIMU3_SIZE_BINARY_SYNC                  (XIMU3_SIZE_BINARY_OVERHEAD + XIMU3_SIZE_BINARY_FLOAT)
 #define XIMU3_SIZE_BINARY_LTC                   (XIMU3_SIZE_BINARY_OVERHEAD + sizeof ("hh:mm:ss:ff") - 1) /* byte stuffing not applicable to timecode */
@@ -56,6 +67,8 @@
 #define XIMU3_SIZE_ASCII_LINEAR_ACCELERATION	(XIMU3_SIZE_ASCII_OVERHEAD + (7 * XIMU3_SIZE_ASCII_FLOAT))
 #define XIMU3_SIZE_ASCII_EARTH_ACCELERATION 	(XIMU3_SIZE_ASCII_OVERHEAD + (7 * XIMU3_SIZE_ASCII_FLOAT))
 #define XIMU3_SIZE_ASCII_AHRS_STATUS        	(XIMU3_SIZE_ASCII_OVERHEAD + (4 * XIMU3_SIZE_ASCII_FLOAT))
+#define XIMU3_SIZE_ASCII_JOINT_ANGLES           (XIMU3_SIZE_ASCII_OVERHEAD + (XIMU3_SIZE_NUMBER_OF_ANGLES * XIMU3_SIZE_ASCII_FLOAT))
+#define XIMU3_SIZE_ASCII_FRAME                  (XIMU3_SIZE_ASCII_OVERHEAD + (XIMU3_SIZE_NUMBER_OF_SENSORS * 11 * XIMU3_SIZE_ASCII_FLOAT))
 #define XIMU3_SIZE_ASCII_SERIAL_ACCESSORY   	(XIMU3_SIZE_ASCII_OVERHEAD + XIMU3_SIZE_ASCII_CHAR_ARRAY)
 #define XIMU3_SIZE_ASCII_SYNC               	(XIMU3_SIZE_ASCII_OVERHEAD + (1 * XIMU3_SIZE_ASCII_FLOAT))
 #define XIMU3_SIZE_ASCII_LTC                	(XIMU3_SIZE_ASCII_OVERHEAD + sizeof (",hh:mm:ss:ff") - 1)
@@ -72,11 +85,14 @@
 #define XIMU3_SIZE_MAGNETOMETER                 XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_MAGNETOMETER, XIMU3_SIZE_ASCII_MAGNETOMETER)
 #define XIMU3_SIZE_HIGH_G_ACCELEROMETER         XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_HIGH_G_ACCELEROMETER, XIMU3_SIZE_ASCII_HIGH_G_ACCELEROMETER)
 #define XIMU3_SIZE_QUATERNION                   XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_QUATERNION, XIMU3_SIZE_ASCII_QUATERNION)
+#define XIMU3_SIZE_COMPRESSED_QUATERNION        XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_COMPRESSED_QUATERNION, XIMU3_SIZE_ASCII_QUATERNION) /* ASCII quaternion used in ASCII mode */
 #define XIMU3_SIZE_ROTATION_MATRIX              XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_ROTATION_MATRIX, XIMU3_SIZE_ASCII_ROTATION_MATRIX)
 #define XIMU3_SIZE_EULER_ANGLES                 XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_EULER_ANGLES, XIMU3_SIZE_ASCII_EULER_ANGLES)
 #define XIMU3_SIZE_LINEAR_ACCELERATION          XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_LINEAR_ACCELERATION, XIMU3_SIZE_ASCII_LINEAR_ACCELERATION)
 #define XIMU3_SIZE_EARTH_ACCELERATION           XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_EARTH_ACCELERATION, XIMU3_SIZE_ASCII_EARTH_ACCELERATION)
 #define XIMU3_SIZE_AHRS_STATUS                  XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_AHRS_STATUS, XIMU3_SIZE_ASCII_AHRS_STATUS)
+#define XIMU3_SIZE_JOINT_ANGLES                 XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_JOINT_ANGLES, XIMU3_SIZE_ASCII_JOINT_ANGLES)
+#define XIMU3_SIZE_FRAME                        XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_FRAME, XIMU3_SIZE_ASCII_FRAME)
 #define XIMU3_SIZE_SERIAL_ACCESSORY             XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_SERIAL_ACCESSORY, XIMU3_SIZE_ASCII_SERIAL_ACCESSORY)
 #define XIMU3_SIZE_SYNC                         XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_SYNC, XIMU3_SIZE_ASCII_SYNC)
 #define XIMU3_SIZE_LTC                          XIMU3_SIZE_MAX(XIMU3_SIZE_BINARY_LTC, XIMU3_SIZE_ASCII_LTC)
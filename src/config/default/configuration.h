@@ -100,7 +100,7 @@ extern "C" {
 /* CDC Transfer Queue Size for both read and
    write. Applicable to all instances of the
    function driver */
-#define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED                 3U
+#define USB_DEVICE_CDC_QUEUE_DEPTH_COMBINED                 6U
 
 /*** USB Driver Configuration ***/
 
@@ -70,7 +70,6 @@
 // *****************************************************************************
 void TIMER_3_Handler (void);
 void TIMER_6_Handler (void);
-void UART1_RX_Handler (void);
 void CHANGE_NOTICE_A_Handler (void);
 void CHANGE_NOTICE_B_Handler (void);
 void CHANGE_NOTICE_D_Handler (void);
@@ -81,13 +80,19 @@ void USB_Handler (void);
 void USB_DMA_Handler (void);
 void DMA0_Handler (void);
 void DMA1_Handler (void);
+void DMA2_Handler (void);
 void DMA3_Handler (void);
+void DMA4_Handler (void);
 void DMA5_Handler (void);
+void DMA6_Handler (void);
 void DMA7_Handler (void);
-void SPI2_RX_Handler (void);
+void SPI2_TX_Handler (void);
+void SPI3_TX_Handler (void);
 void UART3_RX_Handler (void);
 void UART3_TX_Handler (void);
-void SPI5_RX_Handler (void);
+void SPI4_TX_Handler (void);
+void SPI5_TX_Handler (void);
+void SPI6_TX_Handler (void);
 
 
 // *****************************************************************************
@@ -105,11 +110,6 @@ void __attribute__((used)) __ISR(_TIMER_6_VECTOR, ipl1SRS) TIMER_6_Handler (void
     Timer6InterruptHandler();
 }
 
-void __attribute__((used)) __ISR(_UART1_RX_VECTOR, ipl1SRS) UART1_RX_Handler (void)
-{
-    Uart1RxInterruptHandler();
-}
-
 void __attribute__((used)) __ISR(_CHANGE_NOTICE_A_VECTOR, ipl5SRS) CHANGE_NOTICE_A_Handler (void)
 {
     CHANGE_NOTICE_A_InterruptHandler();
@@ -160,24 +160,44 @@ void __attribute__((used)) __ISR(_DMA1_VECTOR, ipl1SRS) DMA1_Handler (void)
     Dma1InterruptHandler();
 }
 
+void __attribute__((used)) __ISR(_DMA2_VECTOR, ipl1SRS) DMA2_Handler (void)
+{
+    Dma2InterruptHandler();
+}
+
 void __attribute__((used)) __ISR(_DMA3_VECTOR, ipl1SRS) DMA3_Handler (void)
 {
     Dma3InterruptHandler();
 }
 
+void __attribute__((used)) __ISR(_DMA4_VECTOR, ipl1SRS) DMA4_Handler (void)
+{
+    Dma4InterruptHandler();
+}
+
 void __attribute__((used)) __ISR(_DMA5_VECTOR, ipl1SRS) DMA5_Handler (void)
 {
     Dma5InterruptHandler();
 }
 
+void __attribute__((used)) __ISR(_DMA6_VECTOR, ipl1SRS) DMA6_Handler (void)
+{
+    Dma6InterruptHandler();
+}
+
 void __attribute__((used)) __ISR(_DMA7_VECTOR, ipl1SRS) DMA7_Handler (void)
 {
     Dma7InterruptHandler();
 }
 
-void __attribute__((used)) __ISR(_SPI2_RX_VECTOR, ipl1SRS) SPI2_RX_Handler (void)
+void __attribute__((used)) __ISR(_SPI2_TX_VECTOR, ipl1SRS) SPI2_TX_Handler (void)
+{
+    Spi2TxInterruptHandler();
+}
+
+void __attribute__((used)) __ISR(_SPI3_TX_VECTOR, ipl1SRS) SPI3_TX_Handler (void)
 {
-    Spi2RxInterruptHandler();
+    Spi3TxInterruptHandler();
 }
 
 void __attribute__((used)) __ISR(_UART3_RX_VECTOR, ipl1SRS) UART3_RX_Handler (void)
@@ -190,11 +210,22 @@ void __attribute__((used)) __ISR(_UART3_TX_VECTOR, ipl1SRS) UART3_TX_Handler (vo
     Uart3TxInterruptHandler();
 }
 
-void __attribute__((used)) __ISR(_SPI5_RX_VECTOR, ipl1SRS) SPI5_RX_Handler (void)
+void __attribute__((used)) __ISR(_SPI4_TX_VECTOR, ipl1SRS) SPI4_TX_Handler (void)
 {
-    Spi5RxInterruptHandler();
+    Spi4TxInterruptHandler();
 }
 
+void __attribute__((used)) __ISR(_SPI5_TX_VECTOR, ipl1SRS) SPI5_TX_Handler (void)
+{
+    Spi5TxInterruptHandler();
+}
+
+void __attribute__((used)) __ISR(_SPI6_TX_VECTOR, ipl1SRS) SPI6_TX_Handler (void)
+{
+    Spi6TxInterruptHandler();
+}
+
+
 
 
 
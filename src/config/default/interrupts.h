@@ -67,16 +67,21 @@ void DRV_USBHS_DMAInterruptHandler( void );
 
 void Timer3InterruptHandler(void);
 void Timer6InterruptHandler(void);
-void Uart1RxInterruptHandler(void);
 void Dma0InterruptHandler(void);
 void Dma1InterruptHandler(void);
+void Dma2InterruptHandler(void);
 void Dma3InterruptHandler(void);
+void Dma4InterruptHandler(void);
 void Dma5InterruptHandler(void);
+void Dma6InterruptHandler(void);
 void Dma7InterruptHandler(void);
-void Spi2RxInterruptHandler(void);
+void Spi2TxInterruptHandler(void);
+void Spi3TxInterruptHandler(void);
 void Uart3RxInterruptHandler(void);
 void Uart3TxInterruptHandler(void);
-void Spi5RxInterruptHandler(void);
+void Spi4TxInterruptHandler(void);
+void Spi5TxInterruptHandler(void);
+void Spi6TxInterruptHandler(void);
 
 
 #endif // INTERRUPTS_H
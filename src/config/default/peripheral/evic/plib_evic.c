@@ -58,7 +58,6 @@ void EVIC_Initialize( void )
     /* Set up priority and subpriority of enabled interrupts */
     IPC3SET = 0x1c0000U | 0x0U;  /* TIMER_3:  Priority 7 / Subpriority 0 */
     IPC7SET = 0x4U | 0x0U;  /* TIMER_6:  Priority 1 / Subpriority 0 */
-    IPC28SET = 0x400U | 0x0U;  /* UART1_RX:  Priority 1 / Subpriority 0 */
     IPC29SET = 0x140000U | 0x0U;  /* CHANGE_NOTICE_A:  Priority 5 / Subpriority 0 */
     IPC29SET = 0x14000000U | 0x0U;  /* CHANGE_NOTICE_B:  Priority 5 / Subpriority 0 */
     IPC30SET = 0x1400U | 0x0U;  /* CHANGE_NOTICE_D:  Priority 5 / Subpriority 0 */
@@ -69,13 +68,19 @@ void EVIC_Initialize( void )
     IPC33SET = 0x400U | 0x0U;  /* USB_DMA:  Priority 1 / Subpriority 0 */
     IPC33SET = 0x40000U | 0x0U;  /* DMA0:  Priority 1 / Subpriority 0 */
     IPC33SET = 0x4000000U | 0x0U;  /* DMA1:  Priority 1 / Subpriority 0 */
+    IPC34SET = 0x4U | 0x0U;  /* DMA2:  Priority 1 / Subpriority 0 */
     IPC34SET = 0x400U | 0x0U;  /* DMA3:  Priority 1 / Subpriority 0 */
+    IPC34SET = 0x40000U | 0x0U;  /* DMA4:  Priority 1 / Subpriority 0 */
     IPC34SET = 0x4000000U | 0x0U;  /* DMA5:  Priority 1 / Subpriority 0 */
+    IPC35SET = 0x4U | 0x0U;  /* DMA6:  Priority 1 / Subpriority 0 */
     IPC35SET = 0x400U | 0x0U;  /* DMA7:  Priority 1 / Subpriority 0 */
-    IPC35SET = 0x4000000U | 0x0U;  /* SPI2_RX:  Priority 1 / Subpriority 0 */
+    IPC36SET = 0x4U | 0x0U;  /* SPI2_TX:  Priority 1 / Subpriority 0 */
+    IPC39SET = 0x4U | 0x0U;  /* SPI3_TX:  Priority 1 / Subpriority 0 */
     IPC39SET = 0x40000U | 0x0U;  /* UART3_RX:  Priority 1 / Subpriority 0 */
     IPC39SET = 0x4000000U | 0x0U;  /* UART3_TX:  Priority 1 / Subpriority 0 */
-    IPC44SET = 0x400U | 0x0U;  /* SPI5_RX:  Priority 1 / Subpriority 0 */
+    IPC41SET = 0x400U | 0x0U;  /* SPI4_TX:  Priority 1 / Subpriority 0 */
+    IPC44SET = 0x40000U | 0x0U;  /* SPI5_TX:  Priority 1 / Subpriority 0 */
+    IPC46SET = 0x4000000U | 0x0U;  /* SPI6_TX:  Priority 1 / Subpriority 0 */
 
 
 
@@ -29,36 +29,16 @@
 #include "I2C/I2CBB5.h"
 #include "I2C/I2CBB6.h"
 #include "I2C/I2CBB7.h"
-#include "Imu/Icm/Icm1.h"
-#include "Imu/Icm/Icm10.h"
-#include "Imu/Icm/Icm11.h"
-#include "Imu/Icm/Icm12.h"
-#include "Imu/Icm/Icm13.h"
-#include "Imu/Icm/Icm14.h"
-#include "Imu/Icm/Icm15.h"
-#include "Imu/Icm/Icm16.h"
-#include "Imu/Icm/Icm17.h"
-#include "Imu/Icm/Icm18.h"
-#include "Imu/Icm/Icm19.h"
-#include "Imu/Icm/Icm2.h"
-#include "Imu/Icm/Icm20.h"
-#include "Imu/Icm/Icm3.h"
-#include "Imu/Icm/Icm4.h"
-#include "Imu/Icm/Icm5.h"
-#include "Imu/Icm/Icm6.h"
-#include "Imu/Icm/Icm7.h"
-#include "Imu/Icm/Icm8.h"
-#include "Imu/Icm/Icm9.h"
-#include "Imu/Imu.h"
+#include "Imu/Icm/Icm.h"
 #include "Led/Led.h"
 #include "NeoPixels/NeoPixels.h"
-#include "Notification/Notification.h"
 #include "ResetCause/ResetCause.h"
+#include "Scheduler/Scheduler.h"
 #include "Spi/Spi1DmaTx.h"
-#include "Spi/Spi2.h"
+#include "Spi/Spi2Dma.h"
 #include "Spi/Spi3Dma.h"
 #include "Spi/Spi4Dma.h"
-#include "Spi/Spi5.h"
+#include "Spi/Spi5Dma.h"
 #include "Spi/Spi6Dma.h"
 #include <stdbool.h>
 #include <stddef.h>
@@ -66,7 +46,6 @@
 #include <stdlib.h>
 #include "Timer/Timer.h"
 #include "Uart/Uart3.h"
-#include "Usb/UsbCdc.h"
 #include "Ximu3Device/Ximu3Device.h"
 
 //------------------------------------------------------------------------------
@@ -97,15 +76,29 @@ int main(void) {
     I2C4Initialise(I2CClockFrequency100kHz);
     I2C5Initialise(I2CClockFrequency100kHz);
     Spi1DmaTxInitialise(&neoPixelsSpiSettings);
-    Spi2Initialise(&icmSpiSettings);
+    Spi2DmaInitialise(&icmSpiSettings);
     Spi3DmaInitialise(&icmSpiSettings);
     Spi4DmaInitialise(&icmSpiSettings);
-    Spi5Initialise(&icmSpiSettings);
+    Spi5DmaInitialise(&icmSpiSettings);
     Spi6DmaInitialise(&icmSpiSettings);
     LedInitialise();
     HapticInitialise();
     Ximu3DeviceInitialise();
 
+    // Wait for ICM initialisation. An ICM that does not initialise within the timeout is idle and fails the self-test.
+    while (true) {
+        bool complete = true;
+        for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+            IcmTasks(&icms[index]);
+            if (IcmInitialisationComplete(&icms[index]) == false) {
+                complete = false;
+            }
+        }
+        if (complete) {
+            break;
+        }
+    }
+
     // Print self-test results
     printf("Haptic          %s\n", HapticTestResultToString(HapticTest()));
     printf("Carpus EEPROM   %s\n", EepromTestResultToString(EepromTest(&i2cBB1)));
@@ -114,55 +107,22 @@ int main(void) {
     printf("CH3 EEPROM      %s\n", EepromTestResultToString(EepromTest(&i2c5)));
     printf("CH4 EEPROM      %s\n", EepromTestResultToString(EepromTest(&i2c1)));
     printf("CH5 EEPROM      %s\n", EepromTestResultToString(EepromTest(&i2c4)));
-    printf("CH1 IMU1        %s\n", IcmTestResultToString(Icm1Test()));
-    printf("CH1 IMU2        %s\n", IcmTestResultToString(Icm2Test()));
-    printf("CH1 IMU3        %s\n", IcmTestResultToString(Icm3Test()));
-    printf("CH1 IMU4        %s\n", IcmTestResultToString(Icm4Test()));
-    printf("CH2 IMU1        %s\n", IcmTestResultToString(Icm5Test()));
-    printf("CH2 IMU2        %s\n", IcmTestResultToString(Icm6Test()));
-    printf("CH2 IMU3        %s\n", IcmTestResultToString(Icm7Test()));
-    printf("CH2 IMU4        %s\n", IcmTestResultToString(Icm8Test()));
-    printf("CH3 IMU1        %s\n", IcmTestResultToString(Icm9Test()));
-    printf("CH3 IMU2        %s\n", IcmTestResultToString(Icm10Test()));
-    printf("CH3 IMU3        %s\n", IcmTestResultToString(Icm11Test()));
-    printf("CH3 IMU4        %s\n", IcmTestResultToString(Icm12Test()));
-    printf("CH4 IMU1        %s\n", IcmTestResultToString(Icm13Test()));
-    printf("CH4 IMU2        %s\n", IcmTestResultToString(Icm14Test()));
-    printf("CH4 IMU3        %s\n", IcmTestResultToString(Icm15Test()));
-    printf("CH4 IMU4        %s\n", IcmTestResultToString(Icm16Test()));
-    printf("CH5 IMU1        %s\n", IcmTestResultToString(Icm17Test()));
-    printf("CH5 IMU2        %s\n", IcmTestResultToString(Icm18Test()));
-    printf("CH5 IMU3        %s\n", IcmTestResultToString(Icm19Test()));
-    printf("CH5 IMU4        %s\n", IcmTestResultToString(Icm20Test()));
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        printf("CH%d IMU%d        %s\n", (index / 4) + 1, (index % 4) + 1, IcmTestResultToString(IcmTest(&icms[index])));
+    }
+
+    // Print boot-to-first-sample time
+    uint64_t firstSampleTicks = 0;
+    for (int index = 0; index < ICM_NUMBER_OF_ICMS; index++) {
+        if (IcmFirstSampleTicks(&icms[index]) > firstSampleTicks) {
+            firstSampleTicks = IcmFirstSampleTicks(&icms[index]);
+        }
+    }
+    printf("IMU start-up    %u ms\n", (unsigned int) (firstSampleTicks / TIMER_TICKS_PER_MILLISECOND));
 
     // Main program loop
     while (true) {
-        SYS_Tasks();
-
-        // Application tasks
-        ImuTasks(&imuA);
-        ImuTasks(&imuB);
-        ImuTasks(&imuC);
-        ImuTasks(&imuD);
-        ImuTasks(&imuE);
-        ImuTasks(&imuF);
-        ImuTasks(&imuG);
-        ImuTasks(&imuH);
-        ImuTasks(&imuI);
-        ImuTasks(&imuJ);
-        ImuTasks(&imuK);
-        ImuTasks(&imuL);
-        ImuTasks(&imuM);
-        ImuTasks(&imuN);
-        ImuTasks(&imuO);
-        ImuTasks(&imuP);
-        ImuTasks(&imuQ);
-        ImuTasks(&imuR);
-        ImuTasks(&imuS);
-        ImuTasks(&imuT);
-        NotificationTasks();
-        UsbCdcTasks();
-        Ximu3DeviceTasks();
+        SchedulerTasks();
     }
     return (EXIT_FAILURE);
 }
@@ -0,0 +1,62 @@
+/**
+ * @file Cache.h
+ * @author Seb Madgwick
+ * @brief Data cache maintenance for PIC32MZ devices. DMA accesses physical
+ * memory and so cacheable data shared with DMA must be written back before a
+ * DMA transfer reads it, and invalidated before the CPU reads data written by a
+ * DMA transfer. The cache operates on lines and so may also affect data either
+ * side of the address range.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Data cache line size in bytes.
+ */
+#define CACHE_LINE_BYTES (16)
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Writes back and invalidates the data cache lines of an address range.
+ * @param address Address.
+ * @param numberOfBytes Number of bytes.
+ */
+static inline __attribute__((always_inline)) void CacheWritebackInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+    const uintptr_t end = (uintptr_t) address + numberOfBytes;
+    for (uintptr_t line = (uintptr_t) address & ~(uintptr_t) (CACHE_LINE_BYTES - 1); line < end; line += CACHE_LINE_BYTES) {
+        __builtin_mips_cache(0x15, (const volatile void*) line); // Hit_Writeback_Inv_D
+    }
+    __asm__ volatile("sync" : : : "memory");
+}
+
+/**
+ * @brief Invalidates the data cache lines of an address range without writing
+ * them back. The address range must not contain data written by the CPU that
+ * has not been written back.
+ * @param address Address.
+ * @param numberOfBytes Number of bytes.
+ */
+static inline __attribute__((always_inline)) void CacheInvalidate(const volatile void* const address, const size_t numberOfBytes) {
+    const uintptr_t end = (uintptr_t) address + numberOfBytes;
+    for (uintptr_t line = (uintptr_t) address & ~(uintptr_t) (CACHE_LINE_BYTES - 1); line < end; line += CACHE_LINE_BYTES) {
+        __builtin_mips_cache(0x11, (const volatile void*) line); // Hit_Invalidate_D
+    }
+    __asm__ volatile("sync" : : : "memory");
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -42,6 +42,17 @@ typedef enum {
     FifoResultError,
 } FifoResult;
 
+/**
+ * @brief Reservation. The reserved region is split into two parts if it wraps
+ * around the end of the buffer. Otherwise, the second part is empty.
+ */
+typedef struct {
+    uint8_t* first;
+    size_t firstSize;
+    uint8_t* second;
+    size_t secondSize;
+} FifoReservation;
+
 //------------------------------------------------------------------------------
 // Inline functions
 
@@ -254,6 +265,99 @@ static inline __attribute__((always_inline)) FifoResult FifoWriteByte(Fifo * con
     return FifoResultOk;
 }
 
+/**
+ * @brief Reserves space in the FIFO to be written to directly. The data is
+ * not available to read until FifoCommit is called. No other data may be
+ * written to the FIFO between FifoReserve and FifoCommit.
+ * @param fifo FIFO structure.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+static inline __attribute__((always_inline)) FifoResult FifoReserve(Fifo * const fifo, const size_t numberOfBytes, FifoReservation * const reservation) {
+
+    // Do nothing if not enough space available
+    if (numberOfBytes > FifoAvailableWrite(fifo)) {
+        return FifoResultError;
+    }
+
+    // Reserve with no wraparound
+    const size_t numberOfBytesBeforeWraparound = fifo->dataSize - fifo->writeIndex;
+    reservation->first = (uint8_t*) &fifo->data[fifo->writeIndex];
+    reservation->second = (uint8_t*) fifo->data;
+    if (numberOfBytes <= numberOfBytesBeforeWraparound) {
+        reservation->firstSize = numberOfBytes;
+        reservation->secondSize = 0;
+        return FifoResultOk;
+    }
+
+    // Reserve with wraparound
+    reservation->firstSize = numberOfBytesBeforeWraparound;
+    reservation->secondSize = numberOfBytes - numberOfBytesBeforeWraparound;
+    return FifoResultOk;
+}
+
+/**
+ * @brief Writes data to a reservation. The offset and number of bytes must
+ * be within the reservation.
+ * @param reservation Reservation.
+ * @param offset Offset.
+ * @param data Data.
+ * @param numberOfBytes Number of bytes.
+ */
+static inline __attribute__((always_inline)) void FifoReservationWrite(const FifoReservation * const reservation, const size_t offset, const void* const data, const size_t numberOfBytes) {
+
+    // Write data to second part only
+    if (offset >= reservation->firstSize) {
+        memcpy(&reservation->second[offset - reservation->firstSize], data, numberOfBytes);
+        return;
+    }
+
+    // Write data to first part only
+    const size_t numberOfBytesBeforeWraparound = reservation->firstSize - offset;
+    if (numberOfBytes <= numberOfBytesBeforeWraparound) {
+        memcpy(&reservation->first[offset], data, numberOfBytes);
+        return;
+    }
+
+    // Write data to both parts
+    memcpy(&reservation->first[offset], data, numberOfBytesBeforeWraparound);
+    memcpy(reservation->second, &((uint8_t*) data)[numberOfBytesBeforeWraparound], numberOfBytes - numberOfBytesBeforeWraparound);
+}
+
+/**
+ * @brief Removes bytes from the start of a reservation. The number of bytes
+ * must be within the reservation.
+ * @param reservation Reservation.
+ * @param numberOfBytes Number of bytes.
+ */
+static inline __attribute__((always_inline)) void FifoReservationSkip(FifoReservation * const reservation, const size_t numberOfBytes) {
+    if (numberOfBytes < reservation->firstSize) {
+        reservation->first += numberOfBytes;
+        reservation->firstSize -= numberOfBytes;
+        return;
+    }
+    const size_t numberOfBytesAfterWraparound = numberOfBytes - reservation->firstSize;
+    reservation->first = &reservation->second[numberOfBytesAfterWraparound];
+    reservation->firstSize = reservation->secondSize - numberOfBytesAfterWraparound;
+    reservation->secondSize = 0;
+}
+
+/**
+ * @brief Makes data written to a reservation available to read. The write
+ * index is updated once so that all data becomes available at the same time.
+ * @param fifo FIFO structure.
+ * @param numberOfBytes Number of bytes. Must not exceed the number of bytes
+ * reserved.
+ */
+static inline __attribute__((always_inline)) void FifoCommit(Fifo * const fifo, const size_t numberOfBytes) {
+    size_t writeIndex = fifo->writeIndex + numberOfBytes;
+    if (writeIndex >= fifo->dataSize) {
+        writeIndex -= fifo->dataSize;
+    }
+    fifo->writeIndex = writeIndex;
+}
+
 /**
  * @brief Returns the space available to write a packet to the FIFO.
  * @param fifo FIFO structure.
@@ -0,0 +1,213 @@
+/**
+ * @file PriorityFifo.h
+ * @author Seb Madgwick
+ * @brief Asynchronous FIFO buffer with a separate FIFO for each priority.
+ * Data is written as messages and read as a stream of bytes. Messages are read
+ * strictly by priority and a message is always read in full before any other
+ * message so that the messages of different priorities are never interleaved.
+ * Each message is stored with a 16-bit size that is not read.
+ */
+
+#ifndef PRIORITY_FIFO_H
+#define PRIORITY_FIFO_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Fifo.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Priority.
+ */
+typedef enum {
+    PriorityFifoPriorityLow,
+    PriorityFifoPriorityMedium,
+    PriorityFifoPriorityHigh,
+} PriorityFifoPriority;
+
+/**
+ * @brief Number of priorities.
+ */
+#define PRIORITY_FIFO_NUMBER_OF_PRIORITIES (3)
+
+/**
+ * @brief Priority FIFO structure. All structure members are private except for
+ * initialisation.
+ *
+ * Example:
+ * @code
+ * uint8_t lowData[4096];
+ * uint8_t mediumData[1024];
+ * uint8_t highData[1024];
+ * PriorityFifo priorityFifo = {.fifos = {
+ *     {.data = lowData, .dataSize = sizeof (lowData)},
+ *     {.data = mediumData, .dataSize = sizeof (mediumData)},
+ *     {.data = highData, .dataSize = sizeof (highData)},
+ * }};
+ * @endcode
+ */
+typedef struct {
+    Fifo fifos[PRIORITY_FIFO_NUMBER_OF_PRIORITIES];
+    PriorityFifoPriority readPriority;
+    size_t readRemaining;
+} PriorityFifo;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns true if there is no data available to read.
+ * @param priorityFifo Priority FIFO structure.
+ * @return True if there is no data available to read.
+ */
+static inline __attribute__((always_inline)) bool PriorityFifoEmpty(PriorityFifo * const priorityFifo) {
+    for (int index = 0; index < PRIORITY_FIFO_NUMBER_OF_PRIORITIES; index++) {
+        if (FifoAvailableRead(&priorityFifo->fifos[index]) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads data from the FIFO. Data is read from the highest-priority
+ * message available each time a message has been read in full.
+ * @param priorityFifo Priority FIFO structure.
+ * @param destination Destination.
+ * @param numberOfBytes Number of bytes.
+ * @return Number of bytes read.
+ */
+static inline __attribute__((always_inline)) size_t PriorityFifoRead(PriorityFifo * const priorityFifo, void* const destination, const size_t numberOfBytes) {
+    size_t index = 0;
+    while (index < numberOfBytes) {
+
+        // Select highest-priority message if previous message read in full
+        if (priorityFifo->readRemaining == 0) {
+            int priority = PRIORITY_FIFO_NUMBER_OF_PRIORITIES - 1;
+            while (FifoAvailableRead(&priorityFifo->fifos[priority]) == 0) {
+                if (--priority < 0) {
+                    return index;
+                }
+            }
+            uint16_t messageSize;
+            FifoRead(&priorityFifo->fifos[priority], &messageSize, sizeof (messageSize));
+            priorityFifo->readPriority = (PriorityFifoPriority) priority;
+            priorityFifo->readRemaining = messageSize;
+        }
+
+        // Read message
+        size_t numberOfBytesToRead = numberOfBytes - index;
+        if (numberOfBytesToRead > priorityFifo->readRemaining) {
+            numberOfBytesToRead = priorityFifo->readRemaining;
+        }
+        index += FifoRead(&priorityFifo->fifos[priorityFifo->readPriority], &((uint8_t*) destination)[index], numberOfBytesToRead);
+        priorityFifo->readRemaining -= numberOfBytesToRead;
+    }
+    return index;
+}
+
+/**
+ * @brief Returns the capacity of the FIFO of the priority.
+ * @param priorityFifo Priority FIFO structure.
+ * @param priority Priority.
+ * @return Capacity of the FIFO of the priority.
+ */
+static inline __attribute__((always_inline)) size_t PriorityFifoCapacity(PriorityFifo * const priorityFifo, const PriorityFifoPriority priority) {
+    return FifoCapacity(&priorityFifo->fifos[priority]);
+}
+
+/**
+ * @brief Returns the space available to write a message to the FIFO.
+ * @param priorityFifo Priority FIFO structure.
+ * @param priority Priority.
+ * @return Space available for the message.
+ */
+static inline __attribute__((always_inline)) size_t PriorityFifoAvailableWrite(PriorityFifo * const priorityFifo, const PriorityFifoPriority priority) {
+    const size_t available = FifoAvailableWrite(&priorityFifo->fifos[priority]);
+    if (available <= sizeof (uint16_t)) {
+        return 0;
+    }
+    return available - sizeof (uint16_t);
+}
+
+/**
+ * @brief Reserves space in the FIFO for a message to be written to directly.
+ * The message is not available to read until PriorityFifoCommit is called. No
+ * other message of the same priority may be written to the FIFO between
+ * PriorityFifoReserve and PriorityFifoCommit.
+ * @param priorityFifo Priority FIFO structure.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+static inline __attribute__((always_inline)) FifoResult PriorityFifoReserve(PriorityFifo * const priorityFifo, const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    if (numberOfBytes > UINT16_MAX) {
+        return FifoResultError;
+    }
+    if (FifoReserve(&priorityFifo->fifos[priority], sizeof (uint16_t) + numberOfBytes, reservation) != FifoResultOk) {
+        return FifoResultError;
+    }
+    FifoReservationSkip(reservation, sizeof (uint16_t));
+    return FifoResultOk;
+}
+
+/**
+ * @brief Makes a message written to a reservation available to read.
+ * @param priorityFifo Priority FIFO structure.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes. Must not exceed the number of bytes
+ * reserved.
+ */
+static inline __attribute__((always_inline)) void PriorityFifoCommit(PriorityFifo * const priorityFifo, const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    Fifo * const fifo = &priorityFifo->fifos[priority];
+    const uint16_t messageSize = (uint16_t) numberOfBytes;
+    const uint8_t * const bytes = (const uint8_t*) &messageSize;
+    size_t index = fifo->writeIndex; // message size is written to start of reservation
+    fifo->data[index] = bytes[0];
+    if (++index >= fifo->dataSize) {
+        index = 0;
+    }
+    fifo->data[index] = bytes[1];
+    FifoCommit(fifo, sizeof (uint16_t) + numberOfBytes);
+}
+
+/**
+ * @brief Writes a message to the FIFO.
+ * @param priorityFifo Priority FIFO structure.
+ * @param priority Priority.
+ * @param data Data.
+ * @param numberOfBytes Number of bytes.
+ * @return Result.
+ */
+static inline __attribute__((always_inline)) FifoResult PriorityFifoWrite(PriorityFifo * const priorityFifo, const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    FifoReservation reservation;
+    if (PriorityFifoReserve(priorityFifo, priority, numberOfBytes, &reservation) != FifoResultOk) {
+        return FifoResultError;
+    }
+    FifoReservationWrite(&reservation, 0, data, numberOfBytes);
+    PriorityFifoCommit(priorityFifo, priority, numberOfBytes);
+    return FifoResultOk;
+}
+
+/**
+ * @brief Clears the FIFO.
+ * @param priorityFifo Priority FIFO structure.
+ */
+static inline __attribute__((always_inline)) void PriorityFifoClear(PriorityFifo * const priorityFifo) {
+    for (int index = 0; index < PRIORITY_FIFO_NUMBER_OF_PRIORITIES; index++) {
+        FifoClear(&priorityFifo->fifos[index]);
+    }
+    priorityFifo->readRemaining = 0;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
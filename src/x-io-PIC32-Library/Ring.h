@@ -0,0 +1,137 @@
+/**
+ * @file Ring.h
+ * @author Seb Madgwick
+ * @brief Single-producer, single-consumer ring buffer of fixed-size slots.
+ * Data is written and read in place so that no copy is required. The number of
+ * slots must be a power of 2.
+ */
+
+#ifndef RING_H
+#define RING_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stddef.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Ring structure. All structure members are private except for
+ * initialisation.
+ *
+ * Example:
+ * @code
+ * static Sample samples[512] __attribute__((aligned(16)));
+ * Ring ring = {.slots = samples, .slotSize = sizeof (samples[0]), .numberOfSlots = 512};
+ * @endcode
+ */
+typedef struct {
+    void* const slots;
+    const size_t slotSize;
+    const size_t numberOfSlots;
+    size_t writeIndex;
+    size_t readIndex;
+} Ring;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns the number of slots available to read.
+ * @param ring Ring structure.
+ * @return Number of slots available to read.
+ */
+static inline __attribute__((always_inline)) size_t RingAvailableRead(Ring * const ring) {
+    return __atomic_load_n(&ring->writeIndex, __ATOMIC_ACQUIRE) - ring->readIndex;
+}
+
+/**
+ * @brief Returns the number of slots available to write.
+ * @param ring Ring structure.
+ * @return Number of slots available to write.
+ */
+static inline __attribute__((always_inline)) size_t RingAvailableWrite(Ring * const ring) {
+    return ring->numberOfSlots - (ring->writeIndex - __atomic_load_n(&ring->readIndex, __ATOMIC_ACQUIRE));
+}
+
+/**
+ * @brief Returns a pointer to the slot for the next write. RingWriteComplete
+ * must be called after the slot has been written.
+ * @param ring Ring structure.
+ * @return Slot. NULL if the ring is full.
+ */
+static inline __attribute__((always_inline)) void* RingWriteSlot(Ring * const ring) {
+    if (RingAvailableWrite(ring) == 0) {
+        return NULL;
+    }
+    return (uint8_t*) ring->slots + ((ring->writeIndex & (ring->numberOfSlots - 1)) * ring->slotSize);
+}
+
+/**
+ * @brief Makes the slot provided by RingWriteSlot available to read.
+ * @param ring Ring structure.
+ */
+static inline __attribute__((always_inline)) void RingWriteComplete(Ring * const ring) {
+    __atomic_store_n(&ring->writeIndex, ring->writeIndex + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Returns a pointer to the slot for the next read. RingReadComplete
+ * must be called after the slot has been read.
+ * @param ring Ring structure.
+ * @return Slot. NULL if the ring is empty.
+ */
+static inline __attribute__((always_inline)) const void* RingReadSlot(Ring * const ring) {
+    if (RingAvailableRead(ring) == 0) {
+        return NULL;
+    }
+    return (const uint8_t*) ring->slots + ((ring->readIndex & (ring->numberOfSlots - 1)) * ring->slotSize);
+}
+
+/**
+ * @brief Releases the slot provided by RingReadSlot so that it may be written.
+ * @param ring Ring structure.
+ */
+static inline __attribute__((always_inline)) void RingReadComplete(Ring * const ring) {
+    __atomic_store_n(&ring->readIndex, ring->readIndex + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Provides a pointer to the next contiguous block of slots to read.
+ * RingReadSlotsComplete must be called after the slots have been read.
+ * @param ring Ring structure.
+ * @param numberOfSlots Number of contiguous slots available to read.
+ * @return First slot.
+ */
+static inline __attribute__((always_inline)) const void* RingReadSlots(Ring * const ring, size_t * const numberOfSlots) {
+    const size_t index = ring->readIndex & (ring->numberOfSlots - 1);
+    const size_t availableRead = RingAvailableRead(ring);
+    const size_t availableBeforeWraparound = ring->numberOfSlots - index;
+    *numberOfSlots = availableRead < availableBeforeWraparound ? availableRead : availableBeforeWraparound;
+    return (const uint8_t*) ring->slots + (index * ring->slotSize);
+}
+
+/**
+ * @brief Releases slots provided by RingReadSlots so that they may be written.
+ * @param ring Ring structure.
+ * @param numberOfSlots Number of slots.
+ */
+static inline __attribute__((always_inline)) void RingReadSlotsComplete(Ring * const ring, const size_t numberOfSlots) {
+    __atomic_store_n(&ring->readIndex, ring->readIndex + numberOfSlots, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Clears the ring. This function must only be called by the consumer.
+ * @param ring Ring structure.
+ */
+static inline __attribute__((always_inline)) void RingClear(Ring * const ring) {
+    __atomic_store_n(&ring->readIndex, __atomic_load_n(&ring->writeIndex, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
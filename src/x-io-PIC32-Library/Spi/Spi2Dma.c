@@ -0,0 +1,215 @@
+/**
+ * @file Spi2Dma.c
+ * @author Seb Madgwick
+ * @brief SPI driver using DMA for PIC32 devices. Received data is transferred
+ * by a single DMA channel. Transmit data is written to the TX FIFO directly,
+ * and from within the TX interrupt for transfers larger than the FIFO.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Config.h"
+#include "definitions.h"
+#include "Spi2Dma.h"
+#include "sys/kmem.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this line to print transfers.
+ */
+//#define PRINT_TRANSFERS
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) void WriteTxFifo(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+const Spi spi2Dma = {
+    .transfer = Spi2DmaTransfer,
+    .transferInProgress = Spi2DmaTransferInProgress,
+};
+
+static GPIO_PIN csPin;
+static uint8_t* data;
+static size_t numberOfBytes;
+static volatile size_t writeIndex;
+static void (*transferComplete)(void);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the module.
+ * @param settings Settings.
+ */
+void Spi2DmaInitialise(const SpiSettings * const settings) {
+
+    // Ensure default register states
+    Spi2DmaDeinitialise();
+
+    // Configure SPI
+    SPI2CONbits.MSTEN = 1; // host mode
+    SPI2CONbits.ENHBUF = 1; // enhanced Buffer mode is enabled
+    SPI2CONbits.SMP = 1; // input data sampled at end of data output time
+    SPI2CONbits.CKP = settings->clockPolarity;
+    SPI2CONbits.CKE = settings->clockPhase;
+    SPI2CONbits.STXISEL = 0b10; // interrupt is generated when the buffer is empty by one-half or more
+    SPI2CONbits.SRXISEL = 0b01; // interrupt is generated when the buffer is not empty
+    SPI2BRG = SpiCalculateSpixbrg(settings->clockFrequency);
+    SPI2CONbits.ON = 1;
+
+    // Enable DMA
+    DMACONbits.ON = 1;
+
+    // Configure RX DMA channel
+#ifdef _SPI2_RX_IRQ
+    DCH2ECONbits.CHSIRQ = _SPI2_RX_IRQ; // channel transfer start IRQ
+#else
+    DCH2ECONbits.CHSIRQ = _SPI2_RX_VECTOR; // channel transfer start IRQ
+#endif
+    DCH2ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH2SSA = KVA_TO_PA(&SPI2BUF); // source address
+    DCH2SSIZ = 1; // source size
+    DCH2CSIZ = 1; // transfers per event
+    DCH2INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
+
+    // Configure RX DMA channel interrupt
+    EVIC_SourceEnable(INT_SOURCE_DMA2);
+}
+
+/**
+ * @brief Deinitialises the module.
+ */
+void Spi2DmaDeinitialise(void) {
+
+    // Disable SPI and restore default register states
+    SPI2CON = 0;
+    SPI2CON2 = 0;
+    SPI2STAT = 0;
+    SPI2BRG = 0;
+
+    // Disable RX DMA channel and restore default register states
+    DCH2CON = 0;
+    DCH2ECON = 0;
+    DCH2INT = 0;
+    DCH2SSA = 0;
+    DCH2DSA = 0;
+    DCH2SSIZ = 0;
+    DCH2DSIZ = 0;
+    DCH2SPTR = 0;
+    DCH2DPTR = 0;
+    DCH2CSIZ = 0;
+    DCH2CPTR = 0;
+    DCH2DAT = 0;
+
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_SPI2_TX);
+    EVIC_SourceStatusClear(INT_SOURCE_SPI2_TX);
+    EVIC_SourceDisable(INT_SOURCE_DMA2);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA2);
+}
+
+/**
+ * @brief Transfers data. The data will be overwritten with the received data.
+ * The data must be declared __attribute__((coherent)) for PIC32MZ devices.
+ * This function must not be called while a transfer is in progress. The
+ * transfer complete callback will be called from within an interrupt once the
+ * transfer is complete.
+ * @param csPin_ CS pin.
+ * @param data_ Data.
+ * @param numberOfBytes_ Number of bytes.
+ * @param transferComplete_ Transfer complete callback. NULL if unused.
+ */
+void Spi2DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void)) {
+
+    // Store arguments
+    csPin = csPin_;
+    data = (uint8_t*) data_;
+    numberOfBytes = numberOfBytes_;
+    writeIndex = 0;
+    transferComplete = transferComplete_;
+
+    // Print
+#ifdef PRINT_TRANSFERS
+    SpiPrintTransfer(csPin, data, numberOfBytes);
+#endif
+
+    // Configure RX DMA channel
+    DCH2DSA = KVA_TO_PA(data_); // destination address
+    DCH2DSIZ = numberOfBytes_; // destination size
+
+    // Begin transfer
+    if (csPin != GPIO_PIN_NONE) {
+#ifdef SPI2_CS_ACTIVE_HIGH
+        GPIO_PinSet(csPin);
+#else
+        GPIO_PinClear(csPin);
+#endif
+    }
+    DCH2INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
+    DCH2CONbits.CHEN = 1; // enable RX DMA channel
+    WriteTxFifo();
+    if (writeIndex < numberOfBytes) {
+        EVIC_SourceEnable(INT_SOURCE_SPI2_TX);
+    }
+}
+
+/**
+ * @brief Writes data to the TX FIFO until the FIFO is full or all data has been
+ * written.
+ */
+static inline __attribute__((always_inline)) void WriteTxFifo(void) {
+    while ((writeIndex < numberOfBytes) && (SPI2STATbits.SPITBF == 0)) { // while data remaining and space available in the FIFO
+        SPI2BUF = data[writeIndex++];
+    }
+}
+
+/**
+ * @brief SPI TX interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Spi2TxInterruptHandler(void) {
+    WriteTxFifo();
+    if (writeIndex >= numberOfBytes) {
+        EVIC_SourceDisable(INT_SOURCE_SPI2_TX);
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_SPI2_TX);
+}
+
+/**
+ * @brief DMA interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Dma2InterruptHandler(void) {
+    EVIC_SourceStatusClear(INT_SOURCE_DMA2); // clear interrupt flag first because transfer complete callback may start a new transfer
+    if (csPin != GPIO_PIN_NONE) {
+#ifdef SPI2_CS_ACTIVE_HIGH
+        GPIO_PinClear(csPin);
+#else
+        GPIO_PinSet(csPin);
+#endif
+    }
+#ifdef PRINT_TRANSFERS
+    SpiPrintTransferComplete(data, numberOfBytes);
+#endif
+    if (transferComplete != NULL) {
+        transferComplete();
+    }
+}
+
+/**
+ * @brief Returns true while the transfer is in progress.
+ * @return True while the transfer is in progress.
+ */
+bool Spi2DmaTransferInProgress(void) {
+    return DCH2CONbits.CHEN == 1; // if RX DMA channel enabled
+}
+
+//------------------------------------------------------------------------------
+// End of file
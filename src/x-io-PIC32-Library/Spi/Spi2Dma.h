@@ -1,11 +1,11 @@
 /**
- * @file Spi2.h
+ * @file Spi2Dma.h
  * @author Seb Madgwick
- * @brief SPI driver for PIC32 devices.
+ * @brief SPI driver using DMA for PIC32 devices.
  */
 
-#ifndef SPI2_H
-#define SPI2_H
+#ifndef SPI2_DMA_H
+#define SPI2_DMA_H
 
 //------------------------------------------------------------------------------
 // Includes
@@ -18,15 +18,15 @@
 //------------------------------------------------------------------------------
 // Variable declarations
 
-extern const Spi spi2;
+extern const Spi spi2Dma;
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-void Spi2Initialise(const SpiSettings * const settings);
-void Spi2Deinitialise(void);
-void Spi2Transfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void));
-bool Spi2TransferInProgress(void);
+void Spi2DmaInitialise(const SpiSettings * const settings);
+void Spi2DmaDeinitialise(void);
+void Spi2DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void));
+bool Spi2DmaTransferInProgress(void);
 
 #endif
 
@@ -1,7 +1,9 @@
 /**
  * @file Spi3Dma.c
  * @author Seb Madgwick
- * @brief SPI driver using DMA for PIC32 devices.
+ * @brief SPI driver using DMA for PIC32 devices. Received data is transferred
+ * by a single DMA channel. Transmit data is written to the TX FIFO directly,
+ * and from within the TX interrupt for transfers larger than the FIFO.
  */
 
 //------------------------------------------------------------------------------
@@ -20,6 +22,11 @@
  */
 //#define PRINT_TRANSFERS
 
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) void WriteTxFifo(void);
+
 //------------------------------------------------------------------------------
 // Variables
 
@@ -29,10 +36,9 @@ const Spi spi3Dma = {
 };
 
 static GPIO_PIN csPin;
-#ifdef PRINT_TRANSFERS
-static void* data;
+static uint8_t* data;
 static size_t numberOfBytes;
-#endif
+static volatile size_t writeIndex;
 static void (*transferComplete)(void);
 
 //------------------------------------------------------------------------------
@@ -53,7 +59,7 @@ void Spi3DmaInitialise(const SpiSettings * const settings) {
     SPI3CONbits.SMP = 1; // input data sampled at end of data output time
     SPI3CONbits.CKP = settings->clockPolarity;
     SPI3CONbits.CKE = settings->clockPhase;
-    SPI3CONbits.STXISEL = 0b11; // interrupt is generated when the buffer is not full (has one or more empty elements)
+    SPI3CONbits.STXISEL = 0b10; // interrupt is generated when the buffer is empty by one-half or more
     SPI3CONbits.SRXISEL = 0b01; // interrupt is generated when the buffer is not empty
     SPI3BRG = SpiCalculateSpixbrg(settings->clockFrequency);
     SPI3CONbits.ON = 1;
@@ -61,17 +67,6 @@ void Spi3DmaInitialise(const SpiSettings * const settings) {
     // Enable DMA
     DMACONbits.ON = 1;
 
-    // Configure TX DMA channel
-#ifdef _SPI3_TX_IRQ
-    DCH2ECONbits.CHSIRQ = _SPI3_TX_IRQ; // channel transfer start IRQ
-#else
-    DCH2ECONbits.CHSIRQ = _SPI3_TX_VECTOR; // channel transfer start IRQ
-#endif
-    DCH2ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
-    DCH2DSA = KVA_TO_PA(&SPI3BUF); // destination address
-    DCH2DSIZ = 1; // destination size
-    DCH2CSIZ = 1; // transfers per event
-
     // Configure RX DMA channel
 #ifdef _SPI3_RX_IRQ
     DCH3ECONbits.CHSIRQ = _SPI3_RX_IRQ; // channel transfer start IRQ
@@ -99,20 +94,6 @@ void Spi3DmaDeinitialise(void) {
     SPI3STAT = 0;
     SPI3BRG = 0;
 
-    // Disable TX DMA channel and restore default register states
-    DCH2CON = 0;
-    DCH2ECON = 0;
-    DCH2INT = 0;
-    DCH2SSA = 0;
-    DCH2DSA = 0;
-    DCH2SSIZ = 0;
-    DCH2DSIZ = 0;
-    DCH2SPTR = 0;
-    DCH2DPTR = 0;
-    DCH2CSIZ = 0;
-    DCH2CPTR = 0;
-    DCH2DAT = 0;
-
     // Disable RX DMA channel and restore default register states
     DCH3CON = 0;
     DCH3ECON = 0;
@@ -127,7 +108,9 @@ void Spi3DmaDeinitialise(void) {
     DCH3CPTR = 0;
     DCH3DAT = 0;
 
-    // Disable interrupt
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_SPI3_TX);
+    EVIC_SourceStatusClear(INT_SOURCE_SPI3_TX);
     EVIC_SourceDisable(INT_SOURCE_DMA3);
     EVIC_SourceStatusClear(INT_SOURCE_DMA3);
 }
@@ -147,10 +130,9 @@ void Spi3DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
 
     // Store arguments
     csPin = csPin_;
-#ifdef PRINT_TRANSFERS
     data = (uint8_t*) data_;
     numberOfBytes = numberOfBytes_;
-#endif
+    writeIndex = 0;
     transferComplete = transferComplete_;
 
     // Print
@@ -158,10 +140,6 @@ void Spi3DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
     SpiPrintTransfer(csPin, data, numberOfBytes);
 #endif
 
-    // Configure TX DMA channel
-    DCH2SSA = KVA_TO_PA(data_); // source address
-    DCH2SSIZ = numberOfBytes_; // source size
-
     // Configure RX DMA channel
     DCH3DSA = KVA_TO_PA(data_); // destination address
     DCH3DSIZ = numberOfBytes_; // destination size
@@ -176,7 +154,32 @@ void Spi3DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
     }
     DCH3INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
     DCH3CONbits.CHEN = 1; // enable RX DMA channel
-    DCH2CONbits.CHEN = 1; // enable TX DMA channel to begin transfer
+    WriteTxFifo();
+    if (writeIndex < numberOfBytes) {
+        EVIC_SourceEnable(INT_SOURCE_SPI3_TX);
+    }
+}
+
+/**
+ * @brief Writes data to the TX FIFO until the FIFO is full or all data has been
+ * written.
+ */
+static inline __attribute__((always_inline)) void WriteTxFifo(void) {
+    while ((writeIndex < numberOfBytes) && (SPI3STATbits.SPITBF == 0)) { // while data remaining and space available in the FIFO
+        SPI3BUF = data[writeIndex++];
+    }
+}
+
+/**
+ * @brief SPI TX interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Spi3TxInterruptHandler(void) {
+    WriteTxFifo();
+    if (writeIndex >= numberOfBytes) {
+        EVIC_SourceDisable(INT_SOURCE_SPI3_TX);
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_SPI3_TX);
 }
 
 /**
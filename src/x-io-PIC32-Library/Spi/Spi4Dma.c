@@ -1,7 +1,9 @@
 /**
  * @file Spi4Dma.c
  * @author Seb Madgwick
- * @brief SPI driver using DMA for PIC32 devices.
+ * @brief SPI driver using DMA for PIC32 devices. Received data is transferred
+ * by a single DMA channel. Transmit data is written to the TX FIFO directly,
+ * and from within the TX interrupt for transfers larger than the FIFO.
  */
 
 //------------------------------------------------------------------------------
@@ -20,6 +22,11 @@
  */
 //#define PRINT_TRANSFERS
 
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) void WriteTxFifo(void);
+
 //------------------------------------------------------------------------------
 // Variables
 
@@ -29,10 +36,9 @@ const Spi spi4Dma = {
 };
 
 static GPIO_PIN csPin;
-#ifdef PRINT_TRANSFERS
-static void* data;
+static uint8_t* data;
 static size_t numberOfBytes;
-#endif
+static volatile size_t writeIndex;
 static void (*transferComplete)(void);
 
 //------------------------------------------------------------------------------
@@ -53,7 +59,7 @@ void Spi4DmaInitialise(const SpiSettings * const settings) {
     SPI4CONbits.SMP = 1; // input data sampled at end of data output time
     SPI4CONbits.CKP = settings->clockPolarity;
     SPI4CONbits.CKE = settings->clockPhase;
-    SPI4CONbits.STXISEL = 0b11; // interrupt is generated when the buffer is not full (has one or more empty elements)
+    SPI4CONbits.STXISEL = 0b10; // interrupt is generated when the buffer is empty by one-half or more
     SPI4CONbits.SRXISEL = 0b01; // interrupt is generated when the buffer is not empty
     SPI4BRG = SpiCalculateSpixbrg(settings->clockFrequency);
     SPI4CONbits.ON = 1;
@@ -61,31 +67,20 @@ void Spi4DmaInitialise(const SpiSettings * const settings) {
     // Enable DMA
     DMACONbits.ON = 1;
 
-    // Configure TX DMA channel
-#ifdef _SPI4_TX_IRQ
-    DCH4ECONbits.CHSIRQ = _SPI4_TX_IRQ; // channel transfer start IRQ
-#else
-    DCH4ECONbits.CHSIRQ = _SPI4_TX_VECTOR; // channel transfer start IRQ
-#endif
-    DCH4ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
-    DCH4DSA = KVA_TO_PA(&SPI4BUF); // destination address
-    DCH4DSIZ = 1; // destination size
-    DCH4CSIZ = 1; // transfers per event
-
     // Configure RX DMA channel
 #ifdef _SPI4_RX_IRQ
-    DCH5ECONbits.CHSIRQ = _SPI4_RX_IRQ; // channel transfer start IRQ
+    DCH4ECONbits.CHSIRQ = _SPI4_RX_IRQ; // channel transfer start IRQ
 #else
-    DCH5ECONbits.CHSIRQ = _SPI4_RX_VECTOR; // channel transfer start IRQ
+    DCH4ECONbits.CHSIRQ = _SPI4_RX_VECTOR; // channel transfer start IRQ
 #endif
-    DCH5ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
-    DCH5SSA = KVA_TO_PA(&SPI4BUF); // source address
-    DCH5SSIZ = 1; // source size
-    DCH5CSIZ = 1; // transfers per event
-    DCH5INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
+    DCH4ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH4SSA = KVA_TO_PA(&SPI4BUF); // source address
+    DCH4SSIZ = 1; // source size
+    DCH4CSIZ = 1; // transfers per event
+    DCH4INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
 
     // Configure RX DMA channel interrupt
-    EVIC_SourceEnable(INT_SOURCE_DMA5);
+    EVIC_SourceEnable(INT_SOURCE_DMA4);
 }
 
 /**
@@ -99,7 +94,7 @@ void Spi4DmaDeinitialise(void) {
     SPI4STAT = 0;
     SPI4BRG = 0;
 
-    // Disable TX DMA channel and restore default register states
+    // Disable RX DMA channel and restore default register states
     DCH4CON = 0;
     DCH4ECON = 0;
     DCH4INT = 0;
@@ -113,23 +108,11 @@ void Spi4DmaDeinitialise(void) {
     DCH4CPTR = 0;
     DCH4DAT = 0;
 
-    // Disable RX DMA channel and restore default register states
-    DCH5CON = 0;
-    DCH5ECON = 0;
-    DCH5INT = 0;
-    DCH5SSA = 0;
-    DCH5DSA = 0;
-    DCH5SSIZ = 0;
-    DCH5DSIZ = 0;
-    DCH5SPTR = 0;
-    DCH5DPTR = 0;
-    DCH5CSIZ = 0;
-    DCH5CPTR = 0;
-    DCH5DAT = 0;
-
-    // Disable interrupt
-    EVIC_SourceDisable(INT_SOURCE_DMA5);
-    EVIC_SourceStatusClear(INT_SOURCE_DMA5);
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_SPI4_TX);
+    EVIC_SourceStatusClear(INT_SOURCE_SPI4_TX);
+    EVIC_SourceDisable(INT_SOURCE_DMA4);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA4);
 }
 
 /**
@@ -147,10 +130,9 @@ void Spi4DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
 
     // Store arguments
     csPin = csPin_;
-#ifdef PRINT_TRANSFERS
     data = (uint8_t*) data_;
     numberOfBytes = numberOfBytes_;
-#endif
+    writeIndex = 0;
     transferComplete = transferComplete_;
 
     // Print
@@ -158,13 +140,9 @@ void Spi4DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
     SpiPrintTransfer(csPin, data, numberOfBytes);
 #endif
 
-    // Configure TX DMA channel
-    DCH4SSA = KVA_TO_PA(data_); // source address
-    DCH4SSIZ = numberOfBytes_; // source size
-
     // Configure RX DMA channel
-    DCH5DSA = KVA_TO_PA(data_); // destination address
-    DCH5DSIZ = numberOfBytes_; // destination size
+    DCH4DSA = KVA_TO_PA(data_); // destination address
+    DCH4DSIZ = numberOfBytes_; // destination size
 
     // Begin transfer
     if (csPin != GPIO_PIN_NONE) {
@@ -174,17 +152,42 @@ void Spi4DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
         GPIO_PinClear(csPin);
 #endif
     }
-    DCH5INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
-    DCH5CONbits.CHEN = 1; // enable RX DMA channel
-    DCH4CONbits.CHEN = 1; // enable TX DMA channel to begin transfer
+    DCH4INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
+    DCH4CONbits.CHEN = 1; // enable RX DMA channel
+    WriteTxFifo();
+    if (writeIndex < numberOfBytes) {
+        EVIC_SourceEnable(INT_SOURCE_SPI4_TX);
+    }
+}
+
+/**
+ * @brief Writes data to the TX FIFO until the FIFO is full or all data has been
+ * written.
+ */
+static inline __attribute__((always_inline)) void WriteTxFifo(void) {
+    while ((writeIndex < numberOfBytes) && (SPI4STATbits.SPITBF == 0)) { // while data remaining and space available in the FIFO
+        SPI4BUF = data[writeIndex++];
+    }
+}
+
+/**
+ * @brief SPI TX interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Spi4TxInterruptHandler(void) {
+    WriteTxFifo();
+    if (writeIndex >= numberOfBytes) {
+        EVIC_SourceDisable(INT_SOURCE_SPI4_TX);
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_SPI4_TX);
 }
 
 /**
  * @brief DMA interrupt handler. This function should be called by the ISR
  * implementation generated by MPLAB Harmony.
  */
-void Dma5InterruptHandler(void) {
-    EVIC_SourceStatusClear(INT_SOURCE_DMA5); // clear interrupt flag first because transfer complete callback may start a new transfer
+void Dma4InterruptHandler(void) {
+    EVIC_SourceStatusClear(INT_SOURCE_DMA4); // clear interrupt flag first because transfer complete callback may start a new transfer
     if (csPin != GPIO_PIN_NONE) {
 #ifdef SPI4_CS_ACTIVE_HIGH
         GPIO_PinClear(csPin);
@@ -205,7 +208,7 @@ void Dma5InterruptHandler(void) {
  * @return True while the transfer is in progress.
  */
 bool Spi4DmaTransferInProgress(void) {
-    return DCH5CONbits.CHEN == 1; // if RX DMA channel enabled
+    return DCH4CONbits.CHEN == 1; // if RX DMA channel enabled
 }
 
 //------------------------------------------------------------------------------
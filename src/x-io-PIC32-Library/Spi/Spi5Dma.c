@@ -0,0 +1,215 @@
+/**
+ * @file Spi5Dma.c
+ * @author Seb Madgwick
+ * @brief SPI driver using DMA for PIC32 devices. Received data is transferred
+ * by a single DMA channel. Transmit data is written to the TX FIFO directly,
+ * and from within the TX interrupt for transfers larger than the FIFO.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Config.h"
+#include "definitions.h"
+#include "Spi5Dma.h"
+#include "sys/kmem.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment this line to print transfers.
+ */
+//#define PRINT_TRANSFERS
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) void WriteTxFifo(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+const Spi spi5Dma = {
+    .transfer = Spi5DmaTransfer,
+    .transferInProgress = Spi5DmaTransferInProgress,
+};
+
+static GPIO_PIN csPin;
+static uint8_t* data;
+static size_t numberOfBytes;
+static volatile size_t writeIndex;
+static void (*transferComplete)(void);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the module.
+ * @param settings Settings.
+ */
+void Spi5DmaInitialise(const SpiSettings * const settings) {
+
+    // Ensure default register states
+    Spi5DmaDeinitialise();
+
+    // Configure SPI
+    SPI5CONbits.MSTEN = 1; // host mode
+    SPI5CONbits.ENHBUF = 1; // enhanced Buffer mode is enabled
+    SPI5CONbits.SMP = 1; // input data sampled at end of data output time
+    SPI5CONbits.CKP = settings->clockPolarity;
+    SPI5CONbits.CKE = settings->clockPhase;
+    SPI5CONbits.STXISEL = 0b10; // interrupt is generated when the buffer is empty by one-half or more
+    SPI5CONbits.SRXISEL = 0b01; // interrupt is generated when the buffer is not empty
+    SPI5BRG = SpiCalculateSpixbrg(settings->clockFrequency);
+    SPI5CONbits.ON = 1;
+
+    // Enable DMA
+    DMACONbits.ON = 1;
+
+    // Configure RX DMA channel
+#ifdef _SPI5_RX_IRQ
+    DCH5ECONbits.CHSIRQ = _SPI5_RX_IRQ; // channel transfer start IRQ
+#else
+    DCH5ECONbits.CHSIRQ = _SPI5_RX_VECTOR; // channel transfer start IRQ
+#endif
+    DCH5ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH5SSA = KVA_TO_PA(&SPI5BUF); // source address
+    DCH5SSIZ = 1; // source size
+    DCH5CSIZ = 1; // transfers per event
+    DCH5INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
+
+    // Configure RX DMA channel interrupt
+    EVIC_SourceEnable(INT_SOURCE_DMA5);
+}
+
+/**
+ * @brief Deinitialises the module.
+ */
+void Spi5DmaDeinitialise(void) {
+
+    // Disable SPI and restore default register states
+    SPI5CON = 0;
+    SPI5CON2 = 0;
+    SPI5STAT = 0;
+    SPI5BRG = 0;
+
+    // Disable RX DMA channel and restore default register states
+    DCH5CON = 0;
+    DCH5ECON = 0;
+    DCH5INT = 0;
+    DCH5SSA = 0;
+    DCH5DSA = 0;
+    DCH5SSIZ = 0;
+    DCH5DSIZ = 0;
+    DCH5SPTR = 0;
+    DCH5DPTR = 0;
+    DCH5CSIZ = 0;
+    DCH5CPTR = 0;
+    DCH5DAT = 0;
+
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_SPI5_TX);
+    EVIC_SourceStatusClear(INT_SOURCE_SPI5_TX);
+    EVIC_SourceDisable(INT_SOURCE_DMA5);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA5);
+}
+
+/**
+ * @brief Transfers data. The data will be overwritten with the received data.
+ * The data must be declared __attribute__((coherent)) for PIC32MZ devices.
+ * This function must not be called while a transfer is in progress. The
+ * transfer complete callback will be called from within an interrupt once the
+ * transfer is complete.
+ * @param csPin_ CS pin.
+ * @param data_ Data.
+ * @param numberOfBytes_ Number of bytes.
+ * @param transferComplete_ Transfer complete callback. NULL if unused.
+ */
+void Spi5DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void)) {
+
+    // Store arguments
+    csPin = csPin_;
+    data = (uint8_t*) data_;
+    numberOfBytes = numberOfBytes_;
+    writeIndex = 0;
+    transferComplete = transferComplete_;
+
+    // Print
+#ifdef PRINT_TRANSFERS
+    SpiPrintTransfer(csPin, data, numberOfBytes);
+#endif
+
+    // Configure RX DMA channel
+    DCH5DSA = KVA_TO_PA(data_); // destination address
+    DCH5DSIZ = numberOfBytes_; // destination size
+
+    // Begin transfer
+    if (csPin != GPIO_PIN_NONE) {
+#ifdef SPI5_CS_ACTIVE_HIGH
+        GPIO_PinSet(csPin);
+#else
+        GPIO_PinClear(csPin);
+#endif
+    }
+    DCH5INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
+    DCH5CONbits.CHEN = 1; // enable RX DMA channel
+    WriteTxFifo();
+    if (writeIndex < numberOfBytes) {
+        EVIC_SourceEnable(INT_SOURCE_SPI5_TX);
+    }
+}
+
+/**
+ * @brief Writes data to the TX FIFO until the FIFO is full or all data has been
+ * written.
+ */
+static inline __attribute__((always_inline)) void WriteTxFifo(void) {
+    while ((writeIndex < numberOfBytes) && (SPI5STATbits.SPITBF == 0)) { // while data remaining and space available in the FIFO
+        SPI5BUF = data[writeIndex++];
+    }
+}
+
+/**
+ * @brief SPI TX interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Spi5TxInterruptHandler(void) {
+    WriteTxFifo();
+    if (writeIndex >= numberOfBytes) {
+        EVIC_SourceDisable(INT_SOURCE_SPI5_TX);
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_SPI5_TX);
+}
+
+/**
+ * @brief DMA interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Dma5InterruptHandler(void) {
+    EVIC_SourceStatusClear(INT_SOURCE_DMA5); // clear interrupt flag first because transfer complete callback may start a new transfer
+    if (csPin != GPIO_PIN_NONE) {
+#ifdef SPI5_CS_ACTIVE_HIGH
+        GPIO_PinClear(csPin);
+#else
+        GPIO_PinSet(csPin);
+#endif
+    }
+#ifdef PRINT_TRANSFERS
+    SpiPrintTransferComplete(data, numberOfBytes);
+#endif
+    if (transferComplete != NULL) {
+        transferComplete();
+    }
+}
+
+/**
+ * @brief Returns true while the transfer is in progress.
+ * @return True while the transfer is in progress.
+ */
+bool Spi5DmaTransferInProgress(void) {
+    return DCH5CONbits.CHEN == 1; // if RX DMA channel enabled
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -1,11 +1,11 @@
 /**
- * @file Spi5.h
+ * @file Spi5Dma.h
  * @author Seb Madgwick
- * @brief SPI driver for PIC32 devices.
+ * @brief SPI driver using DMA for PIC32 devices.
  */
 
-#ifndef SPI5_H
-#define SPI5_H
+#ifndef SPI5_DMA_H
+#define SPI5_DMA_H
 
 //------------------------------------------------------------------------------
 // Includes
@@ -18,15 +18,15 @@
 //------------------------------------------------------------------------------
 // Variable declarations
 
-extern const Spi spi5;
+extern const Spi spi5Dma;
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-void Spi5Initialise(const SpiSettings * const settings);
-void Spi5Deinitialise(void);
-void Spi5Transfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void));
-bool Spi5TransferInProgress(void);
+void Spi5DmaInitialise(const SpiSettings * const settings);
+void Spi5DmaDeinitialise(void);
+void Spi5DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const size_t numberOfBytes_, void (*const transferComplete_) (void));
+bool Spi5DmaTransferInProgress(void);
 
 #endif
 
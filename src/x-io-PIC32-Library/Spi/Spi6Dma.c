@@ -1,7 +1,9 @@
 /**
  * @file Spi6Dma.c
  * @author Seb Madgwick
- * @brief SPI driver using DMA for PIC32 devices.
+ * @brief SPI driver using DMA for PIC32 devices. Received data is transferred
+ * by a single DMA channel. Transmit data is written to the TX FIFO directly,
+ * and from within the TX interrupt for transfers larger than the FIFO.
  */
 
 //------------------------------------------------------------------------------
@@ -20,6 +22,11 @@
  */
 //#define PRINT_TRANSFERS
 
+//------------------------------------------------------------------------------
+// Function declarations
+
+static inline __attribute__((always_inline)) void WriteTxFifo(void);
+
 //------------------------------------------------------------------------------
 // Variables
 
@@ -29,10 +36,9 @@ const Spi spi6Dma = {
 };
 
 static GPIO_PIN csPin;
-#ifdef PRINT_TRANSFERS
-static void* data;
+static uint8_t* data;
 static size_t numberOfBytes;
-#endif
+static volatile size_t writeIndex;
 static void (*transferComplete)(void);
 
 //------------------------------------------------------------------------------
@@ -53,7 +59,7 @@ void Spi6DmaInitialise(const SpiSettings * const settings) {
     SPI6CONbits.SMP = 1; // input data sampled at end of data output time
     SPI6CONbits.CKP = settings->clockPolarity;
     SPI6CONbits.CKE = settings->clockPhase;
-    SPI6CONbits.STXISEL = 0b11; // interrupt is generated when the buffer is not full (has one or more empty elements)
+    SPI6CONbits.STXISEL = 0b10; // interrupt is generated when the buffer is empty by one-half or more
     SPI6CONbits.SRXISEL = 0b01; // interrupt is generated when the buffer is not empty
     SPI6BRG = SpiCalculateSpixbrg(settings->clockFrequency);
     SPI6CONbits.ON = 1;
@@ -61,31 +67,20 @@ void Spi6DmaInitialise(const SpiSettings * const settings) {
     // Enable DMA
     DMACONbits.ON = 1;
 
-    // Configure TX DMA channel
-#ifdef _SPI6_TX_IRQ
-    DCH6ECONbits.CHSIRQ = _SPI6_TX_IRQ; // channel transfer start IRQ
-#else
-    DCH6ECONbits.CHSIRQ = _SPI6_TX_VECTOR; // channel transfer start IRQ
-#endif
-    DCH6ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
-    DCH6DSA = KVA_TO_PA(&SPI6BUF); // destination address
-    DCH6DSIZ = 1; // destination size
-    DCH6CSIZ = 1; // transfers per event
-
     // Configure RX DMA channel
 #ifdef _SPI6_RX_IRQ
-    DCH7ECONbits.CHSIRQ = _SPI6_RX_IRQ; // channel transfer start IRQ
+    DCH6ECONbits.CHSIRQ = _SPI6_RX_IRQ; // channel transfer start IRQ
 #else
-    DCH7ECONbits.CHSIRQ = _SPI6_RX_VECTOR; // channel transfer start IRQ
+    DCH6ECONbits.CHSIRQ = _SPI6_RX_VECTOR; // channel transfer start IRQ
 #endif
-    DCH7ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
-    DCH7SSA = KVA_TO_PA(&SPI6BUF); // source address
-    DCH7SSIZ = 1; // source size
-    DCH7CSIZ = 1; // transfers per event
-    DCH7INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
+    DCH6ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH6SSA = KVA_TO_PA(&SPI6BUF); // source address
+    DCH6SSIZ = 1; // source size
+    DCH6CSIZ = 1; // transfers per event
+    DCH6INTbits.CHBCIE = 1; // channel Block Transfer Complete Interrupt Enable bit
 
     // Configure RX DMA channel interrupt
-    EVIC_SourceEnable(INT_SOURCE_DMA7);
+    EVIC_SourceEnable(INT_SOURCE_DMA6);
 }
 
 /**
@@ -99,7 +94,7 @@ void Spi6DmaDeinitialise(void) {
     SPI6STAT = 0;
     SPI6BRG = 0;
 
-    // Disable TX DMA channel and restore default register states
+    // Disable RX DMA channel and restore default register states
     DCH6CON = 0;
     DCH6ECON = 0;
     DCH6INT = 0;
@@ -113,23 +108,11 @@ void Spi6DmaDeinitialise(void) {
     DCH6CPTR = 0;
     DCH6DAT = 0;
 
-    // Disable RX DMA channel and restore default register states
-    DCH7CON = 0;
-    DCH7ECON = 0;
-    DCH7INT = 0;
-    DCH7SSA = 0;
-    DCH7DSA = 0;
-    DCH7SSIZ = 0;
-    DCH7DSIZ = 0;
-    DCH7SPTR = 0;
-    DCH7DPTR = 0;
-    DCH7CSIZ = 0;
-    DCH7CPTR = 0;
-    DCH7DAT = 0;
-
-    // Disable interrupt
-    EVIC_SourceDisable(INT_SOURCE_DMA7);
-    EVIC_SourceStatusClear(INT_SOURCE_DMA7);
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_SPI6_TX);
+    EVIC_SourceStatusClear(INT_SOURCE_SPI6_TX);
+    EVIC_SourceDisable(INT_SOURCE_DMA6);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA6);
 }
 
 /**
@@ -147,10 +130,9 @@ void Spi6DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
 
     // Store arguments
     csPin = csPin_;
-#ifdef PRINT_TRANSFERS
     data = (uint8_t*) data_;
     numberOfBytes = numberOfBytes_;
-#endif
+    writeIndex = 0;
     transferComplete = transferComplete_;
 
     // Print
@@ -158,13 +140,9 @@ void Spi6DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
     SpiPrintTransfer(csPin, data, numberOfBytes);
 #endif
 
-    // Configure TX DMA channel
-    DCH6SSA = KVA_TO_PA(data_); // source address
-    DCH6SSIZ = numberOfBytes_; // source size
-
     // Configure RX DMA channel
-    DCH7DSA = KVA_TO_PA(data_); // destination address
-    DCH7DSIZ = numberOfBytes_; // destination size
+    DCH6DSA = KVA_TO_PA(data_); // destination address
+    DCH6DSIZ = numberOfBytes_; // destination size
 
     // Begin transfer
     if (csPin != GPIO_PIN_NONE) {
@@ -174,17 +152,42 @@ void Spi6DmaTransfer(const GPIO_PIN csPin_, volatile void* const data_, const si
         GPIO_PinClear(csPin);
 #endif
     }
-    DCH7INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
-    DCH7CONbits.CHEN = 1; // enable RX DMA channel
-    DCH6CONbits.CHEN = 1; // enable TX DMA channel to begin transfer
+    DCH6INTbits.CHBCIF = 0; // clear RX DMA channel interrupt flag
+    DCH6CONbits.CHEN = 1; // enable RX DMA channel
+    WriteTxFifo();
+    if (writeIndex < numberOfBytes) {
+        EVIC_SourceEnable(INT_SOURCE_SPI6_TX);
+    }
+}
+
+/**
+ * @brief Writes data to the TX FIFO until the FIFO is full or all data has been
+ * written.
+ */
+static inline __attribute__((always_inline)) void WriteTxFifo(void) {
+    while ((writeIndex < numberOfBytes) && (SPI6STATbits.SPITBF == 0)) { // while data remaining and space available in the FIFO
+        SPI6BUF = data[writeIndex++];
+    }
+}
+
+/**
+ * @brief SPI TX interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Spi6TxInterruptHandler(void) {
+    WriteTxFifo();
+    if (writeIndex >= numberOfBytes) {
+        EVIC_SourceDisable(INT_SOURCE_SPI6_TX);
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_SPI6_TX);
 }
 
 /**
  * @brief DMA interrupt handler. This function should be called by the ISR
  * implementation generated by MPLAB Harmony.
  */
-void Dma7InterruptHandler(void) {
-    EVIC_SourceStatusClear(INT_SOURCE_DMA7); // clear interrupt flag first because transfer complete callback may start a new transfer
+void Dma6InterruptHandler(void) {
+    EVIC_SourceStatusClear(INT_SOURCE_DMA6); // clear interrupt flag first because transfer complete callback may start a new transfer
     if (csPin != GPIO_PIN_NONE) {
 #ifdef SPI6_CS_ACTIVE_HIGH
         GPIO_PinClear(csPin);
@@ -205,7 +208,7 @@ void Dma7InterruptHandler(void) {
  * @return True while the transfer is in progress.
  */
 bool Spi6DmaTransferInProgress(void) {
-    return DCH7CONbits.CHEN == 1; // if RX DMA channel enabled
+    return DCH6CONbits.CHEN == 1; // if RX DMA channel enabled
 }
 
 //------------------------------------------------------------------------------
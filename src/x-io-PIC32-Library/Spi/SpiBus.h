@@ -24,7 +24,8 @@ typedef struct {
     GPIO_PIN csPin;
     volatile void* data;
     size_t numberOfBytes;
-    void (*transferComplete)(void);
+    void (*transferComplete)(void* const context);
+    void* context;
     volatile bool inProgress;
 } SpiBusClient;
 
@@ -33,7 +34,7 @@ typedef struct {
  */
 typedef struct {
     SpiBusClient * const (*addClient)(const GPIO_PIN csPin);
-    void (*transfer)(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+    void (*transfer)(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
     bool (*transferInProgress)(const SpiBusClient * const client);
 } SpiBus;
 
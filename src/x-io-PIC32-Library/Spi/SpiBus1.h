@@ -24,7 +24,7 @@ extern const SpiBus spiBus1;
 // Function declarations
 
 SpiBusClient * const SpiBus1AddClient(const GPIO_PIN csPin);
-void SpiBus1Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+void SpiBus1Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
 bool SpiBus1TransferInProgress(const SpiBusClient * const client);
 
 #endif
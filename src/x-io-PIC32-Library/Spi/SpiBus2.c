@@ -9,11 +9,19 @@
 
 #include "Config.h"
 #include "SpiBus2.h"
+#include "SpiBusQueue.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#if SPI_BUS_2_MAX_NUMBER_OF_CLIENTS > SPI_BUS_QUEUE_SIZE
+#error "Maximum number of clients exceeds queue size."
+#endif
 
 //------------------------------------------------------------------------------
 // Function declarations
 
-static void BeginTrasnfer(SpiBusClient * const client);
+static void BeginTransfer(void);
 static void TransferComplete(void);
 
 //------------------------------------------------------------------------------
@@ -26,7 +34,9 @@ const SpiBus spiBus2 = {
 };
 static int numberOfClients;
 static SpiBusClient clients[SPI_BUS_2_MAX_NUMBER_OF_CLIENTS];
-static SpiBusClient * volatile activeClient;
+static SpiBusQueue queue;
+static bool busy;
+static SpiBusClient* activeClient;
 
 //------------------------------------------------------------------------------
 // Functions
@@ -55,16 +65,19 @@ SpiBusClient * const SpiBus2AddClient(const GPIO_PIN csPin) {
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @param transferComplete Transfer complete callback. NULL if unused.
+ * @param context Context passed to the transfer complete callback.
  */
-void SpiBus2Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void)) {
+void SpiBus2Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context) {
     if (client == NULL) {
         return;
     }
     client->data = data;
     client->numberOfBytes = numberOfBytes;
     client->transferComplete = transferComplete;
-    client->inProgress = true; // set this member last else interrupt may use invalid structure
-    BeginTrasnfer(client);
+    client->context = context;
+    client->inProgress = true;
+    SpiBusQueueWrite(&queue, client); // cannot fail because each client may only be queued once
+    BeginTransfer();
 }
 
 /**
@@ -80,19 +93,21 @@ bool SpiBus2TransferInProgress(const SpiBusClient * const client) {
 }
 
 /**
- * @brief Begins transfer.
- * @param client Client.
+ * @brief Begins the next queued transfer if the bus is not busy. If the bus is
+ * busy then the transfer will begin once the current transfer is complete.
  */
-static void BeginTrasnfer(SpiBusClient * const client) {
-    static int lock;
-    if (__sync_lock_test_and_set(&lock, 1) == 1) {
-        return;
-    }
-    if (activeClient == NULL) {
-        activeClient = client;
-        SPI_BUS_2_SPI.transfer(activeClient->csPin, activeClient->data, activeClient->numberOfBytes, TransferComplete);
-    }
-    __sync_lock_release(&lock);
+static void BeginTransfer(void) {
+    do {
+        if (__atomic_exchange_n(&busy, true, __ATOMIC_SEQ_CST)) {
+            return;
+        }
+        activeClient = SpiBusQueueRead(&queue);
+        if (activeClient != NULL) {
+            SPI_BUS_2_SPI.transfer(activeClient->csPin, activeClient->data, activeClient->numberOfBytes, TransferComplete);
+            return;
+        }
+        __atomic_store_n(&busy, false, __ATOMIC_SEQ_CST);
+    } while (SpiBusQueueEmpty(&queue) == false); // a client may have been queued after the queue was read
 }
 
 /**
@@ -101,19 +116,16 @@ static void BeginTrasnfer(SpiBusClient * const client) {
 static void TransferComplete(void) {
 
     // End current transfer
-    activeClient->inProgress = false;
-    if (activeClient->transferComplete != NULL) {
-        activeClient->transferComplete();
+    void (*const transferComplete)(void* const context) = activeClient->transferComplete;
+    void* const context = activeClient->context;
+    activeClient->inProgress = false; // client may be queued again from this point
+    if (transferComplete != NULL) {
+        transferComplete(context);
     }
-    activeClient = NULL;
 
     // Begin next transfer
-    for (int index = 0; index < SPI_BUS_2_MAX_NUMBER_OF_CLIENTS; index++) {
-        if (clients[index].inProgress) {
-            BeginTrasnfer(&clients[index]);
-            return;
-        }
-    }
+    __atomic_store_n(&busy, false, __ATOMIC_SEQ_CST);
+    BeginTransfer();
 }
 
 //------------------------------------------------------------------------------
@@ -24,7 +24,7 @@ extern const SpiBus spiBus3;
 // Function declarations
 
 SpiBusClient * const SpiBus3AddClient(const GPIO_PIN csPin);
-void SpiBus3Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+void SpiBus3Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
 bool SpiBus3TransferInProgress(const SpiBusClient * const client);
 
 #endif
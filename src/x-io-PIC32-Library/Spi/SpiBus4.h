@@ -24,7 +24,7 @@ extern const SpiBus spiBus4;
 // Function declarations
 
 SpiBusClient * const SpiBus4AddClient(const GPIO_PIN csPin);
-void SpiBus4Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+void SpiBus4Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
 bool SpiBus4TransferInProgress(const SpiBusClient * const client);
 
 #endif
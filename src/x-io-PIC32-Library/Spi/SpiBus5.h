@@ -24,7 +24,7 @@ extern const SpiBus spiBus5;
 // Function declarations
 
 SpiBusClient * const SpiBus5AddClient(const GPIO_PIN csPin);
-void SpiBus5Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+void SpiBus5Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
 bool SpiBus5TransferInProgress(const SpiBusClient * const client);
 
 #endif
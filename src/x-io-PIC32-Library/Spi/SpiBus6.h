@@ -24,7 +24,7 @@ extern const SpiBus spiBus6;
 // Function declarations
 
 SpiBusClient * const SpiBus6AddClient(const GPIO_PIN csPin);
-void SpiBus6Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void));
+void SpiBus6Transfer(SpiBusClient * const client, volatile void* const data, const size_t numberOfBytes, void (*const transferComplete) (void* const context), void* const context);
 bool SpiBus6TransferInProgress(const SpiBusClient * const client);
 
 #endif
@@ -0,0 +1,124 @@
+/**
+ * @file SpiBusQueue.h
+ * @author Seb Madgwick
+ * @brief Lock-free multiple-producer, single-consumer queue of SPI bus
+ * clients. Each slot has a sequence number that indicates if the slot is free
+ * or has been written to by a producer. Producers claim a slot by incrementing
+ * the write index and so may be interrupted by other producers at any time.
+ * Only one context may read from the queue at a time.
+ */
+
+#ifndef SPI_BUS_QUEUE_H
+#define SPI_BUS_QUEUE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "SpiBus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Queue size. Must be a power of 2 and not less than the maximum number
+ * of clients of any bus.
+ */
+#define SPI_BUS_QUEUE_SIZE (8)
+
+/**
+ * @brief Queue slot. All structure members are private.
+ */
+typedef struct {
+    SpiBusClient* client;
+    uint32_t sequence; // stored relative to slot index so that a zero-initialised slot is free
+} SpiBusQueueSlot;
+
+/**
+ * @brief Queue structure. All structure members are private. A zero-initialised
+ * structure is an empty queue.
+ */
+typedef struct {
+    SpiBusQueueSlot slots[SPI_BUS_QUEUE_SIZE];
+    uint32_t writeIndex;
+    uint32_t readIndex;
+} SpiBusQueue;
+
+//------------------------------------------------------------------------------
+// Inline functions
+
+/**
+ * @brief Returns the sequence number of a slot.
+ * @param queue Queue structure.
+ * @param index Index.
+ * @return Sequence number.
+ */
+static inline __attribute__((always_inline)) uint32_t SpiBusQueueSequence(SpiBusQueue * const queue, const uint32_t index) {
+    const uint32_t slotIndex = index & (SPI_BUS_QUEUE_SIZE - 1);
+    return __atomic_load_n(&queue->slots[slotIndex].sequence, __ATOMIC_ACQUIRE) + slotIndex;
+}
+
+/**
+ * @brief Writes a client to the queue. This function may be called from any
+ * context.
+ * @param queue Queue structure.
+ * @param client Client.
+ * @return True if successful, false if the queue is full.
+ */
+static inline __attribute__((always_inline)) bool SpiBusQueueWrite(SpiBusQueue * const queue, SpiBusClient * const client) {
+
+    // Claim slot
+    uint32_t index = __atomic_load_n(&queue->writeIndex, __ATOMIC_RELAXED);
+    while (true) {
+        const int32_t difference = (int32_t) (SpiBusQueueSequence(queue, index) - index);
+        if (difference == 0) {
+            if (__atomic_compare_exchange_n(&queue->writeIndex, &index, index + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false; // slot not yet read so queue is full
+        } else {
+            index = __atomic_load_n(&queue->writeIndex, __ATOMIC_RELAXED); // slot claimed by another producer
+        }
+    }
+
+    // Write client to slot and make available to consumer
+    const uint32_t slotIndex = index & (SPI_BUS_QUEUE_SIZE - 1);
+    queue->slots[slotIndex].client = client;
+    __atomic_store_n(&queue->slots[slotIndex].sequence, (index + 1) - slotIndex, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Returns true if the next slot to be read has not been written to.
+ * @param queue Queue structure.
+ * @return True if the next slot to be read has not been written to.
+ */
+static inline __attribute__((always_inline)) bool SpiBusQueueEmpty(SpiBusQueue * const queue) {
+    const uint32_t index = __atomic_load_n(&queue->readIndex, __ATOMIC_RELAXED);
+    return SpiBusQueueSequence(queue, index) != (index + 1);
+}
+
+/**
+ * @brief Reads a client from the queue. This function must not be called from
+ * more than one context at a time.
+ * @param queue Queue structure.
+ * @return Client. NULL if the queue is empty.
+ */
+static inline __attribute__((always_inline)) SpiBusClient * SpiBusQueueRead(SpiBusQueue * const queue) {
+    if (SpiBusQueueEmpty(queue)) {
+        return NULL;
+    }
+    const uint32_t index = queue->readIndex;
+    const uint32_t slotIndex = index & (SPI_BUS_QUEUE_SIZE - 1);
+    SpiBusClient * const client = queue->slots[slotIndex].client;
+    __atomic_store_n(&queue->slots[slotIndex].sequence, (index + SPI_BUS_QUEUE_SIZE) - slotIndex, __ATOMIC_RELEASE);
+    __atomic_store_n(&queue->readIndex, index + 1, __ATOMIC_RELAXED);
+    return client;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
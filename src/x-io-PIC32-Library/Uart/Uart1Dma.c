@@ -0,0 +1,381 @@
+/**
+ * @file Uart1Dma.c
+ * @author Seb Madgwick
+ * @brief UART driver using DMA for PIC32 devices. DMA used for TX and RX.
+ *
+ * Received data is transferred by a DMA channel into a circular read buffer
+ * without CPU interrupts for each byte. The DMA channel interrupts only at
+ * each half of the read buffer so that an overrun can be detected. The write
+ * index of the read buffer is updated from the DMA destination pointer each
+ * time the read buffer is accessed so that all received data is available to
+ * read immediately, including a partial message after the line becomes idle.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Config.h"
+#include "definitions.h"
+#include "Fifo.h"
+#include "PriorityFifo.h"
+#include "sys/kmem.h"
+#include "Uart1Dma.h"
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+static void ReadTransferTasks(void);
+static void WriteTransferComplete(void);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static bool receiveBufferOverrun;
+static __attribute__((coherent)) uint8_t readData[UART1_READ_BUFFER_SIZE];
+static Fifo readFifo = {.data = readData, .dataSize = sizeof (readData)};
+static volatile uint32_t numberOfHalfBlocks;
+static uint32_t numberOfBytesReceived;
+static uint8_t writeData[UART1_WRITE_BUFFER_SIZE];
+static uint8_t mediumPriorityWriteData[UART1_MEDIUM_PRIORITY_WRITE_BUFFER_SIZE];
+static uint8_t highPriorityWriteData[UART1_HIGH_PRIORITY_WRITE_BUFFER_SIZE];
+static PriorityFifo writeFifo = {.fifos = {
+    {.data = writeData, .dataSize = sizeof (writeData)},
+    {.data = mediumPriorityWriteData, .dataSize = sizeof (mediumPriorityWriteData)},
+    {.data = highPriorityWriteData, .dataSize = sizeof (highPriorityWriteData)},
+}};
+static void (*writeTransferComplete)(void);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises the module.
+ * @param settings Settings.
+ */
+void Uart1DmaInitialise(const UartSettings * const settings) {
+
+    // Ensure default register states
+    Uart1DmaDeinitialise();
+
+    // Configure UART
+    if (settings->rtsCtsEnabled) {
+        U1MODEbits.UEN = 0b10; // UxTX, UxRX, UxCTS and UxRTS pins are enabled and used
+    }
+    if (settings->invertTxRx) {
+        U1MODEbits.RXINV = 1; // UxRX Idle state is '0'
+        U1STAbits.UTXINV = 1; // UxTX Idle state is '0'
+    }
+    U1MODEbits.PDSEL = settings->parityAndData;
+    U1MODEbits.STSEL = settings->stopBits;
+    U1MODEbits.BRGH = 1; // high-Speed mode - 4x baud clock enabled
+    U1STAbits.URXISEL = 0b00; // interrupt flag bit is asserted while receive buffer is not empty (i.e., has at least 1 data character)
+    U1STAbits.URXEN = 1; // UARTx receiver is enabled. UxRX pin is controlled by UARTx (if ON = 1)
+    U1STAbits.UTXEN = 1; // UARTx transmitter is enabled. UxTX pin is controlled by UARTx (if ON = 1)
+    U1BRG = UartCalculateUxbrg(settings->baudRate);
+    U1MODEbits.ON = 1; // UARTx is enabled. UARTx pins are controlled by UARTx as defined by UEN<1:0> and UTXEN control bits
+
+    // Enable DMA
+    DMACONbits.ON = 1;
+
+    // Configure TX DMA channel
+    DCH1ECONbits.CHSIRQ = _UART1_TX_VECTOR; // channel transfer start IRQ
+    DCH1ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH1DSA = KVA_TO_PA(&U1TXREG); // destination address
+    DCH1DSIZ = 1; // destination size
+    DCH1CSIZ = 1; // transfers per event
+    DCH1INTbits.CHBCIE = 1; // channel block transfer complete interrupt enable bit
+
+    // Configure RX DMA channel
+    DCH7CONbits.CHAEN = 1; // channel is continuously enabled, and not automatically disabled after a block transfer is complete
+    DCH7ECONbits.CHSIRQ = _UART1_RX_VECTOR; // channel transfer start IRQ
+    DCH7ECONbits.SIRQEN = 1; // start channel cell transfer if an interrupt matching CHSIRQ occurs
+    DCH7SSA = KVA_TO_PA(&U1RXREG); // source address
+    DCH7SSIZ = 1; // source size
+    DCH7DSA = KVA_TO_PA(readData); // destination address
+    DCH7DSIZ = sizeof (readData); // destination size
+    DCH7CSIZ = 1; // transfers per event
+    DCH7INTbits.CHDHIE = 1; // channel destination half full interrupt enable bit
+    DCH7INTbits.CHBCIE = 1; // channel block transfer complete interrupt enable bit
+    DCH7CONbits.CHEN = 1; // enable RX DMA channel
+
+    // Enable interrupts
+    EVIC_SourceEnable(INT_SOURCE_DMA1);
+    EVIC_SourceEnable(INT_SOURCE_DMA7);
+}
+
+/**
+ * @brief Deinitialises the module.
+ */
+void Uart1DmaDeinitialise(void) {
+
+    // Disable UART and restore default register states
+    U1MODE = 0;
+    U1STA = 0;
+
+    // Disable TX DMA channel and restore default register states
+    DCH1CON = 0;
+    DCH1ECON = 0;
+    DCH1INT = 0;
+    DCH1SSA = 0;
+    DCH1DSA = 0;
+    DCH1SSIZ = 0;
+    DCH1DSIZ = 0;
+    DCH1SPTR = 0;
+    DCH1DPTR = 0;
+    DCH1CSIZ = 0;
+    DCH1CPTR = 0;
+    DCH1DAT = 0;
+
+    // Disable RX DMA channel and restore default register states
+    DCH7CON = 0;
+    DCH7ECON = 0;
+    DCH7INT = 0;
+    DCH7SSA = 0;
+    DCH7DSA = 0;
+    DCH7SSIZ = 0;
+    DCH7DSIZ = 0;
+    DCH7SPTR = 0;
+    DCH7DPTR = 0;
+    DCH7CSIZ = 0;
+    DCH7CPTR = 0;
+    DCH7DAT = 0;
+
+    // Disable interrupts
+    EVIC_SourceDisable(INT_SOURCE_DMA1);
+    EVIC_SourceDisable(INT_SOURCE_DMA7);
+    EVIC_SourceStatusClear(INT_SOURCE_UART1_RX);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA1);
+    EVIC_SourceStatusClear(INT_SOURCE_DMA7);
+
+    // Clear buffers
+    receiveBufferOverrun = false;
+    numberOfHalfBlocks = 0;
+    numberOfBytesReceived = 0;
+    Uart1DmaClearReadBuffer();
+    Uart1DmaClearWriteBuffer();
+}
+
+/**
+ * @brief Returns the number of bytes available in the read buffer.
+ * @return Number of bytes available in the read buffer.
+ */
+size_t Uart1DmaAvailableRead(void) {
+
+    // Process received data
+    ReadTransferTasks();
+
+    // Clear receive buffer overrun flag
+    if (U1STAbits.OERR == 1) {
+        U1STAbits.OERR = 0;
+        receiveBufferOverrun = true;
+    }
+
+    // Return number of bytes
+    return FifoAvailableRead(&readFifo);
+}
+
+/**
+ * @brief Reads data from the read buffer.
+ * @param destination Destination.
+ * @param numberOfBytes Number of bytes.
+ * @return Number of bytes read.
+ */
+size_t Uart1DmaRead(void* const destination, size_t numberOfBytes) {
+    Uart1DmaAvailableRead(); // process receive buffer
+    return FifoRead(&readFifo, destination, numberOfBytes);
+}
+
+/**
+ * @brief Updates the write index of the read buffer from the RX DMA channel
+ * destination pointer. Unread data is discarded if it has been overwritten.
+ */
+static void ReadTransferTasks(void) {
+
+    // Calculate total number of bytes received
+    const size_t halfBlockSize = sizeof (readData) / 2;
+    const uint32_t numberOfHalfBlocks_ = numberOfHalfBlocks; // must be read before destination pointer
+    const size_t writeIndex = DCH7DPTR % sizeof (readData);
+    const size_t halfBlockIndex = (writeIndex + sizeof (readData) - ((numberOfHalfBlocks_ & 1) * halfBlockSize)) % sizeof (readData); // interrupt may be pending
+    const uint32_t numberOfBytesReceived_ = (numberOfHalfBlocks_ * halfBlockSize) + halfBlockIndex;
+    const uint32_t numberOfNewBytes = numberOfBytesReceived_ - numberOfBytesReceived;
+    numberOfBytesReceived = numberOfBytesReceived_;
+
+    // Discard unread data if overwritten
+    if ((FifoAvailableRead(&readFifo) + numberOfNewBytes) > FifoCapacity(&readFifo)) {
+        readFifo.readIndex = writeIndex;
+        receiveBufferOverrun = true;
+    }
+    readFifo.writeIndex = writeIndex;
+}
+
+/**
+ * @brief Reads a byte from the read buffer. This function must only be called
+ * if there are bytes available in the read buffer.
+ * @return Byte.
+ */
+uint8_t Uart1DmaReadByte(void) {
+    return FifoReadByte(&readFifo);
+}
+
+/**
+ * @brief Returns the capacity of the write buffer of the priority.
+ * @param priority Priority.
+ * @return Capacity of the write buffer of the priority.
+ */
+size_t Uart1DmaWriteCapacity(const PriorityFifoPriority priority) {
+    return PriorityFifoCapacity(&writeFifo, priority);
+}
+
+/**
+ * @brief Returns the space available in the write buffer of the priority.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
+ */
+size_t Uart1DmaAvailableWrite(const PriorityFifoPriority priority) {
+    return PriorityFifoAvailableWrite(&writeFifo, priority);
+}
+
+/**
+ * @brief Writes a message to the write buffer of the priority.
+ * @param priority Priority.
+ * @param data Data.
+ * @param numberOfBytes Number of bytes.
+ * @return Result.
+ */
+FifoResult Uart1DmaWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    const FifoResult result = PriorityFifoWrite(&writeFifo, priority, data, numberOfBytes);
+    if (Uart1DmaWriteTransferInProgress() == false) {
+        WriteTransferComplete();
+    }
+    return result;
+}
+
+/**
+ * @brief Reserves space in the write buffer of the priority for a message to
+ * be written to directly. Uart1DmaCommit must be called after the message
+ * has been written.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+FifoResult Uart1DmaReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return PriorityFifoReserve(&writeFifo, priority, numberOfBytes, reservation);
+}
+
+/**
+ * @brief Makes a message written to a reservation available to transmit.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+void Uart1DmaCommit(const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    PriorityFifoCommit(&writeFifo, priority, numberOfBytes);
+    if (Uart1DmaWriteTransferInProgress() == false) {
+        WriteTransferComplete();
+    }
+}
+
+/**
+ * @brief Write transfer complete callback. Each transfer is filled strictly by
+ * priority so the transfer size limits the data sent before a high-priority
+ * message.
+ */
+static void WriteTransferComplete(void) {
+    static __attribute__((coherent)) uint8_t data[UART1_DMA_WRITE_TRANSFER_SIZE];
+    const size_t numberOfBytes = PriorityFifoRead(&writeFifo, data, sizeof (data));
+    if (numberOfBytes > 0) {
+        Uart1DmaWriteTransfer(data, numberOfBytes, WriteTransferComplete);
+    }
+}
+
+/**
+ * @brief Writes data directly to the transmit buffer through a DMA transfer.
+ * The data must be declared __attribute__((coherent)) for PIC32MZ devices. This
+ * function must not be called while a transfer is in progress.
+ * @param data Data.
+ * @param numberOfBytes Number of bytes.
+ * @param writeTransferComplete_ Write transfer complete callback. NULL if
+ * unused.
+ */
+void Uart1DmaWriteTransfer(const void* const data, const size_t numberOfBytes, void (*const writeTransferComplete_) (void)) {
+    writeTransferComplete = writeTransferComplete_;
+    DCH1SSA = KVA_TO_PA(data); // source address
+    DCH1SSIZ = numberOfBytes; // source size
+    DCH1INTbits.CHBCIF = 0; // clear TX DMA channel interrupt flag
+    DCH1CONbits.CHEN = 1; // enable TX DMA channel to begin write
+}
+
+/**
+ * @brief DMA interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Dma1InterruptHandler(void) {
+    EVIC_SourceStatusClear(INT_SOURCE_DMA1); // clear interrupt flag first because callback may start new write
+    if (writeTransferComplete != NULL) {
+        writeTransferComplete();
+    }
+}
+
+/**
+ * @brief RX DMA interrupt handler. This function should be called by the ISR
+ * implementation generated by MPLAB Harmony.
+ */
+void Dma7InterruptHandler(void) {
+    if (DCH7INTbits.CHDHIF == 1) {
+        DCH7INTCLR = _DCH7INT_CHDHIF_MASK; // atomic clear so that a flag set by the DMA is not lost
+        numberOfHalfBlocks++;
+    }
+    if (DCH7INTbits.CHBCIF == 1) {
+        DCH7INTCLR = _DCH7INT_CHBCIF_MASK;
+        numberOfHalfBlocks++;
+    }
+    EVIC_SourceStatusClear(INT_SOURCE_DMA7);
+}
+
+/**
+ * @brief Returns true while data is being transferred to the transmit buffer.
+ * @return True while data is being transferred to the transmit buffer.
+ */
+bool Uart1DmaWriteTransferInProgress(void) {
+    return DCH1CONbits.CHEN == 1;
+}
+
+/**
+ * @brief Clears the read buffer and resets the read buffer overrun flag.
+ */
+void Uart1DmaClearReadBuffer(void) {
+    ReadTransferTasks();
+    readFifo.readIndex = readFifo.writeIndex;
+    Uart1DmaReceiveBufferOverrun(); // clear flag
+}
+
+/**
+ * @brief Clears the write buffer.
+ */
+void Uart1DmaClearWriteBuffer(void) {
+    PriorityFifoClear(&writeFifo);
+}
+
+/**
+ * @brief Returns true if the receive buffer has overrun. Calling this function
+ * will reset the flag.
+ * @return True if the receive buffer has overrun.
+ */
+bool Uart1DmaReceiveBufferOverrun(void) {
+    if (receiveBufferOverrun) {
+        receiveBufferOverrun = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Returns true if all data has been transmitted.
+ * @return True if all data has been transmitted.
+ */
+bool Uart1DmaTransmissionComplete(void) {
+    return (Uart1DmaWriteTransferInProgress() == false) && (U1STAbits.TRMT == 1);
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,43 @@
+/**
+ * @file Uart1Dma.h
+ * @author Seb Madgwick
+ * @brief UART driver using DMA for PIC32 devices. DMA used for TX and RX.
+ */
+
+#ifndef UART1_DMA_H
+#define UART1_DMA_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Fifo.h"
+#include "PriorityFifo.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "Uart.h"
+
+//------------------------------------------------------------------------------
+// Function declarations
+
+void Uart1DmaInitialise(const UartSettings * const settings);
+void Uart1DmaDeinitialise(void);
+size_t Uart1DmaAvailableRead(void);
+size_t Uart1DmaRead(void* const destination, size_t numberOfBytes);
+uint8_t Uart1DmaReadByte(void);
+size_t Uart1DmaWriteCapacity(const PriorityFifoPriority priority);
+size_t Uart1DmaAvailableWrite(const PriorityFifoPriority priority);
+FifoResult Uart1DmaWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+FifoResult Uart1DmaReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+void Uart1DmaCommit(const PriorityFifoPriority priority, const size_t numberOfBytes);
+void Uart1DmaWriteTransfer(const void* const data, const size_t numberOfBytes, void (*const writeTransferComplete_) (void));
+bool Uart1DmaWriteTransferInProgress(void);
+void Uart1DmaClearReadBuffer(void);
+void Uart1DmaClearWriteBuffer(void);
+bool Uart1DmaReceiveBufferOverrun(void);
+bool Uart1DmaTransmissionComplete(void);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -1,39 +0,0 @@
-/**
- * @file Uart1DmaTx.h
- * @author Seb Madgwick
- * @brief UART driver using DMA for PIC32 devices. DMA used for TX only.
- */
-
-#ifndef UART1_DMA_TX_H
-#define UART1_DMA_TX_H
-
-//------------------------------------------------------------------------------
-// Includes
-
-#include "Fifo.h"
-#include <stdbool.h>
-#include <stddef.h>
-#include <stdint.h>
-#include "Uart.h"
-
-//------------------------------------------------------------------------------
-// Function declarations
-
-void Uart1DmaTxInitialise(const UartSettings * const settings);
-void Uart1DmaTxDeinitialise(void);
-size_t Uart1DmaTxAvailableRead(void);
-size_t Uart1DmaTxRead(void* const destination, size_t numberOfBytes);
-uint8_t Uart1DmaTxReadByte(void);
-size_t Uart1DmaTxAvailableWrite(void);
-FifoResult Uart1DmaTxWrite(const void* const data, const size_t numberOfBytes);
-void Uart1DmaTxWriteTransfer(const void* const data, const size_t numberOfBytes, void (*const writeTransferComplete_) (void));
-bool Uart1DmaTxWriteTransferInProgress(void);
-void Uart1DmaTxClearReadBuffer(void);
-void Uart1DmaTxClearWriteBuffer(void);
-bool Uart1DmaTxReceiveBufferOverrun(void);
-bool Uart1DmaTxTransmissionComplete(void);
-
-#endif
-
-//------------------------------------------------------------------------------
-// End of file
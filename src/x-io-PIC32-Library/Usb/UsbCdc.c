@@ -11,6 +11,19 @@
 #include "definitions.h"
 #include "UsbCdc.h"
 
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum packet size of the bulk IN endpoint in high-speed mode. The
+ * write transfer size must be a multiple of this value.
+ */
+#define MAX_PACKET_SIZE (512)
+
+#if (USB_CDC_WRITE_TRANSFER_SIZE % MAX_PACKET_SIZE) != 0
+#error "Write transfer size must be a multiple of the maximum packet size."
+#endif
+
 //------------------------------------------------------------------------------
 // Function declarations
 
@@ -27,11 +40,18 @@ static volatile bool hostConnected;
 static volatile bool portOpen;
 static volatile uint8_t __attribute__((coherent)) readRequestData[512]; // must be declared __attribute__((coherent)) for PIC32MZ devices
 static volatile bool readInProgress;
-static volatile bool writeInProgress;
+static volatile uint32_t writeTransfersSubmitted;
+static volatile uint32_t writeTransfersCompleted;
 static uint8_t readData[USB_CDC_READ_BUFFER_SIZE];
 static Fifo readFifo = {.data = readData, .dataSize = sizeof (readData)};
 static uint8_t writeData[USB_CDC_WRITE_BUFFER_SIZE];
-static Fifo writeFifo = {.data = writeData, .dataSize = sizeof (writeData)};
+static uint8_t mediumPriorityWriteData[USB_CDC_MEDIUM_PRIORITY_WRITE_BUFFER_SIZE];
+static uint8_t highPriorityWriteData[USB_CDC_HIGH_PRIORITY_WRITE_BUFFER_SIZE];
+static PriorityFifo writeFifo = {.fifos = {
+    {.data = writeData, .dataSize = sizeof (writeData)},
+    {.data = mediumPriorityWriteData, .dataSize = sizeof (mediumPriorityWriteData)},
+    {.data = highPriorityWriteData, .dataSize = sizeof (highPriorityWriteData)},
+}};
 
 //------------------------------------------------------------------------------
 // Functions
@@ -68,7 +88,7 @@ static void APP_USBDeviceEventHandler(USB_DEVICE_EVENT event, void * eventData,
             hostConnected = false;
             portOpen = false;
             readInProgress = false;
-            writeInProgress = false;
+            writeTransfersCompleted = writeTransfersSubmitted;
             break;
         case USB_DEVICE_EVENT_CONFIGURED:
             if (((USB_DEVICE_EVENT_DATA_CONFIGURED *) eventData)->configurationValue == 1) {
@@ -84,7 +104,7 @@ static void APP_USBDeviceEventHandler(USB_DEVICE_EVENT event, void * eventData,
             hostConnected = false;
             portOpen = false;
             readInProgress = false;
-            writeInProgress = false;
+            writeTransfersCompleted = writeTransfersSubmitted;
             break;
         default:
             break;
@@ -126,7 +146,9 @@ static void APP_USBDeviceCDCEventHandler(USB_DEVICE_CDC_INDEX index, USB_DEVICE_
             USB_DEVICE_ControlStatus(usbDeviceHandle, USB_DEVICE_CONTROL_STATUS_OK);
             break;
         case USB_DEVICE_CDC_EVENT_WRITE_COMPLETE:
-            writeInProgress = false;
+            if (writeTransfersCompleted != writeTransfersSubmitted) { // ignore transfers aborted after counts reset
+                writeTransfersCompleted++;
+            }
             break;
         default:
             break;
@@ -154,31 +176,51 @@ static void ReadTasks(void) {
 }
 
 /**
- * @brief Write tasks.
+ * @brief Write tasks. Up to USB_CDC_NUMBER_OF_WRITE_TRANSFERS writes are in
+ * progress at a time so that the next transfer is queued before the previous
+ * transfer completes. Transfers are completed in the order that they are
+ * scheduled so each transfer buffer is reused in turn. A transfer that is a
+ * multiple of the maximum packet size is flagged as more data pending if it is
+ * followed by data already in the buffer so that no ZLP is sent. Otherwise, the
+ * driver will send a ZLP if the transfer size is a multiple of the maximum
+ * packet size. Other transfers must not be flagged as more data pending because
+ * the driver truncates the transfer to a multiple of the maximum packet size.
+ * Each transfer is filled strictly by priority so that no more than the data
+ * already scheduled is sent before a high-priority message. Data is kept in the
+ * transfer buffer if the write is not scheduled and is written by the next
+ * call.
  */
 static void WriteTasks(void) {
+    static uint8_t __attribute__((coherent)) buffers[USB_CDC_NUMBER_OF_WRITE_TRANSFERS][USB_CDC_WRITE_TRANSFER_SIZE]; // must be declared __attribute__((coherent)) for PIC32MZ devices
+    static USB_DEVICE_CDC_TRANSFER_HANDLE usbDeviceCdcTransferHandles[USB_CDC_NUMBER_OF_WRITE_TRANSFERS];
+    static size_t numberOfBytes; // number of bytes in buffer not yet scheduled
+    while ((writeTransfersSubmitted - writeTransfersCompleted) < USB_CDC_NUMBER_OF_WRITE_TRANSFERS) {
 
-    // Do nothing if write in progress
-    if (writeInProgress) {
-        return;
-    }
-
-    // Do nothing if no data available
-    if (FifoAvailableRead(&writeFifo) == 0) {
-        return;
-    }
+        // Copy data to buffer
+        const uint32_t index = writeTransfersSubmitted % USB_CDC_NUMBER_OF_WRITE_TRANSFERS;
+        if (numberOfBytes == 0) {
+            numberOfBytes = PriorityFifoRead(&writeFifo, buffers[index], sizeof (buffers[index]));
+        }
 
-    // Copy data to buffer
-    static uint8_t __attribute__((coherent)) buffer[1024]; // must be declared __attribute__((coherent)) for PIC32MZ devices
-    const size_t numberOfBytes = FifoRead(&writeFifo, buffer, sizeof (buffer));
+        // Do nothing if no data available
+        if (numberOfBytes == 0) {
+            return;
+        }
+        const bool moreDataPending = (PriorityFifoEmpty(&writeFifo) == false) && ((numberOfBytes % MAX_PACKET_SIZE) == 0);
+        const USB_DEVICE_CDC_TRANSFER_FLAGS flags = moreDataPending ? USB_DEVICE_CDC_TRANSFER_FLAGS_MORE_DATA_PENDING : USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE;
 
-    // Schedule write
-    writeInProgress = true;
-    static USB_DEVICE_CDC_TRANSFER_HANDLE usbDeviceCdcTransferHandle = USB_DEVICE_CDC_TRANSFER_HANDLE_INVALID;
-    const USB_DEVICE_CDC_RESULT usbDeviceCdcResult = USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &usbDeviceCdcTransferHandle, buffer, numberOfBytes, USB_DEVICE_CDC_TRANSFER_FLAGS_DATA_COMPLETE);
-    if (usbDeviceCdcResult != USB_DEVICE_CDC_RESULT_OK) {
-        writeInProgress = false;
-        return;
+        // Schedule write
+        writeTransfersSubmitted++; // increment before write because write may complete before function returns
+        const USB_DEVICE_CDC_RESULT usbDeviceCdcResult = USB_DEVICE_CDC_Write(USB_DEVICE_CDC_INDEX_0, &usbDeviceCdcTransferHandles[index], buffers[index], numberOfBytes, flags);
+        if (usbDeviceCdcResult != USB_DEVICE_CDC_RESULT_OK) {
+            if (writeTransfersSubmitted != writeTransfersCompleted) { // counts may have been reset by event handler
+                writeTransfersSubmitted--;
+            } else {
+                numberOfBytes = 0; // discard with aborted transfers
+            }
+            return;
+        }
+        numberOfBytes = 0;
     }
 }
 
@@ -240,30 +282,64 @@ uint8_t UsbCdcReadByte(void) {
 }
 
 /**
- * @brief Returns the space available in the write buffer.
- * @return Space available in the write buffer.
+ * @brief Returns the capacity of the write buffer of the priority.
+ * @param priority Priority.
+ * @return Capacity of the write buffer of the priority.
  */
-size_t UsbCdcAvailableWrite(void) {
-    return FifoAvailableWrite(&writeFifo);
+size_t UsbCdcWriteCapacity(const PriorityFifoPriority priority) {
+    return PriorityFifoCapacity(&writeFifo, priority);
 }
 
 /**
- * @brief Writes data to the write buffer.
+ * @brief Returns the space available in the write buffer of the priority.
+ * @param priority Priority.
+ * @return Space available in the write buffer of the priority.
+ */
+size_t UsbCdcAvailableWrite(const PriorityFifoPriority priority) {
+    return PriorityFifoAvailableWrite(&writeFifo, priority);
+}
+
+/**
+ * @brief Writes a message to the write buffer of the priority.
+ * @param priority Priority.
  * @param data Data.
  * @param numberOfBytes Number of bytes.
  * @return Result.
  */
-FifoResult UsbCdcWrite(const void* const data, const size_t numberOfBytes) {
-    return FifoWrite(&writeFifo, data, numberOfBytes);
+FifoResult UsbCdcWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes) {
+    return PriorityFifoWrite(&writeFifo, priority, data, numberOfBytes);
+}
+
+/**
+ * @brief Reserves space in the write buffer of the priority for a message to
+ * be written to directly. UsbCdcCommit must be called after the message has
+ * been written.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ * @param reservation Reservation.
+ * @return Result.
+ */
+FifoResult UsbCdcReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation) {
+    return PriorityFifoReserve(&writeFifo, priority, numberOfBytes, reservation);
+}
+
+/**
+ * @brief Makes a message written to a reservation available to write to the
+ * host.
+ * @param priority Priority.
+ * @param numberOfBytes Number of bytes.
+ */
+void UsbCdcCommit(const PriorityFifoPriority priority, const size_t numberOfBytes) {
+    PriorityFifoCommit(&writeFifo, priority, numberOfBytes);
 }
 
 /**
- * @brief Writes a byte to the write buffer.
+ * @brief Writes a byte to the low-priority write buffer.
  * @param byte Byte.
  * @return Result.
  */
 FifoResult UsbCdcWriteByte(const uint8_t byte) {
-    return FifoWriteByte(&writeFifo, byte);
+    return PriorityFifoWrite(&writeFifo, PriorityFifoPriorityLow, &byte, sizeof (byte));
 }
 
 //------------------------------------------------------------------------------
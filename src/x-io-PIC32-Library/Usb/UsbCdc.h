@@ -11,6 +11,7 @@
 // Includes
 
 #include "Fifo.h"
+#include "PriorityFifo.h"
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -25,8 +26,11 @@ bool UsbCdcPortOpen(void);
 size_t UsbCdcAvailableRead(void);
 size_t UsbCdcRead(void* const destination, size_t numberOfBytes);
 uint8_t UsbCdcReadByte(void);
-size_t UsbCdcAvailableWrite(void);
-FifoResult UsbCdcWrite(const void* const data, const size_t numberOfBytes);
+size_t UsbCdcWriteCapacity(const PriorityFifoPriority priority);
+size_t UsbCdcAvailableWrite(const PriorityFifoPriority priority);
+FifoResult UsbCdcWrite(const PriorityFifoPriority priority, const void* const data, const size_t numberOfBytes);
+FifoResult UsbCdcReserve(const PriorityFifoPriority priority, const size_t numberOfBytes, FifoReservation * const reservation);
+void UsbCdcCommit(const PriorityFifoPriority priority, const size_t numberOfBytes);
 FifoResult UsbCdcWriteByte(const uint8_t byte);
 
 #endif
@@ -1,5 +1,26 @@
 import re
 
+NUMBER_OF_CHANNELS = 8
+
+# DMA channel allocation. Each driver is assigned unique channels in the order that the channels appear in the code.
+#
+# The ICM buses (Spi2Dma to Spi6Dma) each carry four ICMs and so no bus is busier than the others. Each has an RX channel
+# only. Transfers larger than the 16-byte TX FIFO are topped up by one TX interrupt per 8 bytes, as counted by
+# Tests/Spi3Dma:
+#   - ICM sample read (FIFO watermark 0, the default): 15 bytes, 0 TX interrupts
+#   - ICM FIFO read of 1, 4, or 16 packets: 19, 67, or 259 bytes, 1, 7, or 31 TX interrupts (up to 2 per sample)
+# This is 7750 TX interrupts per second per bus for four ICMs at 1 kHz with a FIFO watermark of 16, and at most
+# 210000 per second per bus at the 14 MHz bus capacity.
+ALLOCATION = {
+    "Spi/Spi1DmaTx.c": (0,),
+    "Uart/Uart1Dma.c": (1, 7),  # TX, RX
+    "Spi/Spi2Dma.c": (2,),  # RX
+    "Spi/Spi3Dma.c": (3,),  # RX
+    "Spi/Spi4Dma.c": (4,),  # RX
+    "Spi/Spi5Dma.c": (5,),  # RX
+    "Spi/Spi6Dma.c": (6,),  # RX
+}
+
 
 def dma_select(path: str, new_channels: tuple[int, ...]):
     with open(path) as file:
@@ -13,6 +34,9 @@ def dma_select(path: str, new_channels: tuple[int, ...]):
 
     old_channels = sorted({c for m in matches for c in m if c})
 
+    if len(old_channels) != len(new_channels):
+        raise ValueError(f"{path} uses {len(old_channels)} channels but is allocated {len(new_channels)}")
+
     for old_channel, new_channel in zip(old_channels, new_channels):
         old_keywords = [k.replace("?", old_channel) for k in keywords]
         new_keywords = [k.replace("?", f"${new_channel}$") for k in keywords]
@@ -26,12 +50,15 @@ def dma_select(path: str, new_channels: tuple[int, ...]):
         file.write(code)
 
 
-dma_select("Spi/Spi1DmaTx.c", (0,))
+allocated = [c for channels in ALLOCATION.values() for c in channels]
 
-dma_select("Spi/Spi3Dma.c", (2, 3))
+if len(allocated) != len(set(allocated)):
+    raise ValueError("DMA channel allocated more than once")
 
-dma_select("Spi/Spi4Dma.c", (4, 5))
+if any(c >= NUMBER_OF_CHANNELS for c in allocated):
+    raise ValueError("Invalid DMA channel")
 
-dma_select("Spi/Spi6Dma.c", (6, 7))
+for path, channels in ALLOCATION.items():
+    dma_select(path, channels)
 
-dma_select("Uart/Uart1DmaTx.c", (1,))
+print("Unallocated channels: " + str(sorted(set(range(NUMBER_OF_CHANNELS)) - set(allocated))))